@@ -0,0 +1,183 @@
+#ifndef MULTILAYER_LASER_SCAN_BENCHMARK_SCANS_H
+#define MULTILAYER_LASER_SCAN_BENCHMARK_SCANS_H
+
+#include <benchmark/benchmark.h>
+
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+
+#include <cmath>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Layout of one scan of Velodyne HDL-32E spinning at 10 Hz (the same
+ *        as in the RealScanners.VelodyneHDL32ERegular test).
+ */
+inline MultiLayerLaserScan CreateVelodyneHDL32EScan()
+{
+  MultiLayerLaserScan msg;
+
+  msg.header.stamp = ros::Time(10.0);
+
+  msg.subscan_layout.time_offsets.regular = true;
+  msg.subscan_layout.time_offsets.increment = ros::Duration(1.152e-6);
+  msg.subscan_layout.angular_offsets.regular = false;
+  msg.subscan_layout.angular_offsets.offsets = {
+      -30.67, -9.33, -29.33, -8.00, -28.00, -6.67, -26.67, -5.33,
+      -25.33, -4.00, -24.00, -2.67, -22.67, -1.33, -21.33,  0.00,
+      -20.00,  1.33, -18.67,  2.67, -17.33,  4.00, -16.00,  5.33,
+      -14.67,  6.67, -13.33,  8.00, -12.00,  9.33, -10.67,  10.67
+  };
+  for (auto& offset : msg.subscan_layout.angular_offsets.offsets)
+    offset *= 2 * M_PI / 360;
+
+  msg.scan_layout.time_offsets.regular = true;
+  msg.scan_layout.time_offsets.increment = msg.subscan_layout.time_offsets.increment * 40;
+  msg.scan_layout.angular_offsets.regular = true;
+  msg.scan_layout.angular_offsets.min = 0;
+  msg.scan_layout.angular_offsets.max = 2 * M_PI;
+  msg.scan_layout.angular_offsets.samples = 2172;
+  msg.scan_layout.angular_offsets.exclude_last = true;
+
+  msg.scan_offsets_during_subscan.regular = true;
+  msg.scan_offsets_during_subscan.min = 0;
+  msg.scan_offsets_during_subscan.max = 2 * M_PI / 2172 / 40 * 32;
+  msg.scan_offsets_during_subscan.samples = 32;
+
+  msg.range_min = 0.9f;
+  msg.range_max = 130.0f;
+  msg.ranges.resize(2172 * 32, 10.0f);
+  msg.intensities.resize(2172 * 32, 100.0f);
+
+  return msg;
+}
+
+/**
+ * @brief Layout of one scan of Ouster OS1-64 in 2048x10 mode (the same as in
+ *        the RealScanners.Ouster64Regular test).
+ */
+inline MultiLayerLaserScan CreateOuster64Scan()
+{
+  MultiLayerLaserScan msg;
+
+  msg.header.stamp = ros::Time(10.0);
+
+  msg.subscan_layout.time_offsets.regular = true;
+  msg.subscan_layout.time_offsets.increment = ros::Duration(0);
+  msg.subscan_layout.angular_offsets.regular = true;
+  msg.subscan_layout.angular_offsets.min = -16.611 * 2 * M_PI / 360;
+  msg.subscan_layout.angular_offsets.max =  16.611 * 2 * M_PI / 360;
+  msg.subscan_layout.angular_offsets.samples = -64;
+
+  msg.scan_layout.time_offsets.regular = true;
+  msg.scan_layout.time_offsets.increment = ros::Duration(0.1 / 2048);
+  msg.scan_layout.angular_offsets.regular = true;
+  msg.scan_layout.angular_offsets.min = 0;
+  msg.scan_layout.angular_offsets.max = 2 * M_PI;
+  msg.scan_layout.angular_offsets.exclude_last = true;
+  msg.scan_layout.angular_offsets.samples = 2048;
+
+  msg.scan_offsets_during_subscan.regular = false;
+  for (size_t i = 0; i < 16; ++i)
+  {
+    for (const auto offset : {3.164, 1.055, -1.055, -3.164})
+      msg.scan_offsets_during_subscan.offsets.push_back(offset * 2 * M_PI / 360);
+  }
+
+  msg.range_min = 0.25f;
+  msg.range_max = 120.0f;
+  msg.ranges.resize(2048 * 64, 10.0f);
+  msg.intensities.resize(2048 * 64, 100.0f);
+
+  return msg;
+}
+
+/**
+ * @brief Layout of one scan of Ouster OS1-128 in 1024x10 mode (131k points).
+ */
+inline MultiLayerLaserScan CreateOuster128Scan()
+{
+  MultiLayerLaserScan msg;
+
+  msg.header.stamp = ros::Time(10.0);
+
+  msg.subscan_layout.time_offsets.regular = true;
+  msg.subscan_layout.time_offsets.increment = ros::Duration(0);
+  msg.subscan_layout.angular_offsets.regular = true;
+  msg.subscan_layout.angular_offsets.min = -22.5 * 2 * M_PI / 360;
+  msg.subscan_layout.angular_offsets.max =  22.5 * 2 * M_PI / 360;
+  msg.subscan_layout.angular_offsets.samples = -128;
+
+  msg.scan_layout.time_offsets.regular = true;
+  msg.scan_layout.time_offsets.increment = ros::Duration(0.1 / 1024);
+  msg.scan_layout.angular_offsets.regular = true;
+  msg.scan_layout.angular_offsets.min = 0;
+  msg.scan_layout.angular_offsets.max = 2 * M_PI;
+  msg.scan_layout.angular_offsets.exclude_last = true;
+  msg.scan_layout.angular_offsets.samples = 1024;
+
+  msg.scan_offsets_during_subscan.regular = false;
+  for (size_t i = 0; i < 32; ++i)
+  {
+    for (const auto offset : {4.23, 1.41, -1.41, -4.23})
+      msg.scan_offsets_during_subscan.offsets.push_back(offset * 2 * M_PI / 360);
+  }
+
+  msg.range_min = 0.3f;
+  msg.range_max = 120.0f;
+  msg.ranges.resize(1024 * 128, 10.0f);
+  msg.intensities.resize(1024 * 128, 100.0f);
+
+  return msg;
+}
+
+/**
+ * @brief Scanners the layout, iteration and conversion benchmarks are
+ *        parametrized with (argument "scanner").
+ */
+enum BenchmarkScanner
+{
+  HDL_32E = 0,
+  OS1_64 = 1,
+  OS1_128 = 2,
+};
+
+inline MultiLayerLaserScan CreateBenchmarkScan(const int64_t scanner)
+{
+  switch (scanner)
+  {
+    case HDL_32E:
+      return CreateVelodyneHDL32EScan();
+    case OS1_64:
+      return CreateOuster64Scan();
+    default:
+      return CreateOuster128Scan();
+  }
+}
+
+/** @brief Label of benchmark results, so that JSON outputs are easy to compare. */
+inline const char* BenchmarkScannerName(const int64_t scanner)
+{
+  switch (scanner)
+  {
+    case HDL_32E:
+      return "HDL-32E";
+    case OS1_64:
+      return "OS1-64";
+    default:
+      return "OS1-128";
+  }
+}
+
+/** @brief Run the benchmark for each BenchmarkScanner. */
+inline void ScannerArguments(benchmark::internal::Benchmark* b)
+{
+  b->ArgName("scanner");
+  for (const int64_t scanner : {HDL_32E, OS1_64, OS1_128})
+    b->Arg(scanner);
+}
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_BENCHMARK_SCANS_H
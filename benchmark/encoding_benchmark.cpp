@@ -0,0 +1,124 @@
+#include <benchmark/benchmark.h>
+
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+#include <multilayer_laser_scan/RangeCodec.h>
+#include <multilayer_laser_scan/RangeEncoding.h>
+
+#include <random>
+
+#include "benchmark_scans.h"
+
+using namespace sensor_msgs;
+
+// OS1-128 scan of a 30x16 m hall with a floor 1.8 m below the sensor and 5 mm noise
+static CompressedMultiLayerLaserScan createHallScan()
+{
+  auto msg = CreateOuster128Scan();
+  const MultiLayerLaserScanLayout layout(msg);
+  std::mt19937 generator(42);
+  std::normal_distribution<float> noise(0.0f, 0.005f);
+  for (size_t i = 0; i < layout.Length(); ++i)
+  {
+    const auto azimuth = layout.GetScanAngle(i);
+    const auto elevation = layout.GetSubscanAngle(i);
+    const auto dx = std::cos(elevation) * std::cos(azimuth);
+    const auto dy = std::cos(elevation) * std::sin(azimuth);
+    const auto dz = std::sin(elevation);
+    auto range = std::min(dx != 0 ? std::abs(15.0 / dx) : 1e9, dy != 0 ? std::abs(8.0 / dy) : 1e9);
+    if (dz < 0)
+      range = std::min(range, -1.8 / dz);
+    msg.ranges[i] = static_cast<float>(range) + noise(generator);
+  }
+
+  CompressedMultiLayerLaserScan compressed;
+  CompressScan(msg, compressed, ChannelEncoding::Scaled(0.001f));
+  return compressed;
+}
+
+static void BM_CompressScaled(benchmark::State& state)
+{
+  const auto msg = CreateOuster128Scan();
+  CompressedMultiLayerLaserScan compressed;
+  for (auto _ : state)
+  {
+    CompressScan(msg, compressed, ChannelEncoding::Scaled(0.002f));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * msg.ranges.size());
+}
+BENCHMARK(BM_CompressScaled);
+
+static void BM_DecompressScaled(benchmark::State& state)
+{
+  const auto msg = CreateOuster128Scan();
+  CompressedMultiLayerLaserScan compressed;
+  CompressScan(msg, compressed, ChannelEncoding::Scaled(0.002f));
+  MultiLayerLaserScan decompressed;
+  for (auto _ : state)
+  {
+    DecompressScan(compressed, decompressed);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * msg.ranges.size());
+}
+BENCHMARK(BM_DecompressScaled);
+
+static void BM_EncodeHalf(benchmark::State& state)
+{
+  const auto msg = CreateOuster128Scan();
+  std::vector<uint16_t> raw(msg.ranges.size());
+  for (auto _ : state)
+  {
+    EncodeHalf(msg.ranges.data(), msg.ranges.size(), raw.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * msg.ranges.size());
+}
+BENCHMARK(BM_EncodeHalf);
+
+static void BM_DecodeHalf(benchmark::State& state)
+{
+  const auto msg = CreateOuster128Scan();
+  std::vector<uint16_t> raw(msg.ranges.size());
+  EncodeHalf(msg.ranges.data(), msg.ranges.size(), raw.data());
+  std::vector<float> values(msg.ranges.size());
+  for (auto _ : state)
+  {
+    DecodeHalf(raw.data(), raw.size(), values.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * msg.ranges.size());
+}
+BENCHMARK(BM_DecodeHalf);
+
+static void BM_PackRanges(benchmark::State& state)
+{
+  const auto msg = createHallScan();
+  RangeCodec codec(static_cast<RangeCodec::Predictor>(state.range(0)));
+  std::vector<uint8_t> encoded;
+  RangeCodec::Statistics stats;
+  for (auto _ : state)
+  {
+    stats = codec.Encode(msg.ranges.data(), 1024, 128, encoded);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * msg.ranges.size());
+  state.counters["ratio"] = stats.CompressionRatio();
+}
+BENCHMARK(BM_PackRanges)->Arg(RangeCodec::PREDICT_PREVIOUS)->Arg(RangeCodec::PREDICT_LINEAR);
+
+static void BM_UnpackRanges(benchmark::State& state)
+{
+  const auto msg = createHallScan();
+  RangeCodec codec(static_cast<RangeCodec::Predictor>(state.range(0)));
+  std::vector<uint8_t> encoded;
+  codec.Encode(msg.ranges.data(), 1024, 128, encoded);
+  std::vector<uint16_t> decoded;
+  for (auto _ : state)
+  {
+    codec.Decode(encoded.data(), encoded.size(), decoded);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * msg.ranges.size());
+}
+BENCHMARK(BM_UnpackRanges)->Arg(RangeCodec::PREDICT_PREVIOUS)->Arg(RangeCodec::PREDICT_LINEAR);
@@ -0,0 +1,28 @@
+#include <benchmark/benchmark.h>
+
+#include <multilayer_laser_scan/SyntheticScanGenerator.h>
+
+using namespace sensor_msgs;
+
+// Generates scans of the default room; the time per scan limits the sustained load the generator can produce.
+static void BM_GenerateScan(benchmark::State& state)
+{
+  const auto preset = static_cast<SyntheticScanGenerator::Preset>(state.range(0));
+  SyntheticScanGenerator generator(SyntheticScanGenerator::CreatePresetScan(preset), SyntheticScene::Room(),
+      state.range(1) != 0);
+  MultiLayerLaserScan msg;
+  for (auto _ : state)
+  {
+    generator.Generate(ros::Time(10), msg);
+    benchmark::DoNotOptimize(msg.ranges.data());
+  }
+  state.SetItemsProcessed(state.iterations() * generator.GetLayout().Length());
+}
+BENCHMARK(BM_GenerateScan)
+  ->ArgNames({"preset", "dual"})
+  ->Args({SyntheticScanGenerator::SICK_LMS151, 0})
+  ->Args({SyntheticScanGenerator::VELODYNE_HDL_32E, 0})
+  ->Args({SyntheticScanGenerator::OUSTER_OS1_64, 0})
+  ->Args({SyntheticScanGenerator::OUSTER_OS1_64, 1})
+  ->Args({SyntheticScanGenerator::RSLIDAR_32, 0})
+  ->Unit(benchmark::kMillisecond);
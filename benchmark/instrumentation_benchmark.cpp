@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+
+#include <multilayer_laser_scan/Instrumentation.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanToPointCloud2.h>
+
+#include <string>
+
+#include "benchmark_scans.h"
+
+using namespace sensor_msgs;
+
+// Cost of one timed call of a stage, i.e. the overhead added to each instrumented call if the library is compiled
+// with MULTILAYER_LASER_SCAN_INSTRUMENTATION. Compare it to the latencies of the stages (e.g. BM_InstrumentedConvertToPointCloud2).
+static void BM_InstrumentationScopedTimer(benchmark::State& state)
+{
+  for (auto _ : state)
+  {
+    instrumentation::ScopedTimer timer(instrumentation::CARTESIAN_PROJECTION, 1024);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_InstrumentationScopedTimer);
+
+// Cost of a counted call without timing.
+static void BM_InstrumentationCount(benchmark::State& state)
+{
+  for (auto _ : state)
+  {
+    instrumentation::Record(instrumentation::ITERATOR_CREATE, 1024);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_InstrumentationCount);
+
+// Collecting the counters of all threads, e.g. for a periodic diagnostics message.
+static void BM_InstrumentationCollect(benchmark::State& state)
+{
+  instrumentation::Record(instrumentation::ITERATOR_CREATE, 1024);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(instrumentation::Collect());
+}
+BENCHMARK(BM_InstrumentationCollect);
+
+// An instrumented stage for reference; run with and without the instrumentation compiled in to see the difference.
+static void BM_InstrumentedConvertToPointCloud2(benchmark::State& state)
+{
+  const auto msg = CreateBenchmarkScan(state.range(0));
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+  MultiLayerLaserScanToPointCloud2 converter;
+  PointCloud2 cloud;
+  for (auto _ : state)
+  {
+    converter.Convert(msg, layout, cloud);
+    benchmark::DoNotOptimize(cloud.data.data());
+  }
+  state.SetItemsProcessed(state.iterations() * layout->Length());
+  state.SetLabel(std::string(BenchmarkScannerName(state.range(0))) +
+    (instrumentation::IsEnabled() ? ", instrumented" : ", not instrumented"));
+}
+BENCHMARK(BM_InstrumentedConvertToPointCloud2)->Apply(ScannerArguments)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,178 @@
+#include <benchmark/benchmark.h>
+
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+#include <multilayer_laser_scan/StaticScanLayout.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+
+#include "benchmark_scans.h"
+
+using namespace sensor_msgs;
+
+namespace
+{
+
+MultiLayerLaserScan CreateScan(benchmark::State& state)
+{
+  state.SetLabel(BenchmarkScannerName(state.range(0)));
+  return CreateBenchmarkScan(state.range(0));
+}
+
+void LayoutArguments(benchmark::internal::Benchmark* b)
+{
+  b->ArgNames({"scanner", "materialized"});
+  for (const int64_t scanner : {HDL_32E, OS1_64, OS1_128})
+    for (const int64_t materialized : {0, 1})
+      b->Args({scanner, materialized});
+}
+
+}
+
+static void BM_LayoutConstruct(benchmark::State& state)
+{
+  const auto msg = CreateScan(state);
+
+  for (auto _ : state)
+  {
+    MultiLayerLaserScanLayout layout(msg);
+    benchmark::DoNotOptimize(layout);
+  }
+}
+BENCHMARK(BM_LayoutConstruct)->Apply(ScannerArguments);
+
+static void BM_LayoutGetAll(benchmark::State& state)
+{
+  const auto msg = CreateScan(state);
+  MultiLayerLaserScanLayout layout(msg);
+  if (state.range(1))
+    layout.Materialize();
+
+  double scanAngle, subscanAngle;
+  ros::Duration time;
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < layout.Length(); ++i)
+    {
+      layout.GetAll(i, scanAngle, subscanAngle, time);
+      benchmark::DoNotOptimize(scanAngle);
+      benchmark::DoNotOptimize(subscanAngle);
+      benchmark::DoNotOptimize(time);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * layout.Length());
+}
+BENCHMARK(BM_LayoutGetAll)->Apply(LayoutArguments);
+
+static void BM_LayoutConstIterator(benchmark::State& state)
+{
+  const auto msg = CreateScan(state);
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+  if (state.range(1))
+    layout->Materialize();
+
+  for (auto _ : state)
+  {
+    for (MultiLayerLaserScanBaseFieldsConstIterator it(msg, layout); it != it.end(); ++it)
+    {
+      const auto fields = *it;
+      benchmark::DoNotOptimize(fields);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * layout->Length());
+}
+BENCHMARK(BM_LayoutConstIterator)->Apply(LayoutArguments);
+
+static void BM_LayoutMaterialize(benchmark::State& state)
+{
+  const auto msg = CreateScan(state);
+
+  for (auto _ : state)
+  {
+    MultiLayerLaserScanLayout layout(msg);
+    layout.Materialize();
+    benchmark::DoNotOptimize(layout);
+  }
+  state.SetItemsProcessed(state.iterations() * msg.ranges.size());
+}
+BENCHMARK(BM_LayoutMaterialize)->Apply(ScannerArguments);
+
+static void BM_LayoutStaticForEachPoint(benchmark::State& state)
+{
+  const auto msg = CreateScan(state);
+  const MultiLayerLaserScanLayout layout(msg);
+
+  for (auto _ : state)
+  {
+    ForEachPoint(layout, [](size_t i, double scanAngle, double subscanAngle, int64_t time)
+    {
+      benchmark::DoNotOptimize(scanAngle);
+      benchmark::DoNotOptimize(subscanAngle);
+      benchmark::DoNotOptimize(time);
+    });
+  }
+  state.SetItemsProcessed(state.iterations() * layout.Length());
+}
+BENCHMARK(BM_LayoutStaticForEachPoint)->Apply(ScannerArguments);
+
+static void BM_LayoutGetTime(benchmark::State& state)
+{
+  const auto msg = CreateScan(state);
+  const MultiLayerLaserScanLayout layout(msg);
+
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < layout.Length(); ++i)
+    {
+      const auto time = msg.header.stamp + layout.GetTime(i);
+      benchmark::DoNotOptimize(time);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * layout.Length());
+}
+BENCHMARK(BM_LayoutGetTime)->Apply(ScannerArguments);
+
+static void BM_LayoutGetTimeNSec(benchmark::State& state)
+{
+  const auto msg = CreateScan(state);
+  const MultiLayerLaserScanLayout layout(msg);
+
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < layout.Length(); ++i)
+    {
+      const auto time = layout.GetTimeNSec(i);
+      benchmark::DoNotOptimize(time);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * layout.Length());
+}
+BENCHMARK(BM_LayoutGetTimeNSec)->Apply(ScannerArguments);
+
+static void BM_LayoutGetTimesNSec(benchmark::State& state)
+{
+  const auto msg = CreateScan(state);
+  const MultiLayerLaserScanLayout layout(msg);
+
+  std::vector<int64_t> times(layout.Length());
+  for (auto _ : state)
+  {
+    layout.GetTimesNSec(times.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * layout.Length());
+}
+BENCHMARK(BM_LayoutGetTimesNSec)->Apply(ScannerArguments);
+
+static void BM_LayoutGetTimesSec(benchmark::State& state)
+{
+  const auto msg = CreateScan(state);
+  const MultiLayerLaserScanLayout layout(msg);
+
+  std::vector<float> times(layout.Length());
+  for (auto _ : state)
+  {
+    layout.GetTimesSec(times.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * layout.Length());
+}
+BENCHMARK(BM_LayoutGetTimesSec)->Apply(ScannerArguments);
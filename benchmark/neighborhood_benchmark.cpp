@@ -0,0 +1,182 @@
+#include <benchmark/benchmark.h>
+
+#include <multilayer_laser_scan/CartesianProjection.h>
+#include <multilayer_laser_scan/ScanNeighborhood.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+#include "benchmark_scans.h"
+
+using namespace sensor_msgs;
+
+namespace
+{
+
+MultiLayerLaserScan createNoisyOuster128Scan()
+{
+  auto msg = CreateOuster128Scan();
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<float> range(2.0f, 30.0f);
+  for (auto& value : msg.ranges)
+    value = range(generator);
+  return msg;
+}
+
+/**
+ * @brief Minimal 3D KD-tree (median split, leaves of up to 8 points) to compare
+ *        the grid neighborhood with what a point cloud library would do.
+ */
+class KdTree
+{
+  public: KdTree(const float* x, const float* y, const float* z, const size_t numPoints)
+    : coords{x, y, z}, indices(numPoints)
+  {
+    std::iota(this->indices.begin(), this->indices.end(), 0);
+    this->nodes.reserve(2 * numPoints / LEAF_SIZE + 1);
+    this->Build(0, numPoints, 0);
+  }
+
+  public: void Knn(const float* point, const size_t k, std::vector<std::pair<float, size_t>>& result) const
+  {
+    result.clear();
+    this->Search(0, point, k, result);
+  }
+
+  protected: static constexpr size_t LEAF_SIZE = 8;
+
+  protected: struct Node
+  {
+    size_t begin, end;
+    int axis;  // -1 for leaves
+    float split;
+    size_t left, right;
+  };
+
+  protected: size_t Build(const size_t begin, const size_t end, const int depth)
+  {
+    const auto id = this->nodes.size();
+    this->nodes.push_back({begin, end, -1, 0.0f, 0, 0});
+    if (end - begin <= LEAF_SIZE)
+      return id;
+
+    const auto axis = depth % 3;
+    const auto middle = begin + (end - begin) / 2;
+    const auto coord = this->coords[axis];
+    std::nth_element(this->indices.begin() + begin, this->indices.begin() + middle,
+        this->indices.begin() + end, [coord](size_t a, size_t b) { return coord[a] < coord[b]; });
+    const auto split = coord[this->indices[middle]];
+    const auto left = this->Build(begin, middle, depth + 1);
+    const auto right = this->Build(middle, end, depth + 1);
+    this->nodes[id].axis = axis;
+    this->nodes[id].split = split;
+    this->nodes[id].left = left;
+    this->nodes[id].right = right;
+    return id;
+  }
+
+  protected: void Search(const size_t id, const float* point, const size_t k,
+      std::vector<std::pair<float, size_t>>& heap) const
+  {
+    const auto& node = this->nodes[id];
+    if (node.axis < 0)
+    {
+      for (size_t n = node.begin; n < node.end; ++n)
+      {
+        const auto i = this->indices[n];
+        const auto dx = this->coords[0][i] - point[0];
+        const auto dy = this->coords[1][i] - point[1];
+        const auto dz = this->coords[2][i] - point[2];
+        const auto distance = dx * dx + dy * dy + dz * dz;
+        if (heap.size() < k)
+        {
+          heap.emplace_back(distance, i);
+          std::push_heap(heap.begin(), heap.end());
+        }
+        else if (distance < heap.front().first)
+        {
+          std::pop_heap(heap.begin(), heap.end());
+          heap.back() = {distance, i};
+          std::push_heap(heap.begin(), heap.end());
+        }
+      }
+      return;
+    }
+
+    const auto diff = point[node.axis] - node.split;
+    this->Search(diff < 0 ? node.left : node.right, point, k, heap);
+    if (heap.size() < k || diff * diff < heap.front().first)
+      this->Search(diff < 0 ? node.right : node.left, point, k, heap);
+  }
+
+  protected: const float* coords[3];
+  protected: std::vector<size_t> indices;
+  protected: std::vector<Node> nodes;
+};
+
+}
+
+static void BM_NeighborhoodGrid(benchmark::State& state)
+{
+  const auto msg = createNoisyOuster128Scan();
+  const MultiLayerLaserScanLayout layout(msg);
+  const ScanNeighborhood neighborhood(layout);
+  const auto radius = static_cast<size_t>(state.range(0));
+  std::vector<size_t> neighbors;
+  for (auto _ : state)
+  {
+    size_t count = 0;
+    for (size_t i = 0; i < layout.Length(); ++i)
+      count += neighborhood.GetNeighbors(i, radius, radius, neighbors);
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * layout.Length());
+}
+BENCHMARK(BM_NeighborhoodGrid)->Arg(1)->Arg(2)->ArgName("radius")->Unit(benchmark::kMillisecond);
+
+static void BM_NeighborhoodGridRangeGated(benchmark::State& state)
+{
+  const auto msg = createNoisyOuster128Scan();
+  const MultiLayerLaserScanLayout layout(msg);
+  const ScanNeighborhood neighborhood(layout);
+  const auto radius = static_cast<size_t>(state.range(0));
+  std::vector<size_t> neighbors;
+  for (auto _ : state)
+  {
+    size_t count = 0;
+    for (size_t i = 0; i < layout.Length(); ++i)
+      count += neighborhood.GetNeighbors(msg, i, radius, radius, 0.5f, neighbors);
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * layout.Length());
+}
+BENCHMARK(BM_NeighborhoodGridRangeGated)->Arg(1)->Arg(2)->ArgName("radius")->Unit(benchmark::kMillisecond);
+
+// k-NN with the same number of neighbors as the grid window, including tree build
+static void BM_NeighborhoodKdTree(benchmark::State& state)
+{
+  const auto msg = createNoisyOuster128Scan();
+  const MultiLayerLaserScanLayout layout(msg);
+  const CartesianProjection projection(layout);
+  std::vector<float> x(layout.Length()), y(layout.Length()), z(layout.Length());
+  projection.Project(msg, x.data(), y.data(), z.data());
+
+  const auto radius = static_cast<size_t>(state.range(0));
+  const auto k = (2 * radius + 1) * (2 * radius + 1);
+  std::vector<std::pair<float, size_t>> neighbors;
+  for (auto _ : state)
+  {
+    const KdTree tree(x.data(), y.data(), z.data(), layout.Length());
+    size_t count = 0;
+    for (size_t i = 0; i < layout.Length(); ++i)
+    {
+      const float point[3] = {x[i], y[i], z[i]};
+      tree.Knn(point, k, neighbors);
+      count += neighbors.size();
+    }
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * layout.Length());
+}
+BENCHMARK(BM_NeighborhoodKdTree)->Arg(1)->Arg(2)->ArgName("radius")->Unit(benchmark::kMillisecond);
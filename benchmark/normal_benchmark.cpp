@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+
+#include <multilayer_laser_scan/NormalEstimation.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "benchmark_scans.h"
+
+using namespace sensor_msgs;
+
+namespace
+{
+
+// A floor 1.5 m below the sensor with some noise, ranges out of the limits where the rays miss it.
+MultiLayerLaserScan createOuster128FloorScan()
+{
+  auto msg = CreateOuster128Scan();
+  const MultiLayerLaserScanLayout layout(msg);
+  std::vector<float> x(layout.Length()), y(layout.Length()), z(layout.Length());
+  std::fill(msg.ranges.begin(), msg.ranges.end(), 1.0f);
+  CartesianProjection(layout).Project(msg, x.data(), y.data(), z.data());
+
+  std::mt19937 generator(42);
+  std::normal_distribution<float> noise(0.0f, 0.01f);
+  for (size_t i = 0; i < layout.Length(); ++i)
+    msg.ranges[i] = z[i] < -0.01f ? -1.5f / z[i] + noise(generator) : msg.range_max + 1.0f;
+  return msg;
+}
+
+void NormalArguments(benchmark::internal::Benchmark* b)
+{
+  b->ArgNames({"radius", "threads"});
+  for (const int64_t radius : {1, 2})
+    for (const int64_t threads : {1, 8})
+      b->Args({radius, threads});
+  b->UseRealTime();
+  b->Unit(benchmark::kMillisecond);
+}
+
+void benchmarkNormals(benchmark::State& state, const NormalEstimation::Method method)
+{
+  const auto msg = createOuster128FloorScan();
+  const MultiLayerLaserScanLayout layout(msg);
+  NormalEstimation estimation(layout, method, static_cast<size_t>(state.range(0)), 0.5f);
+  ThreadPool pool(static_cast<size_t>(state.range(1)));
+
+  std::vector<float> nx(layout.Length()), ny(layout.Length()), nz(layout.Length());
+  for (auto _ : state)
+  {
+    estimation.Compute(msg, nx.data(), ny.data(), nz.data(), pool);
+    benchmark::DoNotOptimize(nx.data());
+  }
+  state.SetItemsProcessed(state.iterations() * layout.Length());
+}
+
+}
+
+// Normals of an OS1-128 scan from the cross product of the grid tangents.
+static void BM_NormalsCrossProduct(benchmark::State& state)
+{
+  benchmarkNormals(state, NormalEstimation::CROSS_PRODUCT);
+}
+BENCHMARK(BM_NormalsCrossProduct)->Apply(NormalArguments);
+
+// Normals of an OS1-128 scan from PCA of the grid window.
+static void BM_NormalsPCA(benchmark::State& state)
+{
+  benchmarkNormals(state, NormalEstimation::PCA);
+}
+BENCHMARK(BM_NormalsPCA)->Apply(NormalArguments);
@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include <multilayer_laser_scan/ParallelForEachPoint.h>
+#include <multilayer_laser_scan/StaticScanLayout.h>
+
+#include <cmath>
+
+#include "benchmark_scans.h"
+
+using namespace sensor_msgs;
+
+namespace
+{
+
+void ThreadArguments(benchmark::internal::Benchmark* b)
+{
+  b->ArgNames({"threads"});
+  for (const int64_t threads : {1, 2, 4, 8, 16})
+    b->Arg(threads);
+  b->UseRealTime();
+}
+
+}
+
+// Computes xyz of all points of an OS1-128 scan using the iterators.
+static void BM_ParallelForEachPoint(benchmark::State& state)
+{
+  const auto msg = CreateOuster128Scan();
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+  ThreadPool pool(static_cast<size_t>(state.range(0)));
+
+  std::vector<float> x(layout->Length()), y(layout->Length()), z(layout->Length());
+  for (auto _ : state)
+  {
+    ParallelForEachPoint(msg, layout,
+      [&](MultiLayerLaserScanBaseFieldsConstIterator it, const MultiLayerLaserScanBaseFieldsConstIterator& end)
+      {
+        for (; it != end; ++it)
+        {
+          const auto point = *it;
+          const auto i = static_cast<size_t>(point.range - msg.ranges.data());
+          const auto r = *point.range;
+          x[i] = r * std::cos(point.subscanAngle) * std::cos(point.scanAngle);
+          y[i] = r * std::cos(point.subscanAngle) * std::sin(point.scanAngle);
+          z[i] = r * std::sin(point.subscanAngle);
+        }
+      }, 0, pool);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * layout->Length());
+}
+BENCHMARK(BM_ParallelForEachPoint)->Apply(ThreadArguments);
+
+// The same using ParallelForScans() with the devirtualized ForEachPointInScans().
+static void BM_ParallelForScansStatic(benchmark::State& state)
+{
+  const auto msg = CreateOuster128Scan();
+  const MultiLayerLaserScanLayout layout(msg);
+  ThreadPool pool(static_cast<size_t>(state.range(0)));
+
+  std::vector<float> x(layout.Length()), y(layout.Length()), z(layout.Length());
+  for (auto _ : state)
+  {
+    ParallelForScans(layout, [&](const size_t firstScan, const size_t endScan)
+    {
+      ForEachPointInScans(layout, firstScan, endScan,
+        [&](const size_t i, const double scanAngle, const double subscanAngle, int64_t)
+        {
+          const auto r = msg.ranges[i];
+          x[i] = r * std::cos(subscanAngle) * std::cos(scanAngle);
+          y[i] = r * std::cos(subscanAngle) * std::sin(scanAngle);
+          z[i] = r * std::sin(subscanAngle);
+        });
+    }, 0, pool);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * layout.Length());
+}
+BENCHMARK(BM_ParallelForScansStatic)->Apply(ThreadArguments);
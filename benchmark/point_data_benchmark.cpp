@@ -0,0 +1,210 @@
+#include <benchmark/benchmark.h>
+
+#include <multilayer_laser_scan/FusedScanIterator.h>
+#include <multilayer_laser_scan/PointDataSchema.h>
+#include <multilayer_laser_scan/PointDataSoA.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+
+#include "benchmark_scans.h"
+
+using namespace sensor_msgs;
+
+#pragma pack(push, 1)
+struct BenchmarkOusterPoint
+{
+  float strongest;
+  uint16_t ring;
+  float reflectivity;
+};
+#pragma pack(pop)
+
+namespace sensor_msgs
+{
+template<> struct PointDataSchemaTraits<BenchmarkOusterPoint>
+{
+  static std::vector<PointField> Fields()
+  {
+    return {
+      MULTILAYER_LASER_SCAN_SCHEMA_FIELD(BenchmarkOusterPoint, strongest),
+      MULTILAYER_LASER_SCAN_SCHEMA_FIELD(BenchmarkOusterPoint, ring),
+      MULTILAYER_LASER_SCAN_SCHEMA_FIELD(BenchmarkOusterPoint, reflectivity),
+    };
+  }
+};
+}
+
+static PointData createOuster128PointData()
+{
+  const auto msg = CreateOuster128Scan();
+  PointData data;
+  PointDataModifier mod(data);
+  mod.setFieldsByString(3, "strongest", "ring", "reflectivity");
+  mod.resize(msg.ranges.size());
+  return data;
+}
+
+static void BM_ReadFieldsByIterators(benchmark::State& state)
+{
+  const auto data = createOuster128PointData();
+  const auto numPoints = data.data.size() / data.point_step;
+  for (auto _ : state)
+  {
+    PointDataConstIterator<float> strongest(data, "strongest");
+    PointDataConstIterator<uint16_t> ring(data, "ring");
+    PointDataConstIterator<float> reflectivity(data, "reflectivity");
+    float sum = 0;
+    for (size_t i = 0; i < numPoints; ++i, ++strongest, ++ring, ++reflectivity)
+      sum += *strongest + *ring + *reflectivity;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * numPoints);
+}
+BENCHMARK(BM_ReadFieldsByIterators);
+
+// Writes and reads back the ring of each point of the scanner's custom data by PointDataIterator.
+static void BM_PointDataIteratorAccess(benchmark::State& state)
+{
+  state.SetLabel(BenchmarkScannerName(state.range(0)));
+  auto msg = CreateBenchmarkScan(state.range(0));
+  PointDataModifier mod(msg.custom_data);
+  mod.setFieldsByString(2, "strongest", "ring");
+  mod.resize(msg.ranges.size());
+
+  const auto numPoints = msg.ranges.size();
+  for (auto _ : state)
+  {
+    PointDataIterator<uint16_t> ring(msg.custom_data, "ring");
+    for (size_t i = 0; i < numPoints; ++i, ++ring)
+      *ring = static_cast<uint16_t>(i);
+
+    PointDataConstIterator<uint16_t> ringIn(msg.custom_data, "ring");
+    PointDataConstIterator<float> strongest(msg.custom_data, "strongest");
+    float sum = 0;
+    for (size_t i = 0; i < numPoints; ++i, ++ringIn, ++strongest)
+      sum += *strongest + *ringIn;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * numPoints);
+}
+BENCHMARK(BM_PointDataIteratorAccess)->Apply(ScannerArguments);
+
+static void BM_ReadFieldsBySchemaView(benchmark::State& state)
+{
+  const auto data = createOuster128PointData();
+  const PointDataSchema<BenchmarkOusterPoint> schema;
+  for (auto _ : state)
+  {
+    float sum = 0;
+    for (const auto& point : schema.View(data))
+      sum += point.strongest + point.ring + point.reflectivity;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * data.data.size() / data.point_step);
+}
+BENCHMARK(BM_ReadFieldsBySchemaView);
+
+static void BM_CopyBySchema(benchmark::State& state)
+{
+  const auto data = createOuster128PointData();
+  const PointDataSchema<BenchmarkOusterPoint> schema;
+  std::vector<BenchmarkOusterPoint> points;
+  for (auto _ : state)
+  {
+    schema.CopyTo(data, points);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_CopyBySchema);
+
+static void BM_ExtractFieldByIterator(benchmark::State& state)
+{
+  const auto data = createOuster128PointData();
+  const auto numPoints = data.data.size() / data.point_step;
+  std::vector<float> reflectivity(numPoints);
+  for (auto _ : state)
+  {
+    PointDataConstIterator<float> it(data, "reflectivity");
+    for (size_t i = 0; i < numPoints; ++i, ++it)
+      reflectivity[i] = *it;
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * numPoints);
+}
+BENCHMARK(BM_ExtractFieldByIterator);
+
+static void BM_ExtractFieldsSoA(benchmark::State& state)
+{
+  const auto data = createOuster128PointData();
+  PointDataSoAView soa;
+  for (auto _ : state)
+  {
+    soa.Extract(data, {"strongest", "ring", "reflectivity"});
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * soa.NumPoints());
+}
+BENCHMARK(BM_ExtractFieldsSoA);
+
+static void BM_PackSoA(benchmark::State& state)
+{
+  const auto data = createOuster128PointData();
+  const PointDataSoAView soa(data, {"strongest", "ring", "reflectivity"});
+  PointData packed;
+  for (auto _ : state)
+  {
+    soa.Pack(packed);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * soa.NumPoints());
+}
+BENCHMARK(BM_PackSoA);
+
+static MultiLayerLaserScan createOuster128ScanWithCustomData()
+{
+  auto msg = CreateOuster128Scan();
+  msg.custom_data = createOuster128PointData();
+  return msg;
+}
+
+static void BM_LockstepIterators(benchmark::State& state)
+{
+  const auto msg = createOuster128ScanWithCustomData();
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+  layout->Materialize();
+  for (auto _ : state)
+  {
+    MultiLayerLaserScanBaseFieldsConstIterator it(msg, layout);
+    PointDataConstIterator<uint16_t> ring(msg.custom_data, "ring");
+    PointDataConstIterator<float> reflectivity(msg.custom_data, "reflectivity");
+    double sum = 0;
+    for (; it != it.end(); ++it, ++ring, ++reflectivity)
+    {
+      const auto point = *it;
+      sum += point.scanAngle + *point.range + *ring + *reflectivity;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * layout->Length());
+}
+BENCHMARK(BM_LockstepIterators);
+
+static void BM_FusedIterator(benchmark::State& state)
+{
+  const auto msg = createOuster128ScanWithCustomData();
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+  layout->Materialize();
+  for (auto _ : state)
+  {
+    MultiLayerLaserScanFusedConstIterator<uint16_t, float> it(msg, layout, {"ring", "reflectivity"});
+    double sum = 0;
+    for (; it != it.end(); ++it)
+    {
+      const auto point = *it;
+      sum += point.scanAngle + *point.range + point.Get<0>() + point.Get<1>();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * layout->Length());
+}
+BENCHMARK(BM_FusedIterator);
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+
+#include <multilayer_laser_scan/CartesianProjection.h>
+#include <multilayer_laser_scan/RangeImage.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+
+#include "benchmark_scans.h"
+
+using namespace sensor_msgs;
+
+static void BM_ProjectionIteratorSinCos(benchmark::State& state)
+{
+  const auto msg = CreateOuster64Scan();
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+  std::vector<float> x(msg.ranges.size()), y(msg.ranges.size()), z(msg.ranges.size());
+
+  for (auto _ : state)
+  {
+    size_t i = 0;
+    for (MultiLayerLaserScanBaseFieldsConstIterator it(msg, layout); it != it.end(); ++it, ++i)
+    {
+      const auto point = *it;
+      x[i] = *point.range * std::cos(point.subscanAngle) * std::cos(point.scanAngle);
+      y[i] = *point.range * std::cos(point.subscanAngle) * std::sin(point.scanAngle);
+      z[i] = *point.range * std::sin(point.subscanAngle);
+    }
+    benchmark::DoNotOptimize(x.data());
+  }
+  state.SetItemsProcessed(state.iterations() * msg.ranges.size());
+}
+BENCHMARK(BM_ProjectionIteratorSinCos);
+
+static void BM_CartesianProjection(benchmark::State& state)
+{
+  const auto msg = CreateOuster64Scan();
+  const MultiLayerLaserScanLayout layout(msg);
+  const CartesianProjection projection(layout);
+  std::vector<float> x(msg.ranges.size()), y(msg.ranges.size()), z(msg.ranges.size());
+  std::vector<float> t(msg.ranges.size());
+
+  for (auto _ : state)
+  {
+    projection.Project(msg, x.data(), y.data(), z.data(), state.range(0) ? t.data() : nullptr);
+    benchmark::DoNotOptimize(x.data());
+  }
+  state.SetItemsProcessed(state.iterations() * msg.ranges.size());
+}
+BENCHMARK(BM_CartesianProjection)->Arg(0)->Arg(1)->ArgName("time");
+
+static void BM_RangesToImage(benchmark::State& state)
+{
+  const auto msg = CreateOuster128Scan();
+  const MultiLayerLaserScanLayout layout(msg);
+  Image image;
+  for (auto _ : state)
+  {
+    RangesToImage(msg, layout, image, state.range(0) != 0);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * layout.Length());
+}
+BENCHMARK(BM_RangesToImage)->Arg(0)->Arg(1)->ArgName("transposed");
@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+
+#include <multilayer_laser_scan/ScanMerger.h>
+#include <multilayer_laser_scan/SubScanView.h>
+
+#include <memory>
+#include <vector>
+
+#include "benchmark_scans.h"
+
+using namespace sensor_msgs;
+
+namespace
+{
+
+// the benchmark scans split into chunks of a few subscans, as they come in packets
+constexpr size_t numParts = 100;
+
+std::vector<MultiLayerLaserScan> splitBenchmarkScan(const MultiLayerLaserScan& msg)
+{
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+  const auto scanLength = layout->GetScanLength();
+  std::vector<MultiLayerLaserScan> parts;
+  for (size_t k = 0; k < numParts; ++k)
+    parts.push_back(SubScanView(msg, layout, k * scanLength / numParts, (k + 1) * scanLength / numParts).ToScan());
+  return parts;
+}
+
+}
+
+// Appends the parts subscan by subscan, extending the layout by ParsedScanLayout::AddOffset().
+static void BM_MergeByAddOffset(benchmark::State& state)
+{
+  const auto parts = splitBenchmarkScan(CreateBenchmarkScan(state.range(0)));
+  const auto subscanLength = ParsedScanLayout(parts[0].subscan_layout).Length();
+  const auto pointStep = parts[0].custom_data.point_step;
+  MultiLayerLaserScan merged;
+  for (auto _ : state)
+  {
+    merged = parts[0];
+    ParsedScanLayout scanLayout(merged.scan_layout);
+    for (size_t k = 1; k < parts.size(); ++k)
+    {
+      const auto& part = parts[k];
+      const ParsedScanLayout partLayout(part.scan_layout);
+      const auto stampOffset = part.header.stamp - merged.header.stamp;
+      for (size_t j = 0; j < partLayout.Length(); ++j)
+      {
+        scanLayout.AddOffset(partLayout.GetAngle(j), partLayout.GetTime(j) + stampOffset);
+        const auto begin = j * subscanLength;
+        const auto end = begin + subscanLength;
+        merged.ranges.insert(merged.ranges.end(), part.ranges.begin() + begin, part.ranges.begin() + end);
+        merged.intensities.insert(merged.intensities.end(),
+          part.intensities.begin() + begin, part.intensities.begin() + end);
+        merged.custom_data.data.insert(merged.custom_data.data.end(),
+          part.custom_data.data.begin() + begin * pointStep, part.custom_data.data.begin() + end * pointStep);
+      }
+    }
+    scanLayout.FillMsg(merged.scan_layout);
+    benchmark::DoNotOptimize(merged.ranges.data());
+  }
+  state.SetItemsProcessed(state.iterations() * subscanLength * ParsedScanLayout(merged.scan_layout).Length());
+  state.SetLabel(BenchmarkScannerName(state.range(0)));
+}
+BENCHMARK(BM_MergeByAddOffset)->Apply(ScannerArguments)->Unit(benchmark::kMicrosecond);
+
+// The same using MergeScans(), which validates each part once and copies whole arrays.
+static void BM_MergeScans(benchmark::State& state)
+{
+  const auto parts = splitBenchmarkScan(CreateBenchmarkScan(state.range(0)));
+  std::vector<const MultiLayerLaserScan*> pointers;
+  for (const auto& part : parts)
+    pointers.push_back(&part);
+  MultiLayerLaserScan merged;
+  for (auto _ : state)
+  {
+    MergeScans(pointers, merged);
+    benchmark::DoNotOptimize(merged.ranges.data());
+  }
+  state.SetItemsProcessed(state.iterations() * merged.ranges.size());
+  state.SetLabel(BenchmarkScannerName(state.range(0)));
+}
+BENCHMARK(BM_MergeScans)->Apply(ScannerArguments)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+
+#include <multilayer_laser_scan/CartesianProjection.h>
+#include <multilayer_laser_scan/GroundSegmentation.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "benchmark_scans.h"
+
+using namespace sensor_msgs;
+
+namespace
+{
+
+// OS1-64 in 1024x10 mode looking at a floor 1.5 m below with noise and boxes in every 8th column.
+MultiLayerLaserScan createOuster64FloorScan()
+{
+  auto msg = CreateOuster64Scan();
+  msg.scan_layout.angular_offsets.samples = 1024;
+  msg.ranges.resize(1024 * 64);
+  msg.intensities.resize(1024 * 64);
+  const MultiLayerLaserScanLayout layout(msg);
+  std::vector<float> x(layout.Length()), y(layout.Length()), z(layout.Length());
+  std::fill(msg.ranges.begin(), msg.ranges.end(), 1.0f);
+  CartesianProjection(layout).Project(msg, x.data(), y.data(), z.data());
+
+  std::mt19937 generator(42);
+  std::normal_distribution<float> noise(0.0f, 0.01f);
+  for (size_t i = 0; i < layout.Length(); ++i)
+  {
+    if ((i / 64) % 8 == 0 && z[i] > -0.2f)
+      msg.ranges[i] = 8.0f + noise(generator);
+    else
+      msg.ranges[i] = z[i] < -0.01f ? -1.5f / z[i] + noise(generator) : msg.range_max + 1.0f;
+  }
+  return msg;
+}
+
+}
+
+// Labels ground of a 64x1024 scan on one core.
+static void BM_GroundSegmentation(benchmark::State& state)
+{
+  const auto msg = createOuster64FloorScan();
+  const MultiLayerLaserScanLayout layout(msg);
+  const GroundSegmentation segmentation(layout, 1.5f);
+  std::vector<uint8_t> labels(layout.Length());
+  for (auto _ : state)
+  {
+    segmentation.Segment(msg, labels.data());
+    benchmark::DoNotOptimize(labels.data());
+  }
+  state.SetItemsProcessed(state.iterations() * layout.Length());
+}
+BENCHMARK(BM_GroundSegmentation)->Unit(benchmark::kMicrosecond);
+
+// The same, writing the labels into the custom data of the scan.
+static void BM_GroundSegmentationCustomField(benchmark::State& state)
+{
+  auto msg = createOuster64FloorScan();
+  const MultiLayerLaserScanLayout layout(msg);
+  const GroundSegmentation segmentation(layout, 1.5f);
+  segmentation.Segment(msg);
+  for (auto _ : state)
+  {
+    segmentation.Segment(msg);
+    benchmark::DoNotOptimize(msg.custom_data.data.data());
+  }
+  state.SetItemsProcessed(state.iterations() * layout.Length());
+}
+BENCHMARK(BM_GroundSegmentationCustomField)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+
+#include <multilayer_laser_scan/SubScanView.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+
+#include <cmath>
+#include <memory>
+
+#include "benchmark_scans.h"
+
+using namespace sensor_msgs;
+
+namespace
+{
+
+// a 120 degree sector that doesn't wrap around the start of the benchmark scans
+constexpr double sectorMin = 2 * M_PI / 3;
+constexpr double sectorMax = 4 * M_PI / 3;
+
+}
+
+// Sums ranges of the points of a 120 degree sector by iterating the whole scan and skipping the other points.
+static void BM_SectorByFiltering(benchmark::State& state)
+{
+  const auto msg = CreateBenchmarkScan(state.range(0));
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+  for (auto _ : state)
+  {
+    float sum = 0;
+    MultiLayerLaserScanBaseFieldsConstIterator it(msg, layout);
+    for (; it != it.end(); ++it)
+    {
+      const auto point = *it;
+      if (point.scanAngle >= sectorMin && point.scanAngle <= sectorMax)
+        sum += *point.range;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * layout->Length());
+  state.SetLabel(BenchmarkScannerName(state.range(0)));
+}
+BENCHMARK(BM_SectorByFiltering)->Apply(ScannerArguments)->Unit(benchmark::kMicrosecond);
+
+// The same using SubScanView, which only visits the points of the sector.
+static void BM_SectorBySubScanView(benchmark::State& state)
+{
+  const auto msg = CreateBenchmarkScan(state.range(0));
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+  for (auto _ : state)
+  {
+    float sum = 0;
+    const auto view = SubScanView::Sector(msg, layout, sectorMin, sectorMax);
+    for (auto it = view.begin(); it != view.end(); ++it)
+      sum += *(*it).range;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * layout->Length());
+  state.SetLabel(BenchmarkScannerName(state.range(0)));
+}
+BENCHMARK(BM_SectorBySubScanView)->Apply(ScannerArguments)->Unit(benchmark::kMicrosecond);
+
+// Copying the sector into a trimmed scan.
+static void BM_SubScanViewToScan(benchmark::State& state)
+{
+  const auto msg = CreateBenchmarkScan(state.range(0));
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+  const auto view = SubScanView::Sector(msg, layout, sectorMin, sectorMax);
+  MultiLayerLaserScan trimmed;
+  for (auto _ : state)
+  {
+    view.ToScan(trimmed);
+    benchmark::DoNotOptimize(trimmed.ranges.data());
+  }
+  state.SetItemsProcessed(state.iterations() * view.Length());
+  state.SetLabel(BenchmarkScannerName(state.range(0)));
+}
+BENCHMARK(BM_SubScanViewToScan)->Apply(ScannerArguments)->Unit(benchmark::kMicrosecond);
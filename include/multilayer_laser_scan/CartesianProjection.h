@@ -0,0 +1,92 @@
+#ifndef MULTILAYER_LASER_SCAN_CARTESIANPROJECTION_H
+#define MULTILAYER_LASER_SCAN_CARTESIANPROJECTION_H
+
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+
+#include <vector>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Projects scans with a given layout to Cartesian coordinates.
+ *
+ * The point with scan angle a and subscan angle e is projected to
+ * x = r cos(e) cos(a), y = r cos(e) sin(a), z = r sin(e)
+ * in the frame of the scan.
+ *
+ * The scan angle of a point is the sum of the angle of its subscan and the
+ * scan offset during subscan, so the sines and cosines are only computed once
+ * per subscan and once per ray of a subscan. Projecting a point is then just
+ * a few multiply-adds which are vectorized with AVX or SSE if the compiler
+ * targets them. A default x86-64 build uses SSE2; AVX and FMA are enabled by
+ * the MULTILAYER_LASER_SCAN_AVX2 CMake option.
+ *
+ * The object only depends on the layout, so it can be reused for all scans
+ * with the same layout. Ranges are projected as they are, i.e. invalid
+ * ranges produce points at invalid distances (or NaNs).
+ */
+class CartesianProjection
+{
+  public: explicit CartesianProjection(const MultiLayerLaserScanLayout& layout);
+  public: virtual ~CartesianProjection() = default;
+
+  /**
+   * @brief Project all points of the scan into the given arrays.
+   * @param scan The scan. It has to have the layout this object was created for.
+   * @param x, y, z Output arrays with space for Length() floats.
+   * @param t If not null, output array with space for Length() floats which
+   *          receives time offsets of the points relative to the header stamp [s].
+   */
+  public: void Project(const MultiLayerLaserScan& scan, float* x, float* y, float* z,
+      float* t = nullptr) const;
+
+  /**
+   * @brief Project only points of subscans firstScan to lastScan (exclusive).
+   * @note The output arrays are indexed by point index in the whole scan, so
+   *       they still need space for Length() floats.
+   */
+  public: void ProjectScans(const MultiLayerLaserScan& scan, size_t firstScan, size_t lastScan,
+      float* x, float* y, float* z, float* t = nullptr) const;
+
+  /**
+   * @brief Project points of one subscan.
+   * @param x, y, z, t Output arrays with space for GetSubscanLength() floats
+   *                   (t can be null).
+   * @note The number of points of the scan is not checked.
+   */
+  public: void ProjectSubscan(const MultiLayerLaserScan& scan, size_t scanIndex,
+      float* x, float* y, float* z, float* t = nullptr) const;
+
+  /** @return Number of points in the layout. */
+  public: size_t Length() const;
+  public: size_t GetScanLength() const;
+  public: size_t GetSubscanLength() const;
+
+  protected: size_t scanLength;
+  protected: size_t subscanLength;
+
+  // per subscan
+  protected: std::vector<float> scanCos;
+  protected: std::vector<float> scanSin;
+  protected: std::vector<double> scanTimes;
+
+  // per ray of a subscan; cos(e) cos(offset), cos(e) sin(offset) and sin(e)
+  protected: std::vector<float> rayCosCos;
+  protected: std::vector<float> rayCosSin;
+  protected: std::vector<float> raySin;
+  protected: std::vector<float> rayTimes;
+};
+
+/**
+ * @brief Project the scan to Cartesian coordinates. See CartesianProjection.
+ * @note If you project more scans with the same layout, create
+ *       CartesianProjection just once and reuse it.
+ */
+void ProjectToCartesian(const MultiLayerLaserScan& scan, const MultiLayerLaserScanLayout& layout,
+    float* x, float* y, float* z, float* t = nullptr);
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_CARTESIANPROJECTION_H
@@ -0,0 +1,99 @@
+#ifndef MULTILAYER_LASER_SCAN_COMPRESSEDSCANITERATOR_H
+#define MULTILAYER_LASER_SCAN_COMPRESSEDSCANITERATOR_H
+
+#include <multilayer_laser_scan/CompressedMultiLayerLaserScan.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+#include <multilayer_laser_scan/RangeEncoding.h>
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Base fields of a point of a compressed scan with decoded range and
+ *        intensity.
+ */
+struct CompressedMultiLayerLaserScanBaseFields
+{
+  double subscanAngle = 0.0;
+  double scanAngle = 0.0;
+  float range = 0.0f;
+  /** NaN if the scan has no intensities. */
+  float intensity = 0.0f;
+  ros::Time timestamp;
+};
+
+/**
+ * \brief Random-access iterator over the base fields of the points of a
+ *        compressed scan.
+ *
+ * It behaves like MultiLayerLaserScanBaseFieldsConstIterator, but range and
+ * intensity are decoded on the fly, so they are returned by value.
+ */
+class CompressedMultiLayerLaserScanBaseFieldsConstIterator
+{
+  public: typedef std::random_access_iterator_tag iterator_category;
+  public: typedef std::random_access_iterator_tag iterator_concept;
+  public: typedef CompressedMultiLayerLaserScanBaseFields value_type;
+  public: typedef std::ptrdiff_t difference_type;
+  public: typedef CompressedMultiLayerLaserScanBaseFields reference;
+  public: typedef void pointer;
+
+  /**
+   * @brief Create a singular iterator which can only be assigned to.
+   */
+  public: CompressedMultiLayerLaserScanBaseFieldsConstIterator();
+
+  /**
+   * @brief Create an iterator pointing to the point with the given index.
+   * @param i Index of the point. Length() of the layout means the end.
+   * @throws std::runtime_error If the scan uses an unknown encoding or has
+   *         packed ranges.
+   */
+  public: CompressedMultiLayerLaserScanBaseFieldsConstIterator(
+      const CompressedMultiLayerLaserScan& scan,
+      std::shared_ptr<const MultiLayerLaserScanLayout> layout, size_t i = 0);
+
+  public: CompressedMultiLayerLaserScanBaseFields operator *() const;
+  public: CompressedMultiLayerLaserScanBaseFields operator [](difference_type n) const;
+
+  public: CompressedMultiLayerLaserScanBaseFieldsConstIterator& operator ++();
+  public: CompressedMultiLayerLaserScanBaseFieldsConstIterator operator ++(int);
+  public: CompressedMultiLayerLaserScanBaseFieldsConstIterator& operator --();
+  public: CompressedMultiLayerLaserScanBaseFieldsConstIterator operator --(int);
+  public: CompressedMultiLayerLaserScanBaseFieldsConstIterator& operator +=(difference_type n);
+  public: CompressedMultiLayerLaserScanBaseFieldsConstIterator& operator -=(difference_type n);
+  public: CompressedMultiLayerLaserScanBaseFieldsConstIterator operator +(difference_type n) const;
+  public: CompressedMultiLayerLaserScanBaseFieldsConstIterator operator -(difference_type n) const;
+  public: difference_type operator -(const CompressedMultiLayerLaserScanBaseFieldsConstIterator& iter) const;
+
+  public: bool operator !=(const CompressedMultiLayerLaserScanBaseFieldsConstIterator& iter) const;
+  public: bool operator ==(const CompressedMultiLayerLaserScanBaseFieldsConstIterator& iter) const;
+  public: bool operator <(const CompressedMultiLayerLaserScanBaseFieldsConstIterator& iter) const;
+  public: bool operator >(const CompressedMultiLayerLaserScanBaseFieldsConstIterator& iter) const;
+  public: bool operator <=(const CompressedMultiLayerLaserScanBaseFieldsConstIterator& iter) const;
+  public: bool operator >=(const CompressedMultiLayerLaserScanBaseFieldsConstIterator& iter) const;
+
+  public: CompressedMultiLayerLaserScanBaseFieldsConstIterator begin() const;
+  public: CompressedMultiLayerLaserScanBaseFieldsConstIterator end() const;
+
+  protected: const CompressedMultiLayerLaserScan* scan = nullptr;
+  protected: std::shared_ptr<const MultiLayerLaserScanLayout> layout;
+  protected: ChannelEncoding rangeEncoding;
+  protected: ChannelEncoding intensityEncoding;
+  protected: size_t i = 0;
+};
+
+inline CompressedMultiLayerLaserScanBaseFieldsConstIterator operator +(
+    const CompressedMultiLayerLaserScanBaseFieldsConstIterator::difference_type n,
+    const CompressedMultiLayerLaserScanBaseFieldsConstIterator& iter)
+{
+  return iter + n;
+}
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_COMPRESSEDSCANITERATOR_H
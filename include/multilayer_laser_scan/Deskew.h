@@ -0,0 +1,130 @@
+#ifndef MULTILAYER_LASER_SCAN_DESKEW_H
+#define MULTILAYER_LASER_SCAN_DESKEW_H
+
+#include <multilayer_laser_scan/CartesianProjection.h>
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+
+#include <Eigen/Geometry>
+#include <Eigen/StdDeque>
+#include <ros/time.h>
+
+#include <deque>
+#include <vector>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Source of poses of the scanner in a fixed frame at arbitrary times.
+ */
+class PoseSource
+{
+  public: virtual ~PoseSource() = default;
+
+  /**
+   * @return Pose of the scanner frame in the fixed frame at the given time.
+   * @throws std::out_of_range if the pose at the given time is not known.
+   */
+  public: virtual Eigen::Isometry3d GetPose(const ros::Time& time) const = 0;
+};
+
+/**
+ * @brief Poses interpolated from a buffer of timestamped poses (e.g. from
+ *        odometry). Translations are interpolated linearly and rotations by
+ *        slerp. No extrapolation is done.
+ */
+class BufferedPoseSource : public PoseSource
+{
+  /**
+   * @param _maxAge Poses older than the newest pose minus this duration are
+   *                removed from the buffer.
+   */
+  public: explicit BufferedPoseSource(const ros::Duration& _maxAge = ros::Duration(10.0));
+
+  /**
+   * @brief Add a pose to the buffer. Poses do not need to be added in time order.
+   */
+  public: void AddPose(const ros::Time& stamp, const Eigen::Isometry3d& pose);
+
+  public: Eigen::Isometry3d GetPose(const ros::Time& time) const override;
+
+  public: size_t Size() const;
+  public: void Clear();
+
+  protected: struct Entry
+  {
+    ros::Time stamp;
+    Eigen::Quaterniond rotation;
+    Eigen::Vector3d translation;
+  };
+
+  protected: const ros::Duration maxAge;
+  protected: std::deque<Entry, Eigen::aligned_allocator<Entry>> poses;
+};
+
+/**
+ * @brief Poses of a scanner moving with a constant twist. The pose at the
+ *        reference time is identity.
+ */
+class ConstantTwistPoseSource : public PoseSource
+{
+  /**
+   * @param _linear Linear velocity in the scanner frame [m/s].
+   * @param _angular Angular velocity in the scanner frame [rad/s].
+   * @param _referenceTime Time at which the pose is identity.
+   */
+  public: ConstantTwistPoseSource(const Eigen::Vector3d& _linear, const Eigen::Vector3d& _angular,
+      const ros::Time& _referenceTime = ros::Time(0));
+
+  public: Eigen::Isometry3d GetPose(const ros::Time& time) const override;
+
+  protected: const Eigen::Vector3d linear;
+  protected: const Eigen::Vector3d angular;
+  protected: const ros::Time referenceTime;
+};
+
+/**
+ * @brief Projects scans to Cartesian coordinates compensating the motion of
+ *        the scanner during the scan (deskewing).
+ *
+ * Each point is expressed in the scanner frame at the chosen reference time.
+ * The pose is interpolated once per subscan at its mean time, and all points
+ * of the subscan are transformed by it. The subscans are projected by
+ * CartesianProjection, so the object only depends on the layout and should be
+ * reused for all scans with the same layout.
+ */
+class Deskewer
+{
+  public: explicit Deskewer(const MultiLayerLaserScanLayout& layout);
+  public: virtual ~Deskewer() = default;
+
+  /**
+   * @brief Project all points of the scan and express them at referenceTime.
+   * @param scan The scan. It has to have the layout this object was created for.
+   * @param poses Poses of the scanner.
+   * @param referenceTime The time at which the points are expressed.
+   * @param x, y, z Output arrays with space for Length() floats.
+   * @throws std::out_of_range if the poses do not cover the scan.
+   */
+  public: void Deskew(const MultiLayerLaserScan& scan, const PoseSource& poses,
+      const ros::Time& referenceTime, float* x, float* y, float* z) const;
+
+  /**
+   * @brief Deskew with referenceTime equal to the header stamp of the scan.
+   */
+  public: void Deskew(const MultiLayerLaserScan& scan, const PoseSource& poses,
+      float* x, float* y, float* z) const;
+
+  /** @return Number of points in the layout. */
+  public: size_t Length() const;
+
+  protected: CartesianProjection projection;
+
+  // mean time of the points of each subscan relative to the header stamp [ns]
+  protected: std::vector<int64_t> subscanTimes;
+};
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_DESKEW_H
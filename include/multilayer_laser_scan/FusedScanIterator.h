@@ -0,0 +1,274 @@
+#ifndef MULTILAYER_LASER_SCAN_FUSEDSCANITERATOR_H
+#define MULTILAYER_LASER_SCAN_FUSEDSCANITERATOR_H
+
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+#include <multilayer_laser_scan/PointDataSchema.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Base fields of a point together with its custom fields of types T.
+ *
+ * Range, intensity and the custom values are pointers into the scan.
+ */
+template<typename R, typename... T>
+struct MultiLayerLaserScanFusedFields
+{
+  double subscanAngle = 0.0;
+  double scanAngle = 0.0;
+  R* range = nullptr;
+  /** nullptr if the scan has no intensities. */
+  R* intensity = nullptr;
+  ros::Time timestamp;
+  std::tuple<T*...> custom;
+
+  /**
+   * @return Reference to the N-th custom field. If the field has count > 1,
+   *         the other elements follow it in memory.
+   */
+  template<size_t N>
+  typename std::tuple_element<N, std::tuple<T...>>::type& Get() const
+  {
+    return *std::get<N>(this->custom);
+  }
+};
+
+/**
+ * \brief Random-access iterator over base fields and custom fields of a scan.
+ *
+ * Instead of iterating MultiLayerLaserScanBaseFieldsIterator together with a
+ * PointDataIterator per custom field, this iterator yields all of them at once.
+ * The custom fields are given by their types as template parameters and by
+ * their names in the constructor:
+ * <PRE>
+ *   MultiLayerLaserScanFusedConstIterator<float, uint16_t> it(
+ *       scan, layout, {"reflectivity", "ring"});
+ *   for (; it != it.end(); ++it)
+ *   {
+ *     const auto point = *it;
+ *     use(*point.range, point.Get<0>(), point.Get<1>());
+ *   }
+ * </PRE>
+ * The field names are looked up only once in the constructor. The iterator
+ * then holds a single point index, so advancing it is one increment and
+ * dereferencing computes all the pointers from it.
+ *
+ * @tparam C MultiLayerLaserScan, possibly const.
+ * @tparam T Types of the custom fields, const-qualified for const scans.
+ */
+template<typename C, typename... T>
+class MultiLayerLaserScanFusedIteratorBase
+{
+  protected: typedef typename std::conditional<std::is_const<C>::value, const float, float>::type R;
+  protected: typedef typename std::conditional<std::is_const<C>::value, const uint8_t, uint8_t>::type U;
+
+  public: typedef std::random_access_iterator_tag iterator_category;
+  public: typedef std::random_access_iterator_tag iterator_concept;
+  public: typedef MultiLayerLaserScanFusedFields<R, T...> value_type;
+  public: typedef std::ptrdiff_t difference_type;
+  public: typedef MultiLayerLaserScanFusedFields<R, T...> reference;
+  public: typedef void pointer;
+
+  public: static constexpr size_t NUM_CUSTOM_FIELDS = sizeof...(T);
+
+  /**
+   * @brief Create a singular iterator which can only be assigned to.
+   */
+  public: MultiLayerLaserScanFusedIteratorBase() = default;
+
+  /**
+   * @brief Create an iterator pointing to the point with the given index.
+   * @param fieldNames Names of the custom fields in the order of T.
+   * @param i Index of the point. Length() of the layout means the end.
+   * @throws std::runtime_error If a field does not exist, its datatype is not
+   *         the one of the corresponding T, or custom_data do not have one item
+   *         per point.
+   */
+  public: MultiLayerLaserScanFusedIteratorBase(C& scan, std::shared_ptr<const MultiLayerLaserScanLayout> layout,
+      const std::array<std::string, sizeof...(T)>& fieldNames, size_t i = 0)
+    : scan(&scan), layout(std::move(layout)), i(i)
+  {
+    const auto& customData = scan.custom_data;
+    this->pointStep = customData.point_step;
+    if (sizeof...(T) > 0 && customData.data.size() != this->layout->Length() * this->pointStep)
+      throw std::runtime_error("Custom data have " + std::to_string(customData.data.size()) +
+          " bytes, but " + std::to_string(this->layout->Length() * this->pointStep) + " are required");
+
+    const std::array<uint8_t, sizeof...(T) + 1> datatypes = {{
+        static_cast<uint8_t>(PointFieldDatatype<typename std::remove_const<T>::type>::value)..., 0}};
+    for (size_t f = 0; f < sizeof...(T); ++f)
+    {
+      auto field = customData.fields.begin();
+      while (field != customData.fields.end() && field->name != fieldNames[f])
+        ++field;
+      if (field == customData.fields.end())
+        throw std::runtime_error("Field " + fieldNames[f] + " does not exist");
+      if (field->datatype != datatypes[f])
+        throw std::runtime_error("Field " + fieldNames[f] + " has datatype " +
+            std::to_string(field->datatype) + " which does not match the iterator type");
+      this->offsets[f] = field->offset;
+    }
+  }
+
+  public: MultiLayerLaserScanFusedFields<R, T...> operator *() const
+  {
+    MultiLayerLaserScanFusedFields<R, T...> result;
+    ros::Duration timeOffset;
+    this->layout->GetAll(this->i, result.scanAngle, result.subscanAngle, timeOffset);
+    result.timestamp = this->scan->header.stamp + timeOffset;
+    result.range = &this->scan->ranges[this->i];
+    result.intensity = this->scan->intensities.empty() ? nullptr : &this->scan->intensities[this->i];
+    result.custom = this->GetCustom(std::index_sequence_for<T...>());
+    return result;
+  }
+
+  public: MultiLayerLaserScanFusedFields<R, T...> operator [](const difference_type n) const
+  {
+    return *(*this + n);
+  }
+
+  /**
+   * @return Pointer to the N-th custom field of the current point. Cheaper than
+   *         dereferencing the iterator when the base fields are not needed.
+   */
+  public: template<size_t N>
+  typename std::tuple_element<N, std::tuple<T...>>::type* GetCustom() const
+  {
+    typedef typename std::tuple_element<N, std::tuple<T...>>::type Field;
+    return reinterpret_cast<Field*>(this->CustomData() + this->offsets[N]);
+  }
+
+  public: MultiLayerLaserScanFusedIteratorBase& operator ++()
+  {
+    ++this->i;
+    return *this;
+  }
+
+  public: MultiLayerLaserScanFusedIteratorBase operator ++(int)
+  {
+    auto result = *this;
+    ++this->i;
+    return result;
+  }
+
+  public: MultiLayerLaserScanFusedIteratorBase& operator --()
+  {
+    --this->i;
+    return *this;
+  }
+
+  public: MultiLayerLaserScanFusedIteratorBase operator --(int)
+  {
+    auto result = *this;
+    --this->i;
+    return result;
+  }
+
+  public: MultiLayerLaserScanFusedIteratorBase& operator +=(const difference_type n)
+  {
+    this->i += n;
+    return *this;
+  }
+
+  public: MultiLayerLaserScanFusedIteratorBase& operator -=(const difference_type n)
+  {
+    this->i -= n;
+    return *this;
+  }
+
+  public: MultiLayerLaserScanFusedIteratorBase operator +(const difference_type n) const
+  {
+    auto result = *this;
+    result.i += n;
+    return result;
+  }
+
+  public: MultiLayerLaserScanFusedIteratorBase operator -(const difference_type n) const
+  {
+    auto result = *this;
+    result.i -= n;
+    return result;
+  }
+
+  public: difference_type operator -(const MultiLayerLaserScanFusedIteratorBase& iter) const
+  {
+    return static_cast<difference_type>(this->i) - static_cast<difference_type>(iter.i);
+  }
+
+  public: bool operator !=(const MultiLayerLaserScanFusedIteratorBase& iter) const { return this->i != iter.i; }
+  public: bool operator ==(const MultiLayerLaserScanFusedIteratorBase& iter) const { return this->i == iter.i; }
+  public: bool operator <(const MultiLayerLaserScanFusedIteratorBase& iter) const { return this->i < iter.i; }
+  public: bool operator >(const MultiLayerLaserScanFusedIteratorBase& iter) const { return this->i > iter.i; }
+  public: bool operator <=(const MultiLayerLaserScanFusedIteratorBase& iter) const { return this->i <= iter.i; }
+  public: bool operator >=(const MultiLayerLaserScanFusedIteratorBase& iter) const { return this->i >= iter.i; }
+
+  public: MultiLayerLaserScanFusedIteratorBase begin() const
+  {
+    auto result = *this;
+    result.i = 0;
+    return result;
+  }
+
+  public: MultiLayerLaserScanFusedIteratorBase end() const
+  {
+    auto result = *this;
+    result.i = this->layout->Length();
+    return result;
+  }
+
+  /** @return Index of the point the iterator points to. */
+  public: size_t Index() const
+  {
+    return this->i;
+  }
+
+  protected: U* CustomData() const
+  {
+    return this->scan->custom_data.data.data() + this->i * this->pointStep;
+  }
+
+  protected: template<size_t... N>
+  std::tuple<T*...> GetCustom(std::index_sequence<N...>) const
+  {
+    return std::tuple<T*...>(this->template GetCustom<N>()...);
+  }
+
+  protected: C* scan = nullptr;
+  protected: std::shared_ptr<const MultiLayerLaserScanLayout> layout;
+  protected: std::array<size_t, sizeof...(T)> offsets {};
+  protected: size_t pointStep = 0;
+  protected: size_t i = 0;
+};
+
+template<typename C, typename... T>
+MultiLayerLaserScanFusedIteratorBase<C, T...> operator +(
+    typename MultiLayerLaserScanFusedIteratorBase<C, T...>::difference_type n,
+    const MultiLayerLaserScanFusedIteratorBase<C, T...>& iter)
+{
+  return iter + n;
+}
+
+template<typename... T>
+using MultiLayerLaserScanFusedIterator = MultiLayerLaserScanFusedIteratorBase<MultiLayerLaserScan, T...>;
+
+template<typename... T>
+using MultiLayerLaserScanFusedConstIterator =
+    MultiLayerLaserScanFusedIteratorBase<const MultiLayerLaserScan, const T...>;
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_FUSEDSCANITERATOR_H
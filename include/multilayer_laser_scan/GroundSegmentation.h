@@ -0,0 +1,93 @@
+#ifndef MULTILAYER_LASER_SCAN_GROUNDSEGMENTATION_H
+#define MULTILAYER_LASER_SCAN_GROUNDSEGMENTATION_H
+
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Labels points of scans as ground or non-ground.
+ *
+ * Each subscan (column) is processed separately, ray by ray from the lowest
+ * elevation to the highest. A ray hitting the scan at range r with elevation e
+ * has horizontal distance d = r cos(e) and height h = r sin(e) relative to the
+ * sensor, independently of its azimuth. A point is ground if it is farther
+ * than the last ground point of the column and the slope between them is at
+ * most maxSlope (plus heightTolerance for noise). The first reference is the
+ * ground right under the sensor, i.e. (0, -sensorHeight).
+ *
+ * The elevation sines and cosines and the order of rays are computed from the
+ * layout once, so labeling is a single pass over the ranges without any
+ * trigonometry or 3D search. The z axis of the scan frame is assumed to point
+ * up.
+ *
+ * Points with ranges outside of <range_min, range_max> (or non-finite) are
+ * labeled INVALID and do not break the ground of the column.
+ */
+class GroundSegmentation
+{
+  public: enum Label : uint8_t
+  {
+    INVALID = 0,
+    GROUND = 1,
+    NON_GROUND = 2,
+  };
+
+  /**
+   * @param layout Layout of the scans.
+   * @param sensorHeight Height of the origin of the scan frame above the ground [m].
+   * @param maxSlope The steepest slope still considered ground [rad].
+   * @param heightTolerance Height difference allowed on top of the slope [m].
+   */
+  public: GroundSegmentation(const MultiLayerLaserScanLayout& layout, float sensorHeight,
+      float maxSlope = 0.15f, float heightTolerance = 0.1f);
+
+  public: virtual ~GroundSegmentation() = default;
+
+  /**
+   * @brief Label all points of the scan.
+   * @param labels Output array with space for the number of points of the layout.
+   * @throws std::runtime_error If the scan doesn't match the layout.
+   */
+  public: void Segment(const MultiLayerLaserScan& scan, uint8_t* labels) const;
+
+  /**
+   * @brief Label all points of the scan and store the labels in the "label"
+   *        custom field. The field is appended to custom_data if it is not
+   *        there yet.
+   * @throws std::runtime_error If the scan doesn't match the layout or the
+   *         existing label field is not a single UINT8.
+   */
+  public: void Segment(MultiLayerLaserScan& scan) const;
+
+  /**
+   * @brief Label points of subscans firstScan to endScan (exclusive).
+   * @param labels Output for point 0; label of point i is stored at
+   *               labels[i * stride].
+   * @note The number of ranges is not checked.
+   * @throws std::out_of_range If the subscans are not in the layout.
+   */
+  public: void SegmentScans(const MultiLayerLaserScan& scan, size_t firstScan, size_t endScan,
+      uint8_t* labels, size_t stride = 1) const;
+
+  protected: size_t scanLength;
+  protected: size_t subscanLength;
+  protected: float sensorHeight;
+  protected: float tanMaxSlope;
+  protected: float heightTolerance;
+
+  // per ray, sorted by increasing elevation
+  protected: std::vector<uint32_t> rayOrder;
+  protected: std::vector<float> rayCos;
+  protected: std::vector<float> raySin;
+};
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_GROUNDSEGMENTATION_H
@@ -0,0 +1,183 @@
+#ifndef MULTILAYER_LASER_SCAN_INSTRUMENTATION_H
+#define MULTILAYER_LASER_SCAN_INSTRUMENTATION_H
+
+#include <diagnostic_msgs/DiagnosticArray.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Per-stage call counts, latency histograms and bytes touched of the
+ *        hot paths of this library.
+ *
+ * The library sources are instrumented with the MLS_INSTRUMENT_* macros below,
+ * which only expand to code if the library is compiled with
+ * MULTILAYER_LASER_SCAN_INSTRUMENTATION defined (CMake option of the same
+ * name). Otherwise they expand to nothing, the arguments are not even
+ * evaluated, and IsEnabled() returns false.
+ *
+ * The instrumented stages are whole per-scan operations (parsing a layout,
+ * converting a scan, ...), never single points, so that timing them costs a
+ * negligible fraction of the stage itself. Each thread records into its own
+ * counters without any locking or atomic read-modify-write; Collect() sums the
+ * counters of all threads, including the ones that already finished.
+ *
+ * <PRE>
+ *   const auto statistics = sensor_msgs::instrumentation::Collect();
+ *   sensor_msgs::instrumentation::WriteToFile("mls_stats.json", statistics);
+ * </PRE>
+ */
+namespace instrumentation
+{
+
+enum Stage : uint8_t
+{
+  LAYOUT_PARSE = 0,  //!< Parsing a ScanLayout message (twice per MultiLayerLaserScanLayout).
+  LAYOUT_MATERIALIZE,  //!< MultiLayerLaserScanLayout::Materialize().
+  LAYOUT_CACHE_GET,  //!< LayoutCache::Get(), including parsing on a miss.
+  ITERATOR_CREATE,  //!< Constructing iterators over a whole scan (only counted, not timed).
+  POINT_DATA_MODIFY,  //!< PointDataModifier::resize() (also called by setFields()) and appendFieldsByString().
+  CARTESIAN_PROJECTION,  //!< CartesianProjection::Project() and ProjectScans() (once per block).
+  SCAN_TO_POINT_CLOUD2,  //!< MultiLayerLaserScanToPointCloud2::Convert().
+  POINT_CLOUD2_TO_SCAN,  //!< PointCloud2ToMultiLayerLaserScan::Convert().
+  SCAN_MERGE,  //!< MergeScans().
+  NUM_STAGES
+};
+
+/**
+ * @brief Number of buckets of the latency histograms. Bucket b counts calls
+ *        that took [2^b, 2^(b+1)) ns (bucket 0 also gets 0 ns), the last one
+ *        counts all calls longer than about 1 s.
+ */
+constexpr size_t NUM_LATENCY_BUCKETS = 31;
+
+struct StageStatistics
+{
+  Stage stage;
+
+  /** Number of calls. */
+  uint64_t calls = 0;
+
+  /** Number of calls that were timed and are in latencyHistogram. */
+  uint64_t timedCalls = 0;
+
+  /** Bytes read or written by all calls. */
+  uint64_t bytes = 0;
+
+  /** Total time of the timed calls [ns]. */
+  uint64_t totalNSec = 0;
+
+  std::array<uint64_t, NUM_LATENCY_BUCKETS> latencyHistogram {};
+
+  /** @return Mean latency of the timed calls [ns], 0 if there were none. */
+  double MeanNSec() const;
+
+  /**
+   * @brief Latency percentile estimated from the histogram.
+   * @param percentile Percentile in <0, 100>.
+   * @return The upper bound of the bucket containing the percentile [ns], 0 if
+   *         there were no timed calls.
+   */
+  uint64_t PercentileNSec(double percentile) const;
+};
+
+/** @return Name of the stage, e.g. "layout_parse". */
+const char* GetStageName(Stage stage);
+
+/** @return Whether the library was compiled with the instrumentation. */
+bool IsEnabled();
+
+/** @return The histogram bucket of the given latency. */
+size_t GetLatencyBucket(uint64_t nsec);
+
+/**
+ * @brief Record a call of the stage in the counters of the calling thread.
+ * @param nsec Latency of the call. Calls without it are only counted.
+ */
+void Record(Stage stage, uint64_t bytes);
+void Record(Stage stage, uint64_t bytes, uint64_t nsec);
+
+/**
+ * @brief Sum the counters of all threads recorded since the last Reset().
+ * @return Statistics of all stages, indexed by Stage.
+ */
+std::vector<StageStatistics> Collect();
+
+/**
+ * @brief Make the following Collect() calls count only calls recorded after
+ *        this one.
+ */
+void Reset();
+
+/**
+ * @brief Write the statistics as a human-readable table.
+ */
+void WriteText(std::ostream& stream, const std::vector<StageStatistics>& statistics);
+
+/**
+ * @brief Write the statistics as a JSON object with one member per stage.
+ */
+void WriteJson(std::ostream& stream, const std::vector<StageStatistics>& statistics);
+
+/**
+ * @brief Write the statistics to a file, as JSON if the file name ends with
+ *        ".json", as text otherwise.
+ * @throws std::runtime_error If the file cannot be written.
+ */
+void WriteToFile(const std::string& filename, const std::vector<StageStatistics>& statistics);
+
+/**
+ * @brief Convert the statistics to one diagnostic status per stage, e.g. to be
+ *        published on /diagnostics. Stages without calls are skipped.
+ * @param hardwareId Hardware ID of the statuses (e.g. node name).
+ */
+void FillDiagnostics(const std::vector<StageStatistics>& statistics, const std::string& hardwareId,
+    diagnostic_msgs::DiagnosticArray& msg);
+
+/**
+ * @brief Records a call of the stage that takes until the end of the scope.
+ */
+class ScopedTimer
+{
+  public: explicit ScopedTimer(Stage stage, uint64_t bytes = 0);
+  public: ScopedTimer(const ScopedTimer&) = delete;
+  public: ScopedTimer& operator=(const ScopedTimer&) = delete;
+  public: ~ScopedTimer();
+
+  /** @brief Add bytes that are only known later in the scope. */
+  public: void AddBytes(uint64_t bytes);
+
+  protected: Stage stage;
+  protected: uint64_t bytes;
+  protected: std::chrono::steady_clock::time_point start;
+};
+
+}
+
+}
+
+#ifdef MULTILAYER_LASER_SCAN_INSTRUMENTATION
+/** @brief Time the rest of the scope as a call of the stage. */
+#define MLS_INSTRUMENT_SCOPE(stage, bytes) \
+  ::sensor_msgs::instrumentation::ScopedTimer mlsInstrumentationTimer( \
+    ::sensor_msgs::instrumentation::stage, (bytes))
+/** @brief Add bytes to the call timed by MLS_INSTRUMENT_SCOPE in this scope. */
+#define MLS_INSTRUMENT_ADD_BYTES(bytes) mlsInstrumentationTimer.AddBytes(bytes)
+/** @brief Count a call of the stage without timing it. */
+#define MLS_INSTRUMENT_COUNT(stage, bytes) \
+  ::sensor_msgs::instrumentation::Record(::sensor_msgs::instrumentation::stage, (bytes))
+#else
+#define MLS_INSTRUMENT_SCOPE(stage, bytes) do {} while (false)
+#define MLS_INSTRUMENT_ADD_BYTES(bytes) do {} while (false)
+#define MLS_INSTRUMENT_COUNT(stage, bytes) do {} while (false)
+#endif
+
+#endif //MULTILAYER_LASER_SCAN_INSTRUMENTATION_H
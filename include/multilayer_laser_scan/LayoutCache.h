@@ -0,0 +1,93 @@
+#ifndef MULTILAYER_LASER_SCAN_LAYOUTCACHE_H
+#define MULTILAYER_LASER_SCAN_LAYOUTCACHE_H
+
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Thread-safe cache of parsed scan layouts.
+ *
+ * Drivers usually publish the same layout for every scan, so parsing it again
+ * for each message is wasted work. The cache is keyed by a hash of
+ * subscan_layout, scan_layout, scan_offsets_during_subscan and the number of
+ * points. Hash collisions are resolved by comparing the layout messages.
+ *
+ * <PRE>
+ *   const auto layout = sensor_msgs::LayoutCache::Instance().Get(msg);
+ *   sensor_msgs::MultiLayerLaserScanBaseFieldsConstIterator it(msg, layout);
+ * </PRE>
+ */
+class LayoutCache
+{
+  /**
+   * @param _capacity Maximum number of cached layouts. The least recently
+   *                  used layout is evicted when the cache is full.
+   * @param _materialize If true, the cached layouts are materialized (see
+   *                     MultiLayerLaserScanLayout::Materialize()).
+   */
+  public: explicit LayoutCache(size_t _capacity = 16, bool _materialize = false);
+  public: virtual ~LayoutCache() = default;
+
+  /**
+   * @return The process-wide cache instance.
+   */
+  public: static LayoutCache& Instance();
+
+  /**
+   * @brief Return the layout of the given scan, parsing it only if it is not
+   *        cached yet.
+   * @throws std::runtime_error if the layout of the scan is invalid.
+   */
+  public: std::shared_ptr<const MultiLayerLaserScanLayout> Get(const MultiLayerLaserScan& msg);
+
+  public: size_t Hits() const;
+  public: size_t Misses() const;
+  public: size_t Size() const;
+  public: size_t Capacity() const;
+
+  /**
+   * @brief Remove all cached layouts and reset the hit/miss counters.
+   */
+  public: void Clear();
+
+  protected: struct Entry
+  {
+    size_t hash;
+    ScanLayout subscanLayout;
+    ScanLayout scanLayout;
+    AngularOffsets scanOffsetsDuringSubscan;
+    size_t numPoints;
+    std::shared_ptr<const MultiLayerLaserScanLayout> layout;
+  };
+
+  protected: static size_t ComputeHash(const MultiLayerLaserScan& msg);
+  protected: static bool Matches(const Entry& entry, size_t hash, const MultiLayerLaserScan& msg);
+
+  /**
+   * @brief Find the entry and move it to the front of the LRU list.
+   * @note Has to be called with the mutex locked.
+   */
+  protected: std::shared_ptr<const MultiLayerLaserScanLayout> Find(
+      size_t hash, const MultiLayerLaserScan& msg);
+
+  protected: const size_t capacity;
+  protected: const bool materialize;
+
+  protected: mutable std::mutex mutex;
+  protected: std::list<Entry> entries;  // most recently used first
+
+  protected: std::atomic<size_t> hits {0};
+  protected: std::atomic<size_t> misses {0};
+};
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_LAYOUTCACHE_H
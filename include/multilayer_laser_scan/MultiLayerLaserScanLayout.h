@@ -3,6 +3,7 @@
 
 #include <multilayer_laser_scan/ScanLayout.h>
 #include <multilayer_laser_scan/MultiLayerLaserScan.h>
+#include <multilayer_laser_scan/CompressedMultiLayerLaserScan.h>
 
 namespace sensor_msgs
 {
@@ -22,6 +23,8 @@ class RegularAngularOffsets : public ParsedAngularOffsets
   public: size_t Length() const override;
   public: void AddOffset(double offset) override;
   public: void FillMsg(AngularOffsets& msg) const override;
+  public: double GetFirstAngle() const;
+  public: double GetIncrement() const;
 
   private: inline double FirstAngle() const;
   private: inline double LastAngle() const;
@@ -43,6 +46,9 @@ class ExplicitAngularOffsets : public ParsedAngularOffsets
   public: size_t Length() const override;
   public: void AddOffset(double offset) override;
   public: void FillMsg(AngularOffsets& msg) const override;
+  public: const std::vector<double>& GetOffsets() const;
+  /** @brief Replace all offsets by the given one, keeping the capacity. */
+  public: void Reset(double offset);
 
   protected: std::vector<double> offsets;
 };
@@ -51,6 +57,8 @@ class ExplicitAngularOffsets : public ParsedAngularOffsets
 struct ParsedTimeOffsets
 {
   virtual ros::Duration Get(size_t i) const = 0;
+  /** @return The same as Get(i).toNSec(), but computed in integer arithmetic. */
+  virtual int64_t GetNSec(size_t i) const = 0;
   virtual void AddOffset(const ros::Duration& offset) = 0;
   virtual bool HasLength(size_t length) const = 0;
   virtual void FillMsg(TimeOffsets& msg) const = 0;
@@ -60,24 +68,35 @@ class RegularTimeOffsets : public ParsedTimeOffsets
 {
   public: explicit RegularTimeOffsets(const TimeOffsets& _msg);
   public: ros::Duration Get(size_t i) const override;
+  public: int64_t GetNSec(size_t i) const override;
   public: void AddOffset(const ros::Duration& offset) override;
   public: bool HasLength(size_t length) const override;
   public: void FillMsg(TimeOffsets& msg) const override;
+  public: const ros::Duration& GetBaseOffset() const;
+  public: const ros::Duration& GetIncrement() const;
 
   protected: ros::Duration baseOffset;
   protected: ros::Duration timeIncrement;
+  protected: int64_t baseOffsetNSec;
+  protected: int64_t timeIncrementNSec;
 };
 
 class ExplicitTimeOffsets : public ParsedTimeOffsets
 {
   public: explicit ExplicitTimeOffsets(const TimeOffsets &_msg);
   public: ros::Duration Get(size_t i) const override;
+  public: int64_t GetNSec(size_t i) const override;
   public: size_t Length() const;
   public: void AddOffset(const ros::Duration& offset) override;
   public: bool HasLength(size_t length) const override;
   public: void FillMsg(TimeOffsets& msg) const override;
+  public: const std::vector<ros::Duration>& GetOffsets() const;
+  public: const std::vector<int64_t>& GetOffsetsNSec() const;
+  /** @brief Replace all offsets by the given one, keeping the capacity. */
+  public: void Reset(const ros::Duration& offset);
 
   protected: std::vector<ros::Duration> offsets;
+  protected: std::vector<int64_t> offsetsNSec;
 };
 
 class ParsedScanLayout
@@ -85,9 +104,19 @@ class ParsedScanLayout
   public: explicit ParsedScanLayout(const ScanLayout& _msg);
   public: virtual double GetAngle(size_t i) const;
   public: virtual ros::Duration GetTime(size_t i) const;
+  public: virtual int64_t GetTimeNSec(size_t i) const;
   public: virtual size_t Length() const;
   public: virtual void AddOffset(double angularOffset, const ros::Duration& timeOffset);
   public: virtual void FillMsg(ScanLayout& msg) const;
+  /**
+   * @brief Replace the layout by explicit offsets of a single subscan. If the
+   *        offsets already are explicit, their capacity is kept, so a layout
+   *        extended by AddOffset() again up to its previous length does not
+   *        allocate.
+   */
+  public: virtual void Reset(double angularOffset, const ros::Duration& timeOffset);
+  public: const ParsedAngularOffsets& GetAngularOffsets() const;
+  public: const ParsedTimeOffsets& GetTimeOffsets() const;
 
   protected: std::unique_ptr<ParsedAngularOffsets> angularOffsets;
   protected: std::unique_ptr<ParsedTimeOffsets> timeOffsets;
@@ -96,13 +125,68 @@ class ParsedScanLayout
 class MultiLayerLaserScanLayout
 {
   public: explicit MultiLayerLaserScanLayout(const MultiLayerLaserScan& _msg);
+  public: explicit MultiLayerLaserScanLayout(const CompressedMultiLayerLaserScan& _msg);
+
+  /**
+   * @brief Layout of scans that do not exist yet (e.g. are being assembled).
+   * @param numPoints The expected number of points.
+   * @throws std::runtime_error If the layout is invalid or doesn't have numPoints points.
+   */
+  public: MultiLayerLaserScanLayout(const ScanLayout& _subscanLayout,
+      const ScanLayout& _scanLayout, const AngularOffsets& _scanOffsetsDuringSubscan,
+      size_t numPoints);
+
   public: virtual double GetScanAngle(size_t i) const;
   public: virtual double GetSubscanAngle(size_t i) const;
   public: virtual ros::Duration GetTime(size_t i) const;
+
+  /**
+   * @return Time offset of the i-th point relative to header.stamp [ns]. The
+   *         same as GetTime(i).toNSec(), but computed in integer arithmetic.
+   */
+  public: virtual int64_t GetTimeNSec(size_t i) const;
+
+  /**
+   * @return Time offset of the i-th point relative to header.stamp [s].
+   */
+  public: float GetTimeSec(size_t i) const;
+
+  /**
+   * @brief Write time offsets of all points relative to header.stamp [ns].
+   * @param times Array with at least Length() elements.
+   */
+  public: virtual void GetTimesNSec(int64_t* times) const;
+  public: void GetTimesNSec(std::vector<int64_t>& times) const;
+
+  /**
+   * @brief Write time offsets of all points relative to header.stamp [s].
+   * @param times Array with at least Length() elements.
+   */
+  public: virtual void GetTimesSec(float* times) const;
+  public: void GetTimesSec(std::vector<float>& times) const;
+
   public: virtual void GetAll(size_t i, double& _scanAngle,
       double& _subscanAngle, ros::Duration& _time) const;
   public: virtual size_t Length() const;
   public: virtual void FillMsg(MultiLayerLaserScan& msg) const;
+  public: virtual void FillMsg(CompressedMultiLayerLaserScan& msg) const;
+
+  /**
+   * @brief Precompute scan angles, subscan angles and time offsets of all
+   *        points so that the Get* methods become plain array lookups.
+   * @note This is opt-in because it costs 24 bytes of memory per point. It
+   *       pays off when the layout is reused for many scans.
+   */
+  public: virtual void Materialize();
+  public: bool IsMaterialized() const;
+
+  /** @return Number of subscans, i.e. the length of the scan layout. */
+  public: size_t GetScanLength() const;
+  /** @return Number of points in one subscan. */
+  public: size_t GetSubscanLength() const;
+  public: const ParsedScanLayout& GetScanLayout() const;
+  public: const ParsedScanLayout& GetSubscanLayout() const;
+  public: const ParsedAngularOffsets& GetScanOffsetsDuringSubscan() const;
 
   protected: virtual size_t GetScanIndex(size_t i) const;
   protected: virtual size_t GetSubscanIndex(size_t i) const;
@@ -110,12 +194,18 @@ class MultiLayerLaserScanLayout
   protected: virtual double GetScanAngleByIndex(size_t scanIndex, size_t subscanIndex) const;
   protected: virtual double GetSubscanAngleByIndex(size_t i) const;
   protected: virtual ros::Duration GetTimeByIndex(size_t scanIndex, size_t subscanIndex) const;
+  protected: virtual int64_t GetTimeNSecByIndex(size_t scanIndex, size_t subscanIndex) const;
 
   protected: ParsedScanLayout subscanLayout;
   protected: ParsedScanLayout scanLayout;
   protected: std::unique_ptr<ParsedAngularOffsets> scanAngularVelocity;
   protected: size_t length;
   protected: size_t subscanLength;
+
+  protected: bool materialized = false;
+  protected: std::vector<double> materializedScanAngles;
+  protected: std::vector<double> materializedSubscanAngles;
+  protected: std::vector<ros::Duration> materializedTimes;
 };
 
 }
@@ -0,0 +1,99 @@
+#ifndef MULTILAYER_LASER_SCAN_MULTILAYERLASERSCANTOPOINTCLOUD2_H
+#define MULTILAYER_LASER_SCAN_MULTILAYERLASERSCANTOPOINTCLOUD2_H
+
+#include <multilayer_laser_scan/CartesianProjection.h>
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+
+#include <sensor_msgs/PointCloud2.h>
+
+#include <memory>
+#include <vector>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Converts MultiLayerLaserScan to PointCloud2 for legacy consumers.
+ *
+ * The cloud has float32 fields x, y, z, optionally float32 intensity,
+ * float32 time (offset from the header stamp in seconds), uint16 ring and all
+ * fields of custom_data. Ring 0 is the ray with the lowest subscan angle, like
+ * in velodyne_pointcloud.
+ *
+ * The converter keeps the projection tables of the last layout, and the
+ * output cloud buffer is only reallocated when it has to grow, so reusing
+ * both the converter and the output cloud makes the conversion
+ * allocation-free.
+ *
+ * <PRE>
+ *   sensor_msgs::MultiLayerLaserScanToPointCloud2 converter(
+ *     sensor_msgs::MultiLayerLaserScanToPointCloud2::INTENSITY |
+ *     sensor_msgs::MultiLayerLaserScanToPointCloud2::RING);
+ *   converter.Convert(scan, sensor_msgs::LayoutCache::Instance().Get(scan), cloud);
+ * </PRE>
+ */
+class MultiLayerLaserScanToPointCloud2
+{
+  public: enum Fields : uint32_t
+  {
+    XYZ = 0,  // x, y and z are always present
+    INTENSITY = 1,
+    TIME = 2,
+    RING = 4,
+    CUSTOM_DATA = 8,
+    ALL = INTENSITY | TIME | RING | CUSTOM_DATA
+  };
+
+  /**
+   * @param _fields Bitwise or of the Fields to output.
+   * @param _organized If true, the cloud is organized with height equal to the
+   *                   number of rays in a subscan and width equal to the number
+   *                   of subscans, and points out of range are set to NaN.
+   *                   If false, points out of range are dropped.
+   */
+  public: explicit MultiLayerLaserScanToPointCloud2(uint32_t _fields = ALL, bool _organized = false);
+  public: virtual ~MultiLayerLaserScanToPointCloud2() = default;
+
+  /**
+   * @brief Convert the scan to the given cloud, reusing its data buffer.
+   * @throws std::runtime_error if custom_data endianness differs from the
+   *         host one or if the scan doesn't correspond to the layout.
+   */
+  public: virtual void Convert(const MultiLayerLaserScan& scan,
+      const std::shared_ptr<const MultiLayerLaserScanLayout>& layout, PointCloud2& cloud);
+
+  protected: virtual void UpdateLayout(const std::shared_ptr<const MultiLayerLaserScanLayout>& layout);
+  protected: virtual void UpdateFields(const PointData& customData);
+
+  protected: const uint32_t fields;
+  protected: const bool organized;
+
+  protected: std::shared_ptr<const MultiLayerLaserScanLayout> layout;
+  protected: std::unique_ptr<CartesianProjection> projection;
+  protected: std::vector<uint16_t> rings;  // ring of each ray of a subscan
+
+  // custom fields the cloud fields were last computed for
+  protected: bool fieldsInitialized = false;
+  protected: std::vector<PointField> customFields;
+  protected: uint32_t customPointStep = 0;
+  protected: bool hasCustomData = false;
+
+  protected: std::vector<PointField> cloudFields;
+  protected: size_t intensityOffset = 0;
+  protected: size_t timeOffset = 0;
+  protected: size_t ringOffset = 0;
+  protected: size_t paddingOffset = 0;  // the bytes from here to customDataOffset are zeroed
+  protected: size_t customDataOffset = 0;
+  protected: size_t pointStep = 0;
+
+  // projection of one subscan
+  protected: std::vector<float> x;
+  protected: std::vector<float> y;
+  protected: std::vector<float> z;
+  protected: std::vector<float> t;
+};
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_MULTILAYERLASERSCANTOPOINTCLOUD2_H
@@ -0,0 +1,94 @@
+#ifndef MULTILAYER_LASER_SCAN_NORMALESTIMATION_H
+#define MULTILAYER_LASER_SCAN_NORMALESTIMATION_H
+
+#include <multilayer_laser_scan/CartesianProjection.h>
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+#include <multilayer_laser_scan/ScanNeighborhood.h>
+#include <multilayer_laser_scan/ThreadPool.h>
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Estimation of surface normals from neighbors on the scan grid (see
+ *        ScanNeighborhood) instead of a spatial search in a point cloud.
+ *
+ * Points with ranges outside of <range_min, range_max> (or non-finite) are
+ * invalid. They get NaN normals and are not used as neighbors. Neighbors whose
+ * range differs too much from the range of the point (i.e. across depth
+ * discontinuities) are ignored, too. Normals are oriented towards the sensor.
+ *
+ * The work is split into blocks of subscans processed in the thread pool.
+ */
+class NormalEstimation
+{
+  public: enum Method
+  {
+    /** Cross product of the tangents along the ring and across rings, computed
+     * from the closest valid neighbors. Fast. */
+    CROSS_PRODUCT = 0,
+    /** Eigenvector of the smallest eigenvalue of the covariance of the valid
+     * points in the window. Needs at least 3 points, more robust to noise. */
+    PCA = 1,
+  };
+
+  /**
+   * @param layout Layout of the scans.
+   * @param method The estimation method.
+   * @param windowRadius Radius of the neighborhood window in both rings and
+   *                     subscans. For CROSS_PRODUCT, it is the maximum distance
+   *                     of the neighbors used for tangents.
+   * @param maxRangeDifference Neighbors whose range differs more from the range
+   *                           of the point are ignored [m].
+   */
+  public: explicit NormalEstimation(const MultiLayerLaserScanLayout& layout, Method method = CROSS_PRODUCT,
+      size_t windowRadius = 1, float maxRangeDifference = std::numeric_limits<float>::infinity());
+
+  public: virtual ~NormalEstimation() = default;
+
+  /**
+   * @brief Compute normals of all points into separate arrays.
+   * @param nx, ny, nz Output arrays with space for the number of points of the
+   *                   layout. Invalid points and points without enough
+   *                   neighbors get NaNs.
+   * @throws std::runtime_error If the scan doesn't match the layout.
+   */
+  public: void Compute(const MultiLayerLaserScan& scan, float* nx, float* ny, float* nz,
+      ThreadPool& pool = ThreadPool::Instance());
+
+  /**
+   * @brief Compute normals and store them in the "normal" custom field of the
+   *        scan. The field is appended to custom_data if it is not there yet.
+   * @throws std::runtime_error If the scan doesn't match the layout or the
+   *         existing normal field is not 3x FLOAT32 in host byte order.
+   */
+  public: void Compute(MultiLayerLaserScan& scan, ThreadPool& pool = ThreadPool::Instance());
+
+  public: Method GetMethod() const;
+
+  protected: void ComputeBlock(const MultiLayerLaserScan& scan, size_t firstScan, size_t endScan,
+      float* nx, float* ny, float* nz) const;
+
+  protected: bool IsValid(const MultiLayerLaserScan& scan, size_t i) const;
+
+  protected: CartesianProjection projection;
+  protected: ScanNeighborhood neighborhood;
+  protected: Method method;
+  protected: size_t windowRadius;
+  protected: float maxRangeDifference;
+
+  // projected points, reused between scans
+  protected: std::vector<float> x;
+  protected: std::vector<float> y;
+  protected: std::vector<float> z;
+  protected: std::vector<float> normals;
+};
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_NORMALESTIMATION_H
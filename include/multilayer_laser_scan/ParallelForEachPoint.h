@@ -0,0 +1,70 @@
+#ifndef MULTILAYER_LASER_SCAN_PARALLELFOREACHPOINT_H
+#define MULTILAYER_LASER_SCAN_PARALLELFOREACHPOINT_H
+
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+#include <multilayer_laser_scan/ThreadPool.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+
+#include <functional>
+#include <memory>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Split the subscans (columns) of the layout into contiguous blocks and
+ *        call fn(firstScan, endScan) for each block in the thread pool.
+ *
+ * The blocks can be processed e.g. by ForEachPointInScans(), which avoids the
+ * virtual calls of MultiLayerLaserScanLayout::GetAll().
+ *
+ * @param grain Number of subscans in one block. 0 chooses the grain so that
+ *              each thread gets about 4 blocks.
+ */
+void ParallelForScans(const MultiLayerLaserScanLayout& layout,
+    const std::function<void(size_t firstScan, size_t endScan)>& fn,
+    size_t grain = 0, ThreadPool& pool = ThreadPool::Instance());
+
+/**
+ * @brief The same as the previous function, but only needs the number of
+ *        subscans of the layout.
+ */
+void ParallelForScans(size_t scanLength,
+    const std::function<void(size_t firstScan, size_t endScan)>& fn,
+    size_t grain = 0, ThreadPool& pool = ThreadPool::Instance());
+
+/**
+ * @brief Call fn(begin, end) in the thread pool for contiguous ranges of
+ *        points of the scan that cover whole subscans (columns).
+ *
+ * <PRE>
+ *   sensor_msgs::ParallelForEachPoint(scan, layout,
+ *     [](sensor_msgs::MultiLayerLaserScanBaseFieldsIterator it,
+ *        const sensor_msgs::MultiLayerLaserScanBaseFieldsIterator& end)
+ *     {
+ *       for (; it != end; ++it)
+ *         *(*it).range *= 2;
+ *     });
+ * </PRE>
+ *
+ * @param grain Number of subscans in one range. See ParallelForScans().
+ */
+void ParallelForEachPoint(MultiLayerLaserScan& scan,
+    const std::shared_ptr<const MultiLayerLaserScanLayout>& layout,
+    const std::function<void(MultiLayerLaserScanBaseFieldsIterator begin,
+                             const MultiLayerLaserScanBaseFieldsIterator& end)>& fn,
+    size_t grain = 0, ThreadPool& pool = ThreadPool::Instance());
+
+/**
+ * @brief Const variant of ParallelForEachPoint().
+ */
+void ParallelForEachPoint(const MultiLayerLaserScan& scan,
+    const std::shared_ptr<const MultiLayerLaserScanLayout>& layout,
+    const std::function<void(MultiLayerLaserScanBaseFieldsConstIterator begin,
+                             const MultiLayerLaserScanBaseFieldsConstIterator& end)>& fn,
+    size_t grain = 0, ThreadPool& pool = ThreadPool::Instance());
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_PARALLELFOREACHPOINT_H
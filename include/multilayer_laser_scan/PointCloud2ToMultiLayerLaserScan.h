@@ -0,0 +1,122 @@
+#ifndef MULTILAYER_LASER_SCAN_POINTCLOUD2TOMULTILAYERLASERSCAN_H
+#define MULTILAYER_LASER_SCAN_POINTCLOUD2TOMULTILAYERLASERSCAN_H
+
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+
+#include <sensor_msgs/PointCloud2.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Packs point clouds from lidar drivers into MultiLayerLaserScan with a
+ *        known layout.
+ *
+ * The subscan (ray) index of each point is given by the ring field of the
+ * cloud. If the cloud has no ring field, the ray with the closest subscan
+ * angle is used. The scan index is the column of an organized cloud with one
+ * column per subscan; otherwise, it is the subscan whose angle is closest to
+ * the azimuth of the point. Points that cannot be mapped to the layout are
+ * dropped, and points of the layout missing in the cloud get NaN range.
+ *
+ * Each point is mapped in constant time, so the conversion is linear in the
+ * number of points. The output message's buffers are reused, so after the
+ * first conversion nothing is allocated.
+ */
+class PointCloud2ToMultiLayerLaserScan
+{
+  /** How to interpret the ring field of the cloud. */
+  public: enum RingMapping
+  {
+    /** Ring 0 is the ray with the lowest subscan angle (velodyne_pointcloud). */
+    RING_BY_ELEVATION,
+    /** Ring is the index of the ray in the subscan (ouster_ros). */
+    RING_IS_SUBSCAN_INDEX,
+  };
+
+  public: struct Statistics
+  {
+    /**
+     * Number of points of the scan filled from the cloud. Points of the cloud
+     * that fall into the same point of the scan are counted once, the last
+     * of them is stored.
+     */
+    size_t numPoints = 0;
+    /** Number of points of the cloud that could not be stored in the scan. */
+    size_t numDroppedPoints = 0;
+    /** Size of the point data of the cloud [bytes]. */
+    size_t cloudBytes = 0;
+    /** Size of the point data and explicit offsets of the scan [bytes]. */
+    size_t scanBytes = 0;
+
+    int64_t BytesSaved() const;
+  };
+
+  /**
+   * @param _layoutTemplate A scan whose layout, range_min and range_max are
+   *                        copied to the output scans. Its ranges are ignored.
+   * @param _customFields Names of fields of the cloud that are copied to
+   *                      custom_data.
+   * @param _intensityField Name of the field with intensities. If it is empty
+   *                        or not in the cloud, intensities are left empty.
+   */
+  public: explicit PointCloud2ToMultiLayerLaserScan(const MultiLayerLaserScan& _layoutTemplate,
+      const std::vector<std::string>& _customFields = {},
+      const std::string& _intensityField = "intensity",
+      const std::string& _ringField = "ring",
+      RingMapping _ringMapping = RING_BY_ELEVATION);
+  public: virtual ~PointCloud2ToMultiLayerLaserScan() = default;
+
+  /**
+   * @brief Fill the scan with points of the cloud.
+   * @throws std::runtime_error if the cloud has no x, y, z fields or has
+   *         non-native endianness.
+   */
+  public: virtual Statistics Convert(const PointCloud2& cloud, MultiLayerLaserScan& scan);
+
+  public: std::shared_ptr<const MultiLayerLaserScanLayout> GetLayout() const;
+
+  /** @return Scan index of a point with the given azimuth, or -1. */
+  protected: virtual ssize_t GetScanIndex(double azimuth) const;
+  /** @return Subscan index of a point with the given elevation. */
+  protected: virtual size_t GetSubscanIndex(double elevation) const;
+
+  protected: MultiLayerLaserScan layoutTemplate;
+  protected: std::shared_ptr<const MultiLayerLaserScanLayout> layout;
+  protected: const std::vector<std::string> customFields;
+  protected: const std::string intensityField;
+  protected: const std::string ringField;
+  protected: const RingMapping ringMapping;
+
+  protected: std::vector<size_t> subscanOfRing;
+  protected: std::vector<double> scanOffsets;  // scan offsets during subscan
+
+  // subscan indices sorted by their angle, with the sorted angles
+  protected: std::vector<size_t> subscansByElevation;
+  protected: std::vector<double> sortedElevations;
+
+  // regular full-circle or sector scans are mapped in closed form
+  protected: bool regularScan = false;
+  protected: bool fullCircle = false;
+  protected: double firstScanAngle = 0;
+  protected: double scanAngleIncrement = 0;
+
+  // explicit scans are mapped using angles sorted in [0, 2 pi) and buckets
+  // pointing to the first sorted angle in each bucket
+  protected: std::vector<double> sortedScanAngles;
+  protected: std::vector<size_t> scansByAngle;
+  protected: std::vector<size_t> buckets;
+
+  // scratch space reused by Convert()
+  protected: std::vector<const PointField*> cloudCustomFields;
+  protected: std::vector<size_t> customFieldSizes;
+};
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_POINTCLOUD2TOMULTILAYERLASERSCAN_H
@@ -0,0 +1,292 @@
+#ifndef MULTILAYER_LASER_SCAN_POINTDATASCHEMA_H
+#define MULTILAYER_LASER_SCAN_POINTDATASCHEMA_H
+
+#include <multilayer_laser_scan/PointData.h>
+#include <multilayer_laser_scan/PointFieldUtils.h>
+#include <sensor_msgs/PointField.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Describes the fields of a point struct T. Specialize it for your struct
+ *        with a static Fields() function returning the PointFields of the members,
+ *        created by MULTILAYER_LASER_SCAN_SCHEMA_FIELD:
+ * <PRE>
+ *   #pragma pack(push, 1)
+ *   struct OusterPoint
+ *   {
+ *     float strongest;
+ *     uint16_t ring;
+ *     float reflectivity;
+ *   };
+ *   #pragma pack(pop)
+ *
+ *   namespace sensor_msgs
+ *   {
+ *   template<> struct PointDataSchemaTraits<OusterPoint>
+ *   {
+ *     static std::vector<PointField> Fields()
+ *     {
+ *       return {
+ *         MULTILAYER_LASER_SCAN_SCHEMA_FIELD(OusterPoint, strongest),
+ *         MULTILAYER_LASER_SCAN_SCHEMA_FIELD(OusterPoint, ring),
+ *         MULTILAYER_LASER_SCAN_SCHEMA_FIELD(OusterPoint, reflectivity),
+ *       };
+ *     }
+ *   };
+ *   }
+ * </PRE>
+ */
+template<typename T>
+struct PointDataSchemaTraits;
+
+/** @brief The PointField datatype corresponding to the C++ type T. */
+template<typename T> struct PointFieldDatatype;
+template<> struct PointFieldDatatype<int8_t> { enum { value = PointField::INT8 }; };
+template<> struct PointFieldDatatype<uint8_t> { enum { value = PointField::UINT8 }; };
+template<> struct PointFieldDatatype<int16_t> { enum { value = PointField::INT16 }; };
+template<> struct PointFieldDatatype<uint16_t> { enum { value = PointField::UINT16 }; };
+template<> struct PointFieldDatatype<int32_t> { enum { value = PointField::INT32 }; };
+template<> struct PointFieldDatatype<uint32_t> { enum { value = PointField::UINT32 }; };
+template<> struct PointFieldDatatype<float> { enum { value = PointField::FLOAT32 }; };
+template<> struct PointFieldDatatype<double> { enum { value = PointField::FLOAT64 }; };
+
+namespace impl
+{
+
+/**
+ * @brief Create the PointField describing a struct member of type M (which may
+ *        be a one-dimensional array, e.g. float normal[3]).
+ */
+template<typename M>
+PointField makeSchemaField(const std::string& name, const size_t offset)
+{
+  static_assert(std::rank<M>::value <= 1, "Only one-dimensional arrays can be used as point fields");
+  typedef typename std::remove_extent<M>::type Element;
+
+  PointField field;
+  field.name = name;
+  field.offset = static_cast<PointField::_offset_type>(offset);
+  field.datatype = PointFieldDatatype<Element>::value;
+  field.count = std::rank<M>::value == 0 ? 1 : std::extent<M>::value;
+  return field;
+}
+
+}
+
+/**
+ * @brief Create the PointField describing member of Struct.
+ */
+#define MULTILAYER_LASER_SCAN_SCHEMA_FIELD(Struct, member) \
+  ::sensor_msgs::impl::makeSchemaField<decltype(Struct::member)>(#member, offsetof(Struct, member))
+
+/**
+ * @brief Contiguous array of points viewed directly in PointData::data
+ *        (a minimal std::span).
+ */
+template<typename T>
+class PointDataSpan
+{
+  public: typedef T element_type;
+  public: typedef T* iterator;
+
+  public: PointDataSpan() = default;
+  public: PointDataSpan(T* data, const size_t size) : ptr(data), length(size) {}
+
+  public: T* data() const { return this->ptr; }
+  public: size_t size() const { return this->length; }
+  public: bool empty() const { return this->length == 0; }
+  public: T& operator[](const size_t i) const { return this->ptr[i]; }
+  public: T* begin() const { return this->ptr; }
+  public: T* end() const { return this->ptr + this->length; }
+
+  protected: T* ptr = nullptr;
+  protected: size_t length = 0;
+};
+
+/**
+ * @brief Typed access to PointData whose points are laid out as struct T.
+ *
+ * The fields of T (given by PointDataSchemaTraits<T>) are compared with
+ * PointData::fields once when calling Validate(), View() or CopyTo(). All the
+ * points can then be accessed as an array of T, without any per-point field
+ * lookup or striding like with PointDataIterator.
+ *
+ * PointData matches the schema if each field of T exists in it with the same
+ * offset, datatype and count, point_step equals sizeof(T) and the data have
+ * host endianness. Other fields of the PointData can only be stored in the
+ * padding of T.
+ *
+ * If the data are not aligned for T (only possible if T is not packed), View()
+ * fails, and the points can be copied out with CopyTo(), which is a single
+ * memcpy.
+ */
+template<typename T>
+class PointDataSchema
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Point struct has to be trivially copyable");
+  static_assert(std::is_standard_layout<T>::value, "Point struct has to have standard layout");
+
+  public: PointDataSchema() : fields(PointDataSchemaTraits<T>::Fields())
+  {
+  }
+
+  /**
+   * @return The fields of T.
+   */
+  public: const std::vector<PointField>& GetFields() const
+  {
+    return this->fields;
+  }
+
+  /**
+   * @brief Check that the PointData match this schema.
+   * @throws std::runtime_error If they do not match. The message tells why.
+   */
+  public: void Validate(const PointData& pointData) const
+  {
+    const auto mismatch = this->FindMismatch(pointData);
+    if (!mismatch.empty())
+      throw std::runtime_error("PointData do not match the schema: " + mismatch);
+  }
+
+  /**
+   * @return Whether the PointData match this schema.
+   */
+  public: bool Matches(const PointData& pointData) const
+  {
+    return this->FindMismatch(pointData).empty();
+  }
+
+  /**
+   * @return Whether View() can be called on the PointData (they match this
+   *         schema and are aligned for T).
+   */
+  public: bool CanView(const PointData& pointData) const
+  {
+    return this->Matches(pointData) && isAligned(pointData);
+  }
+
+  /**
+   * @brief View the points of PointData as an array of T without copying.
+   * @throws std::runtime_error If the PointData do not match the schema or are
+   *         not aligned for T.
+   */
+  public: PointDataSpan<T> View(PointData& pointData) const
+  {
+    this->Validate(pointData);
+    if (!isAligned(pointData))
+      throw std::runtime_error("PointData are not aligned for the schema struct, use CopyTo()");
+    return {reinterpret_cast<T*>(pointData.data.data()), pointData.data.size() / sizeof(T)};
+  }
+
+  /**
+   * @brief View the points of PointData as an array of const T without copying.
+   * @throws std::runtime_error If the PointData do not match the schema or are
+   *         not aligned for T.
+   */
+  public: PointDataSpan<const T> View(const PointData& pointData) const
+  {
+    this->Validate(pointData);
+    if (!isAligned(pointData))
+      throw std::runtime_error("PointData are not aligned for the schema struct, use CopyTo()");
+    return {reinterpret_cast<const T*>(pointData.data.data()), pointData.data.size() / sizeof(T)};
+  }
+
+  /**
+   * @brief Copy the points of PointData to an array of T.
+   * @param points The output. It is resized to the number of points.
+   * @throws std::runtime_error If the PointData do not match the schema.
+   */
+  public: void CopyTo(const PointData& pointData, std::vector<T>& points) const
+  {
+    this->Validate(pointData);
+    points.resize(pointData.data.size() / sizeof(T));
+    if (!points.empty())
+      std::memcpy(points.data(), pointData.data.data(), points.size() * sizeof(T));
+  }
+
+  /**
+   * @brief Set fields of the PointData to this schema and copy the points into
+   *        its data.
+   */
+  public: void Assign(PointData& pointData, const T* points, const size_t numPoints) const
+  {
+    pointData.fields = this->fields;
+    pointData.point_step = sizeof(T);
+    pointData.is_bigendian = impl::isHostBigEndian();
+    pointData.data.resize(numPoints * sizeof(T));
+    if (numPoints > 0)
+      std::memcpy(pointData.data.data(), points, numPoints * sizeof(T));
+  }
+
+  /**
+   * @brief Set fields of the PointData to this schema and resize its data to
+   *        numPoints (zero-initialized), so that it can be filled via View().
+   */
+  public: void Resize(PointData& pointData, const size_t numPoints) const
+  {
+    pointData.fields = this->fields;
+    pointData.point_step = sizeof(T);
+    pointData.is_bigendian = impl::isHostBigEndian();
+    pointData.data.assign(numPoints * sizeof(T), 0);
+  }
+
+  /**
+   * @return Description of the first difference between the PointData and this
+   *         schema, or empty string if they match.
+   */
+  protected: std::string FindMismatch(const PointData& pointData) const
+  {
+    if (pointData.point_step != sizeof(T))
+      return "point_step is " + std::to_string(pointData.point_step) +
+          ", but the struct has " + std::to_string(sizeof(T)) + " bytes";
+
+    if (static_cast<bool>(pointData.is_bigendian) != impl::isHostBigEndian())
+      return "the data do not have host endianness";
+
+    if (pointData.data.size() % sizeof(T) != 0)
+      return "data size is not a multiple of point_step";
+
+    for (const auto& field : this->fields)
+    {
+      auto it = pointData.fields.begin();
+      while (it != pointData.fields.end() && it->name != field.name)
+        ++it;
+
+      if (it == pointData.fields.end())
+        return "field " + field.name + " does not exist";
+      if (it->offset != field.offset)
+        return "field " + field.name + " has offset " + std::to_string(it->offset) +
+            " instead of " + std::to_string(field.offset);
+      if (it->datatype != field.datatype)
+        return "field " + field.name + " has datatype " + std::to_string(it->datatype) +
+            " instead of " + std::to_string(field.datatype);
+      if (it->count != field.count)
+        return "field " + field.name + " has count " + std::to_string(it->count) +
+            " instead of " + std::to_string(field.count);
+    }
+
+    return "";
+  }
+
+  protected: static bool isAligned(const PointData& pointData)
+  {
+    return reinterpret_cast<uintptr_t>(pointData.data.data()) % alignof(T) == 0;
+  }
+
+  protected: std::vector<PointField> fields;
+};
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_POINTDATASCHEMA_H
@@ -0,0 +1,153 @@
+#ifndef MULTILAYER_LASER_SCAN_POINTDATASOA_H
+#define MULTILAYER_LASER_SCAN_POINTDATASOA_H
+
+#include <multilayer_laser_scan/PointData.h>
+#include <sensor_msgs/PointField.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Copy a field of each point from an interleaved buffer to a contiguous
+ *        array (gather).
+ * @param src Pointer to the field of the first point.
+ * @param stride Distance between two points in src [bytes] (point_step).
+ * @param fieldSize Size of the field in one point [bytes].
+ * @param numPoints Number of points.
+ * @param dst Output array of numPoints * fieldSize bytes.
+ */
+void GatherField(const uint8_t* src, size_t stride, size_t fieldSize, size_t numPoints, uint8_t* dst);
+
+/**
+ * @brief Copy a contiguous array to a field of each point of an interleaved
+ *        buffer (scatter). The inverse of GatherField().
+ */
+void ScatterField(const uint8_t* src, size_t fieldSize, size_t numPoints, size_t stride, uint8_t* dst);
+
+/**
+ * @brief Reverse the byte order of each element of a contiguous array in place.
+ * @param elementSize Size of an element [bytes]. Sizes 1 (no-op), 2, 4 and 8
+ *                    are supported.
+ * @throws std::runtime_error If elementSize is not supported.
+ */
+void SwapBytes(uint8_t* data, size_t elementSize, size_t numElements);
+
+/**
+ * @brief Structure-of-arrays copy of selected fields of PointData.
+ *
+ * PointData::data interleaves all fields of a point, so processing a single
+ * channel (e.g. filtering by reflectivity or computing statistics of noise)
+ * strides over all the other bytes. Extract() transposes the selected fields
+ * into one contiguous, host-endian typed array per field, which can be
+ * processed by vectorized code. Scatter() writes the arrays back into the
+ * original PointData and Pack() builds a new PointData out of them for
+ * publishing.
+ *
+ * The buffers are kept between calls, so reusing one instance for consecutive
+ * scans with the same fields does not allocate. Scatter() and Pack() only read
+ * the instance and can be called from several threads at once; they allocate
+ * only to convert the endianness.
+ *
+ * A default x86-64 build gathers the fields with scalar loads and swaps the
+ * bytes of 4- and 8-byte elements one at a time. The
+ * MULTILAYER_LASER_SCAN_AVX2 CMake option enables AVX2 gathers and SSSE3 byte
+ * shuffles.
+ */
+class PointDataSoAView
+{
+  public: PointDataSoAView() = default;
+
+  /**
+   * @brief Extract the given fields of the PointData (see Extract()).
+   */
+  public: PointDataSoAView(const PointData& pointData, const std::vector<std::string>& fieldNames);
+
+  public: virtual ~PointDataSoAView() = default;
+
+  /**
+   * @brief Copy the given fields of all points of PointData into contiguous
+   *        arrays, converting them to host endianness.
+   * @param fieldNames Names of the fields to extract. If empty, all fields are
+   *                   extracted.
+   * @throws std::runtime_error If a field does not exist or has an unknown
+   *         datatype.
+   */
+  public: void Extract(const PointData& pointData, const std::vector<std::string>& fieldNames);
+
+  /**
+   * @brief Add a new zero-initialized field. Its offset is not used.
+   * @throws std::runtime_error If a field with the same name already exists or
+   *         the datatype is unknown.
+   */
+  public: void AddField(const std::string& name, uint8_t datatype, uint32_t count = 1);
+
+  /**
+   * @brief Change the number of points of all fields.
+   */
+  public: void Resize(size_t numPoints);
+
+  public: size_t NumPoints() const;
+
+  /**
+   * @return The fields in the order of extraction. Offsets are the offsets in
+   *         the PointData they were extracted from.
+   */
+  public: const std::vector<PointField>& GetFields() const;
+
+  public: bool HasField(const std::string& name) const;
+
+  /**
+   * @brief Get the contiguous array of a field (NumPoints() * count values).
+   * @tparam T Type of the values. Its size has to match the datatype.
+   * @throws std::runtime_error If the field doesn't exist or T doesn't match it.
+   */
+  public: template<typename T> T* Get(const std::string& name)
+  {
+    return reinterpret_cast<T*>(this->GetBytes(name, sizeof(T)));
+  }
+
+  /** @copydoc Get() */
+  public: template<typename T> const T* Get(const std::string& name) const
+  {
+    return reinterpret_cast<const T*>(const_cast<PointDataSoAView*>(this)->GetBytes(name, sizeof(T)));
+  }
+
+  /**
+   * @brief Write the fields back to the points of PointData, converting them to
+   *        its endianness. Other fields of PointData are left untouched.
+   * @throws std::runtime_error If PointData doesn't have the same number of
+   *         points or some of the fields (with the same datatype and count).
+   */
+  public: void Scatter(PointData& pointData) const;
+
+  /**
+   * @brief Create a new host-endian PointData with just these fields, packed
+   *        without padding in the order of GetFields().
+   */
+  public: void Pack(PointData& pointData) const;
+
+  protected: uint8_t* GetBytes(const std::string& name, size_t valueSize);
+
+  protected: struct Channel
+  {
+    PointField field;
+    size_t valueSize = 0;
+    std::vector<uint8_t> data;
+  };
+
+  protected: std::vector<PointField> fields;
+  protected: std::vector<Channel> channels;
+  protected: size_t numPoints = 0;
+
+  // scratch buffer of Extract() kept between calls
+  protected: std::vector<const PointField*> selectedFields;
+};
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_POINTDATASOA_H
@@ -0,0 +1,78 @@
+#ifndef MULTILAYER_LASER_SCAN_POINTFIELDUTILS_H
+#define MULTILAYER_LASER_SCAN_POINTFIELDUTILS_H
+
+#include <sensor_msgs/PointField.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace sensor_msgs
+{
+
+namespace impl
+{
+
+/**
+ * @return Whether the host stores multi-byte values as big endian, i.e. the
+ *         value for is_bigendian of data written in host byte order.
+ */
+inline bool isHostBigEndian()
+{
+  const uint16_t value = 1;
+  return *reinterpret_cast<const uint8_t*>(&value) == 0;
+}
+
+/**
+ * @brief Size of one element of the datatype in bytes.
+ * @param datatype One of the PointField:: datatype constants.
+ * @throws std::runtime_error If the datatype does not exist.
+ */
+inline size_t sizeOfPointField(const uint8_t datatype)
+{
+  switch (datatype)
+  {
+    case PointField::INT8:
+    case PointField::UINT8:
+      return 1;
+    case PointField::INT16:
+    case PointField::UINT16:
+      return 2;
+    case PointField::INT32:
+    case PointField::UINT32:
+    case PointField::FLOAT32:
+      return 4;
+    case PointField::FLOAT64:
+      return 8;
+    default:
+      throw std::runtime_error("PointField of type " + std::to_string(datatype) + " does not exist");
+  }
+}
+
+/** @return Whether the fields have the same name, offset, datatype and count. */
+inline bool samePointField(const PointField& lhs, const PointField& rhs)
+{
+  return lhs.name == rhs.name && lhs.offset == rhs.offset &&
+    lhs.datatype == rhs.datatype && lhs.count == rhs.count;
+}
+
+/** @return Whether the field lists are equal by samePointField(). */
+inline bool samePointFields(const std::vector<PointField>& lhs, const std::vector<PointField>& rhs)
+{
+  if (lhs.size() != rhs.size())
+    return false;
+
+  for (size_t i = 0; i < lhs.size(); ++i)
+    if (!samePointField(lhs[i], rhs[i]))
+      return false;
+
+  return true;
+}
+
+}
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_POINTFIELDUTILS_H
@@ -0,0 +1,109 @@
+#ifndef MULTILAYER_LASER_SCAN_RANGECODEC_H
+#define MULTILAYER_LASER_SCAN_RANGECODEC_H
+
+#include <multilayer_laser_scan/CompressedMultiLayerLaserScan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Lossless codec for 16-bit encoded ranges (see RangeEncoding.h).
+ *
+ * Neighboring rays of one ring (i.e. points with the same subscan index in
+ * consecutive subscans) have highly correlated ranges. So each value is
+ * predicted from the previous values of its ring, and only the
+ * zigzag-encoded residuals are stored. The residuals are bit-packed in the
+ * order of the points in blocks of BLOCK_SIZE values. Each block uses the bit
+ * width that makes it the smallest; the few residuals that do not fit into
+ * it (e.g. at depth discontinuities) are stored as exceptions. Invalid values
+ * (SCALED_INVALID) are not used for prediction.
+ *
+ * The output is a self-contained byte stream which can be sent in
+ * CompressedMultiLayerLaserScan::packed_ranges or written to a file:
+ * <PRE>
+ *   "MLRC", uint8 version, uint8 predictor, uint16 reserved,
+ *   uint32 number of subscans, uint32 subscan length,
+ *   blocks: uint8 bit width, uint8 number of exceptions,
+ *           bit-packed low bits of residuals (LSB first),
+ *           exceptions: uint8 index in block, uint16 high bits of residual
+ * </PRE>
+ * All multi-byte values are little-endian regardless of the platform.
+ */
+class RangeCodec
+{
+  public: enum Predictor
+  {
+    /** Predict the previous value of the ring. Best for most scans. */
+    PREDICT_PREVIOUS = 0,
+    /** Extrapolate the previous two values of the ring. Better for smooth
+     * surfaces observed at grazing angles. */
+    PREDICT_LINEAR = 1,
+  };
+
+  public: struct Statistics
+  {
+    /** Size of the raw 16-bit values [bytes]. */
+    size_t rawBytes = 0;
+    /** Size of the encoded stream [bytes]. */
+    size_t encodedBytes = 0;
+
+    /** @return rawBytes / encodedBytes. */
+    double CompressionRatio() const;
+  };
+
+  /** Number of residuals sharing one bit width. */
+  public: static constexpr size_t BLOCK_SIZE = 128;
+
+  public: explicit RangeCodec(Predictor _predictor = PREDICT_PREVIOUS);
+  public: virtual ~RangeCodec() = default;
+
+  /**
+   * @brief Encode values of an organized scan.
+   * @param raw The values, scan-major (as MultiLayerLaserScan::ranges).
+   * @param numScans Number of subscans.
+   * @param subscanLength Number of points in a subscan.
+   * @param encoded The output stream. It is overwritten.
+   */
+  public: virtual Statistics Encode(const uint16_t* raw, size_t numScans, size_t subscanLength,
+      std::vector<uint8_t>& encoded);
+
+  /**
+   * @brief Decode a stream created by Encode().
+   * @param raw The output values. It is resized to the number of points.
+   * @param numScans If not null, receives the number of subscans.
+   * @param subscanLength If not null, receives the number of points in a subscan.
+   * @throws std::runtime_error If the stream is corrupted or truncated.
+   */
+  public: virtual Statistics Decode(const uint8_t* encoded, size_t size, std::vector<uint16_t>& raw,
+      size_t* numScans = nullptr, size_t* subscanLength = nullptr);
+
+  public: Predictor GetPredictor() const;
+
+  protected: const Predictor predictor;
+
+  // ring-major residuals
+  protected: std::vector<uint16_t> residuals;
+};
+
+/**
+ * @brief Move the ranges of the scan into packed_ranges.
+ * @throws std::runtime_error If the number of ranges doesn't match the layout.
+ */
+RangeCodec::Statistics PackRanges(CompressedMultiLayerLaserScan& scan,
+    RangeCodec::Predictor predictor = RangeCodec::PREDICT_PREVIOUS);
+
+/**
+ * @brief Move packed_ranges of the scan back into ranges. Does nothing if
+ *        packed_ranges is empty.
+ * @throws std::runtime_error If the packed ranges are corrupted or do not
+ *         match the layout.
+ */
+void UnpackRanges(CompressedMultiLayerLaserScan& scan);
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_RANGECODEC_H
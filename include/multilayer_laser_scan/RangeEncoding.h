@@ -0,0 +1,203 @@
+#ifndef MULTILAYER_LASER_SCAN_RANGEENCODING_H
+#define MULTILAYER_LASER_SCAN_RANGEENCODING_H
+
+#include <multilayer_laser_scan/CompressedMultiLayerLaserScan.h>
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace sensor_msgs
+{
+
+/** @brief Raw value of ENCODING_UINT16_SCALED denoting an invalid value. */
+constexpr uint16_t SCALED_INVALID = 65535;
+
+/**
+ * @brief Parameters of encoding of one channel of CompressedMultiLayerLaserScan.
+ */
+struct ChannelEncoding
+{
+  uint8_t encoding = CompressedMultiLayerLaserScan::ENCODING_FLOAT16;
+  float scale = 1.0f;
+  float offset = 0.0f;
+
+  /**
+   * @brief value = raw * scale + offset, raw in <0, 65534>.
+   * @throws std::runtime_error If scale is not positive.
+   */
+  static ChannelEncoding Scaled(float scale, float offset = 0.0f);
+
+  /**
+   * @brief The finest scaled encoding that can represent all values in
+   *        <min, max>. Its precision is (max - min) / 131068.
+   * @throws std::runtime_error If max <= min.
+   */
+  static ChannelEncoding ScaledRange(float min, float max);
+
+  /**
+   * @brief IEEE half-precision floats.
+   */
+  static ChannelEncoding Half();
+
+  /**
+   * @return The largest absolute error of encoding a value that is
+   *         representable by this encoding. For half floats, the precision is
+   *         relative, so it is returned for a value of magnitude 1.
+   */
+  float Precision() const;
+};
+
+/**
+ * @brief Convert float to IEEE half float, rounding to nearest even.
+ */
+inline uint16_t FloatToHalf(const float value)
+{
+  uint32_t x;
+  std::memcpy(&x, &value, sizeof(x));
+  const uint16_t sign = static_cast<uint16_t>((x >> 16) & 0x8000u);
+  const uint32_t absX = x & 0x7FFFFFFFu;
+
+  if (absX >= 0x7F800000u)  // NaN or infinity
+    return sign | (absX > 0x7F800000u ? 0x7E00u : 0x7C00u);
+  if (absX >= 0x477FF000u)  // rounds to a value larger than 65504
+    return sign | 0x7C00u;
+
+  uint32_t result;
+  uint32_t remainder;
+  uint32_t half;
+  if (absX < 0x38800000u)  // subnormal half
+  {
+    if (absX < 0x33000000u)  // rounds to zero
+      return sign;
+    const uint32_t shift = 126u - (absX >> 23);
+    const uint32_t mantissa = (absX & 0x7FFFFFu) | 0x800000u;
+    result = mantissa >> shift;
+    remainder = mantissa & ((1u << shift) - 1u);
+    half = 1u << (shift - 1u);
+  }
+  else
+  {
+    result = (absX - 0x38000000u) >> 13;
+    remainder = absX & 0x1FFFu;
+    half = 0x1000u;
+  }
+  // a carry from the mantissa correctly increments the exponent
+  if (remainder > half || (remainder == half && (result & 1u)))
+    ++result;
+  return static_cast<uint16_t>(sign | result);
+}
+
+/**
+ * @brief Convert IEEE half float to float (exactly).
+ */
+inline float HalfToFloat(const uint16_t value)
+{
+  const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+  const uint32_t exponent = (value >> 10) & 0x1Fu;
+  const uint32_t mantissa = value & 0x3FFu;
+
+  uint32_t x;
+  if (exponent == 0)
+  {
+    const float result = static_cast<float>(mantissa) * 5.9604644775390625e-8f;  // 2^-24
+    return sign ? -result : result;
+  }
+  else if (exponent == 0x1F)
+    x = sign | 0x7F800000u | (mantissa << 13);
+  else
+    x = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+
+  float result;
+  std::memcpy(&result, &x, sizeof(result));
+  return result;
+}
+
+/**
+ * @brief Decode one value encoded with the given encoding.
+ */
+inline float DecodeValue(const uint16_t raw, const ChannelEncoding& encoding)
+{
+  if (encoding.encoding == CompressedMultiLayerLaserScan::ENCODING_FLOAT16)
+    return HalfToFloat(raw);
+  if (raw == SCALED_INVALID)
+    return std::numeric_limits<float>::quiet_NaN();
+  return static_cast<float>(raw) * encoding.scale + encoding.offset;
+}
+
+/**
+ * @brief Encode values as raw = round((value - offset) / scale).
+ * @note NaNs and values outside the representable range are encoded as
+ *       SCALED_INVALID. Vectorized with SSE2, or with AVX if built with the
+ *       MULTILAYER_LASER_SCAN_AVX2 CMake option.
+ */
+void EncodeScaled(const float* values, size_t length, float scale, float offset, uint16_t* raw);
+
+/**
+ * @brief Decode values as raw * scale + offset, SCALED_INVALID as NaN.
+ */
+void DecodeScaled(const uint16_t* raw, size_t length, float scale, float offset, float* values);
+
+/**
+ * @brief Encode values as IEEE half floats, rounding to nearest even.
+ * @note Uses the F16C instructions if the compiler targets them (the
+ *       MULTILAYER_LASER_SCAN_AVX2 CMake option), otherwise the conversion is
+ *       scalar.
+ */
+void EncodeHalf(const float* values, size_t length, uint16_t* raw);
+
+/**
+ * @brief Decode IEEE half floats.
+ */
+void DecodeHalf(const uint16_t* raw, size_t length, float* values);
+
+/**
+ * @brief Encode values with the given encoding.
+ * @throws std::runtime_error If the encoding is not known.
+ */
+void Encode(const float* values, size_t length, const ChannelEncoding& encoding, uint16_t* raw);
+
+/**
+ * @brief Decode values with the given encoding.
+ * @throws std::runtime_error If the encoding is not known.
+ */
+void Decode(const uint16_t* raw, size_t length, const ChannelEncoding& encoding, float* values);
+
+/**
+ * @return Encoding of the ranges of the compressed scan.
+ */
+ChannelEncoding GetRangeEncoding(const CompressedMultiLayerLaserScan& scan);
+
+/**
+ * @return Encoding of the intensities of the compressed scan.
+ */
+ChannelEncoding GetIntensityEncoding(const CompressedMultiLayerLaserScan& scan);
+
+/**
+ * @brief Compress the scan. Layout and custom data are copied as they are.
+ * @param rangeEncoding Encoding of ranges. A good choice for scanners with
+ *                      millimeter resolution is ChannelEncoding::Scaled(0.002f),
+ *                      which can represent ranges up to 131 m.
+ * @param intensityEncoding Encoding of intensities.
+ */
+void CompressScan(const MultiLayerLaserScan& scan, CompressedMultiLayerLaserScan& compressed,
+    const ChannelEncoding& rangeEncoding,
+    const ChannelEncoding& intensityEncoding = ChannelEncoding::Half());
+
+/**
+ * @brief Compress the scan, encoding ranges with ChannelEncoding::ScaledRange
+ *        between 0 and range_max and intensities as half floats.
+ */
+void CompressScan(const MultiLayerLaserScan& scan, CompressedMultiLayerLaserScan& compressed);
+
+/**
+ * @brief Decompress the scan. Values invalid in the encoding become NaNs.
+ *        Packed ranges (see RangeCodec) are unpacked, too.
+ */
+void DecompressScan(const CompressedMultiLayerLaserScan& compressed, MultiLayerLaserScan& scan);
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_RANGEENCODING_H
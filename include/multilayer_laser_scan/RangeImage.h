@@ -0,0 +1,216 @@
+#ifndef MULTILAYER_LASER_SCAN_RANGEIMAGE_H
+#define MULTILAYER_LASER_SCAN_RANGEIMAGE_H
+
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+#include <multilayer_laser_scan/PointFieldUtils.h>
+#include <sensor_msgs/Image.h>
+#include <sensor_msgs/image_encodings.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Strided 2D view of values stored elsewhere (no copy).
+ *
+ * Element (row, col) is at byte offset row * RowStride() + col * ColStride()
+ * from Data(). The views returned by GetRangeImage() and similar functions
+ * have one row per ring (subscan index) and one column per subscan, so they
+ * are depth images of the scan.
+ *
+ * The rows are in the order of subscan_layout, not sorted by elevation. For
+ * scanners with interleaved rings (e.g. Velodyne HDL-32E), neighboring rows are
+ * therefore not neighboring rings. GetRingsByElevation() gives the order of the
+ * rows sorted by elevation.
+ */
+template<typename T>
+class ScanImageView
+{
+  protected: typedef typename std::conditional<std::is_const<T>::value, const uint8_t, uint8_t>::type Byte;
+
+  public: ScanImageView() = default;
+
+  /**
+   * @param data Pointer to element (0, 0).
+   * @param rows Number of rows.
+   * @param cols Number of columns.
+   * @param rowStride Distance between two consecutive rows [bytes].
+   * @param colStride Distance between two consecutive columns [bytes].
+   */
+  public: ScanImageView(T* data, const size_t rows, const size_t cols, const size_t rowStride,
+      const size_t colStride)
+    : data(reinterpret_cast<Byte*>(data)), rows(rows), cols(cols), rowStride(rowStride), colStride(colStride)
+  {
+  }
+
+  public: T& operator()(const size_t row, const size_t col) const
+  {
+    return *reinterpret_cast<T*>(this->data + row * this->rowStride + col * this->colStride);
+  }
+
+  /**
+   * @return The same values with rows and columns swapped (one row per
+   *         subscan for scan images).
+   */
+  public: ScanImageView Transposed() const
+  {
+    return {this->Data(), this->cols, this->rows, this->colStride, this->rowStride};
+  }
+
+  /**
+   * @return Whether the values of each row are stored next to each other, so
+   *         that the view can be exported to an image with one memcpy.
+   */
+  public: bool HasContiguousRows() const
+  {
+    return this->colStride == sizeof(T) && this->rowStride == this->cols * sizeof(T);
+  }
+
+  public: T* Data() const { return reinterpret_cast<T*>(this->data); }
+  public: size_t Rows() const { return this->rows; }
+  public: size_t Cols() const { return this->cols; }
+  public: size_t RowStride() const { return this->rowStride; }
+  public: size_t ColStride() const { return this->colStride; }
+
+  protected: Byte* data = nullptr;
+  protected: size_t rows = 0;
+  protected: size_t cols = 0;
+  protected: size_t rowStride = 0;
+  protected: size_t colStride = 0;
+};
+
+/**
+ * @brief Order of the rings sorted by elevation, highest first.
+ * @return Subscan indices sorted by descending subscan angle, i.e. the row of
+ *         the scan images to show at each row of an elevation-sorted image.
+ *         Rings with the same angle keep their order.
+ */
+std::vector<size_t> GetRingsByElevation(const MultiLayerLaserScanLayout& layout);
+
+/**
+ * @brief View ranges of the scan as a ring x subscan image.
+ * @throws std::runtime_error If the number of ranges doesn't match the layout.
+ */
+ScanImageView<float> GetRangeImage(MultiLayerLaserScan& scan, const MultiLayerLaserScanLayout& layout);
+ScanImageView<const float> GetRangeImage(const MultiLayerLaserScan& scan, const MultiLayerLaserScanLayout& layout);
+
+/**
+ * @brief View intensities of the scan as a ring x subscan image.
+ * @throws std::runtime_error If the number of intensities doesn't match the layout.
+ */
+ScanImageView<float> GetIntensityImage(MultiLayerLaserScan& scan, const MultiLayerLaserScanLayout& layout);
+ScanImageView<const float> GetIntensityImage(const MultiLayerLaserScan& scan,
+    const MultiLayerLaserScanLayout& layout);
+
+namespace impl
+{
+
+/**
+ * @brief Find a custom field and check it has the given size and one item per
+ *        point of the layout.
+ * @return Offset of the field.
+ * @throws std::runtime_error If the checks fail.
+ */
+size_t checkCustomFieldImage(const PointData& data, const MultiLayerLaserScanLayout& layout,
+    const std::string& fieldName, size_t valueSize);
+
+/**
+ * @brief Copy strided values of elementSize bytes to a row-major image buffer.
+ */
+void copyToImage(const uint8_t* data, size_t rows, size_t cols, size_t rowStride, size_t colStride,
+    size_t elementSize, uint8_t* image);
+
+}
+
+/**
+ * @brief View the first element of a custom field of the scan as a
+ *        ring x subscan image.
+ * @tparam T Type of the field. Its size has to match the datatype.
+ * @throws std::runtime_error If the field doesn't exist, doesn't match T or
+ *         the custom data do not have one item per point.
+ */
+template<typename T>
+ScanImageView<T> GetCustomFieldImage(MultiLayerLaserScan& scan, const MultiLayerLaserScanLayout& layout,
+    const std::string& fieldName)
+{
+  const auto offset = impl::checkCustomFieldImage(scan.custom_data, layout, fieldName, sizeof(T));
+  const size_t step = scan.custom_data.point_step;
+  return {reinterpret_cast<T*>(scan.custom_data.data.data() + offset),
+      layout.GetSubscanLength(), layout.GetScanLength(), step, step * layout.GetSubscanLength()};
+}
+
+/** @copydoc GetCustomFieldImage() */
+template<typename T>
+ScanImageView<const T> GetCustomFieldImage(const MultiLayerLaserScan& scan,
+    const MultiLayerLaserScanLayout& layout, const std::string& fieldName)
+{
+  const auto offset = impl::checkCustomFieldImage(scan.custom_data, layout, fieldName, sizeof(T));
+  const size_t step = scan.custom_data.point_step;
+  return {reinterpret_cast<const T*>(scan.custom_data.data.data() + offset),
+      layout.GetSubscanLength(), layout.GetScanLength(), step, step * layout.GetSubscanLength()};
+}
+
+/** @brief The sensor_msgs::Image encoding of single-channel images of T. */
+template<typename T> std::string ImageEncoding();
+template<> inline std::string ImageEncoding<float>() { return image_encodings::TYPE_32FC1; }
+template<> inline std::string ImageEncoding<double>() { return image_encodings::TYPE_64FC1; }
+template<> inline std::string ImageEncoding<uint8_t>() { return image_encodings::TYPE_8UC1; }
+template<> inline std::string ImageEncoding<int8_t>() { return image_encodings::TYPE_8SC1; }
+template<> inline std::string ImageEncoding<uint16_t>() { return image_encodings::TYPE_16UC1; }
+template<> inline std::string ImageEncoding<int16_t>() { return image_encodings::TYPE_16SC1; }
+template<> inline std::string ImageEncoding<int32_t>() { return image_encodings::TYPE_32SC1; }
+
+/**
+ * @brief Copy the view into a single-channel host-endian image. Header of the
+ *        image is left untouched.
+ *
+ * Image owns its buffer, so it can't share the memory of the scan. If the view
+ * has contiguous rows (e.g. GetRangeImage(...).Transposed(), which has one row
+ * per subscan), this is a single memcpy. Otherwise, the values are transposed
+ * in cache-friendly blocks.
+ */
+template<typename T>
+void ToImage(const ScanImageView<T>& view, Image& image)
+{
+  typedef typename std::remove_const<T>::type Value;
+  image.height = static_cast<uint32_t>(view.Rows());
+  image.width = static_cast<uint32_t>(view.Cols());
+  image.encoding = ImageEncoding<Value>();
+  image.is_bigendian = impl::isHostBigEndian();
+  image.step = static_cast<uint32_t>(view.Cols() * sizeof(Value));
+  image.data.resize(view.Rows() * view.Cols() * sizeof(Value));
+  impl::copyToImage(reinterpret_cast<const uint8_t*>(view.Data()), view.Rows(), view.Cols(),
+      view.RowStride(), view.ColStride(), sizeof(Value), image.data.data());
+}
+
+/**
+ * @brief Export ranges of the scan as a 32FC1 depth image with the header of
+ *        the scan.
+ * @param transposed If false, the image has one row per ring (the usual depth
+ *                   image, but with the rings in layout order, see
+ *                   ScanImageView). If true, it has one row per subscan, which
+ *                   is the memory layout of the scan, and the export is a
+ *                   single memcpy.
+ * @throws std::runtime_error If the number of ranges doesn't match the layout.
+ */
+void RangesToImage(const MultiLayerLaserScan& scan, const MultiLayerLaserScanLayout& layout, Image& image,
+    bool transposed = false);
+
+/**
+ * @brief Export intensities of the scan as a 32FC1 image with the header of the
+ *        scan (see RangesToImage()).
+ * @throws std::runtime_error If the number of intensities doesn't match the layout.
+ */
+void IntensitiesToImage(const MultiLayerLaserScan& scan, const MultiLayerLaserScanLayout& layout,
+    Image& image, bool transposed = false);
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_RANGEIMAGE_H
@@ -0,0 +1,102 @@
+#ifndef MULTILAYER_LASER_SCAN_SCANASSEMBLER_H
+#define MULTILAYER_LASER_SCAN_SCANASSEMBLER_H
+
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+#include <multilayer_laser_scan/ScanPacketDecoder.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Builds MultiLayerLaserScan messages incrementally from raw lidar
+ *        packets, without creating point clouds.
+ *
+ * The packets are decoded by a ScanPacketDecoder, which appends each firing
+ * as a new subscan directly to ranges, intensities and custom_data of the scan
+ * being assembled. The scan layout is extended by
+ * ParsedScanLayout::AddOffset(). When the scan angle crosses the cut angle, the
+ * completed scan is passed to the callback and a new one is started.
+ *
+ * The cost of each packet is linear in the number of points it contains. The
+ * buffers of the scan and the offsets of its layout keep their capacity, so
+ * after the first scan, appending subscans only allocates when a scan is
+ * longer than all the previous ones.
+ *
+ * <PRE>
+ *   sensor_msgs::ScanAssembler assembler(decoder, "velodyne", M_PI,
+ *     [&pub](const sensor_msgs::MultiLayerLaserScan& scan) { pub.publish(scan); });
+ *   assembler.AddPacket(packet.data.data(), packet.data.size(), packet.stamp);
+ * </PRE>
+ */
+class ScanAssembler
+{
+  public: typedef std::function<void(const MultiLayerLaserScan&)> Callback;
+
+  /** Pointers to the data of the subscan being appended. */
+  public: struct SubscanData
+  {
+    float* ranges;
+    float* intensities;
+    /** Custom data of the first point, points are custom_data.point_step apart. */
+    uint8_t* customData;
+  };
+
+  /**
+   * @param _decoder The decoder of packets.
+   * @param _frameId Frame ID of the assembled scans.
+   * @param _cutAngle The scan is completed when scan angle crosses this angle
+   *                  [rad].
+   * @param _callback Function called with every completed scan. The scan is
+   *                  only valid during the call.
+   */
+  public: ScanAssembler(std::shared_ptr<const ScanPacketDecoder> _decoder, const std::string& _frameId,
+      double _cutAngle, Callback _callback);
+  public: virtual ~ScanAssembler() = default;
+
+  /**
+   * @brief Decode the packet and append its subscans to the scan.
+   * @throws std::runtime_error if the packet is malformed.
+   */
+  public: virtual void AddPacket(const uint8_t* data, size_t size, const ros::Time& stamp);
+
+  /**
+   * @brief Append a subscan to the scan and return pointers to its data which
+   *        should be filled by the caller. If the subscan crosses the cut
+   *        angle, the current scan is completed first.
+   * @param scanAngle Scan angle of the subscan [rad].
+   * @param time Time of the subscan.
+   * @note This is meant to be called by decoders.
+   */
+  public: virtual SubscanData AppendSubscan(double scanAngle, const ros::Time& time);
+
+  /**
+   * @brief Complete the current scan even though it did not reach the cut
+   *        angle. Nothing happens if the scan is empty.
+   */
+  public: virtual void Flush();
+
+  /** @return Number of subscans in the scan being assembled. */
+  public: size_t GetNumSubscans() const;
+
+  protected: virtual void StartScan(double scanAngle, const ros::Time& stamp);
+  protected: virtual bool CrossesCutAngle(double scanAngle) const;
+
+  protected: std::shared_ptr<const ScanPacketDecoder> decoder;
+  protected: const double cutAngle;
+  protected: Callback callback;
+  protected: const size_t subscanLength;
+
+  protected: MultiLayerLaserScan scan;
+  protected: std::unique_ptr<ParsedScanLayout> scanLayout;
+  protected: size_t numSubscans = 0;
+  protected: double lastScanAngle = 0;
+};
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_SCANASSEMBLER_H
@@ -0,0 +1,65 @@
+#ifndef MULTILAYER_LASER_SCAN_SCANLAYOUTUTILS_H
+#define MULTILAYER_LASER_SCAN_SCANLAYOUTUTILS_H
+
+#include <multilayer_laser_scan/ScanLayout.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace sensor_msgs
+{
+
+namespace impl
+{
+
+/**
+ * @brief operator== treats regular angular offsets that differ by 2 pi or only
+ *        in exclude_last as equal, but these yield different parsed layouts.
+ * @return Whether lhs and rhs, which are equal by operator==, are equal in these as well.
+ */
+inline bool sameRegularAngularOffsets(const AngularOffsets& lhs, const AngularOffsets& rhs)
+{
+  if (!lhs.regular)
+    return true;
+
+  return lhs.min == rhs.min && lhs.max == rhs.max &&
+    lhs.exclude_last == rhs.exclude_last &&
+    lhs.increment == rhs.increment && lhs.samples == rhs.samples;
+}
+
+/** @return Whether the angular offsets yield the same parsed offsets. */
+inline bool sameAngularOffsets(const AngularOffsets& lhs, const AngularOffsets& rhs)
+{
+  return lhs == rhs && sameRegularAngularOffsets(lhs, rhs);
+}
+
+/** @return Whether the layouts yield the same parsed layout. */
+inline bool sameScanLayout(const ScanLayout& lhs, const ScanLayout& rhs)
+{
+  return lhs == rhs && sameRegularAngularOffsets(lhs.angular_offsets, rhs.angular_offsets);
+}
+
+/**
+ * @brief Fill msg with regular angular offsets of samples angles from
+ *        firstAngle to lastAngle (inclusive).
+ * @param increment Any value with the sign of the increment between the angles.
+ */
+inline void fillRegularAngularOffsets(const double firstAngle, const double lastAngle, const size_t samples,
+    const double increment, AngularOffsets& msg)
+{
+  // only samples are given, because the number of samples recomputed from
+  // the increment could be off by one due to rounding
+  msg = AngularOffsets();
+  msg.regular = true;
+  msg.min = std::min(firstAngle, lastAngle);
+  msg.max = std::max(firstAngle, lastAngle);
+  const auto signedSamples = static_cast<int32_t>(samples);
+  msg.samples = increment >= 0 ? signedSamples : -signedSamples;
+}
+
+}
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_SCANLAYOUTUTILS_H
@@ -0,0 +1,60 @@
+#ifndef MULTILAYER_LASER_SCAN_SCANMERGER_H
+#define MULTILAYER_LASER_SCAN_SCANMERGER_H
+
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Concatenate partial scans (e.g. sectors of one sweep or scans of a few
+ *        packets each) into one scan, subscan by subscan.
+ *
+ * The parts have to have the same frame, range limits, subscan_layout,
+ * scan_offsets_during_subscan and custom data fields, and either all or none
+ * of them has intensities. This is checked once per part; the points are then
+ * appended without any per-point checks, with at most one allocation per
+ * output array, so the cost is linear in the total number of points.
+ *
+ * The header of the merged scan is the header of the first part. Time offsets
+ * of the other parts are shifted by the difference of their stamps.
+ *
+ * The merged scan_layout stays regular if all parts are regular and continue
+ * each other, i.e. the first subscan of each part is one increment after the
+ * last subscan of the previous part (angles within 1e-6 rad, times exactly).
+ * Otherwise the merged offsets are explicit. Unlike extending the layout by
+ * ParsedScanLayout::AddOffset(), this never throws because of the layout.
+ *
+ * @param parts The partial scans in the order in which they are concatenated.
+ * @param msg The merged scan. Memory of its arrays is reused. It may be the
+ *            first part, whose points then stay in place and the other parts
+ *            are appended to them.
+ * @throws std::runtime_error If there are no parts, the parts are not
+ *         compatible, a part doesn't match its layout, or msg is one of the
+ *         parts other than the first one.
+ */
+void MergeScans(const std::vector<const MultiLayerLaserScan*>& parts, MultiLayerLaserScan& msg);
+
+/**
+ * @brief The same as the previous function, but the arrays of the first part
+ *        are moved into the merged scan and the others are appended to them.
+ */
+MultiLayerLaserScan MergeScans(std::vector<MultiLayerLaserScan>&& parts);
+
+/**
+ * @brief Concatenate the scan layouts of parts of a scan as MergeScans() does.
+ * @param layouts The scan_layouts of the parts.
+ * @param stampOffsetsNSec Stamp of each part relative to the stamp of the merged scan [ns].
+ * @param msg The merged scan_layout.
+ * @throws std::runtime_error If layouts are empty or the sizes don't match.
+ */
+void MergeScanLayouts(const std::vector<const ParsedScanLayout*>& layouts,
+    const std::vector<int64_t>& stampOffsetsNSec, ScanLayout& msg);
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_SCANMERGER_H
@@ -0,0 +1,140 @@
+#ifndef MULTILAYER_LASER_SCAN_SCANNEIGHBORHOOD_H
+#define MULTILAYER_LASER_SCAN_SCANNEIGHBORHOOD_H
+
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Neighbors of points given by the topology of the scan.
+ *
+ * Points of a scan form a grid: neighbors in a ring have adjacent subscan
+ * indices (columns), and neighbors across rings have adjacent indices within a
+ * subscan. So neighbors of a point can be enumerated directly in a window of
+ * the grid, without building any search structure, in O(window size).
+ *
+ * Columns of 360 degree scans wrap around, i.e. the last subscan neighbors the
+ * first one. This is detected from the scan layout: it has to have regular
+ * angular offsets with exclude_last whose range spans the full circle. Rings
+ * never wrap around.
+ */
+class ScanNeighborhood
+{
+  /**
+   * @param layout Layout of the scans. Wraparound is detected from it.
+   */
+  public: explicit ScanNeighborhood(const MultiLayerLaserScanLayout& layout);
+
+  /**
+   * @param scanLength Number of subscans (columns).
+   * @param subscanLength Number of points in a subscan (rings).
+   * @param wrapAround Whether the last subscan neighbors the first one.
+   */
+  public: ScanNeighborhood(size_t scanLength, size_t subscanLength, bool wrapAround);
+
+  public: virtual ~ScanNeighborhood() = default;
+
+  /**
+   * @return Whether the layout is a full 360 degree scan whose first and last
+   *         subscans are neighbors.
+   */
+  public: static bool DetectWrapAround(const MultiLayerLaserScanLayout& layout);
+
+  public: bool WrapsAround() const;
+  public: size_t GetScanLength() const;
+  public: size_t GetSubscanLength() const;
+
+  /**
+   * @brief Call callback(j) for the index j of each point in the window
+   *        centered at point i, except for i itself.
+   * @param i Index of the point. It is not checked.
+   * @param ringRadius Maximum distance of the neighbors in the subscan index.
+   * @param columnRadius Maximum distance of the neighbors in the scan index.
+   *
+   * The points are visited column by column, i.e. in the order of memory.
+   */
+  public: template<typename F>
+  void ForEachNeighbor(const size_t i, const size_t ringRadius, const size_t columnRadius, F&& callback) const
+  {
+    const auto column = i / this->subscanLength;
+    const auto ring = i % this->subscanLength;
+    const auto firstRing = ring > ringRadius ? ring - ringRadius : 0;
+    const auto lastRing = std::min(this->subscanLength - 1 - ring, ringRadius) + ring;
+
+    size_t firstColumn;
+    size_t numColumns;
+    if (this->wrapAround)
+    {
+      // each column is visited once even if the window is wider than the scan
+      const auto radius = std::min(columnRadius, (this->scanLength - 1) / 2);
+      numColumns = columnRadius >= this->scanLength / 2 ? this->scanLength : 2 * columnRadius + 1;
+      firstColumn = (column + this->scanLength - radius) % this->scanLength;
+    }
+    else
+    {
+      firstColumn = column > columnRadius ? column - columnRadius : 0;
+      numColumns = std::min(this->scanLength - 1 - column, columnRadius) + column - firstColumn + 1;
+    }
+
+    auto c = firstColumn;
+    for (size_t n = 0; n < numColumns; ++n)
+    {
+      const auto columnStart = c * this->subscanLength;
+      for (size_t r = firstRing; r <= lastRing; ++r)
+      {
+        const auto j = columnStart + r;
+        if (j != i)
+          callback(j);
+      }
+      if (++c == this->scanLength)
+        c = 0;
+    }
+  }
+
+  /**
+   * @brief Get indices of the points in the window centered at point i (see
+   *        ForEachNeighbor()).
+   * @param neighbors The output. It is cleared first.
+   * @return Number of neighbors.
+   * @throws std::out_of_range If i is not a valid index.
+   */
+  public: size_t GetNeighbors(size_t i, size_t ringRadius, size_t columnRadius,
+      std::vector<size_t>& neighbors) const;
+
+  /**
+   * @brief Get indices of the points in the window centered at point i whose
+   *        range differs from the range of i by at most maxRangeDifference.
+   *
+   * Points with non-finite ranges are never neighbors, and they have no
+   * neighbors.
+   * @param ranges Ranges of the points (e.g. MultiLayerLaserScan::ranges).
+   * @param neighbors The output. It is cleared first.
+   * @return Number of neighbors.
+   * @throws std::out_of_range If i is not a valid index.
+   */
+  public: size_t GetNeighbors(const float* ranges, size_t i, size_t ringRadius, size_t columnRadius,
+      float maxRangeDifference, std::vector<size_t>& neighbors) const;
+
+  /**
+   * @brief The same as the previous method, but also ignores points with range
+   *        outside of <range_min, range_max>.
+   * @throws std::runtime_error If the number of ranges doesn't match.
+   */
+  public: size_t GetNeighbors(const MultiLayerLaserScan& scan, size_t i, size_t ringRadius, size_t columnRadius,
+      float maxRangeDifference, std::vector<size_t>& neighbors) const;
+
+  protected: size_t scanLength;
+  protected: size_t subscanLength;
+  protected: bool wrapAround;
+};
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_SCANNEIGHBORHOOD_H
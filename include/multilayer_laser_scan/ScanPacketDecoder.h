@@ -0,0 +1,59 @@
+#ifndef MULTILAYER_LASER_SCAN_SCANPACKETDECODER_H
+#define MULTILAYER_LASER_SCAN_SCANPACKETDECODER_H
+
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+
+#include <ros/time.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace sensor_msgs
+{
+
+class ScanAssembler;
+
+/** Numeric parameters of a decoder, e.g. calibration tables. */
+typedef std::map<std::string, std::vector<double>> DecoderParameters;
+
+/**
+ * @brief Base class of pluginlib plugins decoding raw packets of a lidar.
+ *
+ * A decoder describes the subscan (one firing of all rays) of its lidar and
+ * appends each decoded firing to a ScanAssembler.
+ */
+class ScanPacketDecoder
+{
+  public: virtual ~ScanPacketDecoder() = default;
+
+  /**
+   * @brief Set parameters of the decoder. Unknown parameters are ignored.
+   * @throws std::runtime_error if a parameter has an invalid value.
+   */
+  public: virtual void Configure(const DecoderParameters& /*params*/) {}
+
+  /** @return Number of rays in one subscan. */
+  public: virtual size_t GetSubscanLength() const = 0;
+
+  /**
+   * @brief Fill the parts of the scan that do not change between scans, i.e.
+   *        range_min, range_max, subscan_layout, scan_offsets_during_subscan
+   *        and the fields and point_step of custom_data.
+   */
+  public: virtual void FillScanTemplate(MultiLayerLaserScan& msg) const = 0;
+
+  /**
+   * @brief Decode the packet and append all its subscans to the assembler.
+   * @param data Raw packet data.
+   * @param size Size of the packet data [bytes].
+   * @param stamp Time of the first firing in the packet.
+   * @throws std::runtime_error if the packet is malformed.
+   */
+  public: virtual void Decode(const uint8_t* data, size_t size, const ros::Time& stamp,
+      ScanAssembler& assembler) const = 0;
+};
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_SCANPACKETDECODER_H
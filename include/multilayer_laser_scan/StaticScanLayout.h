@@ -0,0 +1,219 @@
+#ifndef MULTILAYER_LASER_SCAN_STATICSCANLAYOUT_H
+#define MULTILAYER_LASER_SCAN_STATICSCANLAYOUT_H
+
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+
+#include <vector>
+
+namespace sensor_msgs
+{
+
+// Policies describing one dimension of the scan layout without virtual calls.
+// They only hold pointers to the data of the parsed layout, so the layout has
+// to outlive them.
+
+struct RegularAngles
+{
+  explicit RegularAngles(const RegularAngularOffsets& offsets) :
+    first(offsets.GetFirstAngle()), increment(offsets.GetIncrement()) {}
+
+  inline double Get(const size_t i) const { return this->first + i * this->increment; }
+
+  double first;
+  double increment;
+};
+
+struct ExplicitAngles
+{
+  explicit ExplicitAngles(const ExplicitAngularOffsets& offsets) :
+    offsets(offsets.GetOffsets().data()) {}
+
+  inline double Get(const size_t i) const { return this->offsets[i]; }
+
+  const double* offsets;
+};
+
+struct VirtualAngles
+{
+  explicit VirtualAngles(const ParsedAngularOffsets& offsets) : offsets(&offsets) {}
+
+  inline double Get(const size_t i) const { return this->offsets->Get(i); }
+
+  const ParsedAngularOffsets* offsets;
+};
+
+struct RegularTimes
+{
+  explicit RegularTimes(const RegularTimeOffsets& offsets) :
+    baseOffset(offsets.GetBaseOffset().toNSec()), increment(offsets.GetIncrement().toNSec()) {}
+
+  inline int64_t GetNSec(const size_t i) const
+  {
+    return this->baseOffset + static_cast<int64_t>(i) * this->increment;
+  }
+
+  int64_t baseOffset;
+  int64_t increment;
+};
+
+struct ExplicitTimes
+{
+  explicit ExplicitTimes(const ExplicitTimeOffsets& offsets) :
+    offsets(offsets.GetOffsetsNSec().data()) {}
+
+  inline int64_t GetNSec(const size_t i) const { return this->offsets[i]; }
+
+  const int64_t* offsets;
+};
+
+struct VirtualTimes
+{
+  explicit VirtualTimes(const ParsedTimeOffsets& offsets) : offsets(&offsets) {}
+
+  inline int64_t GetNSec(const size_t i) const { return this->offsets->GetNSec(i); }
+
+  const ParsedTimeOffsets* offsets;
+};
+
+/**
+ * @brief A ParsedScanLayout whose regular/explicit representation is fixed
+ *        at compile time, so that accessing the offsets can be inlined.
+ * @tparam Angles One of RegularAngles, ExplicitAngles or VirtualAngles.
+ * @tparam Times One of RegularTimes, ExplicitTimes or VirtualTimes.
+ */
+template<typename Angles, typename Times>
+class StaticScanLayout
+{
+  public: StaticScanLayout(const Angles& _angles, const Times& _times, const size_t _length) :
+    angles(_angles), times(_times), length(_length) {}
+
+  public: inline double GetAngle(const size_t i) const { return this->angles.Get(i); }
+  public: inline int64_t GetTimeNSec(const size_t i) const { return this->times.GetNSec(i); }
+  public: inline size_t Length() const { return this->length; }
+
+  protected: Angles angles;
+  protected: Times times;
+  protected: size_t length;
+};
+
+/**
+ * @brief Angles and times of the points of one subscan. Subscans are short
+ *        (tens of points), so it is cheapest to just tabulate them.
+ */
+struct SubscanTable
+{
+  explicit SubscanTable(const MultiLayerLaserScanLayout& layout)
+  {
+    const auto& subscanLayout = layout.GetSubscanLayout();
+    const auto& scanOffsets = layout.GetScanOffsetsDuringSubscan();
+    const auto length = layout.GetSubscanLength();
+
+    this->angles.resize(length);
+    this->scanAngleOffsets.resize(length);
+    this->timeOffsets.resize(length);
+    for (size_t i = 0; i < length; ++i)
+    {
+      this->angles[i] = subscanLayout.GetAngle(i);
+      this->scanAngleOffsets[i] = scanOffsets.Get(i);
+      this->timeOffsets[i] = subscanLayout.GetTimeNSec(i);
+    }
+  }
+
+  std::vector<double> angles;
+  std::vector<double> scanAngleOffsets;
+  std::vector<int64_t> timeOffsets;  // nanoseconds
+};
+
+namespace impl
+{
+
+template<typename ScanLayoutType, typename F>
+void forEachPoint(const ScanLayoutType& scanLayout, const SubscanTable& subscans,
+    const size_t firstScan, const size_t lastScan, F& fn)
+{
+  const auto subscanLength = subscans.angles.size();
+  const auto* const subscanAngles = subscans.angles.data();
+  const auto* const scanAngleOffsets = subscans.scanAngleOffsets.data();
+  const auto* const subscanTimes = subscans.timeOffsets.data();
+
+  size_t i = firstScan * subscanLength;
+  for (size_t scanIndex = firstScan; scanIndex < lastScan; ++scanIndex)
+  {
+    const auto scanAngle = scanLayout.GetAngle(scanIndex);
+    const auto scanTime = scanLayout.GetTimeNSec(scanIndex);
+    for (size_t subscanIndex = 0; subscanIndex < subscanLength; ++subscanIndex, ++i)
+    {
+      fn(i, scanAngle + scanAngleOffsets[subscanIndex], subscanAngles[subscanIndex],
+         scanTime + subscanTimes[subscanIndex]);
+    }
+  }
+}
+
+template<typename Angles, typename Times, typename F>
+void forEachPoint(const Angles& angles, const Times& times, const MultiLayerLaserScanLayout& layout,
+    const size_t firstScan, const size_t lastScan, F& fn)
+{
+  const StaticScanLayout<Angles, Times> scanLayout(angles, times, layout.GetScanLength());
+  forEachPoint(scanLayout, SubscanTable(layout), firstScan, lastScan, fn);
+}
+
+template<typename Angles, typename F>
+void forEachPoint(const Angles& angles, const MultiLayerLaserScanLayout& layout,
+    const size_t firstScan, const size_t lastScan, F& fn)
+{
+  const auto& timeOffsets = layout.GetScanLayout().GetTimeOffsets();
+  if (const auto* regular = dynamic_cast<const RegularTimeOffsets*>(&timeOffsets))
+    forEachPoint(angles, RegularTimes(*regular), layout, firstScan, lastScan, fn);
+  else if (const auto* explicitOffsets = dynamic_cast<const ExplicitTimeOffsets*>(&timeOffsets))
+    forEachPoint(angles, ExplicitTimes(*explicitOffsets), layout, firstScan, lastScan, fn);
+  else
+    forEachPoint(angles, VirtualTimes(timeOffsets), layout, firstScan, lastScan, fn);
+}
+
+}
+
+/**
+ * @brief Call fn for all points of the given subscans (i.e. points with index
+ *        from firstScan * subscanLength to lastScan * subscanLength).
+ *
+ * The regular/explicit representation of the scan layout is resolved once
+ * and the loop is instantiated for each combination, so that no virtual calls
+ * are done per point. Use this instead of GetAll() in tight loops.
+ *
+ * @param fn Callable with signature
+ *           void(size_t i, double scanAngle, double subscanAngle, int64_t timeOffsetNSec).
+ *           The time offset is relative to the header stamp of the scan.
+ * @note The angles and times are read from the parsed offsets, so overrides
+ *       of the protected Get*ByIndex() methods of MultiLayerLaserScanLayout
+ *       are not taken into account.
+ */
+template<typename F>
+void ForEachPointInScans(const MultiLayerLaserScanLayout& layout,
+    const size_t firstScan, const size_t lastScan, F&& fn)
+{
+  if (firstScan > lastScan || lastScan > layout.GetScanLength())
+    throw std::out_of_range("Requested subscans are outside of the current layout.");
+
+  const auto& angularOffsets = layout.GetScanLayout().GetAngularOffsets();
+  if (const auto* regular = dynamic_cast<const RegularAngularOffsets*>(&angularOffsets))
+    impl::forEachPoint(RegularAngles(*regular), layout, firstScan, lastScan, fn);
+  else if (const auto* explicitOffsets = dynamic_cast<const ExplicitAngularOffsets*>(&angularOffsets))
+    impl::forEachPoint(ExplicitAngles(*explicitOffsets), layout, firstScan, lastScan, fn);
+  else
+    impl::forEachPoint(VirtualAngles(angularOffsets),
+                       VirtualTimes(layout.GetScanLayout().GetTimeOffsets()),
+                       layout, firstScan, lastScan, fn);
+}
+
+/**
+ * @brief Call fn for all points of the layout. See ForEachPointInScans().
+ */
+template<typename F>
+void ForEachPoint(const MultiLayerLaserScanLayout& layout, F&& fn)
+{
+  ForEachPointInScans(layout, 0, layout.GetScanLength(), std::forward<F>(fn));
+}
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_STATICSCANLAYOUT_H
@@ -0,0 +1,166 @@
+#ifndef MULTILAYER_LASER_SCAN_SUBSCANVIEW_H
+#define MULTILAYER_LASER_SCAN_SUBSCANVIEW_H
+
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief A contiguous range of subscans (columns) of a scan, e.g. an angular
+ *        sector or a time window, without copying the scan.
+ *
+ * Points are stored subscan by subscan, so a range of subscans is a contiguous
+ * range of points. Sector() and TimeWindow() select the subscans by the angles
+ * and time offsets of scan_layout, which have to be monotonic. The range is
+ * computed in closed form for regular offsets and by binary search for explicit
+ * ones, so no point is visited. Note that points of a selected subscan may lie
+ * slightly outside of the sector or time window because of subscan_layout
+ * time offsets and scan_offsets_during_subscan.
+ *
+ * The view refers to the scan and its layout, so the scan has to outlive it.
+ *
+ * <PRE>
+ *   const auto layout = sensor_msgs::LayoutCache::Instance().Get(msg);
+ *   // the forward +-60 degrees of a scan running from -pi to pi
+ *   const auto front = sensor_msgs::SubScanView::Sector(msg, layout, -M_PI / 3, M_PI / 3);
+ *   for (auto it = front.begin(); it != front.end(); ++it)
+ *     ...
+ *   // a scan running from 0 to 2 pi starts in the middle of this sector, so Sector()
+ *   // throws there; SplitSector() returns its two parts instead
+ *   for (const auto& part : sensor_msgs::SubScanView::SplitSector(msg, layout, -M_PI / 3, M_PI / 3))
+ *     for (auto it = part.begin(); it != part.end(); ++it)
+ *       ...
+ *   // the last 20 ms of the sweep
+ *   const auto sweepEnd = msg.header.stamp + layout->GetTime(layout->Length() - 1);
+ *   const auto last = sensor_msgs::SubScanView::TimeWindow(msg, layout, sweepEnd - ros::Duration(0.02), sweepEnd);
+ * </PRE>
+ */
+class SubScanView
+{
+  /**
+   * @brief View of subscans firstScan to endScan (exclusive) of the scan.
+   * @param layout Layout of the scan.
+   * @throws std::out_of_range If the subscans are not in the layout.
+   * @throws std::runtime_error If the layout doesn't match the scan.
+   */
+  public: SubScanView(const MultiLayerLaserScan& scan, std::shared_ptr<const MultiLayerLaserScanLayout> layout,
+      size_t firstScan, size_t endScan);
+
+  public: virtual ~SubScanView() = default;
+
+  /**
+   * @brief View of the subscans whose scan_layout angle is in
+   *        <minAngle, maxAngle> [rad].
+   *
+   * The sector is shifted by multiples of 2 pi to the angles of the layout, so
+   * e.g. <-pi/3, pi/3> works for layouts from -pi to pi as well as from 0 to
+   * 2 pi, as long as the selected subscans are contiguous.
+   * @throws std::runtime_error If minAngle > maxAngle or if the sector contains
+   *         both the first and the last subscan, but not the ones in between
+   *         (use SplitSector() then).
+   */
+  public: static SubScanView Sector(const MultiLayerLaserScan& scan,
+      std::shared_ptr<const MultiLayerLaserScanLayout> layout, double minAngle, double maxAngle);
+
+  /**
+   * @brief Like Sector(), but a sector which wraps around the start of the scan
+   *        is returned as two views.
+   * @return One view, or two: first the subscans from minAngle up to the
+   *         end (or start) of the scan, then the ones wrapped around it.
+   * @throws std::runtime_error If minAngle > maxAngle.
+   */
+  public: static std::vector<SubScanView> SplitSector(const MultiLayerLaserScan& scan,
+      const std::shared_ptr<const MultiLayerLaserScanLayout>& layout, double minAngle, double maxAngle);
+
+  /**
+   * @brief View of the subscans whose scan_layout time is in <start, end>.
+   * @throws std::runtime_error If start > end.
+   */
+  public: static SubScanView TimeWindow(const MultiLayerLaserScan& scan,
+      std::shared_ptr<const MultiLayerLaserScanLayout> layout, const ros::Time& start, const ros::Time& end);
+
+  /**
+   * @brief Find the range of subscans of Sector().
+   * @param scanLayout The scan_layout of the scan.
+   * @param endScan Output, exclusive. Equal to firstScan if no subscan is in the sector.
+   */
+  public: static void FindSector(const ParsedScanLayout& scanLayout, double minAngle, double maxAngle,
+      size_t& firstScan, size_t& endScan);
+
+  /**
+   * @brief Find the range of subscans with time offsets in <startNSec, endNSec>.
+   * @param scanLayout The scan_layout of the scan.
+   * @param endScan Output, exclusive. Equal to firstScan if no subscan is in the window.
+   */
+  public: static void FindTimeWindow(const ParsedScanLayout& scanLayout, int64_t startNSec, int64_t endNSec,
+      size_t& firstScan, size_t& endScan);
+
+  /**
+   * @brief Create scan_layout of subscans firstScan to endScan (exclusive) of
+   *        the given layout. Regular offsets stay regular.
+   * @throws std::out_of_range If the range is empty or not in the layout.
+   */
+  public: static void TrimScanLayout(const ParsedScanLayout& scanLayout, size_t firstScan, size_t endScan,
+      ScanLayout& msg);
+
+  /** @return Iterator at the first point of the view. */
+  public: MultiLayerLaserScanBaseFieldsConstIterator begin() const;
+
+  /**
+   * @return Iterator past the last point of the view.
+   * @note begin() and end() of the returned iterators cover the whole scan.
+   */
+  public: MultiLayerLaserScanBaseFieldsConstIterator end() const;
+
+  /**
+   * @brief Copy the viewed points into a scan with correspondingly trimmed
+   *        scan_layout. The header is kept, so the points have the same time
+   *        stamps as in the viewed scan. Memory of the output arrays is reused.
+   * @throws std::out_of_range If the view is empty.
+   */
+  public: void ToScan(MultiLayerLaserScan& msg) const;
+  public: MultiLayerLaserScan ToScan() const;
+
+  /**
+   * @return Layout of the trimmed scan, i.e. of the points of the view only.
+   *         Index 0 is GetFirstIndex() of the viewed scan. It is created on
+   *         the first call, which is not thread-safe.
+   * @throws std::out_of_range If the view is empty.
+   */
+  public: std::shared_ptr<const MultiLayerLaserScanLayout> GetLayout() const;
+
+  /** @return Layout of the whole viewed scan. */
+  public: const std::shared_ptr<const MultiLayerLaserScanLayout>& GetFullLayout() const;
+  public: const MultiLayerLaserScan& GetScan() const;
+
+  public: size_t GetFirstScan() const;
+  public: size_t GetEndScan() const;
+  /** @return Number of subscans of the view. */
+  public: size_t GetScanLength() const;
+  /** @return Index of the first point of the view in the whole scan. */
+  public: size_t GetFirstIndex() const;
+  /** @return Index past the last point of the view in the whole scan. */
+  public: size_t GetEndIndex() const;
+  /** @return Number of points of the view. */
+  public: size_t Length() const;
+  public: bool Empty() const;
+
+  protected: const MultiLayerLaserScan* scan;
+  protected: std::shared_ptr<const MultiLayerLaserScanLayout> fullLayout;
+  protected: size_t firstScan;
+  protected: size_t endScan;
+  protected: size_t subscanLength;
+  protected: mutable std::shared_ptr<const MultiLayerLaserScanLayout> layout;
+};
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_SUBSCANVIEW_H
@@ -0,0 +1,153 @@
+#ifndef MULTILAYER_LASER_SCAN_SYNTHETICSCANGENERATOR_H
+#define MULTILAYER_LASER_SCAN_SYNTHETICSCANGENERATOR_H
+
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+
+#include <Eigen/Core>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Infinite plane of points p with normal.dot(p) == distance.
+ */
+struct SyntheticPlane
+{
+  Eigen::Vector3d normal;
+  double distance;
+  float intensity;
+};
+
+/**
+ * @brief Axis-aligned box.
+ */
+struct SyntheticBox
+{
+  Eigen::Vector3d min;
+  Eigen::Vector3d max;
+  float intensity;
+};
+
+/**
+ * @brief Static scene observed by SyntheticScanGenerator, given in the frame
+ *        of the scans.
+ */
+struct SyntheticScene
+{
+  std::vector<SyntheticPlane> planes;
+  std::vector<SyntheticBox> boxes;
+
+  /** Standard deviation of the Gaussian noise added to ranges [m]. */
+  double rangeNoise = 0.0;
+
+  /** Probability that a ray gets no return at all. */
+  double dropoutProbability = 0.0;
+
+  /**
+   * @brief A square room with the sensor in its center, a floor sensorHeight
+   *        below the sensor, walls size/2 from it and a few boxes on the floor.
+   */
+  static SyntheticScene Room(double sensorHeight = 1.5, double size = 20.0);
+};
+
+/**
+ * @brief Generates scans of a synthetic scene by ray casting, so that tests,
+ *        benchmarks and load tests don't need recorded data.
+ *
+ * The layout of the scans is taken from a template scan, e.g. one of the
+ * presets returned by CreatePresetScan(). Ray directions are computed once
+ * from the layout; each generated scan is then just ray-plane and ray-box
+ * intersections of all points.
+ *
+ * Ranges (and intensities) are the closest hits. Rays that hit nothing or
+ * hit beyond range_max get +inf, rays that are dropped get NaN. If dual returns
+ * are enabled, custom_data get FLOAT32 fields "strongest" (range of the hit
+ * with the highest intensity) and "latest" (range of the farthest hit; the
+ * surfaces are treated as semi-transparent for it).
+ *
+ * Generating is deterministic for a given seed.
+ */
+class SyntheticScanGenerator
+{
+  /** @brief Scanners from the RealScanners tests. */
+  public: enum Preset
+  {
+    SICK_LMS151 = 0,
+    VELODYNE_HDL_32E = 1,
+    OUSTER_OS1_64 = 2,
+    RSLIDAR_32 = 3,
+  };
+
+  /**
+   * @param layoutScan A scan with the layout and range limits of the generated
+   *                   scans. Only the number of its ranges is used, intensities
+   *                   and custom data are ignored.
+   * @param scene The observed scene.
+   * @param dualReturn Whether to add the dual return custom fields.
+   * @param seed Seed of the noise.
+   * @throws std::runtime_error If the layout is invalid or doesn't match the
+   *         number of ranges, or the scene has negative noise.
+   */
+  public: SyntheticScanGenerator(const MultiLayerLaserScan& layoutScan, SyntheticScene scene,
+      bool dualReturn = false, uint32_t seed = 0);
+
+  public: virtual ~SyntheticScanGenerator() = default;
+
+  /**
+   * @brief Generate a scan starting at the given time.
+   * @param scan The output. Memory of its arrays is reused, so generating into
+   *             the same message again does not allocate.
+   */
+  public: void Generate(const ros::Time& stamp, MultiLayerLaserScan& scan);
+
+  public: MultiLayerLaserScan Generate(const ros::Time& stamp);
+
+  public: const MultiLayerLaserScanLayout& GetLayout() const;
+  public: const SyntheticScene& GetScene() const;
+
+  /**
+   * @brief Create an empty scan with the layout of the given scanner.
+   * @param rate Rotation rate [Hz] which determines time offsets of the points.
+   *             If zero, the nominal rate of the scanner is used.
+   * @return The scan with ranges and intensities resized to the number of points.
+   * @throws std::runtime_error If the preset doesn't exist or rate is negative.
+   */
+  public: static MultiLayerLaserScan CreatePresetScan(Preset preset, double rate = 0.0);
+
+  /** @return The usual rotation rate of the scanner [Hz]. */
+  public: static double GetNominalRate(Preset preset);
+
+  /**
+   * @brief Parse names like "sick_lms151", "velodyne_hdl_32e", "ouster_os1_64"
+   *        or "rslidar_32" (case insensitive, "-" may be used instead of "_").
+   * @throws std::runtime_error If the name is unknown.
+   */
+  public: static Preset ParsePreset(const std::string& name);
+
+  protected: void CastRay(size_t i, float& first, float& firstIntensity, float& strongest, float& latest);
+
+  protected: MultiLayerLaserScan layoutScan;
+  protected: std::shared_ptr<MultiLayerLaserScanLayout> layout;
+  protected: SyntheticScene scene;
+  protected: bool dualReturn;
+
+  // unit ray directions of the points
+  protected: std::vector<float> dirX;
+  protected: std::vector<float> dirY;
+  protected: std::vector<float> dirZ;
+
+  protected: std::mt19937 generator;
+  protected: std::normal_distribution<float> noise;  // standard, scaled by rangeNoise
+  protected: std::uniform_real_distribution<double> dropout;
+};
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_SYNTHETICSCANGENERATOR_H
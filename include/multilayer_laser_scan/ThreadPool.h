@@ -0,0 +1,74 @@
+#ifndef MULTILAYER_LASER_SCAN_THREADPOOL_H
+#define MULTILAYER_LASER_SCAN_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief A fixed set of worker threads executing batches of indexed tasks.
+ *
+ * Run() blocks until all tasks of the batch are done. The calling thread
+ * executes tasks, too, so a pool with N threads has N - 1 workers. Tasks are
+ * handed out one by one from a shared counter, so the load is balanced even if
+ * the tasks take different time.
+ */
+class ThreadPool
+{
+  /**
+   * @param _numThreads Number of threads executing the tasks, including the
+   *                    thread calling Run(). 0 means the number of hardware
+   *                    threads.
+   */
+  public: explicit ThreadPool(size_t _numThreads = 0);
+  public: virtual ~ThreadPool();
+
+  /**
+   * @return The process-wide pool with one thread per hardware thread.
+   */
+  public: static ThreadPool& Instance();
+
+  /** @return Number of threads executing the tasks, including the caller. */
+  public: size_t NumThreads() const;
+
+  /**
+   * @brief Call task(i) for all i in [0, numTasks) and wait until all calls
+   *        finish.
+   * @note Calls from multiple threads are serialized. Calls from inside a
+   *       task of the same pool execute all tasks in the calling thread.
+   * @throws The first exception thrown by a task. The remaining tasks of the
+   *         batch are not started after an exception.
+   */
+  public: void Run(size_t numTasks, const std::function<void(size_t)>& task);
+
+  protected: virtual void WorkerLoop();
+  protected: virtual void RunTasks();
+
+  protected: std::vector<std::thread> workers;
+
+  protected: std::mutex runMutex;
+  protected: std::mutex mutex;
+  protected: std::condition_variable batchStarted;
+  protected: std::condition_variable batchFinished;
+
+  // state of the current batch, protected by mutex
+  protected: const std::function<void(size_t)>* task = nullptr;
+  protected: size_t numTasks = 0;
+  protected: size_t generation = 0;
+  protected: size_t busyWorkers = 0;
+  protected: bool stop = false;
+  protected: std::exception_ptr error;
+
+  protected: std::atomic<size_t> nextTask {0};
+};
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_THREADPOOL_H
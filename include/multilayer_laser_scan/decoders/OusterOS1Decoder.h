@@ -0,0 +1,56 @@
+#ifndef MULTILAYER_LASER_SCAN_OUSTEROS1DECODER_H
+#define MULTILAYER_LASER_SCAN_OUSTEROS1DECODER_H
+
+#include <multilayer_laser_scan/ScanPacketDecoder.h>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Decoder of lidar packets of Ouster OS1-64 (legacy packet format).
+ *
+ * A packet has 16 measurement blocks (columns), each with a timestamp,
+ * encoder count and range, signal and reflectivity of all 64 beams. One
+ * column is one subscan. Signal is stored as intensity and reflectivity as
+ * uint16 custom field "reflectivity". Columns with invalid status are skipped.
+ *
+ * The scan angle is measured counter-clockwise from the x axis of the sensor
+ * frame used by ouster_ros, which points to the back of the connector. The
+ * offset between the lidar and beam origins is neglected.
+ *
+ * Parameters:
+ *  - beam_altitude_angles: 64 elevations of the beams [deg]
+ *  - beam_azimuth_angles: 64 azimuth offsets of the beams [deg]
+ *  - range_min, range_max [m]
+ *
+ * Both angle tables are found in the sensor metadata. The defaults are
+ * nominal values.
+ */
+class OusterOS1Decoder : public ScanPacketDecoder
+{
+  public: static constexpr size_t COLUMNS_PER_PACKET = 16;
+  public: static constexpr size_t BEAMS = 64;
+  public: static constexpr size_t PIXEL_SIZE = 12;
+  public: static constexpr size_t COLUMN_HEADER_SIZE = 16;
+  public: static constexpr size_t COLUMN_SIZE = COLUMN_HEADER_SIZE + BEAMS * PIXEL_SIZE + 4;
+  public: static constexpr size_t PACKET_SIZE = COLUMNS_PER_PACKET * COLUMN_SIZE;
+  public: static constexpr uint32_t ENCODER_TICKS_PER_REV = 90112;
+  public: static constexpr uint32_t VALID_COLUMN_STATUS = 0xFFFFFFFF;
+
+  public: OusterOS1Decoder();
+
+  public: void Configure(const DecoderParameters& params) override;
+  public: size_t GetSubscanLength() const override;
+  public: void FillScanTemplate(MultiLayerLaserScan& msg) const override;
+  public: void Decode(const uint8_t* data, size_t size, const ros::Time& stamp,
+      ScanAssembler& assembler) const override;
+
+  protected: std::vector<double> beamAltitudeAngles;  // [rad]
+  protected: std::vector<double> beamAzimuthAngles;  // [rad]
+  protected: float rangeMin = 0.25f;
+  protected: float rangeMax = 120.0f;
+};
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_OUSTEROS1DECODER_H
@@ -0,0 +1,44 @@
+#ifndef MULTILAYER_LASER_SCAN_VELODYNEHDL32EDECODER_H
+#define MULTILAYER_LASER_SCAN_VELODYNEHDL32EDECODER_H
+
+#include <multilayer_laser_scan/ScanPacketDecoder.h>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Decoder of single-return data packets of Velodyne HDL-32E.
+ *
+ * A packet has 12 firing blocks, each with the azimuth of the firing and
+ * range and intensity of all 32 lasers. One firing block is one subscan. The
+ * scan angle is the negated azimuth, i.e. it is measured counter-clockwise
+ * from the x axis like in velodyne_pointcloud.
+ *
+ * Parameters: range_min, range_max [m], rpm (rotation speed used to compute
+ * the scan angle offsets of the lasers fired during one block).
+ */
+class VelodyneHDL32EDecoder : public ScanPacketDecoder
+{
+  public: static constexpr size_t PACKET_SIZE = 1206;
+  public: static constexpr size_t BLOCKS_PER_PACKET = 12;
+  public: static constexpr size_t BLOCK_SIZE = 100;
+  public: static constexpr size_t LASERS = 32;
+  public: static constexpr uint16_t BLOCK_FLAG = 0xEEFF;
+  public: static constexpr double DISTANCE_RESOLUTION = 0.002;  // [m]
+  public: static constexpr double LASER_FIRING_PERIOD = 1.152e-6;  // [s]
+  public: static constexpr double BLOCK_FIRING_PERIOD = 46.08e-6;  // [s]
+
+  public: void Configure(const DecoderParameters& params) override;
+  public: size_t GetSubscanLength() const override;
+  public: void FillScanTemplate(MultiLayerLaserScan& msg) const override;
+  public: void Decode(const uint8_t* data, size_t size, const ros::Time& stamp,
+      ScanAssembler& assembler) const override;
+
+  protected: float rangeMin = 0.9f;
+  protected: float rangeMax = 130.0f;
+  protected: double rpm = 600.0;
+};
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_VELODYNEHDL32EDECODER_H
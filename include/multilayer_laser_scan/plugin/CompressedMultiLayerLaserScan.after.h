@@ -0,0 +1,11 @@
+#ifndef MULTILAYER_LASER_SCAN_COMPRESSEDMULTILAYERLASERSCAN_AFTER_H
+#define MULTILAYER_LASER_SCAN_COMPRESSEDMULTILAYERLASERSCAN_AFTER_H
+
+namespace sensor_msgs
+{
+typedef multilayer_laser_scan::CompressedMultiLayerLaserScan CompressedMultiLayerLaserScan;
+typedef multilayer_laser_scan::CompressedMultiLayerLaserScanPtr CompressedMultiLayerLaserScanPtr;
+typedef multilayer_laser_scan::CompressedMultiLayerLaserScanConstPtr CompressedMultiLayerLaserScanConstPtr;
+}
+
+#endif //MULTILAYER_LASER_SCAN_COMPRESSEDMULTILAYERLASERSCAN_AFTER_H
@@ -11,6 +11,8 @@
 #include <multilayer_laser_scan/MultiLayerLaserScan.h>
 #include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
 
+#include <cstddef>
+#include <iterator>
 #include <memory>
 
 namespace sensor_msgs
@@ -29,11 +31,40 @@ struct MultiLayerLaserScanBaseFields
   ros::Time timestamp;
 };
 
+/**
+ * \brief Random-access iterator over the base fields of the points of a scan.
+ *
+ * Dereferencing returns MultiLayerLaserScanBaseFields by value (a proxy
+ * pointing into the scan), so the iterator models the C++20
+ * std::random_access_iterator concept, while for the legacy iterator
+ * requirements, its reference type is not a real reference.
+ */
 template<typename C, typename R, typename I>
 class MultiLayerLaserScanBaseFieldsIteratorBase
 {
+  public: typedef std::random_access_iterator_tag iterator_category;
+  public: typedef std::random_access_iterator_tag iterator_concept;
+  public: typedef MultiLayerLaserScanBaseFields<C, R, I> value_type;
+  public: typedef std::ptrdiff_t difference_type;
+  public: typedef MultiLayerLaserScanBaseFields<C, R, I> reference;
+  public: typedef void pointer;
+
+  /**
+   * @brief Create a singular iterator which can only be assigned to.
+   */
+  public: MultiLayerLaserScanBaseFieldsIteratorBase();
+
   public: MultiLayerLaserScanBaseFieldsIteratorBase(
-      C& scan, std::shared_ptr<MultiLayerLaserScanLayout> layout);
+      C& scan, std::shared_ptr<const MultiLayerLaserScanLayout> layout);
+
+  /**
+   * @brief Create an iterator pointing to the point with the given index.
+   * @param i Index of the point. Length() of the layout means the end.
+   */
+  public: MultiLayerLaserScanBaseFieldsIteratorBase(
+      C& scan, std::shared_ptr<const MultiLayerLaserScanLayout> layout, size_t i);
+
+  public: MultiLayerLaserScanBaseFieldsIteratorBase(const MultiLayerLaserScanBaseFieldsIteratorBase& iter) = default;
 
   virtual ~MultiLayerLaserScanBaseFieldsIteratorBase();
 
@@ -48,26 +79,69 @@ class MultiLayerLaserScanBaseFieldsIteratorBase
    */
   MultiLayerLaserScanBaseFields<C, R, I> operator *() const;
 
+  /** Dereference the iterator moved by n elements.
+   * @return the value n elements after the one to which the iterator is pointing
+   */
+  MultiLayerLaserScanBaseFields<C, R, I> operator [](difference_type n) const;
+
   /** Increase the iterator to the next element
    * @return a reference to the updated iterator
    */
   MultiLayerLaserScanBaseFieldsIteratorBase& operator ++();
+  MultiLayerLaserScanBaseFieldsIteratorBase operator ++(int);
+
+  /** Decrease the iterator to the previous element
+   * @return a reference to the updated iterator
+   */
+  MultiLayerLaserScanBaseFieldsIteratorBase& operator --();
+  MultiLayerLaserScanBaseFieldsIteratorBase operator --(int);
+
+  /** Move the iterator by n elements
+   * @return a reference to the updated iterator
+   */
+  MultiLayerLaserScanBaseFieldsIteratorBase& operator +=(difference_type n);
+  MultiLayerLaserScanBaseFieldsIteratorBase& operator -=(difference_type n);
+  MultiLayerLaserScanBaseFieldsIteratorBase operator +(difference_type n) const;
+  MultiLayerLaserScanBaseFieldsIteratorBase operator -(difference_type n) const;
+
+  /** Distance to another iterator over the same scan
+   * @return the number of elements between iter and this iterator
+   */
+  difference_type operator -(const MultiLayerLaserScanBaseFieldsIteratorBase& iter) const;
 
   /** Compare to another iterator
    * @return whether the current iterator points to a different address than the other one
    */
   bool operator !=(const MultiLayerLaserScanBaseFieldsIteratorBase& iter) const;
+  bool operator ==(const MultiLayerLaserScanBaseFieldsIteratorBase& iter) const;
+  bool operator <(const MultiLayerLaserScanBaseFieldsIteratorBase& iter) const;
+  bool operator >(const MultiLayerLaserScanBaseFieldsIteratorBase& iter) const;
+  bool operator <=(const MultiLayerLaserScanBaseFieldsIteratorBase& iter) const;
+  bool operator >=(const MultiLayerLaserScanBaseFieldsIteratorBase& iter) const;
+
+  /** Return the begin iterator
+   * @return the iterator pointing to the first point of the scan
+   */
+  MultiLayerLaserScanBaseFieldsIteratorBase begin() const;
 
   /** Return the end iterator
    * @return the end iterator (useful when performing normal iterator processing with ++)
    */
   MultiLayerLaserScanBaseFieldsIteratorBase end() const;
 
-  protected: C* scan;
-  protected: std::shared_ptr<MultiLayerLaserScanLayout> layout;
+  protected: C* scan = nullptr;
+  protected: std::shared_ptr<const MultiLayerLaserScanLayout> layout;
   protected: size_t i = 0;
 };
 
+template<typename C, typename R, typename I>
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I> operator +(
+    typename MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::difference_type n,
+    const MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>& iter)
+{
+  return iter + n;
+}
+
 typedef MultiLayerLaserScanBaseFieldsIteratorBase<MultiLayerLaserScan, float, float> MultiLayerLaserScanBaseFieldsIterator;
 typedef MultiLayerLaserScanBaseFieldsIteratorBase<const MultiLayerLaserScan, const float, const float> MultiLayerLaserScanBaseFieldsConstIterator;
 
@@ -256,13 +330,41 @@ class PointDataModifier
    *        internals of the PointData
    * @param n_fields the number of fields to add. The fields are given as
    *        strings: "xyz" (3 floats), "rgb" (3 uchar stacked in a float),
-   *        "rgba" (4 uchar stacked in a float)
+   *        "rgba" (4 uchar stacked in a float), "normal" (3 floats),
+   *        "ring" (uint16), "label" (uint8)
    * @return void
    *
    * WARNING: THIS FUNCTION DOES NOT ADD ANY PADDING
    */
   public: void setFieldsByString(size_t n_fields, ...);
 
+  /**
+   * @brief Function adding some fields after the existing fields of the
+   *        PointData and moving the existing point data to the new layout
+   * @param n_fields the number of fields to add. The fields are given as
+   *        strings like in setFieldsByString
+   * @return void
+   *
+   * The new fields are zero-initialized. The existing fields keep their
+   * offsets, only point_step grows.
+   * WARNING: THIS FUNCTION DOES NOT ADD ANY PADDING
+   */
+  public: void appendFieldsByString(size_t n_fields, ...);
+
+  /**
+   * @brief Find the field with the given name, or add it like
+   *        appendFieldsByString does (or setFieldsByString with host
+   *        endianness if there are no fields yet)
+   * @param fieldName the name of the field, one of those of setFieldsByString
+   * @param size If the PointData have no points yet, they are resized to this
+   *        number of points
+   * @return the field. Its datatype and count are not checked, because an
+   *         existing field may have been created by someone else.
+   * @throws std::runtime_error If the PointData have points, but not size of
+   *         them. Nothing is appended then.
+   */
+  public: const PointField& findOrAppendFieldByString(const std::string& fieldName, size_t size);
+
   protected: virtual bool addPointFieldByString(const std::string& fieldName,
       size_t& offset);
 
@@ -0,0 +1,174 @@
+#include <multilayer_laser_scan/CartesianProjection.h>
+#include <multilayer_laser_scan/Instrumentation.h>
+
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace sensor_msgs
+{
+
+namespace
+{
+
+/**
+ * Project one subscan. scanCos and scanSin are the cosine and sine of the
+ * subscan angle, the other arrays are indexed by ray.
+ */
+void projectSubscan(const float* __restrict ranges,
+    const float* __restrict cosCos, const float* __restrict cosSin, const float* __restrict sin,
+    const float scanCos, const float scanSin, const size_t length,
+    float* __restrict x, float* __restrict y, float* __restrict z)
+{
+  size_t i = 0;
+
+  // x = r (cos(a) cos(e) cos(o) - sin(a) cos(e) sin(o))
+  // y = r (sin(a) cos(e) cos(o) + cos(a) cos(e) sin(o))
+  // z = r sin(e)
+#if defined(__AVX__)
+  const auto c = _mm256_set1_ps(scanCos);
+  const auto s = _mm256_set1_ps(scanSin);
+  for (; i + 8 <= length; i += 8)
+  {
+    const auto r = _mm256_loadu_ps(ranges + i);
+    const auto cc = _mm256_loadu_ps(cosCos + i);
+    const auto cs = _mm256_loadu_ps(cosSin + i);
+#if defined(__FMA__)
+    const auto dirX = _mm256_fmsub_ps(c, cc, _mm256_mul_ps(s, cs));
+    const auto dirY = _mm256_fmadd_ps(s, cc, _mm256_mul_ps(c, cs));
+#else
+    const auto dirX = _mm256_sub_ps(_mm256_mul_ps(c, cc), _mm256_mul_ps(s, cs));
+    const auto dirY = _mm256_add_ps(_mm256_mul_ps(s, cc), _mm256_mul_ps(c, cs));
+#endif
+    _mm256_storeu_ps(x + i, _mm256_mul_ps(r, dirX));
+    _mm256_storeu_ps(y + i, _mm256_mul_ps(r, dirY));
+    _mm256_storeu_ps(z + i, _mm256_mul_ps(r, _mm256_loadu_ps(sin + i)));
+  }
+#elif defined(__SSE2__)
+  const auto c = _mm_set1_ps(scanCos);
+  const auto s = _mm_set1_ps(scanSin);
+  for (; i + 4 <= length; i += 4)
+  {
+    const auto r = _mm_loadu_ps(ranges + i);
+    const auto cc = _mm_loadu_ps(cosCos + i);
+    const auto cs = _mm_loadu_ps(cosSin + i);
+    const auto dirX = _mm_sub_ps(_mm_mul_ps(c, cc), _mm_mul_ps(s, cs));
+    const auto dirY = _mm_add_ps(_mm_mul_ps(s, cc), _mm_mul_ps(c, cs));
+    _mm_storeu_ps(x + i, _mm_mul_ps(r, dirX));
+    _mm_storeu_ps(y + i, _mm_mul_ps(r, dirY));
+    _mm_storeu_ps(z + i, _mm_mul_ps(r, _mm_loadu_ps(sin + i)));
+  }
+#endif
+
+  for (; i < length; ++i)
+  {
+    x[i] = ranges[i] * (scanCos * cosCos[i] - scanSin * cosSin[i]);
+    y[i] = ranges[i] * (scanSin * cosCos[i] + scanCos * cosSin[i]);
+    z[i] = ranges[i] * sin[i];
+  }
+}
+
+}
+
+CartesianProjection::CartesianProjection(const MultiLayerLaserScanLayout& layout) :
+  scanLength(layout.GetScanLength()), subscanLength(layout.GetSubscanLength())
+{
+  const auto& scanLayout = layout.GetScanLayout();
+  this->scanCos.resize(this->scanLength);
+  this->scanSin.resize(this->scanLength);
+  this->scanTimes.resize(this->scanLength);
+  for (size_t i = 0; i < this->scanLength; ++i)
+  {
+    const auto angle = scanLayout.GetAngle(i);
+    this->scanCos[i] = static_cast<float>(std::cos(angle));
+    this->scanSin[i] = static_cast<float>(std::sin(angle));
+    this->scanTimes[i] = scanLayout.GetTime(i).toSec();
+  }
+
+  const auto& subscanLayout = layout.GetSubscanLayout();
+  const auto& scanOffsets = layout.GetScanOffsetsDuringSubscan();
+  this->rayCosCos.resize(this->subscanLength);
+  this->rayCosSin.resize(this->subscanLength);
+  this->raySin.resize(this->subscanLength);
+  this->rayTimes.resize(this->subscanLength);
+  for (size_t i = 0; i < this->subscanLength; ++i)
+  {
+    const auto elevation = subscanLayout.GetAngle(i);
+    const auto offset = scanOffsets.Get(i);
+    this->rayCosCos[i] = static_cast<float>(std::cos(elevation) * std::cos(offset));
+    this->rayCosSin[i] = static_cast<float>(std::cos(elevation) * std::sin(offset));
+    this->raySin[i] = static_cast<float>(std::sin(elevation));
+    this->rayTimes[i] = static_cast<float>(subscanLayout.GetTime(i).toSec());
+  }
+}
+
+void CartesianProjection::Project(const MultiLayerLaserScan& scan,
+    float* x, float* y, float* z, float* t) const
+{
+  this->ProjectScans(scan, 0, this->scanLength, x, y, z, t);
+}
+
+void CartesianProjection::ProjectScans(const MultiLayerLaserScan& scan,
+    const size_t firstScan, const size_t lastScan, float* x, float* y, float* z, float* t) const
+{
+  MLS_INSTRUMENT_SCOPE(CARTESIAN_PROJECTION, (lastScan - firstScan) * this->subscanLength *
+    sizeof(float) * ((t != nullptr) ? 5 : 4));
+
+  if (scan.ranges.size() != this->Length())
+    throw std::runtime_error("Scan layout " + std::to_string(this->Length()) +
+      " size doesn't correspond to the number of actual points " +
+      std::to_string(scan.ranges.size()));
+
+  if (firstScan > lastScan || lastScan > this->scanLength)
+    throw std::out_of_range("Requested subscans are outside of the current layout.");
+
+  for (size_t scanIndex = firstScan; scanIndex < lastScan; ++scanIndex)
+  {
+    const auto offset = scanIndex * this->subscanLength;
+    this->ProjectSubscan(scan, scanIndex, x + offset, y + offset, z + offset,
+                         (t != nullptr) ? t + offset : nullptr);
+  }
+}
+
+void CartesianProjection::ProjectSubscan(const MultiLayerLaserScan& scan, const size_t scanIndex,
+    float* x, float* y, float* z, float* t) const
+{
+  projectSubscan(scan.ranges.data() + scanIndex * this->subscanLength,
+                 this->rayCosCos.data(), this->rayCosSin.data(), this->raySin.data(),
+                 this->scanCos[scanIndex], this->scanSin[scanIndex], this->subscanLength,
+                 x, y, z);
+
+  if (t != nullptr)
+  {
+    const auto scanTime = static_cast<float>(this->scanTimes[scanIndex]);
+    for (size_t i = 0; i < this->subscanLength; ++i)
+      t[i] = scanTime + this->rayTimes[i];
+  }
+}
+
+size_t CartesianProjection::Length() const
+{
+  return this->scanLength * this->subscanLength;
+}
+
+size_t CartesianProjection::GetScanLength() const
+{
+  return this->scanLength;
+}
+
+size_t CartesianProjection::GetSubscanLength() const
+{
+  return this->subscanLength;
+}
+
+void ProjectToCartesian(const MultiLayerLaserScan& scan, const MultiLayerLaserScanLayout& layout,
+    float* x, float* y, float* z, float* t)
+{
+  CartesianProjection(layout).Project(scan, x, y, z, t);
+}
+
+}
@@ -0,0 +1,144 @@
+#include <multilayer_laser_scan/CompressedScanIterator.h>
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace sensor_msgs
+{
+
+CompressedMultiLayerLaserScanBaseFieldsConstIterator::CompressedMultiLayerLaserScanBaseFieldsConstIterator() = default;
+
+CompressedMultiLayerLaserScanBaseFieldsConstIterator::CompressedMultiLayerLaserScanBaseFieldsConstIterator(
+    const CompressedMultiLayerLaserScan& scan,
+    std::shared_ptr<const MultiLayerLaserScanLayout> layout, const size_t i)
+    : scan(&scan), layout(std::move(layout)),
+      rangeEncoding(GetRangeEncoding(scan)), intensityEncoding(GetIntensityEncoding(scan)), i(i)
+{
+  for (const auto encoding : {this->rangeEncoding.encoding, this->intensityEncoding.encoding})
+    if (encoding != CompressedMultiLayerLaserScan::ENCODING_UINT16_SCALED &&
+        encoding != CompressedMultiLayerLaserScan::ENCODING_FLOAT16)
+      throw std::runtime_error("Unknown encoding " + std::to_string(encoding));
+  if (!scan.packed_ranges.empty())
+    throw std::runtime_error("Ranges of the scan are packed, call UnpackRanges() first");
+}
+
+CompressedMultiLayerLaserScanBaseFields CompressedMultiLayerLaserScanBaseFieldsConstIterator::operator*() const
+{
+  CompressedMultiLayerLaserScanBaseFields result;
+  ros::Duration timeOffset;
+
+  this->layout->GetAll(this->i, result.scanAngle, result.subscanAngle, timeOffset);
+
+  result.timestamp = this->scan->header.stamp + timeOffset;
+  result.range = DecodeValue(this->scan->ranges[this->i], this->rangeEncoding);
+  result.intensity = this->scan->intensities.empty() ?
+    std::numeric_limits<float>::quiet_NaN() :
+    DecodeValue(this->scan->intensities[this->i], this->intensityEncoding);
+
+  return result;
+}
+
+CompressedMultiLayerLaserScanBaseFields CompressedMultiLayerLaserScanBaseFieldsConstIterator::operator[](const difference_type n) const
+{
+  return *(*this + n);
+}
+
+CompressedMultiLayerLaserScanBaseFieldsConstIterator& CompressedMultiLayerLaserScanBaseFieldsConstIterator::operator++()
+{
+  ++this->i;
+  return *this;
+}
+
+CompressedMultiLayerLaserScanBaseFieldsConstIterator CompressedMultiLayerLaserScanBaseFieldsConstIterator::operator++(int)
+{
+  auto result = *this;
+  ++this->i;
+  return result;
+}
+
+CompressedMultiLayerLaserScanBaseFieldsConstIterator& CompressedMultiLayerLaserScanBaseFieldsConstIterator::operator--()
+{
+  --this->i;
+  return *this;
+}
+
+CompressedMultiLayerLaserScanBaseFieldsConstIterator CompressedMultiLayerLaserScanBaseFieldsConstIterator::operator--(int)
+{
+  auto result = *this;
+  --this->i;
+  return result;
+}
+
+CompressedMultiLayerLaserScanBaseFieldsConstIterator& CompressedMultiLayerLaserScanBaseFieldsConstIterator::operator+=(const difference_type n)
+{
+  this->i += n;
+  return *this;
+}
+
+CompressedMultiLayerLaserScanBaseFieldsConstIterator& CompressedMultiLayerLaserScanBaseFieldsConstIterator::operator-=(const difference_type n)
+{
+  this->i -= n;
+  return *this;
+}
+
+CompressedMultiLayerLaserScanBaseFieldsConstIterator CompressedMultiLayerLaserScanBaseFieldsConstIterator::operator+(const difference_type n) const
+{
+  auto result = *this;
+  result.i += n;
+  return result;
+}
+
+CompressedMultiLayerLaserScanBaseFieldsConstIterator CompressedMultiLayerLaserScanBaseFieldsConstIterator::operator-(const difference_type n) const
+{
+  auto result = *this;
+  result.i -= n;
+  return result;
+}
+
+CompressedMultiLayerLaserScanBaseFieldsConstIterator::difference_type CompressedMultiLayerLaserScanBaseFieldsConstIterator::operator-(const CompressedMultiLayerLaserScanBaseFieldsConstIterator& iter) const
+{
+  return static_cast<difference_type>(this->i) - static_cast<difference_type>(iter.i);
+}
+
+bool CompressedMultiLayerLaserScanBaseFieldsConstIterator::operator!=(const CompressedMultiLayerLaserScanBaseFieldsConstIterator& iter) const
+{
+  return this->i != iter.i;
+}
+
+bool CompressedMultiLayerLaserScanBaseFieldsConstIterator::operator==(const CompressedMultiLayerLaserScanBaseFieldsConstIterator& iter) const
+{
+  return this->i == iter.i;
+}
+
+bool CompressedMultiLayerLaserScanBaseFieldsConstIterator::operator<(const CompressedMultiLayerLaserScanBaseFieldsConstIterator& iter) const
+{
+  return this->i < iter.i;
+}
+
+bool CompressedMultiLayerLaserScanBaseFieldsConstIterator::operator>(const CompressedMultiLayerLaserScanBaseFieldsConstIterator& iter) const
+{
+  return this->i > iter.i;
+}
+
+bool CompressedMultiLayerLaserScanBaseFieldsConstIterator::operator<=(const CompressedMultiLayerLaserScanBaseFieldsConstIterator& iter) const
+{
+  return this->i <= iter.i;
+}
+
+bool CompressedMultiLayerLaserScanBaseFieldsConstIterator::operator>=(const CompressedMultiLayerLaserScanBaseFieldsConstIterator& iter) const
+{
+  return this->i >= iter.i;
+}
+
+CompressedMultiLayerLaserScanBaseFieldsConstIterator CompressedMultiLayerLaserScanBaseFieldsConstIterator::begin() const
+{
+  return CompressedMultiLayerLaserScanBaseFieldsConstIterator(*this->scan, this->layout, 0);
+}
+
+CompressedMultiLayerLaserScanBaseFieldsConstIterator CompressedMultiLayerLaserScanBaseFieldsConstIterator::end() const
+{
+  return CompressedMultiLayerLaserScanBaseFieldsConstIterator(*this->scan, this->layout, this->layout->Length());
+}
+
+}
@@ -0,0 +1,166 @@
+#include <multilayer_laser_scan/Deskew.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace sensor_msgs
+{
+
+BufferedPoseSource::BufferedPoseSource(const ros::Duration& _maxAge) : maxAge(_maxAge)
+{
+}
+
+void BufferedPoseSource::AddPose(const ros::Time& stamp, const Eigen::Isometry3d& pose)
+{
+  Entry entry;
+  entry.stamp = stamp;
+  entry.rotation = Eigen::Quaterniond(pose.rotation());
+  entry.translation = pose.translation();
+
+  const auto position = std::upper_bound(this->poses.begin(), this->poses.end(), stamp,
+    [](const ros::Time& time, const Entry& e) { return time < e.stamp; });
+  this->poses.insert(position, entry);
+
+  while (this->poses.back().stamp - this->poses.front().stamp > this->maxAge)
+    this->poses.pop_front();
+}
+
+Eigen::Isometry3d BufferedPoseSource::GetPose(const ros::Time& time) const
+{
+  if (this->poses.empty() || time < this->poses.front().stamp || time > this->poses.back().stamp)
+    throw std::out_of_range("Pose at the requested time is not in the buffer.");
+
+  // the first pose newer than time, or the last pose
+  auto next = std::upper_bound(this->poses.begin(), this->poses.end(), time,
+    [](const ros::Time& t, const Entry& e) { return t < e.stamp; });
+  if (next == this->poses.end())
+    --next;
+  const auto prev = (next == this->poses.begin()) ? next : std::prev(next);
+
+  Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+  if (prev == next || next->stamp == prev->stamp)
+  {
+    pose.linear() = next->rotation.toRotationMatrix();
+    pose.translation() = next->translation;
+    return pose;
+  }
+
+  const auto ratio = (time - prev->stamp).toSec() / (next->stamp - prev->stamp).toSec();
+  pose.linear() = prev->rotation.slerp(ratio, next->rotation).toRotationMatrix();
+  pose.translation() = prev->translation + ratio * (next->translation - prev->translation);
+  return pose;
+}
+
+size_t BufferedPoseSource::Size() const
+{
+  return this->poses.size();
+}
+
+void BufferedPoseSource::Clear()
+{
+  this->poses.clear();
+}
+
+ConstantTwistPoseSource::ConstantTwistPoseSource(const Eigen::Vector3d& _linear, const Eigen::Vector3d& _angular,
+    const ros::Time& _referenceTime) :
+  linear(_linear), angular(_angular), referenceTime(_referenceTime)
+{
+}
+
+Eigen::Isometry3d ConstantTwistPoseSource::GetPose(const ros::Time& time) const
+{
+  // exponential map of the twist integrated over dt
+  const auto dt = (time - this->referenceTime).toSec();
+  const Eigen::Vector3d rotationVector = this->angular * dt;
+  const Eigen::Vector3d translationVector = this->linear * dt;
+  const auto angle = rotationVector.norm();
+
+  Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+  if (angle < 1e-10)
+  {
+    pose.translation() = translationVector;
+    return pose;
+  }
+
+  const Eigen::Vector3d axis = rotationVector / angle;
+  pose.linear() = Eigen::AngleAxisd(angle, axis).toRotationMatrix();
+
+  Eigen::Matrix3d skew;
+  skew << 0, -axis.z(), axis.y(),
+          axis.z(), 0, -axis.x(),
+          -axis.y(), axis.x(), 0;
+  const Eigen::Matrix3d v = Eigen::Matrix3d::Identity() + (1 - std::cos(angle)) / angle * skew +
+    (angle - std::sin(angle)) / angle * skew * skew;
+  pose.translation() = v * translationVector;
+
+  return pose;
+}
+
+Deskewer::Deskewer(const MultiLayerLaserScanLayout& layout) : projection(layout)
+{
+  const auto scanLength = layout.GetScanLength();
+  const auto subscanLength = layout.GetSubscanLength();
+
+  int64_t meanRayTime = 0;
+  for (size_t i = 0; i < subscanLength; ++i)
+    meanRayTime += layout.GetSubscanLayout().GetTimeNSec(i);
+  if (subscanLength > 0)
+    meanRayTime /= static_cast<int64_t>(subscanLength);
+
+  this->subscanTimes.resize(scanLength);
+  for (size_t i = 0; i < scanLength; ++i)
+    this->subscanTimes[i] = layout.GetScanLayout().GetTimeNSec(i) + meanRayTime;
+}
+
+void Deskewer::Deskew(const MultiLayerLaserScan& scan, const PoseSource& poses,
+    const ros::Time& referenceTime, float* x, float* y, float* z) const
+{
+  const auto scanLength = this->projection.GetScanLength();
+  const auto subscanLength = this->projection.GetSubscanLength();
+  if (scan.ranges.size() != this->Length())
+    throw std::runtime_error("The scan has " + std::to_string(scan.ranges.size()) +
+      " ranges, but the layout has " + std::to_string(this->Length()) + " points.");
+
+  const Eigen::Isometry3d referenceInverse = poses.GetPose(referenceTime).inverse();
+
+  for (size_t scanIndex = 0; scanIndex < scanLength; ++scanIndex)
+  {
+    const auto offset = scanIndex * subscanLength;
+    float* const xs = x + offset;
+    float* const ys = y + offset;
+    float* const zs = z + offset;
+    this->projection.ProjectSubscan(scan, scanIndex, xs, ys, zs);
+
+    ros::Duration timeOffset;
+    timeOffset.fromNSec(this->subscanTimes[scanIndex]);
+    const Eigen::Isometry3f transform = (referenceInverse * poses.GetPose(scan.header.stamp + timeOffset)).cast<float>();
+
+    const auto& r = transform.linear();
+    const auto& t = transform.translation();
+    const float r00 = r(0, 0), r01 = r(0, 1), r02 = r(0, 2);
+    const float r10 = r(1, 0), r11 = r(1, 1), r12 = r(1, 2);
+    const float r20 = r(2, 0), r21 = r(2, 1), r22 = r(2, 2);
+    const float t0 = t.x(), t1 = t.y(), t2 = t.z();
+
+    for (size_t i = 0; i < subscanLength; ++i)
+    {
+      const auto px = xs[i], py = ys[i], pz = zs[i];
+      xs[i] = r00 * px + r01 * py + r02 * pz + t0;
+      ys[i] = r10 * px + r11 * py + r12 * pz + t1;
+      zs[i] = r20 * px + r21 * py + r22 * pz + t2;
+    }
+  }
+}
+
+void Deskewer::Deskew(const MultiLayerLaserScan& scan, const PoseSource& poses,
+    float* x, float* y, float* z) const
+{
+  this->Deskew(scan, poses, scan.header.stamp, x, y, z);
+}
+
+size_t Deskewer::Length() const
+{
+  return this->projection.Length();
+}
+
+}
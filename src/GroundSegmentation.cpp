@@ -0,0 +1,120 @@
+#include <multilayer_laser_scan/GroundSegmentation.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace sensor_msgs
+{
+
+GroundSegmentation::GroundSegmentation(const MultiLayerLaserScanLayout& layout, const float sensorHeight,
+    const float maxSlope, const float heightTolerance)
+  : scanLength(layout.GetScanLength()), subscanLength(layout.GetSubscanLength()), sensorHeight(sensorHeight),
+    tanMaxSlope(std::tan(maxSlope)), heightTolerance(heightTolerance)
+{
+  if (!(maxSlope >= 0) || !(maxSlope < M_PI_2))
+    throw std::runtime_error("Maximum ground slope has to be in <0, pi/2)");
+
+  const auto& subscanLayout = layout.GetSubscanLayout();
+  std::vector<double> elevations(this->subscanLength);
+  for (size_t i = 0; i < this->subscanLength; ++i)
+    elevations[i] = subscanLayout.GetAngle(i);
+
+  this->rayOrder.resize(this->subscanLength);
+  std::iota(this->rayOrder.begin(), this->rayOrder.end(), 0);
+  std::stable_sort(this->rayOrder.begin(), this->rayOrder.end(), [&](const uint32_t a, const uint32_t b)
+  {
+    return elevations[a] < elevations[b];
+  });
+
+  this->rayCos.resize(this->subscanLength);
+  this->raySin.resize(this->subscanLength);
+  for (size_t k = 0; k < this->subscanLength; ++k)
+  {
+    const auto elevation = elevations[this->rayOrder[k]];
+    this->rayCos[k] = static_cast<float>(std::cos(elevation));
+    this->raySin[k] = static_cast<float>(std::sin(elevation));
+  }
+}
+
+void GroundSegmentation::Segment(const MultiLayerLaserScan& scan, uint8_t* labels) const
+{
+  const auto length = this->scanLength * this->subscanLength;
+  if (scan.ranges.size() != length)
+    throw std::runtime_error("The scan has " + std::to_string(scan.ranges.size()) +
+        " ranges, but its layout has " + std::to_string(length) + " points");
+
+  this->SegmentScans(scan, 0, this->scanLength, labels);
+}
+
+void GroundSegmentation::Segment(MultiLayerLaserScan& scan) const
+{
+  const auto length = this->scanLength * this->subscanLength;
+  if (scan.ranges.size() != length)
+    throw std::runtime_error("The scan has " + std::to_string(scan.ranges.size()) +
+        " ranges, but its layout has " + std::to_string(length) + " points");
+
+  auto& data = scan.custom_data;
+  const auto& field = PointDataModifier(data).findOrAppendFieldByString("label", length);
+
+  if (field.datatype != PointField::UINT8 || field.count != 1)
+    throw std::runtime_error("Field label has to have 1 UINT8 element");
+
+  this->SegmentScans(scan, 0, this->scanLength, data.data.data() + field.offset, data.point_step);
+}
+
+void GroundSegmentation::SegmentScans(const MultiLayerLaserScan& scan, const size_t firstScan,
+    const size_t endScan, uint8_t* labels, const size_t stride) const
+{
+  if (firstScan > endScan || endScan > this->scanLength)
+    throw std::out_of_range("Requested subscans are outside of the current layout.");
+
+  const auto rangeMin = scan.range_min;
+  const auto rangeMax = scan.range_max;
+  const auto order = this->rayOrder.data();
+  const auto cosines = this->rayCos.data();
+  const auto sines = this->raySin.data();
+
+  for (size_t scanIndex = firstScan; scanIndex < endScan; ++scanIndex)
+  {
+    const auto offset = scanIndex * this->subscanLength;
+    const auto ranges = scan.ranges.data() + offset;
+    const auto columnLabels = labels + offset * stride;
+
+    // the last ground point of the column
+    float groundDistance = 0;
+    float groundHeight = -this->sensorHeight;
+
+    for (size_t k = 0; k < this->subscanLength; ++k)
+    {
+      const auto ray = order[k];
+      const auto range = ranges[ray];
+      auto& label = columnLabels[ray * stride];
+      // NaNs fail both comparisons
+      if (!(range >= rangeMin && range <= rangeMax))
+      {
+        label = INVALID;
+        continue;
+      }
+
+      const auto distance = range * cosines[k];
+      const auto height = range * sines[k];
+      const auto run = distance - groundDistance;
+      if (run > 0 && std::abs(height - groundHeight) <= this->tanMaxSlope * run + this->heightTolerance)
+      {
+        label = GROUND;
+        groundDistance = distance;
+        groundHeight = height;
+      }
+      else
+      {
+        label = NON_GROUND;
+      }
+    }
+  }
+}
+
+}
@@ -0,0 +1,374 @@
+#include <multilayer_laser_scan/Instrumentation.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+namespace sensor_msgs
+{
+
+namespace instrumentation
+{
+
+namespace
+{
+
+const char* const stageNames[NUM_STAGES] = {
+  "layout_parse",
+  "layout_materialize",
+  "layout_cache_get",
+  "iterator_create",
+  "point_data_modify",
+  "cartesian_projection",
+  "scan_to_point_cloud2",
+  "point_cloud2_to_scan",
+  "scan_merge",
+};
+
+struct StageCounters
+{
+  std::atomic<uint64_t> calls {0};
+  std::atomic<uint64_t> timedCalls {0};
+  std::atomic<uint64_t> bytes {0};
+  std::atomic<uint64_t> totalNSec {0};
+  std::array<std::atomic<uint64_t>, NUM_LATENCY_BUCKETS> latencyHistogram {};
+};
+
+typedef std::array<StageCounters, NUM_STAGES> ThreadCounters;
+
+/**
+ * Only the owning thread writes its counters, so a relaxed load and store is
+ * enough and avoids the locked instruction of fetch_add. Other threads only
+ * read them in Collect().
+ */
+inline void add(std::atomic<uint64_t>& counter, const uint64_t value)
+{
+  counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+std::vector<StageStatistics> createStatistics()
+{
+  std::vector<StageStatistics> statistics(NUM_STAGES);
+  for (size_t s = 0; s < NUM_STAGES; ++s)
+    statistics[s].stage = static_cast<Stage>(s);
+  return statistics;
+}
+
+void accumulate(const ThreadCounters& counters, std::vector<StageStatistics>& statistics)
+{
+  for (size_t s = 0; s < NUM_STAGES; ++s)
+  {
+    const auto& source = counters[s];
+    auto& target = statistics[s];
+    target.calls += source.calls.load(std::memory_order_relaxed);
+    target.timedCalls += source.timedCalls.load(std::memory_order_relaxed);
+    target.bytes += source.bytes.load(std::memory_order_relaxed);
+    target.totalNSec += source.totalNSec.load(std::memory_order_relaxed);
+    for (size_t b = 0; b < NUM_LATENCY_BUCKETS; ++b)
+      target.latencyHistogram[b] += source.latencyHistogram[b].load(std::memory_order_relaxed);
+  }
+}
+
+/**
+ * Counters of all live threads plus the sums of the finished ones.
+ */
+class Registry
+{
+  public: static Registry& Instance()
+  {
+    // never destroyed, so that threads finishing during static destruction
+    // (e.g. of a static thread pool) can still unregister
+    static auto* const instance = new Registry;
+    return *instance;
+  }
+
+  public: void Add(const ThreadCounters* counters)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->threads.push_back(counters);
+  }
+
+  public: void Remove(const ThreadCounters* counters)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    accumulate(*counters, this->finished);
+    this->threads.erase(std::remove(this->threads.begin(), this->threads.end(), counters), this->threads.end());
+  }
+
+  public: std::vector<StageStatistics> Sum()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto statistics = this->SumLocked();
+    for (size_t s = 0; s < NUM_STAGES; ++s)
+    {
+      auto& target = statistics[s];
+      const auto& base = this->baseline[s];
+      target.calls -= base.calls;
+      target.timedCalls -= base.timedCalls;
+      target.bytes -= base.bytes;
+      target.totalNSec -= base.totalNSec;
+      for (size_t b = 0; b < NUM_LATENCY_BUCKETS; ++b)
+        target.latencyHistogram[b] -= base.latencyHistogram[b];
+    }
+    return statistics;
+  }
+
+  public: void Reset()
+  {
+    // the counters are owned by their threads, so they are not zeroed, only
+    // remembered and subtracted from the later sums
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->baseline = this->SumLocked();
+  }
+
+  protected: Registry() : finished(createStatistics()), baseline(createStatistics())
+  {
+  }
+
+  protected: std::vector<StageStatistics> SumLocked() const
+  {
+    auto statistics = this->finished;
+    for (const auto* counters : this->threads)
+      accumulate(*counters, statistics);
+    return statistics;
+  }
+
+  protected: std::mutex mutex;
+  protected: std::vector<const ThreadCounters*> threads;
+  protected: std::vector<StageStatistics> finished;
+  protected: std::vector<StageStatistics> baseline;
+};
+
+struct ThreadSlot
+{
+  ThreadSlot()
+  {
+    Registry::Instance().Add(&this->counters);
+  }
+
+  ~ThreadSlot()
+  {
+    Registry::Instance().Remove(&this->counters);
+  }
+
+  ThreadCounters counters;
+};
+
+inline ThreadCounters& localCounters()
+{
+  thread_local ThreadSlot slot;
+  return slot.counters;
+}
+
+std::string formatMicroseconds(const double nsec)
+{
+  std::stringstream stream;
+  stream << std::fixed << std::setprecision(1) << nsec * 1e-3;
+  return stream.str();
+}
+
+diagnostic_msgs::KeyValue createKeyValue(const std::string& key, const std::string& value)
+{
+  diagnostic_msgs::KeyValue keyValue;
+  keyValue.key = key;
+  keyValue.value = value;
+  return keyValue;
+}
+
+}
+
+double StageStatistics::MeanNSec() const
+{
+  if (this->timedCalls == 0)
+    return 0.0;
+  return static_cast<double>(this->totalNSec) / static_cast<double>(this->timedCalls);
+}
+
+uint64_t StageStatistics::PercentileNSec(const double percentile) const
+{
+  if (this->timedCalls == 0)
+    return 0;
+
+  const auto clamped = std::min(std::max(percentile, 0.0), 100.0);
+  const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(
+    std::ceil(clamped / 100.0 * static_cast<double>(this->timedCalls))));
+
+  uint64_t count = 0;
+  for (size_t b = 0; b < NUM_LATENCY_BUCKETS; ++b)
+  {
+    count += this->latencyHistogram[b];
+    if (count >= rank)
+      return uint64_t(1) << (b + 1);
+  }
+  return uint64_t(1) << NUM_LATENCY_BUCKETS;
+}
+
+const char* GetStageName(const Stage stage)
+{
+  if (stage >= NUM_STAGES)
+    throw std::out_of_range("Unknown instrumentation stage " + std::to_string(stage));
+  return stageNames[stage];
+}
+
+bool IsEnabled()
+{
+#ifdef MULTILAYER_LASER_SCAN_INSTRUMENTATION
+  return true;
+#else
+  return false;
+#endif
+}
+
+size_t GetLatencyBucket(const uint64_t nsec)
+{
+  if (nsec == 0)
+    return 0;
+  const auto bucket = static_cast<size_t>(63 - __builtin_clzll(nsec));
+  return std::min(bucket, NUM_LATENCY_BUCKETS - 1);
+}
+
+void Record(const Stage stage, const uint64_t bytes)
+{
+  auto& counters = localCounters()[stage];
+  add(counters.calls, 1);
+  add(counters.bytes, bytes);
+}
+
+void Record(const Stage stage, const uint64_t bytes, const uint64_t nsec)
+{
+  auto& counters = localCounters()[stage];
+  add(counters.calls, 1);
+  add(counters.timedCalls, 1);
+  add(counters.bytes, bytes);
+  add(counters.totalNSec, nsec);
+  add(counters.latencyHistogram[GetLatencyBucket(nsec)], 1);
+}
+
+std::vector<StageStatistics> Collect()
+{
+  return Registry::Instance().Sum();
+}
+
+void Reset()
+{
+  Registry::Instance().Reset();
+}
+
+void WriteText(std::ostream& stream, const std::vector<StageStatistics>& statistics)
+{
+  stream << std::left << std::setw(24) << "stage" << std::right
+         << std::setw(12) << "calls" << std::setw(16) << "bytes"
+         << std::setw(12) << "mean [us]" << std::setw(12) << "p50 [us]" << std::setw(12) << "p99 [us]"
+         << std::setw(14) << "total [ms]" << "\n";
+
+  for (const auto& stage : statistics)
+  {
+    stream << std::left << std::setw(24) << GetStageName(stage.stage) << std::right
+           << std::setw(12) << stage.calls << std::setw(16) << stage.bytes
+           << std::setw(12) << formatMicroseconds(stage.MeanNSec())
+           << std::setw(12) << formatMicroseconds(static_cast<double>(stage.PercentileNSec(50)))
+           << std::setw(12) << formatMicroseconds(static_cast<double>(stage.PercentileNSec(99)))
+           << std::setw(14) << formatMicroseconds(static_cast<double>(stage.totalNSec) * 1e-3) << "\n";
+  }
+}
+
+void WriteJson(std::ostream& stream, const std::vector<StageStatistics>& statistics)
+{
+  stream << "{";
+  for (size_t s = 0; s < statistics.size(); ++s)
+  {
+    const auto& stage = statistics[s];
+    stream << (s == 0 ? "\n" : ",\n")
+           << "  \"" << GetStageName(stage.stage) << "\": {"
+           << "\"calls\": " << stage.calls
+           << ", \"timed_calls\": " << stage.timedCalls
+           << ", \"bytes\": " << stage.bytes
+           << ", \"total_ns\": " << stage.totalNSec
+           << ", \"mean_ns\": " << stage.MeanNSec()
+           << ", \"p50_ns\": " << stage.PercentileNSec(50)
+           << ", \"p99_ns\": " << stage.PercentileNSec(99)
+           << ", \"latency_histogram_log2_ns\": [";
+    for (size_t b = 0; b < NUM_LATENCY_BUCKETS; ++b)
+      stream << (b == 0 ? "" : ", ") << stage.latencyHistogram[b];
+    stream << "]}";
+  }
+  stream << "\n}\n";
+}
+
+void WriteToFile(const std::string& filename, const std::vector<StageStatistics>& statistics)
+{
+  std::ofstream file(filename);
+  if (!file)
+    throw std::runtime_error("Cannot open file " + filename + " for writing");
+
+  const std::string extension(".json");
+  if (filename.size() >= extension.size() &&
+      filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0)
+    WriteJson(file, statistics);
+  else
+    WriteText(file, statistics);
+
+  if (!file)
+    throw std::runtime_error("Failed writing file " + filename);
+}
+
+void FillDiagnostics(const std::vector<StageStatistics>& statistics, const std::string& hardwareId,
+    diagnostic_msgs::DiagnosticArray& msg)
+{
+  msg.header.stamp = ros::Time::now();
+  msg.status.clear();
+
+  for (const auto& stage : statistics)
+  {
+    if (stage.calls == 0)
+      continue;
+
+    diagnostic_msgs::DiagnosticStatus status;
+    status.level = diagnostic_msgs::DiagnosticStatus::OK;
+    status.name = std::string("multilayer_laser_scan: ") + GetStageName(stage.stage);
+    status.hardware_id = hardwareId;
+    status.message = std::to_string(stage.calls) + " calls";
+    if (stage.timedCalls > 0)
+      status.message += ", mean " + formatMicroseconds(stage.MeanNSec()) + " us";
+
+    status.values.push_back(createKeyValue("calls", std::to_string(stage.calls)));
+    status.values.push_back(createKeyValue("bytes", std::to_string(stage.bytes)));
+    if (stage.timedCalls > 0)
+    {
+      status.values.push_back(createKeyValue("mean [us]", formatMicroseconds(stage.MeanNSec())));
+      status.values.push_back(createKeyValue("p50 [us]",
+        formatMicroseconds(static_cast<double>(stage.PercentileNSec(50)))));
+      status.values.push_back(createKeyValue("p99 [us]",
+        formatMicroseconds(static_cast<double>(stage.PercentileNSec(99)))));
+      status.values.push_back(createKeyValue("total [ms]",
+        formatMicroseconds(static_cast<double>(stage.totalNSec) * 1e-3)));
+    }
+    msg.status.push_back(status);
+  }
+}
+
+ScopedTimer::ScopedTimer(const Stage stage, const uint64_t bytes) :
+  stage(stage), bytes(bytes), start(std::chrono::steady_clock::now())
+{
+}
+
+ScopedTimer::~ScopedTimer()
+{
+  const auto duration = std::chrono::steady_clock::now() - this->start;
+  const auto nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+  Record(this->stage, this->bytes, static_cast<uint64_t>(std::max<int64_t>(nsec, 0)));
+}
+
+void ScopedTimer::AddBytes(const uint64_t _bytes)
+{
+  this->bytes += _bytes;
+}
+
+}
+
+}
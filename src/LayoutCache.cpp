@@ -0,0 +1,186 @@
+#include <multilayer_laser_scan/LayoutCache.h>
+#include <multilayer_laser_scan/Instrumentation.h>
+#include <multilayer_laser_scan/ScanLayoutUtils.h>
+
+#include <functional>
+
+namespace sensor_msgs
+{
+
+namespace
+{
+
+template<typename T>
+inline void hashCombine(size_t& seed, const T& value)
+{
+  seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+inline void hashCombine(size_t& seed, const ros::Duration& value)
+{
+  hashCombine(seed, value.sec);
+  hashCombine(seed, value.nsec);
+}
+
+// Only hash the fields that the cache compares (operator== together with
+// impl::sameRegularAngularOffsets(), which also checks exclude_last),
+// otherwise layouts the cache treats as equal could get different hashes.
+void hashAngularOffsets(size_t& seed, const AngularOffsets& msg)
+{
+  hashCombine(seed, static_cast<bool>(msg.regular));
+  if (msg.regular)
+  {
+    hashCombine(seed, msg.min);
+    hashCombine(seed, msg.max);
+    hashCombine(seed, static_cast<bool>(msg.exclude_last));
+    hashCombine(seed, msg.increment);
+    hashCombine(seed, msg.samples);
+  }
+  else
+  {
+    hashCombine(seed, msg.offsets.size());
+    for (const auto offset : msg.offsets)
+      hashCombine(seed, offset);
+  }
+}
+
+void hashTimeOffsets(size_t& seed, const TimeOffsets& msg)
+{
+  hashCombine(seed, static_cast<bool>(msg.regular));
+  if (msg.regular)
+  {
+    hashCombine(seed, msg.base_offset);
+    hashCombine(seed, msg.increment);
+  }
+  else
+  {
+    hashCombine(seed, msg.offsets.size());
+    for (const auto& offset : msg.offsets)
+      hashCombine(seed, offset);
+  }
+}
+
+void hashScanLayout(size_t& seed, const ScanLayout& msg)
+{
+  hashAngularOffsets(seed, msg.angular_offsets);
+  hashTimeOffsets(seed, msg.time_offsets);
+}
+
+}
+
+LayoutCache::LayoutCache(const size_t _capacity, const bool _materialize) :
+  capacity(_capacity), materialize(_materialize)
+{
+  if (this->capacity == 0)
+    throw std::runtime_error("Layout cache capacity has to be positive.");
+}
+
+LayoutCache& LayoutCache::Instance()
+{
+  static LayoutCache instance;
+  return instance;
+}
+
+std::shared_ptr<const MultiLayerLaserScanLayout> LayoutCache::Get(const MultiLayerLaserScan& msg)
+{
+  MLS_INSTRUMENT_SCOPE(LAYOUT_CACHE_GET, 0);
+
+  const auto hash = ComputeHash(msg);
+
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto layout = this->Find(hash, msg);
+    if (layout != nullptr)
+    {
+      ++this->hits;
+      return layout;
+    }
+  }
+
+  ++this->misses;
+
+  // parse outside of the lock so that other threads can still use the cache
+  auto parsed = std::make_shared<MultiLayerLaserScanLayout>(msg);
+  if (this->materialize)
+    parsed->Materialize();
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  // another thread might have parsed the same layout in the meantime
+  auto layout = this->Find(hash, msg);
+  if (layout != nullptr)
+    return layout;
+
+  this->entries.push_front(Entry {hash, msg.subscan_layout, msg.scan_layout,
+    msg.scan_offsets_during_subscan, msg.ranges.size(), parsed});
+
+  if (this->entries.size() > this->capacity)
+    this->entries.pop_back();
+
+  return parsed;
+}
+
+std::shared_ptr<const MultiLayerLaserScanLayout> LayoutCache::Find(
+    const size_t hash, const MultiLayerLaserScan& msg)
+{
+  for (auto it = this->entries.begin(); it != this->entries.end(); ++it)
+  {
+    if (Matches(*it, hash, msg))
+    {
+      if (it != this->entries.begin())
+        this->entries.splice(this->entries.begin(), this->entries, it);
+      return this->entries.front().layout;
+    }
+  }
+  return nullptr;
+}
+
+size_t LayoutCache::ComputeHash(const MultiLayerLaserScan& msg)
+{
+  size_t seed = 0;
+  hashScanLayout(seed, msg.subscan_layout);
+  hashScanLayout(seed, msg.scan_layout);
+  hashAngularOffsets(seed, msg.scan_offsets_during_subscan);
+  hashCombine(seed, msg.ranges.size());
+  return seed;
+}
+
+bool LayoutCache::Matches(const Entry& entry, const size_t hash, const MultiLayerLaserScan& msg)
+{
+  return entry.hash == hash &&
+    entry.numPoints == msg.ranges.size() &&
+    impl::sameScanLayout(entry.subscanLayout, msg.subscan_layout) &&
+    impl::sameScanLayout(entry.scanLayout, msg.scan_layout) &&
+    impl::sameAngularOffsets(entry.scanOffsetsDuringSubscan, msg.scan_offsets_during_subscan);
+}
+
+size_t LayoutCache::Hits() const
+{
+  return this->hits;
+}
+
+size_t LayoutCache::Misses() const
+{
+  return this->misses;
+}
+
+size_t LayoutCache::Size() const
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->entries.size();
+}
+
+size_t LayoutCache::Capacity() const
+{
+  return this->capacity;
+}
+
+void LayoutCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->entries.clear();
+  this->hits = 0;
+  this->misses = 0;
+}
+
+}
@@ -1,4 +1,5 @@
 #include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+#include <multilayer_laser_scan/Instrumentation.h>
 
 #include <ros/console.h>
 
@@ -170,6 +171,16 @@ void RegularAngularOffsets::FillMsg(AngularOffsets& msg) const
   msg.exclude_last = this->excludeLast;
 }
 
+double RegularAngularOffsets::GetFirstAngle() const
+{
+  return this->FirstAngle();
+}
+
+double RegularAngularOffsets::GetIncrement() const
+{
+  return this->angleIncrement;
+}
+
 double RegularAngularOffsets::FirstAngle() const
 {
   // if angleIncrement is negative, we go backwards from angleMax to angleMin
@@ -223,6 +234,17 @@ void ExplicitAngularOffsets::FillMsg(AngularOffsets &msg) const
   msg.offsets = this->offsets;
 }
 
+const std::vector<double>& ExplicitAngularOffsets::GetOffsets() const
+{
+  return this->offsets;
+}
+
+void ExplicitAngularOffsets::Reset(const double offset)
+{
+  this->offsets.clear();
+  this->offsets.push_back(offset);
+}
+
 RegularTimeOffsets::RegularTimeOffsets(const TimeOffsets &_msg)
 {
   if (!_msg.regular)
@@ -230,6 +252,8 @@ RegularTimeOffsets::RegularTimeOffsets(const TimeOffsets &_msg)
 
   this->baseOffset = _msg.base_offset;
   this->timeIncrement = _msg.increment;
+  this->baseOffsetNSec = this->baseOffset.toNSec();
+  this->timeIncrementNSec = this->timeIncrement.toNSec();
 }
 
 ros::Duration RegularTimeOffsets::Get(size_t i) const
@@ -237,6 +261,11 @@ ros::Duration RegularTimeOffsets::Get(size_t i) const
   return this->timeIncrement * i + this->baseOffset;
 }
 
+int64_t RegularTimeOffsets::GetNSec(size_t i) const
+{
+  return this->timeIncrementNSec * static_cast<int64_t>(i) + this->baseOffsetNSec;
+}
+
 void RegularTimeOffsets::AddOffset(const ros::Duration& offset)
 {
   const auto first = this->Get(0);
@@ -246,6 +275,7 @@ void RegularTimeOffsets::AddOffset(const ros::Duration& offset)
   if (std::abs((offset - beforeFirst).toSec()) < eps)
   {
     this->baseOffset = offset;
+    this->baseOffsetNSec = offset.toNSec();
     return;
   }
 
@@ -285,6 +315,16 @@ void RegularTimeOffsets::FillMsg(TimeOffsets& msg) const
   msg.increment = this->timeIncrement;
 }
 
+const ros::Duration& RegularTimeOffsets::GetBaseOffset() const
+{
+  return this->baseOffset;
+}
+
+const ros::Duration& RegularTimeOffsets::GetIncrement() const
+{
+  return this->timeIncrement;
+}
+
 ExplicitTimeOffsets::ExplicitTimeOffsets(const TimeOffsets &_msg)
 {
   if (_msg.regular)
@@ -294,6 +334,9 @@ ExplicitTimeOffsets::ExplicitTimeOffsets(const TimeOffsets &_msg)
     throw std::runtime_error("Time offsets cannot be empty.");
 
   this->offsets = _msg.offsets;
+  this->offsetsNSec.reserve(this->offsets.size());
+  for (const auto& offset : this->offsets)
+    this->offsetsNSec.push_back(offset.toNSec());
 }
 
 ros::Duration ExplicitTimeOffsets::Get(size_t i) const
@@ -301,6 +344,11 @@ ros::Duration ExplicitTimeOffsets::Get(size_t i) const
   return this->offsets.at(i);
 }
 
+int64_t ExplicitTimeOffsets::GetNSec(size_t i) const
+{
+  return this->offsetsNSec.at(i);
+}
+
 size_t ExplicitTimeOffsets::Length() const
 {
   return this->offsets.size();
@@ -309,6 +357,7 @@ size_t ExplicitTimeOffsets::Length() const
 void ExplicitTimeOffsets::AddOffset(const ros::Duration& offset)
 {
   this->offsets.emplace_back(offset.sec, offset.nsec);
+  this->offsetsNSec.push_back(offset.toNSec());
 }
 
 bool ExplicitTimeOffsets::HasLength(const size_t length) const
@@ -322,8 +371,28 @@ void ExplicitTimeOffsets::FillMsg(TimeOffsets &msg) const
   msg.offsets = this->offsets;
 }
 
+const std::vector<ros::Duration>& ExplicitTimeOffsets::GetOffsets() const
+{
+  return this->offsets;
+}
+
+const std::vector<int64_t>& ExplicitTimeOffsets::GetOffsetsNSec() const
+{
+  return this->offsetsNSec;
+}
+
+void ExplicitTimeOffsets::Reset(const ros::Duration& offset)
+{
+  this->offsets.clear();
+  this->offsetsNSec.clear();
+  this->AddOffset(offset);
+}
+
 ParsedScanLayout::ParsedScanLayout(const ScanLayout& _msg)
 {
+  MLS_INSTRUMENT_SCOPE(LAYOUT_PARSE, _msg.angular_offsets.offsets.size() * sizeof(double) +
+    _msg.time_offsets.offsets.size() * sizeof(ros::Duration));
+
   if (_msg.angular_offsets.regular)
     this->angularOffsets.reset(new RegularAngularOffsets(_msg.angular_offsets));
   else
@@ -348,6 +417,11 @@ ros::Duration ParsedScanLayout::GetTime(size_t i) const
   return this->timeOffsets->Get(i);
 }
 
+int64_t ParsedScanLayout::GetTimeNSec(size_t i) const
+{
+  return this->timeOffsets->GetNSec(i);
+}
+
 size_t ParsedScanLayout::Length() const
 {
   return this->angularOffsets->Length();
@@ -365,27 +439,80 @@ void ParsedScanLayout::FillMsg(ScanLayout& msg) const
   this->timeOffsets->FillMsg(msg.time_offsets);
 }
 
+void ParsedScanLayout::Reset(const double angularOffset, const ros::Duration& timeOffset)
+{
+  auto* explicitAngularOffsets = dynamic_cast<ExplicitAngularOffsets*>(this->angularOffsets.get());
+  if (explicitAngularOffsets != nullptr)
+  {
+    explicitAngularOffsets->Reset(angularOffset);
+  }
+  else
+  {
+    AngularOffsets msg;
+    msg.regular = false;
+    msg.offsets.push_back(angularOffset);
+    this->angularOffsets.reset(new ExplicitAngularOffsets(msg));
+  }
+
+  auto* explicitTimeOffsets = dynamic_cast<ExplicitTimeOffsets*>(this->timeOffsets.get());
+  if (explicitTimeOffsets != nullptr)
+  {
+    explicitTimeOffsets->Reset(timeOffset);
+  }
+  else
+  {
+    TimeOffsets msg;
+    msg.regular = false;
+    msg.offsets.push_back(timeOffset);
+    this->timeOffsets.reset(new ExplicitTimeOffsets(msg));
+  }
+}
+
+const ParsedAngularOffsets& ParsedScanLayout::GetAngularOffsets() const
+{
+  return *this->angularOffsets;
+}
+
+const ParsedTimeOffsets& ParsedScanLayout::GetTimeOffsets() const
+{
+  return *this->timeOffsets;
+}
+
 MultiLayerLaserScanLayout::MultiLayerLaserScanLayout(const MultiLayerLaserScan& _msg) :
-  subscanLayout(ParsedScanLayout(_msg.subscan_layout)),
-  scanLayout(ParsedScanLayout(_msg.scan_layout))
+  MultiLayerLaserScanLayout(_msg.subscan_layout, _msg.scan_layout,
+    _msg.scan_offsets_during_subscan, _msg.ranges.size())
+{
+}
+
+MultiLayerLaserScanLayout::MultiLayerLaserScanLayout(const CompressedMultiLayerLaserScan& _msg) :
+  MultiLayerLaserScanLayout(_msg.subscan_layout, _msg.scan_layout,
+    _msg.scan_offsets_during_subscan, _msg.ranges.size())
+{
+}
+
+MultiLayerLaserScanLayout::MultiLayerLaserScanLayout(const ScanLayout& _subscanLayout,
+    const ScanLayout& _scanLayout, const AngularOffsets& _scanOffsetsDuringSubscan,
+    const size_t numPoints) :
+  subscanLayout(ParsedScanLayout(_subscanLayout)),
+  scanLayout(ParsedScanLayout(_scanLayout))
 {
   this->subscanLength = this->subscanLayout.Length();
   this->length = this->scanLayout.Length() * this->subscanLength;
 
-  if (_msg.scan_offsets_during_subscan.regular)
-    this->scanAngularVelocity.reset(new RegularAngularOffsets(_msg.scan_offsets_during_subscan));
+  if (_scanOffsetsDuringSubscan.regular)
+    this->scanAngularVelocity.reset(new RegularAngularOffsets(_scanOffsetsDuringSubscan));
   else
-    this->scanAngularVelocity.reset(new ExplicitAngularOffsets(_msg.scan_offsets_during_subscan));
+    this->scanAngularVelocity.reset(new ExplicitAngularOffsets(_scanOffsetsDuringSubscan));
 
   if (this->scanAngularVelocity->Length() != this->subscanLength)
     throw std::runtime_error("Length of scan_offsets_during_subscan " +
       std::to_string(this->scanAngularVelocity->Length()) + " is not the "
       "same as length of subscans " + std::to_string(this->subscanLength));
 
-  if (this->length != _msg.ranges.size())
+  if (this->length != numPoints)
     throw std::runtime_error("Scan layout " + std::to_string(this->length) +
       " size doesn't correspond to the number of actual points " +
-      std::to_string(_msg.ranges.size()));
+      std::to_string(numPoints));
 }
 
 double MultiLayerLaserScanLayout::GetScanAngleByIndex(
@@ -402,6 +529,9 @@ double MultiLayerLaserScanLayout::GetScanAngle(const size_t i) const
   if (i >= this->length)
     throw std::out_of_range("Requested point is outside of the current layout.");
 
+  if (this->materialized)
+    return this->materializedScanAngles[i];
+
   return this->GetScanAngleByIndex(this->GetScanIndex(i), this->GetSubscanIndex(i));
 }
 
@@ -415,6 +545,9 @@ double MultiLayerLaserScanLayout::GetSubscanAngle(const size_t i) const
   if (i >= this->length)
     throw std::out_of_range("Requested point is outside of the current layout.");
 
+  if (this->materialized)
+    return this->materializedSubscanAngles[i];
+
   return this->GetSubscanAngleByIndex(this->GetSubscanIndex(i));
 }
 
@@ -429,9 +562,91 @@ ros::Duration MultiLayerLaserScanLayout::GetTime(size_t i) const
   if (i >= this->length)
     throw std::out_of_range("Requested point is outside of the current layout.");
 
+  if (this->materialized)
+    return this->materializedTimes[i];
+
   return this->GetTimeByIndex(this->GetScanIndex(i), this->GetSubscanIndex(i));
 }
 
+int64_t MultiLayerLaserScanLayout::GetTimeNSecByIndex(
+    const size_t scanIndex, const size_t subscanIndex) const
+{
+  return this->scanLayout.GetTimeNSec(scanIndex) + this->subscanLayout.GetTimeNSec(subscanIndex);
+}
+
+int64_t MultiLayerLaserScanLayout::GetTimeNSec(const size_t i) const
+{
+  if (i >= this->length)
+    throw std::out_of_range("Requested point is outside of the current layout.");
+
+  if (this->materialized)
+    return this->materializedTimes[i].toNSec();
+
+  return this->GetTimeNSecByIndex(this->GetScanIndex(i), this->GetSubscanIndex(i));
+}
+
+float MultiLayerLaserScanLayout::GetTimeSec(const size_t i) const
+{
+  return static_cast<float>(this->GetTimeNSec(i) * 1e-9);
+}
+
+void MultiLayerLaserScanLayout::GetTimesNSec(int64_t* times) const
+{
+  if (this->materialized)
+  {
+    for (size_t i = 0; i < this->length; ++i)
+      times[i] = this->materializedTimes[i].toNSec();
+    return;
+  }
+
+  // the subscan offsets are the same for all subscans, so compute them once
+  std::vector<int64_t> subscanTimes(this->subscanLength);
+  for (size_t subscanIndex = 0; subscanIndex < this->subscanLength; ++subscanIndex)
+    subscanTimes[subscanIndex] = this->subscanLayout.GetTimeNSec(subscanIndex);
+
+  const auto scanLength = this->scanLayout.Length();
+  for (size_t scanIndex = 0; scanIndex < scanLength; ++scanIndex)
+  {
+    const auto scanTime = this->scanLayout.GetTimeNSec(scanIndex);
+    for (size_t subscanIndex = 0; subscanIndex < this->subscanLength; ++subscanIndex)
+      *times++ = scanTime + subscanTimes[subscanIndex];
+  }
+}
+
+void MultiLayerLaserScanLayout::GetTimesNSec(std::vector<int64_t>& times) const
+{
+  times.resize(this->length);
+  this->GetTimesNSec(times.data());
+}
+
+void MultiLayerLaserScanLayout::GetTimesSec(float* times) const
+{
+  if (this->materialized)
+  {
+    for (size_t i = 0; i < this->length; ++i)
+      times[i] = static_cast<float>(this->materializedTimes[i].toNSec() * 1e-9);
+    return;
+  }
+
+  std::vector<int64_t> subscanTimes(this->subscanLength);
+  for (size_t subscanIndex = 0; subscanIndex < this->subscanLength; ++subscanIndex)
+    subscanTimes[subscanIndex] = this->subscanLayout.GetTimeNSec(subscanIndex);
+
+  const auto scanLength = this->scanLayout.Length();
+  for (size_t scanIndex = 0; scanIndex < scanLength; ++scanIndex)
+  {
+    const auto scanTime = this->scanLayout.GetTimeNSec(scanIndex);
+    for (size_t subscanIndex = 0; subscanIndex < this->subscanLength; ++subscanIndex)
+      *times++ = static_cast<float>((scanTime + subscanTimes[subscanIndex]) * 1e-9);
+  }
+}
+
+void MultiLayerLaserScanLayout::GetTimesSec(std::vector<float>& times) const
+{
+  times.resize(this->length);
+  this->GetTimesSec(times.data());
+}
+
 size_t MultiLayerLaserScanLayout::Length() const
 {
   return this->length;
@@ -453,6 +668,14 @@ void MultiLayerLaserScanLayout::GetAll(size_t i, double& _scanAngle,
   if (i >= this->length)
     throw std::out_of_range("Requested point is outside of the current layout.");
 
+  if (this->materialized)
+  {
+    _subscanAngle = this->materializedSubscanAngles[i];
+    _scanAngle = this->materializedScanAngles[i];
+    _time = this->materializedTimes[i];
+    return;
+  }
+
   const auto subscanIndex = this->GetSubscanIndex(i);
   const auto scanIndex = this->GetScanIndex(i);
 
@@ -461,6 +684,62 @@ void MultiLayerLaserScanLayout::GetAll(size_t i, double& _scanAngle,
   _time = this->GetTimeByIndex(scanIndex, subscanIndex);
 }
 
+void MultiLayerLaserScanLayout::Materialize()
+{
+  if (this->materialized)
+    return;
+
+  MLS_INSTRUMENT_SCOPE(LAYOUT_MATERIALIZE, this->length * (2 * sizeof(double) + sizeof(ros::Duration)));
+
+  this->materializedScanAngles.resize(this->length);
+  this->materializedSubscanAngles.resize(this->length);
+  this->materializedTimes.resize(this->length);
+
+  const auto scanLength = this->scanLayout.Length();
+  size_t i = 0;
+  for (size_t scanIndex = 0; scanIndex < scanLength; ++scanIndex)
+  {
+    for (size_t subscanIndex = 0; subscanIndex < this->subscanLength; ++subscanIndex, ++i)
+    {
+      this->materializedScanAngles[i] = this->GetScanAngleByIndex(scanIndex, subscanIndex);
+      this->materializedSubscanAngles[i] = this->GetSubscanAngleByIndex(subscanIndex);
+      this->materializedTimes[i] = this->GetTimeByIndex(scanIndex, subscanIndex);
+    }
+  }
+
+  this->materialized = true;
+}
+
+bool MultiLayerLaserScanLayout::IsMaterialized() const
+{
+  return this->materialized;
+}
+
+size_t MultiLayerLaserScanLayout::GetScanLength() const
+{
+  return this->scanLayout.Length();
+}
+
+size_t MultiLayerLaserScanLayout::GetSubscanLength() const
+{
+  return this->subscanLength;
+}
+
+const ParsedScanLayout& MultiLayerLaserScanLayout::GetScanLayout() const
+{
+  return this->scanLayout;
+}
+
+const ParsedScanLayout& MultiLayerLaserScanLayout::GetSubscanLayout() const
+{
+  return this->subscanLayout;
+}
+
+const ParsedAngularOffsets& MultiLayerLaserScanLayout::GetScanOffsetsDuringSubscan() const
+{
+  return *this->scanAngularVelocity;
+}
+
 void MultiLayerLaserScanLayout::FillMsg(MultiLayerLaserScan &msg) const
 {
   this->scanLayout.FillMsg(msg.scan_layout);
@@ -468,4 +747,11 @@ void MultiLayerLaserScanLayout::FillMsg(MultiLayerLaserScan &msg) const
   this->scanAngularVelocity->FillMsg(msg.scan_offsets_during_subscan);
 }
 
+void MultiLayerLaserScanLayout::FillMsg(CompressedMultiLayerLaserScan &msg) const
+{
+  this->scanLayout.FillMsg(msg.scan_layout);
+  this->subscanLayout.FillMsg(msg.subscan_layout);
+  this->scanAngularVelocity->FillMsg(msg.scan_offsets_during_subscan);
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include <multilayer_laser_scan/MultiLayerLaserScanToPointCloud2.h>
+#include <multilayer_laser_scan/Instrumentation.h>
+#include <multilayer_laser_scan/PointFieldUtils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace sensor_msgs
+{
+
+namespace
+{
+
+bool sameFields(const std::vector<PointField>& lhs, const std::vector<PointField>& rhs)
+{
+  if (lhs.size() != rhs.size())
+    return false;
+
+  for (size_t i = 0; i < lhs.size(); ++i)
+  {
+    if (lhs[i].name != rhs[i].name || lhs[i].offset != rhs[i].offset ||
+        lhs[i].datatype != rhs[i].datatype || lhs[i].count != rhs[i].count)
+      return false;
+  }
+
+  return true;
+}
+
+PointField createField(const std::string& name, const size_t offset, const uint8_t datatype,
+    const size_t count = 1)
+{
+  PointField field;
+  field.name = name;
+  field.offset = static_cast<PointField::_offset_type>(offset);
+  field.datatype = datatype;
+  field.count = static_cast<PointField::_count_type>(count);
+  return field;
+}
+
+template<typename T>
+inline void writeValue(uint8_t* data, const T value)
+{
+  std::memcpy(data, &value, sizeof(T));
+}
+
+}
+
+MultiLayerLaserScanToPointCloud2::MultiLayerLaserScanToPointCloud2(
+    const uint32_t _fields, const bool _organized) : fields(_fields), organized(_organized)
+{
+}
+
+void MultiLayerLaserScanToPointCloud2::UpdateLayout(
+    const std::shared_ptr<const MultiLayerLaserScanLayout>& _layout)
+{
+  if (this->layout == _layout)
+    return;
+
+  this->layout = _layout;
+  this->projection.reset(new CartesianProjection(*_layout));
+
+  const auto subscanLength = _layout->GetSubscanLength();
+
+  // ring 0 is the lowest ray
+  std::vector<size_t> order(subscanLength);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&_layout](size_t a, size_t b)
+  {
+    return _layout->GetSubscanLayout().GetAngle(a) < _layout->GetSubscanLayout().GetAngle(b);
+  });
+  this->rings.resize(subscanLength);
+  for (size_t ring = 0; ring < subscanLength; ++ring)
+    this->rings[order[ring]] = static_cast<uint16_t>(ring);
+
+  this->x.resize(subscanLength);
+  this->y.resize(subscanLength);
+  this->z.resize(subscanLength);
+  this->t.resize(subscanLength);
+}
+
+void MultiLayerLaserScanToPointCloud2::UpdateFields(const PointData& customData)
+{
+  const auto copyCustomData = (this->fields & CUSTOM_DATA) && !customData.data.empty();
+  if (this->fieldsInitialized && copyCustomData == this->hasCustomData &&
+      (!copyCustomData || (customData.point_step == this->customPointStep &&
+                           sameFields(customData.fields, this->customFields))))
+    return;
+
+  this->fieldsInitialized = true;
+  this->hasCustomData = copyCustomData;
+  this->customPointStep = customData.point_step;
+  this->customFields = customData.fields;
+
+  this->cloudFields.clear();
+  this->cloudFields.push_back(createField("x", 0, PointField::FLOAT32));
+  this->cloudFields.push_back(createField("y", 4, PointField::FLOAT32));
+  this->cloudFields.push_back(createField("z", 8, PointField::FLOAT32));
+
+  size_t offset = 12;
+  if (this->fields & INTENSITY)
+  {
+    this->intensityOffset = offset;
+    this->cloudFields.push_back(createField("intensity", offset, PointField::FLOAT32));
+    offset += 4;
+  }
+  if (this->fields & TIME)
+  {
+    this->timeOffset = offset;
+    this->cloudFields.push_back(createField("time", offset, PointField::FLOAT32));
+    offset += 4;
+  }
+  if (this->fields & RING)
+  {
+    this->ringOffset = offset;
+    this->cloudFields.push_back(createField("ring", offset, PointField::UINT16));
+    offset += 2;
+  }
+
+  // keep the custom fields 4-byte aligned
+  this->paddingOffset = offset;
+  offset = (offset + 3) / 4 * 4;
+  this->customDataOffset = offset;
+
+  if (copyCustomData)
+  {
+    for (const auto& field : customData.fields)
+    {
+      this->cloudFields.push_back(field);
+      this->cloudFields.back().offset += this->customDataOffset;
+    }
+    offset += customData.point_step;
+  }
+
+  this->pointStep = offset;
+}
+
+void MultiLayerLaserScanToPointCloud2::Convert(const MultiLayerLaserScan& scan,
+    const std::shared_ptr<const MultiLayerLaserScanLayout>& _layout, PointCloud2& cloud)
+{
+  MLS_INSTRUMENT_SCOPE(SCAN_TO_POINT_CLOUD2, (scan.ranges.size() + scan.intensities.size()) * sizeof(float) +
+    scan.custom_data.data.size());
+
+  if (_layout->Length() != scan.ranges.size())
+    throw std::runtime_error("Scan layout " + std::to_string(_layout->Length()) +
+      " size doesn't correspond to the number of actual points " +
+      std::to_string(scan.ranges.size()));
+
+  const auto hasIntensities = !scan.intensities.empty();
+  if (hasIntensities && scan.intensities.size() != scan.ranges.size())
+    throw std::runtime_error("The scan has different number of ranges and intensities.");
+
+  const auto copyCustomData = (this->fields & CUSTOM_DATA) && !scan.custom_data.data.empty();
+  if (copyCustomData)
+  {
+    if (static_cast<bool>(scan.custom_data.is_bigendian) != impl::isHostBigEndian())
+      throw std::runtime_error("Custom data with non-native endianness cannot be converted.");
+    if (scan.custom_data.data.size() != scan.ranges.size() * scan.custom_data.point_step)
+      throw std::runtime_error("Custom data size doesn't correspond to the number of actual points.");
+  }
+
+  this->UpdateLayout(_layout);
+  this->UpdateFields(scan.custom_data);
+
+  cloud.header = scan.header;
+  cloud.is_bigendian = impl::isHostBigEndian();
+  cloud.point_step = static_cast<uint32_t>(this->pointStep);
+  if (!sameFields(cloud.fields, this->cloudFields))
+    cloud.fields = this->cloudFields;
+
+  const auto scanLength = _layout->GetScanLength();
+  const auto subscanLength = _layout->GetSubscanLength();
+
+  // does not reallocate if the cloud already had enough capacity
+  cloud.data.resize(_layout->Length() * this->pointStep);
+
+  const auto nan = std::numeric_limits<float>::quiet_NaN();
+  const auto customStep = scan.custom_data.point_step;
+  auto* const data = cloud.data.data();
+  size_t numPoints = 0;
+  bool dense = true;
+
+  for (size_t scanIndex = 0; scanIndex < scanLength; ++scanIndex)
+  {
+    this->projection->ProjectSubscan(scan, scanIndex, this->x.data(), this->y.data(), this->z.data(),
+      (this->fields & TIME) ? this->t.data() : nullptr);
+
+    for (size_t subscanIndex = 0; subscanIndex < subscanLength; ++subscanIndex)
+    {
+      const auto i = scanIndex * subscanLength + subscanIndex;
+      const auto range = scan.ranges[i];
+      const auto valid = std::isfinite(range) && range >= scan.range_min && range <= scan.range_max;
+
+      if (!valid && !this->organized)
+        continue;
+
+      const auto row = this->rings[subscanIndex];
+      const auto index = this->organized ? row * scanLength + scanIndex : numPoints;
+      auto* const point = data + index * this->pointStep;
+
+      if (valid)
+      {
+        writeValue(point + 0, this->x[subscanIndex]);
+        writeValue(point + 4, this->y[subscanIndex]);
+        writeValue(point + 8, this->z[subscanIndex]);
+      }
+      else
+      {
+        writeValue(point + 0, nan);
+        writeValue(point + 4, nan);
+        writeValue(point + 8, nan);
+        dense = false;
+      }
+
+      if (this->fields & INTENSITY)
+        writeValue(point + this->intensityOffset, hasIntensities ? scan.intensities[i] : 0.0f);
+      if (this->fields & TIME)
+        writeValue(point + this->timeOffset, this->t[subscanIndex]);
+      if (this->fields & RING)
+        writeValue(point + this->ringOffset, this->rings[subscanIndex]);
+      // the reused buffer would otherwise publish stale bytes
+      if (this->customDataOffset > this->paddingOffset)
+        std::memset(point + this->paddingOffset, 0, this->customDataOffset - this->paddingOffset);
+      if (copyCustomData)
+        std::memcpy(point + this->customDataOffset, &scan.custom_data.data[i * customStep], customStep);
+
+      ++numPoints;
+    }
+  }
+
+  if (this->organized)
+  {
+    cloud.height = static_cast<uint32_t>(subscanLength);
+    cloud.width = static_cast<uint32_t>(scanLength);
+  }
+  else
+  {
+    cloud.height = 1;
+    cloud.width = static_cast<uint32_t>(numPoints);
+    cloud.data.resize(numPoints * this->pointStep);
+  }
+  cloud.row_step = cloud.width * cloud.point_step;
+  cloud.is_dense = dense;
+}
+
+}
@@ -0,0 +1,213 @@
+#include <multilayer_laser_scan/NormalEstimation.h>
+#include <multilayer_laser_scan/ParallelForEachPoint.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+#include <multilayer_laser_scan/PointFieldUtils.h>
+
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace sensor_msgs
+{
+
+namespace
+{
+
+constexpr float NaN = std::numeric_limits<float>::quiet_NaN();
+
+}
+
+NormalEstimation::NormalEstimation(const MultiLayerLaserScanLayout& layout, const Method method,
+    const size_t windowRadius, const float maxRangeDifference)
+  : projection(layout), neighborhood(layout), method(method), windowRadius(windowRadius),
+    maxRangeDifference(maxRangeDifference)
+{
+  if (method != CROSS_PRODUCT && method != PCA)
+    throw std::runtime_error("Unknown normal estimation method " + std::to_string(method));
+  if (windowRadius == 0)
+    throw std::runtime_error("Window radius of normal estimation has to be positive");
+}
+
+NormalEstimation::Method NormalEstimation::GetMethod() const
+{
+  return this->method;
+}
+
+bool NormalEstimation::IsValid(const MultiLayerLaserScan& scan, const size_t i) const
+{
+  const auto range = scan.ranges[i];
+  return std::isfinite(range) && range >= scan.range_min && range <= scan.range_max;
+}
+
+void NormalEstimation::Compute(const MultiLayerLaserScan& scan, float* nx, float* ny, float* nz,
+    ThreadPool& pool)
+{
+  const auto length = this->projection.Length();
+  if (scan.ranges.size() != length)
+    throw std::runtime_error("The scan has " + std::to_string(scan.ranges.size()) +
+        " ranges, but its layout has " + std::to_string(length) + " points");
+
+  this->x.resize(length);
+  this->y.resize(length);
+  this->z.resize(length);
+
+  // all points have to be projected before the neighbors of block borders are used
+  const auto scanLength = this->projection.GetScanLength();
+  ParallelForScans(scanLength, [&](const size_t firstScan, const size_t endScan)
+  {
+    this->projection.ProjectScans(scan, firstScan, endScan, this->x.data(), this->y.data(), this->z.data());
+  }, 0, pool);
+
+  ParallelForScans(scanLength, [&](const size_t firstScan, const size_t endScan)
+  {
+    this->ComputeBlock(scan, firstScan, endScan, nx, ny, nz);
+  }, 0, pool);
+}
+
+void NormalEstimation::Compute(MultiLayerLaserScan& scan, ThreadPool& pool)
+{
+  const auto length = this->projection.Length();
+  auto& data = scan.custom_data;
+
+  // checked before the field is appended; custom data without fields get host byte order
+  if (!data.fields.empty() && static_cast<bool>(data.is_bigendian) != impl::isHostBigEndian())
+    throw std::runtime_error("Normals can only be written to custom data with host byte order");
+
+  const auto& field = PointDataModifier(data).findOrAppendFieldByString("normal", length);
+
+  if (field.datatype != PointField::FLOAT32 || field.count != 3)
+    throw std::runtime_error("Field normal has to have 3 FLOAT32 elements");
+
+  this->normals.resize(3 * length);
+  const auto nx = this->normals.data();
+  const auto ny = nx + length;
+  const auto nz = ny + length;
+  this->Compute(scan, nx, ny, nz, pool);
+
+  const auto offset = field.offset;
+  const size_t step = data.point_step;
+  for (size_t i = 0; i < length; ++i)
+  {
+    const float normal[3] = {nx[i], ny[i], nz[i]};
+    std::memcpy(&data.data[i * step + offset], normal, sizeof(normal));
+  }
+}
+
+void NormalEstimation::ComputeBlock(const MultiLayerLaserScan& scan, const size_t firstScan,
+    const size_t endScan, float* nx, float* ny, float* nz) const
+{
+  const auto scanLength = this->neighborhood.GetScanLength();
+  const auto subscanLength = this->neighborhood.GetSubscanLength();
+  const auto wrapAround = this->neighborhood.WrapsAround();
+  const auto radius = static_cast<ptrdiff_t>(this->windowRadius);
+
+  const auto X = this->x.data();
+  const auto Y = this->y.data();
+  const auto Z = this->z.data();
+
+  // index of the point in column + dc and ring + dr, or -1 if it doesn't exist
+  const auto offsetIndex = [&](const size_t column, const size_t ring, const ptrdiff_t dc, const ptrdiff_t dr)
+  {
+    const auto r = static_cast<ptrdiff_t>(ring) + dr;
+    if (r < 0 || r >= static_cast<ptrdiff_t>(subscanLength))
+      return static_cast<ptrdiff_t>(-1);
+    auto c = static_cast<ptrdiff_t>(column) + dc;
+    if (c < 0 || c >= static_cast<ptrdiff_t>(scanLength))
+    {
+      if (!wrapAround)
+        return static_cast<ptrdiff_t>(-1);
+      c = (c + static_cast<ptrdiff_t>(scanLength)) % static_cast<ptrdiff_t>(scanLength);
+    }
+    return c * static_cast<ptrdiff_t>(subscanLength) + r;
+  };
+
+  for (size_t column = firstScan; column < endScan; ++column)
+  {
+    for (size_t ring = 0; ring < subscanLength; ++ring)
+    {
+      const auto i = column * subscanLength + ring;
+      nx[i] = ny[i] = nz[i] = NaN;
+      if (!this->IsValid(scan, i))
+        continue;
+
+      const auto range = scan.ranges[i];
+      const auto isNeighbor = [&](const ptrdiff_t j)
+      {
+        return j >= 0 && this->IsValid(scan, j) && std::abs(scan.ranges[j] - range) <= this->maxRangeDifference;
+      };
+
+      Eigen::Vector3f normal;
+      if (this->method == CROSS_PRODUCT)
+      {
+        // the closest valid neighbor in the given direction (or the point itself)
+        const auto closest = [&](const ptrdiff_t dc, const ptrdiff_t dr)
+        {
+          for (ptrdiff_t k = 1; k <= radius; ++k)
+          {
+            const auto j = offsetIndex(column, ring, k * dc, k * dr);
+            if (isNeighbor(j))
+              return static_cast<size_t>(j);
+          }
+          return i;
+        };
+
+        const auto left = closest(-1, 0);
+        const auto right = closest(1, 0);
+        const auto down = closest(0, -1);
+        const auto up = closest(0, 1);
+        if (left == right || down == up)
+          continue;
+
+        const Eigen::Vector3f alongRing(X[right] - X[left], Y[right] - Y[left], Z[right] - Z[left]);
+        const Eigen::Vector3f acrossRings(X[up] - X[down], Y[up] - Y[down], Z[up] - Z[down]);
+        normal = alongRing.cross(acrossRings);
+        const auto norm = normal.norm();
+        if (!(norm > 0))
+          continue;
+        normal /= norm;
+      }
+      else
+      {
+        // coordinates relative to the point reduce cancellation in the covariance
+        const Eigen::Vector3f center(X[i], Y[i], Z[i]);
+        Eigen::Vector3f sum = Eigen::Vector3f::Zero();
+        Eigen::Matrix3f sumSquares = Eigen::Matrix3f::Zero();
+        size_t count = 1;
+        this->neighborhood.ForEachNeighbor(i, this->windowRadius, this->windowRadius, [&](const size_t j)
+        {
+          if (!isNeighbor(j))
+            return;
+          const Eigen::Vector3f p = Eigen::Vector3f(X[j], Y[j], Z[j]) - center;
+          sum += p;
+          sumSquares += p * p.transpose();
+          ++count;
+        });
+        if (count < 3)
+          continue;
+
+        const Eigen::Vector3f mean = sum / count;
+        const Eigen::Matrix3f covariance = sumSquares / count - mean * mean.transpose();
+        Eigen::SelfAdjointEigenSolver<Eigen::Matrix3f> solver;
+        solver.computeDirect(covariance);
+        // eigenvalues are sorted in increasing order
+        normal = solver.eigenvectors().col(0);
+        if (!normal.allFinite() || !(solver.eigenvalues()(1) > 0))
+          continue;
+      }
+
+      // orient towards the sensor
+      if (normal.x() * X[i] + normal.y() * Y[i] + normal.z() * Z[i] > 0)
+        normal = -normal;
+
+      nx[i] = normal.x();
+      ny[i] = normal.y();
+      nz[i] = normal.z();
+    }
+  }
+}
+
+}
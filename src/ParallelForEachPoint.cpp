@@ -0,0 +1,68 @@
+#include <multilayer_laser_scan/ParallelForEachPoint.h>
+
+#include <algorithm>
+
+namespace sensor_msgs
+{
+
+namespace
+{
+
+template<typename C, typename It>
+void parallelForEachPoint(C& scan, const std::shared_ptr<const MultiLayerLaserScanLayout>& layout,
+    const std::function<void(It, const It&)>& fn, const size_t grain, ThreadPool& pool)
+{
+  if (scan.ranges.size() != layout->Length())
+    throw std::runtime_error("The scan has " + std::to_string(scan.ranges.size()) +
+      " ranges, but its layout has " + std::to_string(layout->Length()) + " points.");
+
+  const auto subscanLength = layout->GetSubscanLength();
+  ParallelForScans(*layout, [&](const size_t firstScan, const size_t endScan)
+  {
+    fn(It(scan, layout, firstScan * subscanLength), It(scan, layout, endScan * subscanLength));
+  }, grain, pool);
+}
+
+}
+
+void ParallelForScans(const MultiLayerLaserScanLayout& layout,
+    const std::function<void(size_t firstScan, size_t endScan)>& fn,
+    const size_t grain, ThreadPool& pool)
+{
+  ParallelForScans(layout.GetScanLength(), fn, grain, pool);
+}
+
+void ParallelForScans(const size_t scanLength,
+    const std::function<void(size_t firstScan, size_t endScan)>& fn,
+    size_t grain, ThreadPool& pool)
+{
+  if (grain == 0)
+    grain = std::max<size_t>(1, scanLength / (4 * pool.NumThreads()));
+
+  const auto numBlocks = (scanLength + grain - 1) / grain;
+  pool.Run(numBlocks, [&](const size_t block)
+  {
+    const auto firstScan = block * grain;
+    fn(firstScan, std::min(firstScan + grain, scanLength));
+  });
+}
+
+void ParallelForEachPoint(MultiLayerLaserScan& scan,
+    const std::shared_ptr<const MultiLayerLaserScanLayout>& layout,
+    const std::function<void(MultiLayerLaserScanBaseFieldsIterator begin,
+                             const MultiLayerLaserScanBaseFieldsIterator& end)>& fn,
+    const size_t grain, ThreadPool& pool)
+{
+  parallelForEachPoint(scan, layout, fn, grain, pool);
+}
+
+void ParallelForEachPoint(const MultiLayerLaserScan& scan,
+    const std::shared_ptr<const MultiLayerLaserScanLayout>& layout,
+    const std::function<void(MultiLayerLaserScanBaseFieldsConstIterator begin,
+                             const MultiLayerLaserScanBaseFieldsConstIterator& end)>& fn,
+    const size_t grain, ThreadPool& pool)
+{
+  parallelForEachPoint(scan, layout, fn, grain, pool);
+}
+
+}
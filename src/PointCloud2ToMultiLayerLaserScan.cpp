@@ -0,0 +1,345 @@
+#include <multilayer_laser_scan/PointCloud2ToMultiLayerLaserScan.h>
+#include <multilayer_laser_scan/Instrumentation.h>
+#include <multilayer_laser_scan/PointFieldUtils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace sensor_msgs
+{
+
+namespace
+{
+
+/** Normalize the angle to [min, min + 2 pi). */
+inline double normalizeAngle(double angle, const double min)
+{
+  angle = std::fmod(angle - min, 2 * M_PI);
+  if (angle < 0)
+    angle += 2 * M_PI;
+  return angle + min;
+}
+
+template<typename T>
+inline double readAs(const uint8_t* data)
+{
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return static_cast<double>(value);
+}
+
+inline double readValue(const uint8_t* data, const uint8_t datatype)
+{
+  switch (datatype)
+  {
+    case PointField::INT8: return readAs<int8_t>(data);
+    case PointField::UINT8: return readAs<uint8_t>(data);
+    case PointField::INT16: return readAs<int16_t>(data);
+    case PointField::UINT16: return readAs<uint16_t>(data);
+    case PointField::INT32: return readAs<int32_t>(data);
+    case PointField::UINT32: return readAs<uint32_t>(data);
+    case PointField::FLOAT32: return readAs<float>(data);
+    case PointField::FLOAT64: return readAs<double>(data);
+    default:
+      throw std::runtime_error("PointField of type " + std::to_string(datatype) + " does not exist");
+  }
+}
+
+const PointField* findField(const PointCloud2& cloud, const std::string& name)
+{
+  if (name.empty())
+    return nullptr;
+
+  for (const auto& field : cloud.fields)
+    if (field.name == name)
+      return &field;
+
+  return nullptr;
+}
+
+}
+
+int64_t PointCloud2ToMultiLayerLaserScan::Statistics::BytesSaved() const
+{
+  return static_cast<int64_t>(this->cloudBytes) - static_cast<int64_t>(this->scanBytes);
+}
+
+PointCloud2ToMultiLayerLaserScan::PointCloud2ToMultiLayerLaserScan(
+    const MultiLayerLaserScan& _layoutTemplate, const std::vector<std::string>& _customFields,
+    const std::string& _intensityField, const std::string& _ringField,
+    const RingMapping _ringMapping) :
+  customFields(_customFields), intensityField(_intensityField), ringField(_ringField),
+  ringMapping(_ringMapping)
+{
+  this->layoutTemplate.header = _layoutTemplate.header;
+  this->layoutTemplate.range_min = _layoutTemplate.range_min;
+  this->layoutTemplate.range_max = _layoutTemplate.range_max;
+  this->layoutTemplate.subscan_layout = _layoutTemplate.subscan_layout;
+  this->layoutTemplate.scan_layout = _layoutTemplate.scan_layout;
+  this->layoutTemplate.scan_offsets_during_subscan = _layoutTemplate.scan_offsets_during_subscan;
+
+  const auto numPoints = ParsedScanLayout(_layoutTemplate.scan_layout).Length() *
+    ParsedScanLayout(_layoutTemplate.subscan_layout).Length();
+  this->layoutTemplate.ranges.resize(numPoints);
+  this->layout = std::make_shared<MultiLayerLaserScanLayout>(this->layoutTemplate);
+  this->layoutTemplate.ranges.clear();
+
+  const auto subscanLength = this->layout->GetSubscanLength();
+  const auto scanLength = this->layout->GetScanLength();
+  const auto& subscanLayout = this->layout->GetSubscanLayout();
+
+  this->subscansByElevation.resize(subscanLength);
+  std::iota(this->subscansByElevation.begin(), this->subscansByElevation.end(), 0);
+  std::stable_sort(this->subscansByElevation.begin(), this->subscansByElevation.end(),
+    [&subscanLayout](size_t a, size_t b) { return subscanLayout.GetAngle(a) < subscanLayout.GetAngle(b); });
+
+  this->sortedElevations.resize(subscanLength);
+  this->scanOffsets.resize(subscanLength);
+  this->subscanOfRing.resize(subscanLength);
+  for (size_t i = 0; i < subscanLength; ++i)
+  {
+    this->sortedElevations[i] = subscanLayout.GetAngle(this->subscansByElevation[i]);
+    this->scanOffsets[i] = this->layout->GetScanOffsetsDuringSubscan().Get(i);
+    this->subscanOfRing[i] = (this->ringMapping == RING_BY_ELEVATION) ? this->subscansByElevation[i] : i;
+  }
+
+  const auto& scanAngularOffsets = this->layout->GetScanLayout().GetAngularOffsets();
+  if (const auto* regular = dynamic_cast<const RegularAngularOffsets*>(&scanAngularOffsets))
+  {
+    this->regularScan = true;
+    this->firstScanAngle = regular->GetFirstAngle();
+    this->scanAngleIncrement = regular->GetIncrement();
+    this->fullCircle = std::abs(std::abs(this->scanAngleIncrement) * scanLength - 2 * M_PI) < 1e-6;
+    if (this->scanAngleIncrement == 0.0 && scanLength > 1)
+      throw std::runtime_error("Cannot map points to a scan layout with zero angle increment.");
+    return;
+  }
+
+  this->scansByAngle.resize(scanLength);
+  std::iota(this->scansByAngle.begin(), this->scansByAngle.end(), 0);
+  std::vector<double> angles(scanLength);
+  for (size_t i = 0; i < scanLength; ++i)
+    angles[i] = normalizeAngle(scanAngularOffsets.Get(i), 0);
+  std::stable_sort(this->scansByAngle.begin(), this->scansByAngle.end(),
+    [&angles](size_t a, size_t b) { return angles[a] < angles[b]; });
+
+  this->sortedScanAngles.resize(scanLength);
+  for (size_t i = 0; i < scanLength; ++i)
+    this->sortedScanAngles[i] = angles[this->scansByAngle[i]];
+
+  // buckets[b] is the index of the first sorted angle >= b * bucketWidth
+  const auto numBuckets = 4 * scanLength;
+  this->buckets.resize(numBuckets + 1);
+  size_t sorted = 0;
+  for (size_t b = 0; b <= numBuckets; ++b)
+  {
+    const auto bucketStart = 2 * M_PI * b / numBuckets;
+    while (sorted < scanLength && this->sortedScanAngles[sorted] < bucketStart)
+      ++sorted;
+    this->buckets[b] = sorted;
+  }
+}
+
+std::shared_ptr<const MultiLayerLaserScanLayout> PointCloud2ToMultiLayerLaserScan::GetLayout() const
+{
+  return this->layout;
+}
+
+ssize_t PointCloud2ToMultiLayerLaserScan::GetScanIndex(const double azimuth) const
+{
+  const auto scanLength = static_cast<ssize_t>(this->layout->GetScanLength());
+
+  if (this->regularScan)
+  {
+    if (scanLength == 1)
+      return 0;
+
+    const auto increment = std::abs(this->scanAngleIncrement);
+    const auto direction = (this->scanAngleIncrement >= 0) ? 1.0 : -1.0;
+    const auto steps = normalizeAngle(direction * (azimuth - this->firstScanAngle), -increment / 2) / increment;
+    auto index = static_cast<ssize_t>(std::lround(steps));
+    if (this->fullCircle && index >= scanLength)
+      index -= scanLength;
+    return (index >= 0 && index < scanLength) ? index : -1;
+  }
+
+  const auto angle = normalizeAngle(azimuth, 0);
+  const auto numBuckets = this->buckets.size() - 1;
+  const auto bucket = std::min(static_cast<size_t>(angle / (2 * M_PI) * numBuckets), numBuckets - 1);
+
+  // the closest angle is either the first one >= angle or the one before it
+  auto next = this->buckets[bucket];
+  while (next < this->sortedScanAngles.size() && this->sortedScanAngles[next] < angle)
+    ++next;
+
+  const auto nextIndex = next % this->sortedScanAngles.size();
+  const auto prevIndex = (next + this->sortedScanAngles.size() - 1) % this->sortedScanAngles.size();
+
+  const auto nextDistance = std::abs(normalizeAngle(this->sortedScanAngles[nextIndex] - angle, -M_PI));
+  const auto prevDistance = std::abs(normalizeAngle(this->sortedScanAngles[prevIndex] - angle, -M_PI));
+
+  return static_cast<ssize_t>(this->scansByAngle[(nextDistance < prevDistance) ? nextIndex : prevIndex]);
+}
+
+size_t PointCloud2ToMultiLayerLaserScan::GetSubscanIndex(const double elevation) const
+{
+  const auto& angles = this->sortedElevations;
+  const auto next = static_cast<size_t>(
+    std::lower_bound(angles.begin(), angles.end(), elevation) - angles.begin());
+
+  if (next == 0)
+    return this->subscansByElevation.front();
+  if (next == angles.size())
+    return this->subscansByElevation.back();
+
+  const auto closest = (angles[next] - elevation < elevation - angles[next - 1]) ? next : next - 1;
+  return this->subscansByElevation[closest];
+}
+
+PointCloud2ToMultiLayerLaserScan::Statistics PointCloud2ToMultiLayerLaserScan::Convert(
+    const PointCloud2& cloud, MultiLayerLaserScan& scan)
+{
+  MLS_INSTRUMENT_SCOPE(POINT_CLOUD2_TO_SCAN, cloud.data.size());
+
+  if (static_cast<bool>(cloud.is_bigendian) != impl::isHostBigEndian())
+    throw std::runtime_error("Point clouds with non-native endianness cannot be converted.");
+
+  const auto* const xField = findField(cloud, "x");
+  const auto* const yField = findField(cloud, "y");
+  const auto* const zField = findField(cloud, "z");
+  if (xField == nullptr || yField == nullptr || zField == nullptr)
+    throw std::runtime_error("The point cloud has to have x, y and z fields.");
+
+  const auto* const intensityField = findField(cloud, this->intensityField);
+  const auto* const ringField = findField(cloud, this->ringField);
+
+  const auto subscanLength = this->layout->GetSubscanLength();
+  const auto scanLength = this->layout->GetScanLength();
+  const auto numPoints = this->layout->Length();
+  const auto organized = cloud.height == subscanLength && cloud.width == scanLength && subscanLength > 1;
+
+  scan.header = cloud.header;
+  scan.range_min = this->layoutTemplate.range_min;
+  scan.range_max = this->layoutTemplate.range_max;
+  scan.subscan_layout = this->layoutTemplate.subscan_layout;
+  scan.scan_layout = this->layoutTemplate.scan_layout;
+  scan.scan_offsets_during_subscan = this->layoutTemplate.scan_offsets_during_subscan;
+
+  scan.ranges.assign(numPoints, std::numeric_limits<float>::quiet_NaN());
+  if (intensityField != nullptr)
+    scan.intensities.assign(numPoints, 0.0f);
+  else
+    scan.intensities.clear();
+
+  // custom fields keep their type and are packed in the order they were given
+  auto& cloudCustomFields = this->cloudCustomFields;
+  auto& customFieldSizes = this->customFieldSizes;
+  cloudCustomFields.clear();
+  customFieldSizes.clear();
+  size_t customStep = 0;
+  scan.custom_data.fields.resize(this->customFields.size());
+  for (size_t f = 0; f < this->customFields.size(); ++f)
+  {
+    const auto* const field = findField(cloud, this->customFields[f]);
+    if (field == nullptr)
+      throw std::runtime_error("Field " + this->customFields[f] + " does not exist");
+
+    auto& customField = scan.custom_data.fields[f];
+    if (customField.name != field->name)
+      customField.name = field->name;
+    customField.datatype = field->datatype;
+    customField.count = field->count;
+    customField.offset = static_cast<PointField::_offset_type>(customStep);
+
+    cloudCustomFields.push_back(field);
+    customFieldSizes.push_back(impl::sizeOfPointField(field->datatype) * field->count);
+    customStep += customFieldSizes.back();
+  }
+  scan.custom_data.is_bigendian = cloud.is_bigendian;
+  scan.custom_data.point_step = static_cast<uint32_t>(customStep);
+  scan.custom_data.data.assign(numPoints * customStep, 0);
+
+  Statistics stats;
+  const auto numCloudPoints = static_cast<size_t>(cloud.width) * cloud.height;
+  for (size_t row = 0; row < cloud.height; ++row)
+  {
+    for (size_t column = 0; column < cloud.width; ++column)
+    {
+      const auto* const point = &cloud.data[row * cloud.row_step + column * cloud.point_step];
+
+      const auto x = readValue(point + xField->offset, xField->datatype);
+      const auto y = readValue(point + yField->offset, yField->datatype);
+      const auto z = readValue(point + zField->offset, zField->datatype);
+      if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z))
+      {
+        ++stats.numDroppedPoints;
+        continue;
+      }
+
+      const auto xy = std::hypot(x, y);
+
+      size_t subscanIndex;
+      if (ringField != nullptr)
+      {
+        const auto ring = readValue(point + ringField->offset, ringField->datatype);
+        if (!std::isfinite(ring) || ring < 0 || ring >= static_cast<double>(subscanLength))
+        {
+          ++stats.numDroppedPoints;
+          continue;
+        }
+        subscanIndex = this->subscanOfRing[static_cast<size_t>(ring)];
+      }
+      else if (organized)
+      {
+        subscanIndex = this->subscanOfRing[row];
+      }
+      else
+      {
+        subscanIndex = this->GetSubscanIndex(std::atan2(z, xy));
+      }
+
+      ssize_t scanIndex;
+      if (organized)
+        scanIndex = static_cast<ssize_t>(column);
+      else
+        scanIndex = this->GetScanIndex(std::atan2(y, x) - this->scanOffsets[subscanIndex]);
+
+      if (scanIndex < 0)
+      {
+        ++stats.numDroppedPoints;
+        continue;
+      }
+
+      const auto i = static_cast<size_t>(scanIndex) * subscanLength + subscanIndex;
+      // the ranges of unfilled points are NaN, points of the cloud always have a valid one
+      if (std::isnan(scan.ranges[i]))
+        ++stats.numPoints;
+      scan.ranges[i] = static_cast<float>(std::hypot(xy, z));
+      if (intensityField != nullptr)
+        scan.intensities[i] = static_cast<float>(readValue(point + intensityField->offset, intensityField->datatype));
+
+      auto* customData = &scan.custom_data.data[i * customStep];
+      for (size_t f = 0; f < cloudCustomFields.size(); ++f)
+      {
+        std::memcpy(customData, point + cloudCustomFields[f]->offset, customFieldSizes[f]);
+        customData += customFieldSizes[f];
+      }
+    }
+  }
+
+  stats.cloudBytes = numCloudPoints * cloud.point_step;
+  stats.scanBytes = (scan.ranges.size() + scan.intensities.size()) * sizeof(float) +
+    scan.custom_data.data.size() +
+    (scan.subscan_layout.angular_offsets.offsets.size() +
+     scan.scan_layout.angular_offsets.offsets.size() +
+     scan.scan_offsets_during_subscan.offsets.size()) * sizeof(double) +
+    (scan.subscan_layout.time_offsets.offsets.size() +
+     scan.scan_layout.time_offsets.offsets.size()) * 2 * sizeof(int32_t);
+
+  return stats;
+}
+
+}
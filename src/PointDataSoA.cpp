@@ -0,0 +1,445 @@
+#include <multilayer_laser_scan/PointDataSoA.h>
+#include <multilayer_laser_scan/PointFieldUtils.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace sensor_msgs
+{
+
+namespace
+{
+
+const PointField* findField(const std::vector<PointField>& fields, const std::string& name)
+{
+  for (const auto& field : fields)
+    if (field.name == name)
+      return &field;
+  return nullptr;
+}
+
+// The fixed size lets the compiler turn each memcpy into a single load and store.
+template<size_t N>
+void gatherFixed(const uint8_t* src, const size_t stride, const size_t begin, const size_t numPoints,
+    uint8_t* dst)
+{
+  for (size_t i = begin; i < numPoints; ++i)
+    std::memcpy(dst + i * N, src + i * stride, N);
+}
+
+template<size_t N>
+void scatterFixed(const uint8_t* src, const size_t numPoints, const size_t stride, uint8_t* dst)
+{
+  for (size_t i = 0; i < numPoints; ++i)
+    std::memcpy(dst + i * stride, src + i * N, N);
+}
+
+#if defined(__AVX2__)
+// 32-bit lanes at offsets k * stride from base
+inline __m256i gatherOffsets(const size_t stride)
+{
+  const auto s = static_cast<int>(stride);
+  return _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+}
+
+void gather2(const uint8_t* src, const size_t stride, const size_t numPoints, uint8_t* dst)
+{
+  size_t i = 0;
+  if (stride <= INT_MAX / 8)
+  {
+    // A 32-bit load of the field reads 2 bytes of the next point, so the last
+    // point of the buffer is never loaded by the vectorized loop.
+    const auto offsets = gatherOffsets(stride);
+    const auto mask = _mm256_set1_epi32(0xFFFF);
+    for (; i + 8 < numPoints; i += 8)
+    {
+      const auto base = reinterpret_cast<const int*>(src + i * stride);
+      const auto values = _mm256_and_si256(_mm256_i32gather_epi32(base, offsets, 1), mask);
+      const auto packed = _mm_packus_epi32(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), packed);
+    }
+  }
+  gatherFixed<2>(src, stride, i, numPoints, dst);
+}
+
+void gather4(const uint8_t* src, const size_t stride, const size_t numPoints, uint8_t* dst)
+{
+  size_t i = 0;
+  if (stride <= INT_MAX / 8)
+  {
+    const auto offsets = gatherOffsets(stride);
+    for (; i + 8 <= numPoints; i += 8)
+    {
+      const auto base = reinterpret_cast<const int*>(src + i * stride);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_i32gather_epi32(base, offsets, 1));
+    }
+  }
+  gatherFixed<4>(src, stride, i, numPoints, dst);
+}
+
+void gather8(const uint8_t* src, const size_t stride, const size_t numPoints, uint8_t* dst)
+{
+  size_t i = 0;
+  if (stride <= INT_MAX / 4)
+  {
+    const auto s = static_cast<int>(stride);
+    const auto offsets = _mm_setr_epi32(0, s, 2 * s, 3 * s);
+    for (; i + 4 <= numPoints; i += 4)
+    {
+      const auto base = reinterpret_cast<const long long*>(src + i * stride);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 8), _mm256_i32gather_epi64(base, offsets, 1));
+    }
+  }
+  gatherFixed<8>(src, stride, i, numPoints, dst);
+}
+#else
+void gather2(const uint8_t* src, const size_t stride, const size_t numPoints, uint8_t* dst)
+{
+  gatherFixed<2>(src, stride, 0, numPoints, dst);
+}
+
+void gather4(const uint8_t* src, const size_t stride, const size_t numPoints, uint8_t* dst)
+{
+  gatherFixed<4>(src, stride, 0, numPoints, dst);
+}
+
+void gather8(const uint8_t* src, const size_t stride, const size_t numPoints, uint8_t* dst)
+{
+  gatherFixed<8>(src, stride, 0, numPoints, dst);
+}
+#endif
+
+void swapBytes2(uint8_t* data, const size_t numElements)
+{
+  size_t i = 0;
+#if defined(__SSE2__)
+  for (; i + 8 <= numElements; i += 8)
+  {
+    const auto ptr = reinterpret_cast<__m128i*>(data + i * 2);
+    const auto v = _mm_loadu_si128(ptr);
+    _mm_storeu_si128(ptr, _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+  }
+#endif
+  for (; i < numElements; ++i)
+    std::swap(data[i * 2], data[i * 2 + 1]);
+}
+
+void swapBytes4(uint8_t* data, const size_t numElements)
+{
+  size_t i = 0;
+#if defined(__SSSE3__)
+  const auto shuffle = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+  for (; i + 4 <= numElements; i += 4)
+  {
+    const auto ptr = reinterpret_cast<__m128i*>(data + i * 4);
+    _mm_storeu_si128(ptr, _mm_shuffle_epi8(_mm_loadu_si128(ptr), shuffle));
+  }
+#endif
+  for (; i < numElements; ++i)
+  {
+    uint32_t value;
+    std::memcpy(&value, data + i * 4, 4);
+    value = __builtin_bswap32(value);
+    std::memcpy(data + i * 4, &value, 4);
+  }
+}
+
+void swapBytes8(uint8_t* data, const size_t numElements)
+{
+  size_t i = 0;
+#if defined(__SSSE3__)
+  const auto shuffle = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  for (; i + 2 <= numElements; i += 2)
+  {
+    const auto ptr = reinterpret_cast<__m128i*>(data + i * 8);
+    _mm_storeu_si128(ptr, _mm_shuffle_epi8(_mm_loadu_si128(ptr), shuffle));
+  }
+#endif
+  for (; i < numElements; ++i)
+  {
+    uint64_t value;
+    std::memcpy(&value, data + i * 8, 8);
+    value = __builtin_bswap64(value);
+    std::memcpy(data + i * 8, &value, 8);
+  }
+}
+
+}
+
+void GatherField(const uint8_t* src, const size_t stride, const size_t fieldSize, const size_t numPoints,
+    uint8_t* dst)
+{
+  if (numPoints == 0)
+    return;
+
+  if (stride == fieldSize)
+  {
+    std::memcpy(dst, src, numPoints * fieldSize);
+    return;
+  }
+
+  switch (fieldSize)
+  {
+    case 1:
+      gatherFixed<1>(src, stride, 0, numPoints, dst);
+      break;
+    case 2:
+      gather2(src, stride, numPoints, dst);
+      break;
+    case 4:
+      gather4(src, stride, numPoints, dst);
+      break;
+    case 8:
+      gather8(src, stride, numPoints, dst);
+      break;
+    default:
+      for (size_t i = 0; i < numPoints; ++i)
+        std::memcpy(dst + i * fieldSize, src + i * stride, fieldSize);
+  }
+}
+
+void ScatterField(const uint8_t* src, const size_t fieldSize, const size_t numPoints, const size_t stride,
+    uint8_t* dst)
+{
+  if (numPoints == 0)
+    return;
+
+  if (stride == fieldSize)
+  {
+    std::memcpy(dst, src, numPoints * fieldSize);
+    return;
+  }
+
+  // There is no scatter instruction below AVX-512, so fixed-size scalar stores
+  // are the fastest option.
+  switch (fieldSize)
+  {
+    case 1:
+      scatterFixed<1>(src, numPoints, stride, dst);
+      break;
+    case 2:
+      scatterFixed<2>(src, numPoints, stride, dst);
+      break;
+    case 4:
+      scatterFixed<4>(src, numPoints, stride, dst);
+      break;
+    case 8:
+      scatterFixed<8>(src, numPoints, stride, dst);
+      break;
+    default:
+      for (size_t i = 0; i < numPoints; ++i)
+        std::memcpy(dst + i * stride, src + i * fieldSize, fieldSize);
+  }
+}
+
+void SwapBytes(uint8_t* data, const size_t elementSize, const size_t numElements)
+{
+  switch (elementSize)
+  {
+    case 1:
+      break;
+    case 2:
+      swapBytes2(data, numElements);
+      break;
+    case 4:
+      swapBytes4(data, numElements);
+      break;
+    case 8:
+      swapBytes8(data, numElements);
+      break;
+    default:
+      throw std::runtime_error("Cannot swap bytes of elements of size " + std::to_string(elementSize));
+  }
+}
+
+PointDataSoAView::PointDataSoAView(const PointData& pointData, const std::vector<std::string>& fieldNames)
+{
+  this->Extract(pointData, fieldNames);
+}
+
+void PointDataSoAView::Extract(const PointData& pointData, const std::vector<std::string>& fieldNames)
+{
+  // pointers into pointData, so that nothing is copied before all fields are validated
+  auto& selected = this->selectedFields;
+  selected.clear();
+  if (fieldNames.empty())
+  {
+    for (const auto& field : pointData.fields)
+      selected.push_back(&field);
+  }
+  else
+  {
+    for (const auto& name : fieldNames)
+    {
+      const auto field = findField(pointData.fields, name);
+      if (field == nullptr)
+        throw std::runtime_error("Field " + name + " does not exist");
+      selected.push_back(field);
+    }
+  }
+
+  const size_t step = pointData.point_step;
+  for (const auto* field : selected)
+  {
+    if (field->offset + field->count * impl::sizeOfPointField(field->datatype) > step)
+      throw std::runtime_error("Field " + field->name + " does not fit into point_step");
+  }
+
+  this->numPoints = step > 0 ? pointData.data.size() / step : 0;
+
+  // consecutive scans usually have the same fields, so they are only copied when they change
+  bool sameFields = selected.size() == this->fields.size();
+  for (size_t c = 0; sameFields && c < selected.size(); ++c)
+    sameFields = impl::samePointField(*selected[c], this->fields[c]);
+  if (!sameFields)
+  {
+    this->fields.resize(selected.size());
+    for (size_t c = 0; c < selected.size(); ++c)
+      this->fields[c] = *selected[c];
+  }
+  selected.clear();
+
+  // keep the buffers of the previous extraction
+  this->channels.resize(this->fields.size());
+
+  const auto swap = static_cast<bool>(pointData.is_bigendian) != impl::isHostBigEndian();
+  for (size_t c = 0; c < this->fields.size(); ++c)
+  {
+    auto& channel = this->channels[c];
+    channel.field = this->fields[c];
+    channel.valueSize = impl::sizeOfPointField(channel.field.datatype);
+    const auto fieldSize = channel.valueSize * channel.field.count;
+    channel.data.resize(this->numPoints * fieldSize);
+    if (this->numPoints == 0)
+      continue;
+
+    GatherField(pointData.data.data() + channel.field.offset, step, fieldSize, this->numPoints,
+        channel.data.data());
+    if (swap)
+      SwapBytes(channel.data.data(), channel.valueSize, this->numPoints * channel.field.count);
+  }
+}
+
+void PointDataSoAView::AddField(const std::string& name, const uint8_t datatype, const uint32_t count)
+{
+  if (this->HasField(name))
+    throw std::runtime_error("Field " + name + " already exists");
+
+  Channel channel;
+  channel.field.name = name;
+  channel.field.datatype = datatype;
+  channel.field.count = count;
+  channel.valueSize = impl::sizeOfPointField(datatype);
+  channel.data.resize(this->numPoints * channel.valueSize * count, 0);
+
+  this->fields.push_back(channel.field);
+  this->channels.push_back(std::move(channel));
+}
+
+void PointDataSoAView::Resize(const size_t numPoints)
+{
+  this->numPoints = numPoints;
+  for (auto& channel : this->channels)
+    channel.data.resize(numPoints * channel.valueSize * channel.field.count, 0);
+}
+
+size_t PointDataSoAView::NumPoints() const
+{
+  return this->numPoints;
+}
+
+const std::vector<PointField>& PointDataSoAView::GetFields() const
+{
+  return this->fields;
+}
+
+bool PointDataSoAView::HasField(const std::string& name) const
+{
+  return findField(this->fields, name) != nullptr;
+}
+
+uint8_t* PointDataSoAView::GetBytes(const std::string& name, const size_t valueSize)
+{
+  for (size_t c = 0; c < this->fields.size(); ++c)
+  {
+    auto& channel = this->channels[c];
+    if (channel.field.name != name)
+      continue;
+    if (channel.valueSize != valueSize)
+      throw std::runtime_error("Field " + name + " has values of " + std::to_string(channel.valueSize) +
+          " bytes, but " + std::to_string(valueSize) + " were requested");
+    return channel.data.data();
+  }
+  throw std::runtime_error("Field " + name + " does not exist");
+}
+
+void PointDataSoAView::Scatter(PointData& pointData) const
+{
+  const size_t step = pointData.point_step;
+  const auto targetPoints = step > 0 ? pointData.data.size() / step : 0;
+  if (targetPoints != this->numPoints)
+    throw std::runtime_error("PointData have " + std::to_string(targetPoints) + " points, but " +
+        std::to_string(this->numPoints) + " are required");
+
+  // all fields are validated before anything is written; they are looked up
+  // again below instead of being stored, so that no scratch buffer is needed
+  for (size_t c = 0; c < this->fields.size(); ++c)
+  {
+    const auto& channel = this->channels[c];
+    const auto field = findField(pointData.fields, channel.field.name);
+    if (field == nullptr)
+      throw std::runtime_error("Field " + channel.field.name + " does not exist");
+    if (field->datatype != channel.field.datatype || field->count != channel.field.count)
+      throw std::runtime_error("Field " + channel.field.name + " has a different datatype or count");
+    if (field->offset + field->count * channel.valueSize > step)
+      throw std::runtime_error("Field " + channel.field.name + " does not fit into point_step");
+  }
+
+  if (this->numPoints == 0)
+    return;
+
+  const auto swap = static_cast<bool>(pointData.is_bigendian) != impl::isHostBigEndian();
+  std::vector<uint8_t> swapped;
+  for (size_t c = 0; c < this->fields.size(); ++c)
+  {
+    const auto& channel = this->channels[c];
+    const uint8_t* src = channel.data.data();
+    if (swap && channel.valueSize > 1)
+    {
+      // the channel itself stays in host byte order
+      swapped.assign(channel.data.begin(), channel.data.end());
+      SwapBytes(swapped.data(), channel.valueSize, this->numPoints * channel.field.count);
+      src = swapped.data();
+    }
+    ScatterField(src, channel.valueSize * channel.field.count, this->numPoints, step,
+        pointData.data.data() + findField(pointData.fields, channel.field.name)->offset);
+  }
+}
+
+void PointDataSoAView::Pack(PointData& pointData) const
+{
+  pointData.fields = this->fields;
+  size_t offset = 0;
+  for (size_t c = 0; c < this->fields.size(); ++c)
+  {
+    pointData.fields[c].offset = static_cast<PointField::_offset_type>(offset);
+    offset += this->channels[c].valueSize * this->fields[c].count;
+  }
+  pointData.point_step = static_cast<uint32_t>(offset);
+  pointData.is_bigendian = impl::isHostBigEndian();
+  pointData.data.resize(this->numPoints * offset);
+
+  this->Scatter(pointData);
+}
+
+}
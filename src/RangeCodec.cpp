@@ -0,0 +1,516 @@
+#include <multilayer_laser_scan/RangeCodec.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanLayout.h>
+#include <multilayer_laser_scan/RangeEncoding.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace sensor_msgs
+{
+
+namespace
+{
+
+constexpr uint8_t MAGIC[4] = {'M', 'L', 'R', 'C'};
+constexpr uint8_t VERSION = 1;
+constexpr size_t HEADER_SIZE = 16;
+// index in the block and the high bits of the value
+constexpr size_t EXCEPTION_SIZE = 3;
+
+void writeUint32(uint8_t* const data, const uint32_t value)
+{
+  data[0] = static_cast<uint8_t>(value);
+  data[1] = static_cast<uint8_t>(value >> 8);
+  data[2] = static_cast<uint8_t>(value >> 16);
+  data[3] = static_cast<uint8_t>(value >> 24);
+}
+
+uint32_t readUint32(const uint8_t* const data)
+{
+  return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+    (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+inline uint16_t zigzag(const uint16_t residual)
+{
+  const auto signedResidual = static_cast<int16_t>(residual);
+  return static_cast<uint16_t>((static_cast<uint16_t>(signedResidual) << 1) ^
+    static_cast<uint16_t>(signedResidual >> 15));
+}
+
+inline uint16_t unzigzag(const uint16_t value)
+{
+  return static_cast<uint16_t>((value >> 1) ^ static_cast<uint16_t>(-(value & 1)));
+}
+
+inline uint8_t bitWidth(const uint16_t value)
+{
+  // branchless, the residuals are often zero
+  return static_cast<uint8_t>(31 - __builtin_clz((static_cast<uint32_t>(value) << 1) | 1u));
+}
+
+inline size_t packedSize(const size_t count, const uint8_t width)
+{
+  return (count * width + 7) / 8;
+}
+
+/**
+ * @return The bit width for which the block is the smallest, taking into
+ *         account that each value wider than it costs EXCEPTION_SIZE bytes.
+ * @param numExceptions Receives the number of values wider than the result.
+ */
+uint8_t bestBitWidth(const uint16_t* const values, const size_t count, size_t& numExceptions)
+{
+  // four interleaved histograms break the dependency chains between increments
+  uint32_t histograms[4][17] = {{0}};
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    ++histograms[0][bitWidth(values[i])];
+    ++histograms[1][bitWidth(values[i + 1])];
+    ++histograms[2][bitWidth(values[i + 2])];
+    ++histograms[3][bitWidth(values[i + 3])];
+  }
+  for (; i < count; ++i)
+    ++histograms[0][bitWidth(values[i])];
+
+  uint8_t bestWidth = 16;
+  size_t bestSize = packedSize(count, 16);
+  numExceptions = 0;
+  size_t wider = 0;
+  for (int width = 15; width >= 0; --width)
+  {
+    wider += histograms[0][width + 1] + histograms[1][width + 1] +
+      histograms[2][width + 1] + histograms[3][width + 1];
+    const auto size = packedSize(count, width) + wider * EXCEPTION_SIZE;
+    if (size < bestSize)
+    {
+      bestSize = size;
+      bestWidth = static_cast<uint8_t>(width);
+      numExceptions = wider;
+    }
+  }
+  return bestWidth;
+}
+
+/**
+ * Predictions of the next value of each ring. Invalid values do not update
+ * the prediction, so that they cost one exception and not two.
+ */
+struct RingPredictions
+{
+  explicit RingPredictions(const size_t numRings) :
+    previous(numRings, 0), previous2(numRings, 0), started(numRings, 0)
+  {
+  }
+
+  std::vector<uint16_t> previous;
+  std::vector<uint16_t> previous2;
+  std::vector<uint16_t> started;  // 0 or 0xFFFF so that it can be used as a SIMD mask
+};
+
+template<bool Linear>
+inline uint16_t predict(const RingPredictions& predictions, const size_t ring)
+{
+  return Linear ?
+    static_cast<uint16_t>(2 * predictions.previous[ring] - predictions.previous2[ring]) :
+    predictions.previous[ring];
+}
+
+inline void updatePrediction(RingPredictions& predictions, const size_t ring, const uint16_t value)
+{
+  if (value == SCALED_INVALID)
+    return;
+  predictions.previous2[ring] = predictions.started[ring] ? predictions.previous[ring] : value;
+  predictions.previous[ring] = value;
+  predictions.started[ring] = 0xFFFF;
+}
+
+#if defined(__SSE2__)
+template<bool Linear>
+inline __m128i predict(const __m128i previous, const __m128i previous2)
+{
+  return Linear ? _mm_sub_epi16(_mm_add_epi16(previous, previous), previous2) : previous;
+}
+
+inline __m128i select(const __m128i mask, const __m128i a, const __m128i b)
+{
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+template<bool Linear>
+inline void updatePrediction(RingPredictions& predictions, const size_t ring, const __m128i value)
+{
+  const auto ones = _mm_set1_epi16(-1);
+  const auto valid = _mm_xor_si128(_mm_cmpeq_epi16(value, ones), ones);
+  auto previous = reinterpret_cast<__m128i*>(predictions.previous.data() + ring);
+  const auto oldPrevious = _mm_loadu_si128(previous);
+  if (Linear)
+  {
+    auto previous2 = reinterpret_cast<__m128i*>(predictions.previous2.data() + ring);
+    auto started = reinterpret_cast<__m128i*>(predictions.started.data() + ring);
+    const auto oldStarted = _mm_loadu_si128(started);
+    const auto newPrevious2 = select(oldStarted, oldPrevious, value);
+    _mm_storeu_si128(previous2, select(valid, newPrevious2, _mm_loadu_si128(previous2)));
+    _mm_storeu_si128(started, _mm_or_si128(oldStarted, valid));
+  }
+  _mm_storeu_si128(previous, select(valid, value, oldPrevious));
+}
+#endif
+
+/**
+ * Compute residuals of all points. The rings are predicted independently,
+ * but the points are processed in the scan-major order to access memory
+ * sequentially. Vectorized with SSE2.
+ */
+template<bool Linear>
+void computeResiduals(const uint16_t* raw, const size_t numScans, const size_t subscanLength,
+    uint16_t* residuals)
+{
+  RingPredictions predictions(subscanLength);
+  for (size_t scan = 0; scan < numScans; ++scan)
+  {
+    size_t ring = 0;
+#if defined(__SSE2__)
+    for (; ring + 8 <= subscanLength; ring += 8)
+    {
+      const auto value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + ring));
+      const auto prediction = predict<Linear>(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(predictions.previous.data() + ring)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(predictions.previous2.data() + ring)));
+      const auto residual = _mm_sub_epi16(value, prediction);
+      const auto zigzag = _mm_xor_si128(_mm_slli_epi16(residual, 1), _mm_srai_epi16(residual, 15));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(residuals + ring), zigzag);
+      updatePrediction<Linear>(predictions, ring, value);
+    }
+#endif
+    for (; ring < subscanLength; ++ring)
+    {
+      // residuals are computed modulo 2^16, so any values are lossless
+      const auto value = raw[ring];
+      residuals[ring] = zigzag(static_cast<uint16_t>(value - predict<Linear>(predictions, ring)));
+      updatePrediction(predictions, ring, value);
+    }
+    raw += subscanLength;
+    residuals += subscanLength;
+  }
+}
+
+template<bool Linear>
+void reconstructValues(const uint16_t* residuals, const size_t numScans, const size_t subscanLength,
+    uint16_t* raw)
+{
+  RingPredictions predictions(subscanLength);
+  for (size_t scan = 0; scan < numScans; ++scan)
+  {
+    size_t ring = 0;
+#if defined(__SSE2__)
+    const auto one = _mm_set1_epi16(1);
+    for (; ring + 8 <= subscanLength; ring += 8)
+    {
+      const auto zigzag = _mm_loadu_si128(reinterpret_cast<const __m128i*>(residuals + ring));
+      const auto residual = _mm_xor_si128(_mm_srli_epi16(zigzag, 1),
+        _mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(zigzag, one)));
+      const auto prediction = predict<Linear>(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(predictions.previous.data() + ring)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(predictions.previous2.data() + ring)));
+      const auto value = _mm_add_epi16(prediction, residual);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(raw + ring), value);
+      updatePrediction<Linear>(predictions, ring, value);
+    }
+#endif
+    for (; ring < subscanLength; ++ring)
+    {
+      const auto value = static_cast<uint16_t>(predict<Linear>(predictions, ring) + unzigzag(residuals[ring]));
+      raw[ring] = value;
+      updatePrediction(predictions, ring, value);
+    }
+    raw += subscanLength;
+    residuals += subscanLength;
+  }
+}
+
+inline void writeUint64(uint8_t* const data, const uint64_t value)
+{
+  writeUint32(data, static_cast<uint32_t>(value));
+  writeUint32(data + 4, static_cast<uint32_t>(value >> 32));
+}
+
+inline uint64_t readUint64(const uint8_t* const data)
+{
+  return static_cast<uint64_t>(readUint32(data)) | (static_cast<uint64_t>(readUint32(data + 4)) << 32);
+}
+
+inline uint64_t lowBits(const unsigned int bits)
+{
+  return bits >= 64 ? ~static_cast<uint64_t>(0) : (static_cast<uint64_t>(1) << bits) - 1;
+}
+
+/**
+ * Bit-pack the low width bits of the values. Groups of 8 values take exactly
+ * width bytes, so they are packed independently of each other.
+ * @note Writes up to 16 bytes after the returned pointer.
+ * @return Pointer after the last written byte.
+ */
+uint8_t* pack(const uint16_t* const values, const size_t count, const uint8_t width, uint8_t* out)
+{
+  const uint64_t mask = lowBits(width);
+  const unsigned int halfBits = 4u * width;
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8, out += width)
+  {
+    uint64_t low = 0;
+    uint64_t high = 0;
+    for (unsigned int j = 0; j < 4; ++j)
+    {
+      low |= (values[i + j] & mask) << (j * width);
+      high |= (values[i + 4 + j] & mask) << (j * width);
+    }
+    // the second half starts in the middle of a byte if width is odd
+    const auto highByte = halfBits / 8;
+    const auto highShift = halfBits % 8;
+    writeUint64(out, low);
+    if (highShift == 0)
+      writeUint64(out + highByte, high);
+    else
+      writeUint64(out + highByte, (high << highShift) | (low >> (8 * highByte)));
+  }
+
+  uint32_t accumulator = 0;
+  unsigned int bits = 0;
+  for (; i < count; ++i)
+  {
+    accumulator |= static_cast<uint32_t>(values[i] & mask) << bits;
+    bits += width;
+    writeUint32(out, accumulator);
+    out += bits / 8;
+    accumulator >>= bits & ~7u;
+    bits %= 8;
+  }
+  return out + (bits > 0 ? 1 : 0);
+}
+
+/**
+ * Unpack count values of width bits.
+ * @param end End of the readable data. Bytes up to it may be read even if
+ *            they do not belong to the packed values.
+ * @return Pointer after the last read byte.
+ */
+const uint8_t* unpack(const uint8_t* in, const size_t count, const uint8_t width, uint16_t* const values,
+    const uint8_t* const end)
+{
+  const uint64_t mask = lowBits(width);
+  const uint64_t halfMask = lowBits(4u * width);
+  const unsigned int halfBits = 4u * width;
+  const auto packedEnd = in + packedSize(count, width);
+  size_t i = 0;
+  for (; i + 8 <= count && end - in >= 16; i += 8, in += width)
+  {
+    const auto low = readUint64(in) & halfMask;
+    const auto high = (readUint64(in + halfBits / 8) >> (halfBits % 8)) & halfMask;
+    for (unsigned int j = 0; j < 4; ++j)
+    {
+      values[i + j] = static_cast<uint16_t>((low >> (j * width)) & mask);
+      values[i + 4 + j] = static_cast<uint16_t>((high >> (j * width)) & mask);
+    }
+  }
+
+  unsigned int bits = 0;
+  for (; i < count; ++i)
+  {
+    // at most 7 + 16 bits are needed for a value
+    uint32_t word = 0;
+    for (size_t j = 0; j < 3 && in + j < packedEnd; ++j)
+      word |= static_cast<uint32_t>(in[j]) << (8 * j);
+    values[i] = static_cast<uint16_t>((word >> bits) & mask);
+    bits += width;
+    in += bits / 8;
+    bits %= 8;
+  }
+  return packedEnd;
+}
+
+}
+
+double RangeCodec::Statistics::CompressionRatio() const
+{
+  if (this->encodedBytes == 0)
+    return 0.0;
+  return static_cast<double>(this->rawBytes) / static_cast<double>(this->encodedBytes);
+}
+
+constexpr size_t RangeCodec::BLOCK_SIZE;
+
+RangeCodec::RangeCodec(const Predictor _predictor) : predictor(_predictor)
+{
+  if (_predictor != PREDICT_PREVIOUS && _predictor != PREDICT_LINEAR)
+    throw std::runtime_error("Unknown predictor " + std::to_string(_predictor));
+}
+
+RangeCodec::Predictor RangeCodec::GetPredictor() const
+{
+  return this->predictor;
+}
+
+RangeCodec::Statistics RangeCodec::Encode(const uint16_t* const raw, const size_t numScans,
+    const size_t subscanLength, std::vector<uint8_t>& encoded)
+{
+  if (numScans > UINT32_MAX || subscanLength > UINT32_MAX)
+    throw std::runtime_error("The scan is too large to be encoded");
+
+  const auto length = numScans * subscanLength;
+  this->residuals.resize(length);
+
+  if (this->predictor == PREDICT_LINEAR)
+    computeResiduals<true>(raw, numScans, subscanLength, this->residuals.data());
+  else
+    computeResiduals<false>(raw, numScans, subscanLength, this->residuals.data());
+
+  const auto numBlocks = (length + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  // pack() writes a few bytes ahead
+  encoded.resize(HEADER_SIZE + numBlocks * (2 + packedSize(BLOCK_SIZE, 16)) + 16);
+
+  auto out = encoded.data();
+  std::copy(MAGIC, MAGIC + 4, out);
+  out[4] = VERSION;
+  out[5] = static_cast<uint8_t>(this->predictor);
+  out[6] = out[7] = 0;
+  writeUint32(out + 8, static_cast<uint32_t>(numScans));
+  writeUint32(out + 12, static_cast<uint32_t>(subscanLength));
+  out += HEADER_SIZE;
+
+  for (size_t first = 0; first < length; first += BLOCK_SIZE)
+  {
+    const auto count = std::min(BLOCK_SIZE, length - first);
+    const auto block = this->residuals.data() + first;
+    size_t numExceptions;
+    const auto width = bestBitWidth(block, count, numExceptions);
+    *out++ = width;
+    *out++ = static_cast<uint8_t>(numExceptions);
+    out = pack(block, count, width, out);
+    for (size_t i = 0; numExceptions > 0; ++i)
+    {
+      const auto high = static_cast<uint16_t>(block[i] >> width);
+      if (high != 0)
+      {
+        *out++ = static_cast<uint8_t>(i);
+        *out++ = static_cast<uint8_t>(high);
+        *out++ = static_cast<uint8_t>(high >> 8);
+        --numExceptions;
+      }
+    }
+  }
+
+  encoded.resize(out - encoded.data());
+
+  Statistics stats;
+  stats.rawBytes = length * sizeof(uint16_t);
+  stats.encodedBytes = encoded.size();
+  return stats;
+}
+
+RangeCodec::Statistics RangeCodec::Decode(const uint8_t* const encoded, const size_t size,
+    std::vector<uint16_t>& raw, size_t* const numScans, size_t* const subscanLength)
+{
+  if (size < HEADER_SIZE || !std::equal(MAGIC, MAGIC + 4, encoded))
+    throw std::runtime_error("The data are not encoded by RangeCodec");
+  if (encoded[4] != VERSION)
+    throw std::runtime_error("Unsupported RangeCodec version " + std::to_string(encoded[4]));
+  const auto streamPredictor = encoded[5];
+  if (streamPredictor != PREDICT_PREVIOUS && streamPredictor != PREDICT_LINEAR)
+    throw std::runtime_error("Unknown predictor " + std::to_string(streamPredictor));
+
+  const size_t scans = readUint32(encoded + 8);
+  const size_t ringLength = readUint32(encoded + 12);
+  const auto length = scans * ringLength;
+  // each block takes at least two bytes
+  if ((length + BLOCK_SIZE - 1) / BLOCK_SIZE * 2 > size - HEADER_SIZE)
+    throw std::runtime_error("RangeCodec data are truncated");
+
+  this->residuals.resize(length);
+  const auto end = encoded + size;
+  auto in = encoded + HEADER_SIZE;
+  for (size_t first = 0; first < length; first += BLOCK_SIZE)
+  {
+    const auto count = std::min(BLOCK_SIZE, length - first);
+    const auto block = this->residuals.data() + first;
+    if (end - in < 2)
+      throw std::runtime_error("RangeCodec data are truncated");
+    const auto width = *in++;
+    const auto numExceptions = *in++;
+    if (width > 16 || numExceptions > count)
+      throw std::runtime_error("RangeCodec data are corrupted");
+    if (static_cast<size_t>(end - in) < packedSize(count, width) + numExceptions * EXCEPTION_SIZE)
+      throw std::runtime_error("RangeCodec data are truncated");
+    in = unpack(in, count, width, block, end);
+    for (size_t i = 0; i < numExceptions; ++i, in += EXCEPTION_SIZE)
+    {
+      if (in[0] >= count)
+        throw std::runtime_error("RangeCodec data are corrupted");
+      const auto high = static_cast<uint32_t>(in[1]) | (static_cast<uint32_t>(in[2]) << 8);
+      block[in[0]] = static_cast<uint16_t>(block[in[0]] | (high << width));
+    }
+  }
+  if (in != end)
+    throw std::runtime_error("RangeCodec data have " + std::to_string(end - in) +
+      " superfluous bytes");
+
+  raw.resize(length);
+  if (streamPredictor == PREDICT_LINEAR)
+    reconstructValues<true>(this->residuals.data(), scans, ringLength, raw.data());
+  else
+    reconstructValues<false>(this->residuals.data(), scans, ringLength, raw.data());
+
+  if (numScans != nullptr)
+    *numScans = scans;
+  if (subscanLength != nullptr)
+    *subscanLength = ringLength;
+
+  Statistics stats;
+  stats.rawBytes = length * sizeof(uint16_t);
+  stats.encodedBytes = size;
+  return stats;
+}
+
+RangeCodec::Statistics PackRanges(CompressedMultiLayerLaserScan& scan,
+    const RangeCodec::Predictor predictor)
+{
+  const auto numScans = ParsedScanLayout(scan.scan_layout).Length();
+  const auto subscanLength = ParsedScanLayout(scan.subscan_layout).Length();
+  if (numScans * subscanLength != scan.ranges.size())
+    throw std::runtime_error("Scan layout " + std::to_string(numScans * subscanLength) +
+      " size doesn't correspond to the number of actual points " +
+      std::to_string(scan.ranges.size()));
+
+  RangeCodec codec(predictor);
+  const auto stats = codec.Encode(scan.ranges.data(), numScans, subscanLength, scan.packed_ranges);
+  scan.ranges.clear();
+  return stats;
+}
+
+void UnpackRanges(CompressedMultiLayerLaserScan& scan)
+{
+  if (scan.packed_ranges.empty())
+    return;
+
+  RangeCodec codec;
+  std::vector<uint16_t> ranges;
+  size_t numScans;
+  size_t subscanLength;
+  codec.Decode(scan.packed_ranges.data(), scan.packed_ranges.size(), ranges, &numScans,
+    &subscanLength);
+
+  if (numScans != ParsedScanLayout(scan.scan_layout).Length() ||
+      subscanLength != ParsedScanLayout(scan.subscan_layout).Length())
+    throw std::runtime_error("Packed ranges do not correspond to the scan layout");
+
+  scan.ranges.swap(ranges);
+  scan.packed_ranges.clear();
+}
+
+}
@@ -0,0 +1,317 @@
+#include <multilayer_laser_scan/RangeEncoding.h>
+#include <multilayer_laser_scan/RangeCodec.h>
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace sensor_msgs
+{
+
+namespace
+{
+
+// raw values are valid in <0, 65534>; everything that rounds outside of it is invalid
+constexpr float SCALED_MIN = -0.5f;
+constexpr float SCALED_MAX = 65534.5f;
+
+void checkEncoding(const uint8_t encoding)
+{
+  if (encoding != CompressedMultiLayerLaserScan::ENCODING_UINT16_SCALED &&
+      encoding != CompressedMultiLayerLaserScan::ENCODING_FLOAT16)
+    throw std::runtime_error("Unknown encoding " + std::to_string(encoding));
+}
+
+}
+
+ChannelEncoding ChannelEncoding::Scaled(const float scale, const float offset)
+{
+  if (!(scale > 0.0f))
+    throw std::runtime_error("Scale of the encoding has to be positive, " +
+      std::to_string(scale) + " given");
+
+  ChannelEncoding result;
+  result.encoding = CompressedMultiLayerLaserScan::ENCODING_UINT16_SCALED;
+  result.scale = scale;
+  result.offset = offset;
+  return result;
+}
+
+ChannelEncoding ChannelEncoding::ScaledRange(const float min, const float max)
+{
+  if (!(max > min))
+    throw std::runtime_error("Invalid range of the encoding <" + std::to_string(min) +
+      ", " + std::to_string(max) + ">");
+
+  // enlarge the scale by a few ulps so that max still rounds into the valid range
+  const auto scale = (max - min) / (SCALED_INVALID - 1) * (1.0f + 4 * std::numeric_limits<float>::epsilon());
+  return ChannelEncoding::Scaled(scale, min);
+}
+
+ChannelEncoding ChannelEncoding::Half()
+{
+  ChannelEncoding result;
+  result.encoding = CompressedMultiLayerLaserScan::ENCODING_FLOAT16;
+  return result;
+}
+
+float ChannelEncoding::Precision() const
+{
+  if (this->encoding == CompressedMultiLayerLaserScan::ENCODING_FLOAT16)
+    return 1.0f / 2048.0f;
+  return this->scale / 2;
+}
+
+void EncodeScaled(const float* const values, const size_t length, const float scale,
+    const float offset, uint16_t* const raw)
+{
+  const auto invScale = 1.0f / scale;
+  size_t i = 0;
+
+#if defined(__AVX__)
+  const auto inv = _mm256_set1_ps(invScale);
+  const auto off = _mm256_set1_ps(offset);
+  const auto lo = _mm256_set1_ps(SCALED_MIN);
+  const auto hi = _mm256_set1_ps(SCALED_MAX);
+  const auto invalid = _mm256_set1_ps(SCALED_INVALID);
+  for (; i + 16 <= length; i += 16)
+  {
+    auto q0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(values + i), off), inv);
+    auto q1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(values + i + 8), off), inv);
+    // ordered comparisons are false for NaNs
+    const auto valid0 = _mm256_and_ps(_mm256_cmp_ps(q0, lo, _CMP_GE_OQ), _mm256_cmp_ps(q0, hi, _CMP_LT_OQ));
+    const auto valid1 = _mm256_and_ps(_mm256_cmp_ps(q1, lo, _CMP_GE_OQ), _mm256_cmp_ps(q1, hi, _CMP_LT_OQ));
+    q0 = _mm256_blendv_ps(invalid, q0, valid0);
+    q1 = _mm256_blendv_ps(invalid, q1, valid1);
+    const auto r0 = _mm256_cvtps_epi32(q0);
+    const auto r1 = _mm256_cvtps_epi32(q1);
+    const auto packed0 = _mm_packus_epi32(_mm256_castsi256_si128(r0), _mm256_extractf128_si256(r0, 1));
+    const auto packed1 = _mm_packus_epi32(_mm256_castsi256_si128(r1), _mm256_extractf128_si256(r1, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(raw + i), packed0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(raw + i + 8), packed1);
+  }
+#elif defined(__SSE2__)
+  const auto inv = _mm_set1_ps(invScale);
+  const auto off = _mm_set1_ps(offset);
+  const auto lo = _mm_set1_ps(SCALED_MIN);
+  const auto hi = _mm_set1_ps(SCALED_MAX);
+  const auto invalid = _mm_set1_ps(SCALED_INVALID);
+  // SSE2 only has signed saturating pack, so shift the values to the signed range and back
+  const auto bias = _mm_set1_epi32(32768);
+  const auto flip = _mm_set1_epi16(static_cast<int16_t>(0x8000));
+  for (; i + 8 <= length; i += 8)
+  {
+    auto q0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(values + i), off), inv);
+    auto q1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(values + i + 4), off), inv);
+    // ordered comparisons are false for NaNs
+    const auto valid0 = _mm_and_ps(_mm_cmpge_ps(q0, lo), _mm_cmplt_ps(q0, hi));
+    const auto valid1 = _mm_and_ps(_mm_cmpge_ps(q1, lo), _mm_cmplt_ps(q1, hi));
+    q0 = _mm_or_ps(_mm_and_ps(valid0, q0), _mm_andnot_ps(valid0, invalid));
+    q1 = _mm_or_ps(_mm_and_ps(valid1, q1), _mm_andnot_ps(valid1, invalid));
+    const auto r0 = _mm_sub_epi32(_mm_cvtps_epi32(q0), bias);
+    const auto r1 = _mm_sub_epi32(_mm_cvtps_epi32(q1), bias);
+    const auto packed = _mm_xor_si128(_mm_packs_epi32(r0, r1), flip);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(raw + i), packed);
+  }
+#endif
+
+  for (; i < length; ++i)
+  {
+    const auto q = (values[i] - offset) * invScale;
+    if (q >= SCALED_MIN && q < SCALED_MAX)
+      raw[i] = static_cast<uint16_t>(std::lrint(q));
+    else
+      raw[i] = SCALED_INVALID;
+  }
+}
+
+void DecodeScaled(const uint16_t* const raw, const size_t length, const float scale,
+    const float offset, float* const values)
+{
+  size_t i = 0;
+
+#if defined(__AVX__)
+  const auto s = _mm256_set1_ps(scale);
+  const auto off = _mm256_set1_ps(offset);
+  const auto invalid = _mm256_set1_ps(SCALED_INVALID);
+  const auto nan = _mm256_set1_ps(std::numeric_limits<float>::quiet_NaN());
+  const auto zero = _mm_setzero_si128();
+  for (; i + 8 <= length; i += 8)
+  {
+    const auto r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + i));
+    const auto r32 = _mm256_insertf128_si256(
+      _mm256_castsi128_si256(_mm_unpacklo_epi16(r, zero)), _mm_unpackhi_epi16(r, zero), 1);
+    const auto q = _mm256_cvtepi32_ps(r32);
+#if defined(__FMA__)
+    const auto v = _mm256_fmadd_ps(q, s, off);
+#else
+    const auto v = _mm256_add_ps(_mm256_mul_ps(q, s), off);
+#endif
+    _mm256_storeu_ps(values + i, _mm256_blendv_ps(v, nan, _mm256_cmp_ps(q, invalid, _CMP_EQ_OQ)));
+  }
+#elif defined(__SSE2__)
+  const auto s = _mm_set1_ps(scale);
+  const auto off = _mm_set1_ps(offset);
+  const auto invalid = _mm_set1_ps(SCALED_INVALID);
+  const auto nan = _mm_set1_ps(std::numeric_limits<float>::quiet_NaN());
+  const auto zero = _mm_setzero_si128();
+  for (; i + 8 <= length; i += 8)
+  {
+    const auto r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + i));
+    const auto q0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(r, zero));
+    const auto q1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(r, zero));
+    const auto v0 = _mm_add_ps(_mm_mul_ps(q0, s), off);
+    const auto v1 = _mm_add_ps(_mm_mul_ps(q1, s), off);
+    const auto invalid0 = _mm_cmpeq_ps(q0, invalid);
+    const auto invalid1 = _mm_cmpeq_ps(q1, invalid);
+    _mm_storeu_ps(values + i, _mm_or_ps(_mm_and_ps(invalid0, nan), _mm_andnot_ps(invalid0, v0)));
+    _mm_storeu_ps(values + i + 4, _mm_or_ps(_mm_and_ps(invalid1, nan), _mm_andnot_ps(invalid1, v1)));
+  }
+#endif
+
+  for (; i < length; ++i)
+  {
+    if (raw[i] == SCALED_INVALID)
+      values[i] = std::numeric_limits<float>::quiet_NaN();
+    else
+      values[i] = static_cast<float>(raw[i]) * scale + offset;
+  }
+}
+
+void EncodeHalf(const float* const values, const size_t length, uint16_t* const raw)
+{
+  size_t i = 0;
+
+#if defined(__F16C__)
+  for (; i + 8 <= length; i += 8)
+  {
+    const auto h = _mm256_cvtps_ph(_mm256_loadu_ps(values + i), _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(raw + i), h);
+  }
+#endif
+
+  for (; i < length; ++i)
+    raw[i] = FloatToHalf(values[i]);
+}
+
+void DecodeHalf(const uint16_t* const raw, const size_t length, float* const values)
+{
+  size_t i = 0;
+
+#if defined(__F16C__)
+  for (; i + 8 <= length; i += 8)
+  {
+    const auto h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + i));
+    _mm256_storeu_ps(values + i, _mm256_cvtph_ps(h));
+  }
+#endif
+
+  for (; i < length; ++i)
+    values[i] = HalfToFloat(raw[i]);
+}
+
+void Encode(const float* const values, const size_t length, const ChannelEncoding& encoding,
+    uint16_t* const raw)
+{
+  checkEncoding(encoding.encoding);
+  if (encoding.encoding == CompressedMultiLayerLaserScan::ENCODING_FLOAT16)
+    EncodeHalf(values, length, raw);
+  else
+    EncodeScaled(values, length, encoding.scale, encoding.offset, raw);
+}
+
+void Decode(const uint16_t* const raw, const size_t length, const ChannelEncoding& encoding,
+    float* const values)
+{
+  checkEncoding(encoding.encoding);
+  if (encoding.encoding == CompressedMultiLayerLaserScan::ENCODING_FLOAT16)
+    DecodeHalf(raw, length, values);
+  else
+    DecodeScaled(raw, length, encoding.scale, encoding.offset, values);
+}
+
+ChannelEncoding GetRangeEncoding(const CompressedMultiLayerLaserScan& scan)
+{
+  ChannelEncoding result;
+  result.encoding = scan.range_encoding;
+  result.scale = scan.range_scale;
+  result.offset = scan.range_offset;
+  return result;
+}
+
+ChannelEncoding GetIntensityEncoding(const CompressedMultiLayerLaserScan& scan)
+{
+  ChannelEncoding result;
+  result.encoding = scan.intensity_encoding;
+  result.scale = scan.intensity_scale;
+  result.offset = scan.intensity_offset;
+  return result;
+}
+
+void CompressScan(const MultiLayerLaserScan& scan, CompressedMultiLayerLaserScan& compressed,
+    const ChannelEncoding& rangeEncoding, const ChannelEncoding& intensityEncoding)
+{
+  compressed.header = scan.header;
+  compressed.range_min = scan.range_min;
+  compressed.range_max = scan.range_max;
+  compressed.subscan_layout = scan.subscan_layout;
+  compressed.scan_layout = scan.scan_layout;
+  compressed.scan_offsets_during_subscan = scan.scan_offsets_during_subscan;
+  compressed.custom_data = scan.custom_data;
+
+  compressed.range_encoding = rangeEncoding.encoding;
+  compressed.range_scale = rangeEncoding.scale;
+  compressed.range_offset = rangeEncoding.offset;
+  compressed.ranges.resize(scan.ranges.size());
+  compressed.packed_ranges.clear();
+  Encode(scan.ranges.data(), scan.ranges.size(), rangeEncoding, compressed.ranges.data());
+
+  compressed.intensity_encoding = intensityEncoding.encoding;
+  compressed.intensity_scale = intensityEncoding.scale;
+  compressed.intensity_offset = intensityEncoding.offset;
+  compressed.intensities.resize(scan.intensities.size());
+  Encode(scan.intensities.data(), scan.intensities.size(), intensityEncoding,
+    compressed.intensities.data());
+}
+
+void CompressScan(const MultiLayerLaserScan& scan, CompressedMultiLayerLaserScan& compressed)
+{
+  CompressScan(scan, compressed, ChannelEncoding::ScaledRange(0.0f, scan.range_max));
+}
+
+void DecompressScan(const CompressedMultiLayerLaserScan& compressed, MultiLayerLaserScan& scan)
+{
+  scan.header = compressed.header;
+  scan.range_min = compressed.range_min;
+  scan.range_max = compressed.range_max;
+  scan.subscan_layout = compressed.subscan_layout;
+  scan.scan_layout = compressed.scan_layout;
+  scan.scan_offsets_during_subscan = compressed.scan_offsets_during_subscan;
+  scan.custom_data = compressed.custom_data;
+
+  if (compressed.packed_ranges.empty())
+  {
+    scan.ranges.resize(compressed.ranges.size());
+    Decode(compressed.ranges.data(), compressed.ranges.size(), GetRangeEncoding(compressed),
+      scan.ranges.data());
+  }
+  else
+  {
+    std::vector<uint16_t> ranges;
+    RangeCodec().Decode(compressed.packed_ranges.data(), compressed.packed_ranges.size(), ranges);
+    scan.ranges.resize(ranges.size());
+    Decode(ranges.data(), ranges.size(), GetRangeEncoding(compressed), scan.ranges.data());
+  }
+
+  scan.intensities.resize(compressed.intensities.size());
+  Decode(compressed.intensities.data(), compressed.intensities.size(),
+    GetIntensityEncoding(compressed), scan.intensities.data());
+}
+
+}
@@ -0,0 +1,165 @@
+#include <multilayer_laser_scan/RangeImage.h>
+#include <multilayer_laser_scan/PointFieldUtils.h>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace sensor_msgs
+{
+
+namespace
+{
+
+// Blocks of 16x16 values of the source and the destination fit into L1 cache.
+constexpr size_t BLOCK = 16;
+
+void checkLength(const size_t length, const MultiLayerLaserScanLayout& layout, const std::string& what)
+{
+  if (length != layout.Length())
+    throw std::runtime_error("The scan has " + std::to_string(length) + " " + what +
+        ", but its layout has " + std::to_string(layout.Length()) + " points");
+}
+
+template<size_t N>
+void copyBlocked(const uint8_t* data, const size_t rows, const size_t cols, const size_t rowStride,
+    const size_t colStride, uint8_t* image)
+{
+  for (size_t r0 = 0; r0 < rows; r0 += BLOCK)
+  {
+    const auto r1 = std::min(rows, r0 + BLOCK);
+    for (size_t c0 = 0; c0 < cols; c0 += BLOCK)
+    {
+      const auto c1 = std::min(cols, c0 + BLOCK);
+      for (size_t r = r0; r < r1; ++r)
+        for (size_t c = c0; c < c1; ++c)
+          std::memcpy(image + (r * cols + c) * N, data + r * rowStride + c * colStride, N);
+    }
+  }
+}
+
+}
+
+std::vector<size_t> GetRingsByElevation(const MultiLayerLaserScanLayout& layout)
+{
+  const auto& subscanLayout = layout.GetSubscanLayout();
+  std::vector<size_t> rings(subscanLayout.Length());
+  std::iota(rings.begin(), rings.end(), 0);
+  std::stable_sort(rings.begin(), rings.end(), [&subscanLayout](const size_t lhs, const size_t rhs)
+  {
+    return subscanLayout.GetAngle(lhs) > subscanLayout.GetAngle(rhs);
+  });
+  return rings;
+}
+
+ScanImageView<float> GetRangeImage(MultiLayerLaserScan& scan, const MultiLayerLaserScanLayout& layout)
+{
+  checkLength(scan.ranges.size(), layout, "ranges");
+  return {scan.ranges.data(), layout.GetSubscanLength(), layout.GetScanLength(),
+      sizeof(float), sizeof(float) * layout.GetSubscanLength()};
+}
+
+ScanImageView<const float> GetRangeImage(const MultiLayerLaserScan& scan, const MultiLayerLaserScanLayout& layout)
+{
+  checkLength(scan.ranges.size(), layout, "ranges");
+  return {scan.ranges.data(), layout.GetSubscanLength(), layout.GetScanLength(),
+      sizeof(float), sizeof(float) * layout.GetSubscanLength()};
+}
+
+ScanImageView<float> GetIntensityImage(MultiLayerLaserScan& scan, const MultiLayerLaserScanLayout& layout)
+{
+  checkLength(scan.intensities.size(), layout, "intensities");
+  return {scan.intensities.data(), layout.GetSubscanLength(), layout.GetScanLength(),
+      sizeof(float), sizeof(float) * layout.GetSubscanLength()};
+}
+
+ScanImageView<const float> GetIntensityImage(const MultiLayerLaserScan& scan,
+    const MultiLayerLaserScanLayout& layout)
+{
+  checkLength(scan.intensities.size(), layout, "intensities");
+  return {scan.intensities.data(), layout.GetSubscanLength(), layout.GetScanLength(),
+      sizeof(float), sizeof(float) * layout.GetSubscanLength()};
+}
+
+namespace impl
+{
+
+size_t checkCustomFieldImage(const PointData& data, const MultiLayerLaserScanLayout& layout,
+    const std::string& fieldName, const size_t valueSize)
+{
+  auto field = data.fields.begin();
+  while (field != data.fields.end() && field->name != fieldName)
+    ++field;
+  if (field == data.fields.end())
+    throw std::runtime_error("Field " + fieldName + " does not exist");
+
+  if (impl::sizeOfPointField(field->datatype) != valueSize)
+    throw std::runtime_error("Field " + fieldName + " has datatype " + std::to_string(field->datatype) +
+        " which does not match the image type");
+
+  if (data.point_step == 0 || data.data.size() != layout.Length() * data.point_step)
+    throw std::runtime_error("Custom data have " + std::to_string(data.data.size()) + " bytes, but " +
+        std::to_string(layout.Length() * data.point_step) + " are required");
+
+  return field->offset;
+}
+
+void copyToImage(const uint8_t* data, const size_t rows, const size_t cols, const size_t rowStride,
+    const size_t colStride, const size_t elementSize, uint8_t* image)
+{
+  if (rows == 0 || cols == 0)
+    return;
+
+  if (colStride == elementSize && rowStride == cols * elementSize)
+  {
+    std::memcpy(image, data, rows * cols * elementSize);
+    return;
+  }
+
+  if (colStride == elementSize)
+  {
+    for (size_t r = 0; r < rows; ++r)
+      std::memcpy(image + r * cols * elementSize, data + r * rowStride, cols * elementSize);
+    return;
+  }
+
+  switch (elementSize)
+  {
+    case 1:
+      copyBlocked<1>(data, rows, cols, rowStride, colStride, image);
+      break;
+    case 2:
+      copyBlocked<2>(data, rows, cols, rowStride, colStride, image);
+      break;
+    case 4:
+      copyBlocked<4>(data, rows, cols, rowStride, colStride, image);
+      break;
+    case 8:
+      copyBlocked<8>(data, rows, cols, rowStride, colStride, image);
+      break;
+    default:
+      for (size_t r = 0; r < rows; ++r)
+        for (size_t c = 0; c < cols; ++c)
+          std::memcpy(image + (r * cols + c) * elementSize, data + r * rowStride + c * colStride, elementSize);
+  }
+}
+
+}
+
+void RangesToImage(const MultiLayerLaserScan& scan, const MultiLayerLaserScanLayout& layout, Image& image,
+    const bool transposed)
+{
+  const auto view = GetRangeImage(scan, layout);
+  ToImage(transposed ? view.Transposed() : view, image);
+  image.header = scan.header;
+}
+
+void IntensitiesToImage(const MultiLayerLaserScan& scan, const MultiLayerLaserScanLayout& layout,
+    Image& image, const bool transposed)
+{
+  const auto view = GetIntensityImage(scan, layout);
+  ToImage(transposed ? view.Transposed() : view, image);
+  image.header = scan.header;
+}
+
+}
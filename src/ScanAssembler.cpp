@@ -0,0 +1,115 @@
+#include <multilayer_laser_scan/ScanAssembler.h>
+
+#include <cmath>
+
+namespace sensor_msgs
+{
+
+namespace
+{
+
+/** Normalize the angle to [min, min + 2 pi). */
+inline double normalizeAngle(double angle, const double min)
+{
+  angle = std::fmod(angle - min, 2 * M_PI);
+  if (angle < 0)
+    angle += 2 * M_PI;
+  return angle + min;
+}
+
+}
+
+ScanAssembler::ScanAssembler(std::shared_ptr<const ScanPacketDecoder> _decoder, const std::string& _frameId,
+    const double _cutAngle, Callback _callback) :
+  decoder(std::move(_decoder)), cutAngle(_cutAngle), callback(std::move(_callback)),
+  subscanLength(this->decoder->GetSubscanLength())
+{
+  this->decoder->FillScanTemplate(this->scan);
+  this->scan.header.frame_id = _frameId;
+
+  // explicit offsets cannot be empty; StartScan() replaces the placeholder subscan
+  ScanLayout firstSubscanLayout;
+  firstSubscanLayout.angular_offsets.regular = false;
+  firstSubscanLayout.angular_offsets.offsets.resize(1);
+  firstSubscanLayout.time_offsets.regular = false;
+  firstSubscanLayout.time_offsets.offsets.resize(1);
+  this->scanLayout.reset(new ParsedScanLayout(firstSubscanLayout));
+}
+
+void ScanAssembler::AddPacket(const uint8_t* data, const size_t size, const ros::Time& stamp)
+{
+  this->decoder->Decode(data, size, stamp, *this);
+}
+
+ScanAssembler::SubscanData ScanAssembler::AppendSubscan(const double scanAngle, const ros::Time& time)
+{
+  if (this->numSubscans > 0 && this->CrossesCutAngle(scanAngle))
+    this->Flush();
+
+  if (this->numSubscans == 0)
+    this->StartScan(scanAngle, time);
+  else
+    this->scanLayout->AddOffset(scanAngle, time - this->scan.header.stamp);
+
+  this->lastScanAngle = scanAngle;
+
+  const auto begin = this->numSubscans * this->subscanLength;
+  ++this->numSubscans;
+  const auto end = this->numSubscans * this->subscanLength;
+  const auto pointStep = this->scan.custom_data.point_step;
+
+  this->scan.ranges.resize(end);
+  this->scan.intensities.resize(end);
+  this->scan.custom_data.data.resize(end * pointStep);
+
+  SubscanData subscan;
+  subscan.ranges = &this->scan.ranges[begin];
+  subscan.intensities = &this->scan.intensities[begin];
+  subscan.customData = (pointStep > 0) ? &this->scan.custom_data.data[begin * pointStep] : nullptr;
+  return subscan;
+}
+
+void ScanAssembler::Flush()
+{
+  if (this->numSubscans == 0)
+    return;
+
+  this->scanLayout->FillMsg(this->scan.scan_layout);
+  this->callback(this->scan);
+
+  // clear() keeps the capacity, so the next scan does not need to allocate
+  this->numSubscans = 0;
+  this->scan.ranges.clear();
+  this->scan.intensities.clear();
+  this->scan.custom_data.data.clear();
+}
+
+size_t ScanAssembler::GetNumSubscans() const
+{
+  return this->numSubscans;
+}
+
+void ScanAssembler::StartScan(const double scanAngle, const ros::Time& stamp)
+{
+  this->scan.header.stamp = stamp;
+  // reused, so its offsets keep the capacity of the previous scans
+  this->scanLayout->Reset(scanAngle, ros::Duration(0));
+}
+
+bool ScanAssembler::CrossesCutAngle(const double scanAngle) const
+{
+  const auto delta = normalizeAngle(scanAngle - this->lastScanAngle, -M_PI);
+  if (delta > 0)
+  {
+    const auto toCut = normalizeAngle(this->cutAngle - this->lastScanAngle, 0);
+    return toCut > 0 && toCut <= delta;
+  }
+  else if (delta < 0)
+  {
+    const auto toCut = normalizeAngle(this->cutAngle - this->lastScanAngle, -2 * M_PI);
+    return toCut >= delta;
+  }
+  return false;
+}
+
+}
@@ -0,0 +1,288 @@
+#include <multilayer_laser_scan/ScanMerger.h>
+#include <multilayer_laser_scan/Instrumentation.h>
+#include <multilayer_laser_scan/PointFieldUtils.h>
+#include <multilayer_laser_scan/ScanLayoutUtils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace sensor_msgs
+{
+
+namespace
+{
+
+// the same tolerance as RegularAngularOffsets::AddOffset() uses
+constexpr double angleTolerance = 1e-6;
+
+/**
+ * @brief Whether the merged angular offsets can stay regular.
+ * @param increment Output, the increment of the merged offsets.
+ */
+bool continuesRegularAngles(const std::vector<const ParsedScanLayout*>& layouts, double& increment)
+{
+  bool hasIncrement = false;
+  increment = 0;
+  for (const auto* layout : layouts)
+  {
+    const auto* regular = dynamic_cast<const RegularAngularOffsets*>(&layout->GetAngularOffsets());
+    if (regular == nullptr)
+      return false;
+
+    // the increment of a single subscan is meaningless
+    if (layout->Length() < 2)
+      continue;
+
+    if (!hasIncrement)
+    {
+      increment = regular->GetIncrement();
+      hasIncrement = true;
+    }
+    else if (std::abs(regular->GetIncrement() - increment) > 1e-9)
+    {
+      return false;
+    }
+  }
+
+  if (!hasIncrement && layouts.size() > 1)
+    increment = layouts[1]->GetAngle(0) - layouts[0]->GetAngle(0);
+
+  for (size_t k = 1; k < layouts.size(); ++k)
+  {
+    const auto expected = layouts[k - 1]->GetAngle(layouts[k - 1]->Length() - 1) + increment;
+    if (std::abs(layouts[k]->GetAngle(0) - expected) > angleTolerance)
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Whether the merged time offsets can stay regular.
+ * @param increment Output, the increment of the merged offsets [ns].
+ */
+bool continuesRegularTimes(const std::vector<const ParsedScanLayout*>& layouts,
+    const std::vector<int64_t>& stampOffsetsNSec, int64_t& increment)
+{
+  bool hasIncrement = false;
+  increment = 0;
+  for (const auto* layout : layouts)
+  {
+    const auto* regular = dynamic_cast<const RegularTimeOffsets*>(&layout->GetTimeOffsets());
+    if (regular == nullptr)
+      return false;
+
+    if (layout->Length() < 2)
+      continue;
+
+    if (!hasIncrement)
+    {
+      increment = regular->GetIncrement().toNSec();
+      hasIncrement = true;
+    }
+    else if (regular->GetIncrement().toNSec() != increment)
+    {
+      return false;
+    }
+  }
+
+  if (!hasIncrement && layouts.size() > 1)
+    increment = (layouts[1]->GetTimeNSec(0) + stampOffsetsNSec[1]) -
+      (layouts[0]->GetTimeNSec(0) + stampOffsetsNSec[0]);
+
+  for (size_t k = 1; k < layouts.size(); ++k)
+  {
+    const auto previousEnd = layouts[k - 1]->GetTimeNSec(layouts[k - 1]->Length() - 1) + stampOffsetsNSec[k - 1];
+    if (layouts[k]->GetTimeNSec(0) + stampOffsetsNSec[k] != previousEnd + increment)
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Replace output by the concatenated arrays of the parts with a single
+ *        reserve, or append to it if it is the array of the first part.
+ */
+template<typename T, typename G>
+void concatenate(std::vector<T>& output, const std::vector<const MultiLayerLaserScan*>& parts,
+    const bool inPlace, const size_t size, const G& getArray)
+{
+  if (!inPlace)
+    output.clear();
+  output.reserve(size);
+  for (size_t k = inPlace ? 1 : 0; k < parts.size(); ++k)
+  {
+    const auto& array = getArray(*parts[k]);
+    output.insert(output.end(), array.begin(), array.end());
+  }
+}
+
+}
+
+void MergeScanLayouts(const std::vector<const ParsedScanLayout*>& layouts,
+    const std::vector<int64_t>& stampOffsetsNSec, ScanLayout& msg)
+{
+  if (layouts.empty())
+    throw std::runtime_error("No scan layouts to merge.");
+  if (stampOffsetsNSec.size() != layouts.size())
+    throw std::runtime_error("There are " + std::to_string(layouts.size()) + " scan layouts, but " +
+      std::to_string(stampOffsetsNSec.size()) + " stamp offsets.");
+
+  size_t length = 0;
+  for (const auto* layout : layouts)
+    length += layout->Length();
+
+  double angleIncrement;
+  if (continuesRegularAngles(layouts, angleIncrement))
+  {
+    const auto firstAngle = layouts[0]->GetAngle(0);
+    const auto lastAngle = firstAngle + static_cast<double>(length - 1) * angleIncrement;
+    impl::fillRegularAngularOffsets(firstAngle, lastAngle, length, angleIncrement, msg.angular_offsets);
+  }
+  else
+  {
+    msg.angular_offsets = AngularOffsets();
+    msg.angular_offsets.regular = false;
+    msg.angular_offsets.offsets.reserve(length);
+    for (const auto* layout : layouts)
+      for (size_t i = 0; i < layout->Length(); ++i)
+        msg.angular_offsets.offsets.push_back(layout->GetAngle(i));
+  }
+
+  int64_t timeIncrement;
+  msg.time_offsets = TimeOffsets();
+  if (continuesRegularTimes(layouts, stampOffsetsNSec, timeIncrement))
+  {
+    msg.time_offsets.regular = true;
+    msg.time_offsets.base_offset.fromNSec(layouts[0]->GetTimeNSec(0) + stampOffsetsNSec[0]);
+    msg.time_offsets.increment.fromNSec(timeIncrement);
+  }
+  else
+  {
+    msg.time_offsets.regular = false;
+    msg.time_offsets.offsets.resize(length);
+    size_t j = 0;
+    for (size_t k = 0; k < layouts.size(); ++k)
+      for (size_t i = 0; i < layouts[k]->Length(); ++i, ++j)
+        msg.time_offsets.offsets[j].fromNSec(layouts[k]->GetTimeNSec(i) + stampOffsetsNSec[k]);
+  }
+}
+
+void MergeScans(const std::vector<const MultiLayerLaserScan*>& parts, MultiLayerLaserScan& msg)
+{
+  MLS_INSTRUMENT_SCOPE(SCAN_MERGE, 0);
+
+  if (parts.empty())
+    throw std::runtime_error("No scans to merge.");
+
+  const auto& first = *parts[0];
+  const auto subscanLength = ParsedScanLayout(first.subscan_layout).Length();
+  const auto hasIntensities = !first.intensities.empty();
+  const auto hasCustomData = !first.custom_data.data.empty();
+  const auto pointStep = first.custom_data.point_step;
+
+  std::vector<std::unique_ptr<ParsedScanLayout>> scanLayouts;
+  std::vector<const ParsedScanLayout*> layouts;
+  std::vector<int64_t> stampOffsetsNSec;
+  scanLayouts.reserve(parts.size());
+  layouts.reserve(parts.size());
+  stampOffsetsNSec.reserve(parts.size());
+  size_t numPoints = 0;
+
+  for (size_t k = 0; k < parts.size(); ++k)
+  {
+    const auto& part = *parts[k];
+    const auto name = "Part " + std::to_string(k);
+    if (k > 0)
+    {
+      if (&part == &msg)
+        throw std::runtime_error("The merged scan can only be the first of the parts.");
+      if (part.header.frame_id != first.header.frame_id)
+        throw std::runtime_error(name + " has frame " + part.header.frame_id + ", but the first part has frame " +
+          first.header.frame_id + ".");
+      if (part.range_min != first.range_min || part.range_max != first.range_max)
+        throw std::runtime_error(name + " has different range limits than the first part.");
+      if (!impl::sameScanLayout(part.subscan_layout, first.subscan_layout) ||
+          !impl::sameAngularOffsets(part.scan_offsets_during_subscan, first.scan_offsets_during_subscan))
+        throw std::runtime_error(name + " has different subscan_layout or scan_offsets_during_subscan than the "
+          "first part.");
+      if (part.intensities.empty() == hasIntensities)
+        throw std::runtime_error("Either all or none of the parts have to have intensities.");
+      if (part.custom_data.data.empty() == hasCustomData || (hasCustomData &&
+          (part.custom_data.point_step != pointStep || part.custom_data.is_bigendian != first.custom_data.is_bigendian ||
+           !impl::samePointFields(part.custom_data.fields, first.custom_data.fields))))
+        throw std::runtime_error(name + " has different custom data than the first part.");
+    }
+
+    scanLayouts.emplace_back(new ParsedScanLayout(part.scan_layout));
+    layouts.push_back(scanLayouts.back().get());
+    const auto partLength = scanLayouts.back()->Length() * subscanLength;
+    if (part.ranges.size() != partLength)
+      throw std::runtime_error(name + " has layout with " + std::to_string(partLength) + " points, but " +
+        std::to_string(part.ranges.size()) + " ranges.");
+    if (hasIntensities && part.intensities.size() != partLength)
+      throw std::runtime_error(name + " has different number of ranges and intensities.");
+    if (hasCustomData && part.custom_data.data.size() != partLength * pointStep)
+      throw std::runtime_error(name + " has custom data size that doesn't correspond to its number of points.");
+
+    numPoints += partLength;
+    stampOffsetsNSec.push_back((part.header.stamp - first.header.stamp).toNSec());
+  }
+
+  // computed before msg is changed, because it may be the first part
+  ScanLayout scanLayout;
+  MergeScanLayouts(layouts, stampOffsetsNSec, scanLayout);
+
+  const auto inPlace = parts[0] == &msg;
+  if (!inPlace)
+  {
+    msg.header = first.header;
+    msg.range_min = first.range_min;
+    msg.range_max = first.range_max;
+    msg.subscan_layout = first.subscan_layout;
+    msg.scan_offsets_during_subscan = first.scan_offsets_during_subscan;
+    msg.custom_data.fields = first.custom_data.fields;
+    msg.custom_data.is_bigendian = first.custom_data.is_bigendian;
+    msg.custom_data.point_step = pointStep;
+  }
+  msg.scan_layout = std::move(scanLayout);
+
+  concatenate(msg.ranges, parts, inPlace, numPoints,
+    [](const MultiLayerLaserScan& part) -> const std::vector<float>& { return part.ranges; });
+
+  if (hasIntensities)
+    concatenate(msg.intensities, parts, inPlace, numPoints,
+      [](const MultiLayerLaserScan& part) -> const std::vector<float>& { return part.intensities; });
+  else
+    msg.intensities.clear();
+
+  if (hasCustomData)
+    concatenate(msg.custom_data.data, parts, inPlace, numPoints * pointStep,
+      [](const MultiLayerLaserScan& part) -> const std::vector<uint8_t>& { return part.custom_data.data; });
+  else
+    msg.custom_data.data.clear();
+
+  MLS_INSTRUMENT_ADD_BYTES(numPoints * ((hasIntensities ? 2 : 1) * sizeof(float) + (hasCustomData ? pointStep : 0)));
+}
+
+MultiLayerLaserScan MergeScans(std::vector<MultiLayerLaserScan>&& parts)
+{
+  if (parts.empty())
+    throw std::runtime_error("No scans to merge.");
+
+  auto msg = std::move(parts[0]);
+  std::vector<const MultiLayerLaserScan*> pointers;
+  pointers.reserve(parts.size());
+  pointers.push_back(&msg);
+  for (size_t k = 1; k < parts.size(); ++k)
+    pointers.push_back(&parts[k]);
+
+  MergeScans(pointers, msg);
+  return msg;
+}
+
+}
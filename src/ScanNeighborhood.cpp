@@ -0,0 +1,111 @@
+#include <multilayer_laser_scan/ScanNeighborhood.h>
+
+#include <stdexcept>
+#include <string>
+
+namespace sensor_msgs
+{
+
+namespace
+{
+
+void checkIndex(const size_t i, const size_t length)
+{
+  if (i >= length)
+    throw std::out_of_range("Point " + std::to_string(i) + " is not in the scan with " +
+        std::to_string(length) + " points");
+}
+
+}
+
+ScanNeighborhood::ScanNeighborhood(const MultiLayerLaserScanLayout& layout)
+  : ScanNeighborhood(layout.GetScanLength(), layout.GetSubscanLength(), DetectWrapAround(layout))
+{
+}
+
+ScanNeighborhood::ScanNeighborhood(const size_t scanLength, const size_t subscanLength, const bool wrapAround)
+  : scanLength(scanLength), subscanLength(subscanLength), wrapAround(wrapAround)
+{
+}
+
+bool ScanNeighborhood::DetectWrapAround(const MultiLayerLaserScanLayout& layout)
+{
+  const auto offsets = dynamic_cast<const RegularAngularOffsets*>(
+      &layout.GetScanLayout().GetAngularOffsets());
+  if (offsets == nullptr || offsets->Length() < 2)
+    return false;
+
+  AngularOffsets msg;
+  offsets->FillMsg(msg);
+  if (!msg.exclude_last)
+    return false;
+
+  // with exclude_last, the samples cover the whole <min, max> range
+  const auto increment = std::abs(offsets->GetIncrement());
+  return std::abs(increment * offsets->Length() - 2 * M_PI) < increment / 2;
+}
+
+bool ScanNeighborhood::WrapsAround() const
+{
+  return this->wrapAround;
+}
+
+size_t ScanNeighborhood::GetScanLength() const
+{
+  return this->scanLength;
+}
+
+size_t ScanNeighborhood::GetSubscanLength() const
+{
+  return this->subscanLength;
+}
+
+size_t ScanNeighborhood::GetNeighbors(const size_t i, const size_t ringRadius, const size_t columnRadius,
+    std::vector<size_t>& neighbors) const
+{
+  checkIndex(i, this->scanLength * this->subscanLength);
+  neighbors.clear();
+  this->ForEachNeighbor(i, ringRadius, columnRadius, [&neighbors](const size_t j) { neighbors.push_back(j); });
+  return neighbors.size();
+}
+
+size_t ScanNeighborhood::GetNeighbors(const float* ranges, const size_t i, const size_t ringRadius,
+    const size_t columnRadius, const float maxRangeDifference, std::vector<size_t>& neighbors) const
+{
+  checkIndex(i, this->scanLength * this->subscanLength);
+  neighbors.clear();
+  const auto range = ranges[i];
+  if (!std::isfinite(range))
+    return 0;
+
+  // NaN differences fail the comparison
+  this->ForEachNeighbor(i, ringRadius, columnRadius, [&](const size_t j) {
+    if (std::abs(ranges[j] - range) <= maxRangeDifference)
+      neighbors.push_back(j);
+  });
+  return neighbors.size();
+}
+
+size_t ScanNeighborhood::GetNeighbors(const MultiLayerLaserScan& scan, const size_t i, const size_t ringRadius,
+    const size_t columnRadius, const float maxRangeDifference, std::vector<size_t>& neighbors) const
+{
+  if (scan.ranges.size() != this->scanLength * this->subscanLength)
+    throw std::runtime_error("The scan has " + std::to_string(scan.ranges.size()) + " ranges, but " +
+        std::to_string(this->scanLength * this->subscanLength) + " are required");
+
+  checkIndex(i, scan.ranges.size());
+  neighbors.clear();
+  const auto range = scan.ranges[i];
+  if (!std::isfinite(range) || range < scan.range_min || range > scan.range_max)
+    return 0;
+
+  this->ForEachNeighbor(i, ringRadius, columnRadius, [&](const size_t j) {
+    const auto neighborRange = scan.ranges[j];
+    if (std::abs(neighborRange - range) <= maxRangeDifference &&
+        neighborRange >= scan.range_min && neighborRange <= scan.range_max)
+      neighbors.push_back(j);
+  });
+  return neighbors.size();
+}
+
+}
@@ -0,0 +1,386 @@
+#include <multilayer_laser_scan/SubScanView.h>
+#include <multilayer_laser_scan/ScanLayoutUtils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace sensor_msgs
+{
+
+namespace
+{
+
+// so that sector bounds equal to subscan angles select the subscans despite rounding
+constexpr double angleTolerance = 1e-9;
+
+size_t clampIndex(const double index, const size_t length)
+{
+  if (!(index > 0))
+    return 0;
+  if (index >= static_cast<double>(length))
+    return length;
+  return static_cast<size_t>(index);
+}
+
+/**
+ * @return The first index in <0, length) for which pred is false, assuming
+ *         that pred is true for all indices before it and false after.
+ */
+template<typename P>
+size_t partitionPoint(const size_t length, const P& pred)
+{
+  size_t first = 0;
+  size_t count = length;
+  while (count > 0)
+  {
+    const auto step = count / 2;
+    if (pred(first + step))
+    {
+      first += step + 1;
+      count -= step + 1;
+    }
+    else
+    {
+      count = step;
+    }
+  }
+  return first;
+}
+
+int64_t floorDiv(const int64_t a, const int64_t b)
+{
+  // b > 0
+  return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+int64_t ceilDiv(const int64_t a, const int64_t b)
+{
+  // b > 0
+  return a >= 0 ? (a + b - 1) / b : -((-a) / b);
+}
+
+void findAngles(const ParsedAngularOffsets& offsets, double minAngle, double maxAngle,
+    size_t& firstScan, size_t& endScan)
+{
+  const auto length = offsets.Length();
+  minAngle -= angleTolerance;
+  maxAngle += angleTolerance;
+
+  const auto* regular = dynamic_cast<const RegularAngularOffsets*>(&offsets);
+  if (regular != nullptr && regular->GetIncrement() != 0.0)
+  {
+    // angle i is firstAngle + i * increment
+    const auto firstAngle = regular->GetFirstAngle();
+    const auto increment = regular->GetIncrement();
+    const auto low = ((increment > 0 ? minAngle : maxAngle) - firstAngle) / increment;
+    const auto high = ((increment > 0 ? maxAngle : minAngle) - firstAngle) / increment;
+    firstScan = clampIndex(std::ceil(low), length);
+    endScan = clampIndex(std::floor(high) + 1, length);
+  }
+  else if (length < 2 || offsets.Get(length - 1) >= offsets.Get(0))
+  {
+    firstScan = partitionPoint(length, [&](const size_t i) { return offsets.Get(i) < minAngle; });
+    endScan = partitionPoint(length, [&](const size_t i) { return offsets.Get(i) <= maxAngle; });
+  }
+  else
+  {
+    firstScan = partitionPoint(length, [&](const size_t i) { return offsets.Get(i) > maxAngle; });
+    endScan = partitionPoint(length, [&](const size_t i) { return offsets.Get(i) >= minAngle; });
+  }
+
+  endScan = std::max(firstScan, endScan);
+}
+
+/**
+ * @brief Find the subscans of the sector <minAngle, maxAngle> shifted by multiples of 2 pi.
+ * @param endScan Output, exclusive.
+ * @param wrappedEndScan Output, exclusive. The part of the sector wrapped around the start
+ *        of the scan. Both are 0 unless the sector wraps around it.
+ */
+void findSectorParts(const ParsedAngularOffsets& offsets, double minAngle, double maxAngle,
+    size_t& firstScan, size_t& endScan, size_t& wrappedFirstScan, size_t& wrappedEndScan)
+{
+  if (!(minAngle <= maxAngle))
+    throw std::runtime_error("Minimum angle of the sector is larger than its maximum angle.");
+
+  const auto length = offsets.Length();
+  wrappedFirstScan = wrappedEndScan = 0;
+  // a scan without subscans has no angles to look at
+  if (length == 0 || maxAngle - minAngle >= 2 * M_PI)
+  {
+    firstScan = 0;
+    endScan = length;
+    return;
+  }
+
+  // shift the sector so that it starts within 2 pi from the lowest angle; its part
+  // above 2 pi from the lowest angle then wraps around to the lowest angles
+  const auto lowestAngle = std::min(offsets.Get(0), offsets.Get(length - 1));
+  const auto shift = 2 * M_PI * std::floor((minAngle - lowestAngle + angleTolerance) / (2 * M_PI));
+  minAngle -= shift;
+  maxAngle -= shift;
+
+  findAngles(offsets, minAngle, maxAngle, firstScan, endScan);
+  findAngles(offsets, minAngle - 2 * M_PI, maxAngle - 2 * M_PI, wrappedFirstScan, wrappedEndScan);
+
+  if (wrappedFirstScan == wrappedEndScan)
+  {
+    wrappedFirstScan = wrappedEndScan = 0;
+  }
+  else if (firstScan == endScan)
+  {
+    firstScan = wrappedFirstScan;
+    endScan = wrappedEndScan;
+    wrappedFirstScan = wrappedEndScan = 0;
+  }
+  else if (firstScan <= wrappedEndScan && wrappedFirstScan <= endScan)
+  {
+    firstScan = std::min(firstScan, wrappedFirstScan);
+    endScan = std::max(endScan, wrappedEndScan);
+    wrappedFirstScan = wrappedEndScan = 0;
+  }
+}
+
+}
+
+SubScanView::SubScanView(const MultiLayerLaserScan& scan, std::shared_ptr<const MultiLayerLaserScanLayout> layout,
+    const size_t firstScan, const size_t endScan)
+  : scan(&scan), fullLayout(std::move(layout)), firstScan(firstScan), endScan(endScan)
+{
+  if (this->fullLayout->Length() != scan.ranges.size())
+    throw std::runtime_error("Scan layout " + std::to_string(this->fullLayout->Length()) +
+      " size doesn't correspond to the number of actual points " + std::to_string(scan.ranges.size()));
+
+  if (firstScan > endScan || endScan > this->fullLayout->GetScanLength())
+    throw std::out_of_range("Requested subscans are outside of the current layout.");
+
+  this->subscanLength = this->fullLayout->GetSubscanLength();
+}
+
+SubScanView SubScanView::Sector(const MultiLayerLaserScan& scan,
+    std::shared_ptr<const MultiLayerLaserScanLayout> layout, const double minAngle, const double maxAngle)
+{
+  size_t firstScan, endScan;
+  FindSector(layout->GetScanLayout(), minAngle, maxAngle, firstScan, endScan);
+  return SubScanView(scan, std::move(layout), firstScan, endScan);
+}
+
+SubScanView SubScanView::TimeWindow(const MultiLayerLaserScan& scan,
+    std::shared_ptr<const MultiLayerLaserScanLayout> layout, const ros::Time& start, const ros::Time& end)
+{
+  size_t firstScan, endScan;
+  FindTimeWindow(layout->GetScanLayout(), (start - scan.header.stamp).toNSec(), (end - scan.header.stamp).toNSec(),
+    firstScan, endScan);
+  return SubScanView(scan, std::move(layout), firstScan, endScan);
+}
+
+void SubScanView::FindSector(const ParsedScanLayout& scanLayout, const double minAngle, const double maxAngle,
+    size_t& firstScan, size_t& endScan)
+{
+  size_t wrappedFirstScan, wrappedEndScan;
+  findSectorParts(scanLayout.GetAngularOffsets(), minAngle, maxAngle, firstScan, endScan,
+    wrappedFirstScan, wrappedEndScan);
+
+  if (wrappedFirstScan != wrappedEndScan)
+    throw std::runtime_error("The sector <" + std::to_string(minAngle) + ", " + std::to_string(maxAngle) +
+      "> wraps around the start of the scan, so its subscans are not contiguous. Use SplitSector().");
+}
+
+std::vector<SubScanView> SubScanView::SplitSector(const MultiLayerLaserScan& scan,
+    const std::shared_ptr<const MultiLayerLaserScanLayout>& layout, const double minAngle, const double maxAngle)
+{
+  size_t firstScan, endScan, wrappedFirstScan, wrappedEndScan;
+  findSectorParts(layout->GetScanLayout().GetAngularOffsets(), minAngle, maxAngle, firstScan, endScan,
+    wrappedFirstScan, wrappedEndScan);
+
+  std::vector<SubScanView> views;
+  views.emplace_back(scan, layout, firstScan, endScan);
+  if (wrappedFirstScan != wrappedEndScan)
+    views.emplace_back(scan, layout, wrappedFirstScan, wrappedEndScan);
+  return views;
+}
+
+void SubScanView::FindTimeWindow(const ParsedScanLayout& scanLayout, const int64_t startNSec,
+    const int64_t endNSec, size_t& firstScan, size_t& endScan)
+{
+  if (startNSec > endNSec)
+    throw std::runtime_error("Start of the time window is after its end.");
+
+  const auto length = scanLayout.Length();
+  const auto& offsets = scanLayout.GetTimeOffsets();
+
+  const auto* regular = dynamic_cast<const RegularTimeOffsets*>(&offsets);
+  if (regular != nullptr && regular->GetIncrement().toNSec() > 0)
+  {
+    // time i is base + i * increment
+    const auto base = regular->GetBaseOffset().toNSec();
+    const auto increment = regular->GetIncrement().toNSec();
+    const auto first = std::max<int64_t>(ceilDiv(startNSec - base, increment), 0);
+    const auto end = std::max<int64_t>(floorDiv(endNSec - base, increment) + 1, 0);
+    firstScan = std::min(static_cast<size_t>(first), length);
+    endScan = std::min(static_cast<size_t>(end), length);
+  }
+  else
+  {
+    firstScan = partitionPoint(length, [&](const size_t i) { return offsets.GetNSec(i) < startNSec; });
+    endScan = partitionPoint(length, [&](const size_t i) { return offsets.GetNSec(i) <= endNSec; });
+  }
+
+  endScan = std::max(firstScan, endScan);
+}
+
+void SubScanView::TrimScanLayout(const ParsedScanLayout& scanLayout, const size_t firstScan, const size_t endScan,
+    ScanLayout& msg)
+{
+  if (firstScan >= endScan || endScan > scanLayout.Length())
+    throw std::out_of_range("Requested subscans are outside of the current layout.");
+
+  const auto count = endScan - firstScan;
+
+  const auto& angularOffsets = scanLayout.GetAngularOffsets();
+  if (const auto* regular = dynamic_cast<const RegularAngularOffsets*>(&angularOffsets))
+  {
+    impl::fillRegularAngularOffsets(regular->Get(firstScan), regular->Get(endScan - 1), count,
+      regular->GetIncrement(), msg.angular_offsets);
+  }
+  else
+  {
+    msg.angular_offsets = AngularOffsets();
+    msg.angular_offsets.regular = false;
+    msg.angular_offsets.offsets.resize(count);
+    for (size_t i = 0; i < count; ++i)
+      msg.angular_offsets.offsets[i] = angularOffsets.Get(firstScan + i);
+  }
+
+  const auto& timeOffsets = scanLayout.GetTimeOffsets();
+  msg.time_offsets = TimeOffsets();
+  if (const auto* regular = dynamic_cast<const RegularTimeOffsets*>(&timeOffsets))
+  {
+    msg.time_offsets.regular = true;
+    msg.time_offsets.base_offset = regular->Get(firstScan);
+    msg.time_offsets.increment = regular->GetIncrement();
+  }
+  else
+  {
+    msg.time_offsets.regular = false;
+    msg.time_offsets.offsets.resize(count);
+    for (size_t i = 0; i < count; ++i)
+      msg.time_offsets.offsets[i] = timeOffsets.Get(firstScan + i);
+  }
+}
+
+MultiLayerLaserScanBaseFieldsConstIterator SubScanView::begin() const
+{
+  return MultiLayerLaserScanBaseFieldsConstIterator(*this->scan, this->fullLayout, this->GetFirstIndex());
+}
+
+MultiLayerLaserScanBaseFieldsConstIterator SubScanView::end() const
+{
+  return MultiLayerLaserScanBaseFieldsConstIterator(*this->scan, this->fullLayout, this->GetEndIndex());
+}
+
+void SubScanView::ToScan(MultiLayerLaserScan& msg) const
+{
+  if (this->Empty())
+    throw std::out_of_range("Cannot create a scan from an empty view.");
+
+  const auto& scan = *this->scan;
+  const auto& customData = scan.custom_data;
+  if (!customData.data.empty() && customData.data.size() != scan.ranges.size() * customData.point_step)
+    throw std::runtime_error("Custom data size doesn't correspond to the number of actual points.");
+  if (!scan.intensities.empty() && scan.intensities.size() != scan.ranges.size())
+    throw std::runtime_error("The scan has different number of ranges and intensities.");
+
+  msg.header = scan.header;
+  msg.range_min = scan.range_min;
+  msg.range_max = scan.range_max;
+  msg.subscan_layout = scan.subscan_layout;
+  msg.scan_offsets_during_subscan = scan.scan_offsets_during_subscan;
+  TrimScanLayout(this->fullLayout->GetScanLayout(), this->firstScan, this->endScan, msg.scan_layout);
+
+  const auto first = this->GetFirstIndex();
+  const auto end = this->GetEndIndex();
+  msg.ranges.assign(scan.ranges.begin() + first, scan.ranges.begin() + end);
+  if (scan.intensities.empty())
+    msg.intensities.clear();
+  else
+    msg.intensities.assign(scan.intensities.begin() + first, scan.intensities.begin() + end);
+
+  msg.custom_data.fields = customData.fields;
+  msg.custom_data.is_bigendian = customData.is_bigendian;
+  msg.custom_data.point_step = customData.point_step;
+  if (customData.data.empty())
+    msg.custom_data.data.clear();
+  else
+    msg.custom_data.data.assign(customData.data.begin() + first * customData.point_step,
+      customData.data.begin() + end * customData.point_step);
+}
+
+MultiLayerLaserScan SubScanView::ToScan() const
+{
+  MultiLayerLaserScan msg;
+  this->ToScan(msg);
+  return msg;
+}
+
+std::shared_ptr<const MultiLayerLaserScanLayout> SubScanView::GetLayout() const
+{
+  if (this->layout == nullptr)
+  {
+    ScanLayout trimmedLayout;
+    TrimScanLayout(this->fullLayout->GetScanLayout(), this->firstScan, this->endScan, trimmedLayout);
+    this->layout = std::make_shared<MultiLayerLaserScanLayout>(this->scan->subscan_layout, trimmedLayout,
+      this->scan->scan_offsets_during_subscan, this->Length());
+  }
+  return this->layout;
+}
+
+const std::shared_ptr<const MultiLayerLaserScanLayout>& SubScanView::GetFullLayout() const
+{
+  return this->fullLayout;
+}
+
+const MultiLayerLaserScan& SubScanView::GetScan() const
+{
+  return *this->scan;
+}
+
+size_t SubScanView::GetFirstScan() const
+{
+  return this->firstScan;
+}
+
+size_t SubScanView::GetEndScan() const
+{
+  return this->endScan;
+}
+
+size_t SubScanView::GetScanLength() const
+{
+  return this->endScan - this->firstScan;
+}
+
+size_t SubScanView::GetFirstIndex() const
+{
+  return this->firstScan * this->subscanLength;
+}
+
+size_t SubScanView::GetEndIndex() const
+{
+  return this->endScan * this->subscanLength;
+}
+
+size_t SubScanView::Length() const
+{
+  return this->GetScanLength() * this->subscanLength;
+}
+
+bool SubScanView::Empty() const
+{
+  return this->firstScan == this->endScan;
+}
+
+}
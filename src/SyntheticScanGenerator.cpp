@@ -0,0 +1,400 @@
+#include <multilayer_laser_scan/SyntheticScanGenerator.h>
+#include <multilayer_laser_scan/CartesianProjection.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+#include <multilayer_laser_scan/PointFieldUtils.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace sensor_msgs
+{
+
+namespace
+{
+
+constexpr double DEG = 2 * M_PI / 360;
+
+/**
+ * @return Distance of the intersection of the ray from the origin in direction
+ *         d with the box, or a negative number if they don't intersect.
+ */
+double intersectBox(const SyntheticBox& box, const double d[3])
+{
+  double tNear = -std::numeric_limits<double>::infinity();
+  double tFar = std::numeric_limits<double>::infinity();
+  for (size_t axis = 0; axis < 3; ++axis)
+  {
+    if (std::abs(d[axis]) < 1e-12)
+    {
+      if (box.min[axis] > 0 || box.max[axis] < 0)
+        return -1;
+      continue;
+    }
+    auto t1 = box.min[axis] / d[axis];
+    auto t2 = box.max[axis] / d[axis];
+    if (t1 > t2)
+      std::swap(t1, t2);
+    tNear = std::max(tNear, t1);
+    tFar = std::min(tFar, t2);
+  }
+  if (tNear > tFar || tFar < 0)
+    return -1;
+  // the sensor is inside the box
+  return tNear > 0 ? tNear : tFar;
+}
+
+}
+
+SyntheticScene SyntheticScene::Room(const double sensorHeight, const double size)
+{
+  SyntheticScene scene;
+  const auto half = size / 2;
+
+  scene.planes.push_back({Eigen::Vector3d::UnitZ(), -sensorHeight, 20.0f});
+  scene.planes.push_back({Eigen::Vector3d::UnitX(), half, 60.0f});
+  scene.planes.push_back({-Eigen::Vector3d::UnitX(), half, 60.0f});
+  scene.planes.push_back({Eigen::Vector3d::UnitY(), half, 60.0f});
+  scene.planes.push_back({-Eigen::Vector3d::UnitY(), half, 60.0f});
+
+  const auto floor = -sensorHeight;
+  scene.boxes.push_back({{3.0, -1.0, floor}, {4.0, 1.0, floor + 1.0}, 150.0f});
+  scene.boxes.push_back({{-6.0, 2.0, floor}, {-5.0, 5.0, floor + 2.5}, 100.0f});
+  scene.boxes.push_back({{-1.0, -5.0, floor}, {1.5, -4.0, floor + 0.5}, 200.0f});
+
+  scene.rangeNoise = 0.01;
+  return scene;
+}
+
+SyntheticScanGenerator::SyntheticScanGenerator(const MultiLayerLaserScan& layoutScan, SyntheticScene scene,
+    const bool dualReturn, const uint32_t seed)
+  : layoutScan(layoutScan), scene(std::move(scene)), dualReturn(dualReturn), generator(seed),
+    noise(0.0f, 1.0f), dropout(0.0, 1.0)
+{
+  if (!(this->scene.rangeNoise >= 0))
+    throw std::runtime_error("Range noise has to be non-negative");
+
+  this->layout = std::make_shared<MultiLayerLaserScanLayout>(layoutScan);
+  // only the layout is needed
+  this->layoutScan.ranges.clear();
+  this->layoutScan.intensities.clear();
+  this->layoutScan.custom_data = PointData();
+
+  const auto length = this->layout->Length();
+  this->dirX.resize(length);
+  this->dirY.resize(length);
+  this->dirZ.resize(length);
+
+  MultiLayerLaserScan unitScan;
+  unitScan.ranges.resize(length, 1.0f);
+  CartesianProjection(*this->layout).Project(unitScan, this->dirX.data(), this->dirY.data(), this->dirZ.data());
+}
+
+const MultiLayerLaserScanLayout& SyntheticScanGenerator::GetLayout() const
+{
+  return *this->layout;
+}
+
+const SyntheticScene& SyntheticScanGenerator::GetScene() const
+{
+  return this->scene;
+}
+
+MultiLayerLaserScan SyntheticScanGenerator::Generate(const ros::Time& stamp)
+{
+  MultiLayerLaserScan scan;
+  this->Generate(stamp, scan);
+  return scan;
+}
+
+void SyntheticScanGenerator::Generate(const ros::Time& stamp, MultiLayerLaserScan& scan)
+{
+  const auto length = this->layout->Length();
+
+  scan.header.frame_id = this->layoutScan.header.frame_id;
+  scan.header.stamp = stamp;
+  scan.scan_layout = this->layoutScan.scan_layout;
+  scan.subscan_layout = this->layoutScan.subscan_layout;
+  scan.scan_offsets_during_subscan = this->layoutScan.scan_offsets_during_subscan;
+  scan.range_min = this->layoutScan.range_min;
+  scan.range_max = this->layoutScan.range_max;
+  scan.ranges.resize(length);
+  scan.intensities.resize(length);
+
+  auto& data = scan.custom_data;
+  uint8_t* returns = nullptr;
+  size_t step = 0;
+  if (this->dualReturn)
+  {
+    if (data.fields.size() != 2 || data.fields[0].name != "strongest" || data.fields[1].name != "latest")
+    {
+      PointDataModifier modifier(data);
+      modifier.setFieldsByString(2, "strongest", "latest");
+      data.is_bigendian = impl::isHostBigEndian();
+    }
+    PointDataModifier(data).resize(length);
+    returns = data.data.data();
+    step = data.point_step;
+  }
+  else
+  {
+    data = PointData();
+  }
+
+  for (size_t i = 0; i < length; ++i)
+  {
+    float strongest, latest;
+    this->CastRay(i, scan.ranges[i], scan.intensities[i], strongest, latest);
+    if (returns != nullptr)
+    {
+      std::memcpy(returns + i * step, &strongest, sizeof(float));
+      std::memcpy(returns + i * step + sizeof(float), &latest, sizeof(float));
+    }
+  }
+}
+
+void SyntheticScanGenerator::CastRay(const size_t i, float& first, float& firstIntensity, float& strongest,
+    float& latest)
+{
+  if (this->scene.dropoutProbability > 0 && this->dropout(this->generator) < this->scene.dropoutProbability)
+  {
+    first = strongest = latest = std::numeric_limits<float>::quiet_NaN();
+    firstIntensity = 0;
+    return;
+  }
+
+  const double d[3] = {this->dirX[i], this->dirY[i], this->dirZ[i]};
+  const double rangeMax = this->layoutScan.range_max;
+
+  double firstT = std::numeric_limits<double>::infinity();
+  double strongestT = firstT;
+  double latestT = -1;
+  float maxIntensity = -std::numeric_limits<float>::infinity();
+  firstIntensity = 0;
+
+  const auto addHit = [&](const double t, const float intensity)
+  {
+    if (!(t > 0) || t > rangeMax)
+      return;
+    if (t < firstT)
+    {
+      firstT = t;
+      firstIntensity = intensity;
+    }
+    if (intensity > maxIntensity || (intensity == maxIntensity && t < strongestT))
+    {
+      maxIntensity = intensity;
+      strongestT = t;
+    }
+    latestT = std::max(latestT, t);
+  };
+
+  for (const auto& plane : this->scene.planes)
+  {
+    const auto denominator = plane.normal.x() * d[0] + plane.normal.y() * d[1] + plane.normal.z() * d[2];
+    if (std::abs(denominator) > 1e-12)
+      addHit(plane.distance / denominator, plane.intensity);
+  }
+  for (const auto& box : this->scene.boxes)
+    addHit(intersectBox(box, d), box.intensity);
+
+  if (latestT < 0)
+  {
+    first = strongest = latest = std::numeric_limits<float>::infinity();
+    return;
+  }
+
+  const auto rangeNoise = this->scene.rangeNoise > 0 ?
+      static_cast<float>(this->scene.rangeNoise) * this->noise(this->generator) : 0.0f;
+  first = static_cast<float>(firstT) + rangeNoise;
+  strongest = static_cast<float>(strongestT) + rangeNoise;
+  latest = static_cast<float>(latestT) + rangeNoise;
+}
+
+MultiLayerLaserScan SyntheticScanGenerator::CreatePresetScan(const Preset preset, double rate)
+{
+  if (rate < 0)
+    throw std::runtime_error("Scan rate has to be positive");
+  if (rate == 0)
+    rate = GetNominalRate(preset);
+
+  MultiLayerLaserScan msg;
+
+  switch (preset)
+  {
+    case SICK_LMS151:
+    {
+      // 541 single-element subscans (RealScanners.SickLMS151AsScan), 720 samples per revolution
+      msg.scan_layout.time_offsets.regular = true;
+      msg.scan_layout.time_offsets.increment = ros::Duration(1.0 / rate / 720);
+      msg.scan_layout.angular_offsets.regular = true;
+      msg.scan_layout.angular_offsets.min = -135 * DEG;
+      msg.scan_layout.angular_offsets.max = 135 * DEG;
+      msg.scan_layout.angular_offsets.samples = 541;
+
+      msg.subscan_layout.time_offsets.regular = true;
+      msg.subscan_layout.time_offsets.increment = ros::Duration(0);
+      msg.subscan_layout.angular_offsets.regular = false;
+      msg.subscan_layout.angular_offsets.offsets = {0};
+
+      msg.scan_offsets_during_subscan.regular = false;
+      msg.scan_offsets_during_subscan.offsets = {0};
+
+      msg.range_min = 0.05f;
+      msg.range_max = 50.0f;
+      break;
+    }
+    case VELODYNE_HDL_32E:
+    {
+      // RealScanners.VelodyneHDL32ERegular
+      msg.subscan_layout.time_offsets.regular = true;
+      msg.subscan_layout.time_offsets.increment = ros::Duration(1.152e-6);
+      msg.subscan_layout.angular_offsets.regular = false;
+      msg.subscan_layout.angular_offsets.offsets = {
+          -30.67, -9.33, -29.33, -8.00, -28.00, -6.67, -26.67, -5.33,
+          -25.33, -4.00, -24.00, -2.67, -22.67, -1.33, -21.33,  0.00,
+          -20.00,  1.33, -18.67,  2.67, -17.33,  4.00, -16.00,  5.33,
+          -14.67,  6.67, -13.33,  8.00, -12.00,  9.33, -10.67,  10.67
+      };
+      for (auto& offset : msg.subscan_layout.angular_offsets.offsets)
+        offset *= DEG;
+
+      const size_t samples = 2172;
+      msg.scan_layout.time_offsets.regular = true;
+      msg.scan_layout.time_offsets.increment = ros::Duration(1.0 / rate / samples);
+      msg.scan_layout.angular_offsets.regular = true;
+      msg.scan_layout.angular_offsets.min = 0;
+      msg.scan_layout.angular_offsets.max = 2 * M_PI;
+      msg.scan_layout.angular_offsets.samples = samples;
+      msg.scan_layout.angular_offsets.exclude_last = true;
+
+      // the head keeps rotating while the 32 lasers fire (40 firing slots per subscan)
+      msg.scan_offsets_during_subscan.regular = true;
+      msg.scan_offsets_during_subscan.min = 0;
+      msg.scan_offsets_during_subscan.max = 2 * M_PI / samples / 40 * 32;
+      msg.scan_offsets_during_subscan.samples = 32;
+
+      msg.range_min = 1.0f;
+      msg.range_max = 100.0f;
+      break;
+    }
+    case OUSTER_OS1_64:
+    {
+      // RealScanners.Ouster64Regular
+      msg.subscan_layout.time_offsets.regular = true;
+      msg.subscan_layout.time_offsets.increment = ros::Duration(0);
+      msg.subscan_layout.angular_offsets.regular = true;
+      msg.subscan_layout.angular_offsets.min = -16.611 * DEG;
+      msg.subscan_layout.angular_offsets.max = 16.611 * DEG;
+      msg.subscan_layout.angular_offsets.samples = -64;
+
+      const size_t samples = 2048;
+      msg.scan_layout.time_offsets.regular = true;
+      msg.scan_layout.time_offsets.increment = ros::Duration(1.0 / rate / samples);
+      msg.scan_layout.angular_offsets.regular = true;
+      msg.scan_layout.angular_offsets.min = 0;
+      msg.scan_layout.angular_offsets.max = 2 * M_PI;
+      msg.scan_layout.angular_offsets.exclude_last = true;
+      msg.scan_layout.angular_offsets.samples = samples;
+
+      msg.scan_offsets_during_subscan.regular = false;
+      for (size_t i = 0; i < 16; ++i)
+      {
+        for (const auto offset : {3.164, 1.055, -1.055, -3.164})
+          msg.scan_offsets_during_subscan.offsets.push_back(offset * DEG);
+      }
+
+      msg.range_min = 0.25f;
+      msg.range_max = 120.0f;
+      break;
+    }
+    case RSLIDAR_32:
+    {
+      // RealScanners.RSLidar32Regular
+      msg.subscan_layout.time_offsets.regular = false;
+      msg.subscan_layout.time_offsets.offsets.resize(32);
+      for (size_t i = 0; i < 16; ++i)
+      {
+        const ros::Duration offset(0, static_cast<int32_t>(i * 3000));
+        msg.subscan_layout.time_offsets.offsets[i] = offset;
+        msg.subscan_layout.time_offsets.offsets[i + 16] = offset;
+      }
+      msg.subscan_layout.angular_offsets.regular = false;
+      msg.subscan_layout.angular_offsets.offsets = {
+          -10.2637,   0.2972,  -6.4063,  -0.0179,   2.2794,  -0.3330,   3.2973,  -0.6670,
+            4.6136,   1.6849,   7.0176,   1.2972,  10.2983,   1.0000,  15.0167,   0.7028,
+          -25.0000,  -2.2794, -14.6380,  -2.6670,  -7.9100,  -3.0179,  -5.4070,  -3.2973,
+           -3.6492,  -1.0179,  -4.0534,  -1.3330,  -4.3864,  -1.6312,  -4.6492,  -1.9821
+      };
+      for (auto& offset : msg.subscan_layout.angular_offsets.offsets)
+        offset *= DEG;
+
+      const size_t samples = 1500;
+      msg.scan_layout.time_offsets.regular = true;
+      msg.scan_layout.time_offsets.increment = ros::Duration(1.0 / rate / samples);
+      msg.scan_layout.angular_offsets.regular = true;
+      msg.scan_layout.angular_offsets.min = 0;
+      msg.scan_layout.angular_offsets.max = 2 * M_PI;
+      msg.scan_layout.angular_offsets.exclude_last = true;
+      msg.scan_layout.angular_offsets.samples = samples;
+
+      msg.scan_offsets_during_subscan.regular = false;
+      msg.scan_offsets_during_subscan.offsets = {
+          9.1205,  -7.1203,   8.9109,  -1.7781,   9.1205,   3.5716,  -6.8380,   8.7856,
+          9.1205,  -7.1555,  -6.7674,  -1.8139,   9.0507,   3.4859,  -6.9439,   8.9007,
+         -6.6968,  -7.3317,  -6.6614,  -2.0000,  -6.7674,   3.3932,  -6.8380,   8.8060,
+         -7.1908,  -7.2965,  -1.8643,  -1.8139,   3.4932,   3.5716,   8.8060,   8.7308
+      };
+      for (auto& offset : msg.scan_offsets_during_subscan.offsets)
+        offset *= DEG;
+
+      msg.range_min = 0.4f;
+      msg.range_max = 200.0f;
+      break;
+    }
+    default:
+      throw std::runtime_error("Unknown scanner preset " + std::to_string(preset));
+  }
+
+  const auto length = ParsedScanLayout(msg.scan_layout).Length() * ParsedScanLayout(msg.subscan_layout).Length();
+  msg.ranges.resize(length, std::numeric_limits<float>::infinity());
+  msg.intensities.resize(length, 0.0f);
+  return msg;
+}
+
+double SyntheticScanGenerator::GetNominalRate(const Preset preset)
+{
+  switch (preset)
+  {
+    case SICK_LMS151:
+      return 50.0;
+    case VELODYNE_HDL_32E:
+    case OUSTER_OS1_64:
+    case RSLIDAR_32:
+      return 10.0;
+    default:
+      throw std::runtime_error("Unknown scanner preset " + std::to_string(preset));
+  }
+}
+
+SyntheticScanGenerator::Preset SyntheticScanGenerator::ParsePreset(const std::string& name)
+{
+  std::string normalized(name);
+  for (auto& c : normalized)
+    c = (c == '-') ? '_' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+  if (normalized == "sick_lms151")
+    return SICK_LMS151;
+  if (normalized == "velodyne_hdl_32e")
+    return VELODYNE_HDL_32E;
+  if (normalized == "ouster_os1_64")
+    return OUSTER_OS1_64;
+  if (normalized == "rslidar_32")
+    return RSLIDAR_32;
+  throw std::runtime_error("Unknown scanner preset " + name);
+}
+
+}
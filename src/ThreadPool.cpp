@@ -0,0 +1,135 @@
+#include <multilayer_laser_scan/ThreadPool.h>
+
+#include <algorithm>
+
+namespace sensor_msgs
+{
+
+namespace
+{
+
+// the pool whose task is being executed by this thread
+thread_local const ThreadPool* currentPool = nullptr;
+
+}
+
+ThreadPool::ThreadPool(size_t _numThreads)
+{
+  if (_numThreads == 0)
+    _numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+  this->workers.reserve(_numThreads - 1);
+  for (size_t i = 0; i + 1 < _numThreads; ++i)
+    this->workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stop = true;
+  }
+  this->batchStarted.notify_all();
+
+  for (auto& worker : this->workers)
+    worker.join();
+}
+
+ThreadPool& ThreadPool::Instance()
+{
+  static ThreadPool pool;
+  return pool;
+}
+
+size_t ThreadPool::NumThreads() const
+{
+  return this->workers.size() + 1;
+}
+
+void ThreadPool::Run(const size_t numTasks, const std::function<void(size_t)>& task)
+{
+  if (numTasks == 0)
+    return;
+
+  if (this->workers.empty() || numTasks == 1 || currentPool == this)
+  {
+    for (size_t i = 0; i < numTasks; ++i)
+      task(i);
+    return;
+  }
+
+  std::lock_guard<std::mutex> runLock(this->runMutex);
+
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->task = &task;
+    this->numTasks = numTasks;
+    this->nextTask = 0;
+    this->error = nullptr;
+    this->busyWorkers = this->workers.size();
+    ++this->generation;
+  }
+  this->batchStarted.notify_all();
+
+  const auto previousPool = currentPool;
+  currentPool = this;
+  this->RunTasks();
+  currentPool = previousPool;
+
+  std::exception_ptr batchError;
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->batchFinished.wait(lock, [this] { return this->busyWorkers == 0; });
+    this->task = nullptr;
+    batchError = this->error;
+  }
+
+  if (batchError)
+    std::rethrow_exception(batchError);
+}
+
+void ThreadPool::WorkerLoop()
+{
+  currentPool = this;
+  size_t lastGeneration = 0;
+
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->batchStarted.wait(lock, [&] { return this->stop || this->generation != lastGeneration; });
+      if (this->stop)
+        return;
+      lastGeneration = this->generation;
+    }
+
+    this->RunTasks();
+
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      if (--this->busyWorkers == 0)
+        this->batchFinished.notify_one();
+    }
+  }
+}
+
+void ThreadPool::RunTasks()
+{
+  // task and numTasks do not change until all threads finish the batch
+  for (auto i = this->nextTask++; i < this->numTasks; i = this->nextTask++)
+  {
+    try
+    {
+      (*this->task)(i);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      if (!this->error)
+        this->error = std::current_exception();
+      this->nextTask = this->numTasks;
+    }
+  }
+}
+
+}
@@ -0,0 +1,160 @@
+#include <multilayer_laser_scan/decoders/OusterOS1Decoder.h>
+#include <multilayer_laser_scan/ScanAssembler.h>
+#include <multilayer_laser_scan/PointFieldUtils.h>
+
+#include <pluginlib/class_list_macros.hpp>
+
+#include <cmath>
+#include <cstring>
+
+namespace sensor_msgs
+{
+
+constexpr size_t OusterOS1Decoder::COLUMNS_PER_PACKET;
+constexpr size_t OusterOS1Decoder::BEAMS;
+constexpr size_t OusterOS1Decoder::PIXEL_SIZE;
+constexpr size_t OusterOS1Decoder::COLUMN_HEADER_SIZE;
+constexpr size_t OusterOS1Decoder::COLUMN_SIZE;
+constexpr size_t OusterOS1Decoder::PACKET_SIZE;
+constexpr uint32_t OusterOS1Decoder::ENCODER_TICKS_PER_REV;
+constexpr uint32_t OusterOS1Decoder::VALID_COLUMN_STATUS;
+
+namespace
+{
+
+// nominal azimuth offsets of the 4 staggered beam columns [deg]
+const double NOMINAL_BEAM_AZIMUTHS[4] = {3.164, 1.055, -1.055, -3.164};
+const double NOMINAL_VERTICAL_FOV = 33.222;  // [deg]
+
+inline uint16_t readUInt16(const uint8_t* data)
+{
+  return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+inline uint32_t readUInt32(const uint8_t* data)
+{
+  return static_cast<uint32_t>(readUInt16(data)) | (static_cast<uint32_t>(readUInt16(data + 2)) << 16);
+}
+
+inline uint64_t readUInt64(const uint8_t* data)
+{
+  return static_cast<uint64_t>(readUInt32(data)) | (static_cast<uint64_t>(readUInt32(data + 4)) << 32);
+}
+
+double getParameter(const DecoderParameters& params, const std::string& name, const double defaultValue)
+{
+  const auto param = params.find(name);
+  if (param == params.end())
+    return defaultValue;
+  if (param->second.size() != 1)
+    throw std::runtime_error("Parameter " + name + " has to have exactly one value");
+  return param->second[0];
+}
+
+void getAnglesParameter(const DecoderParameters& params, const std::string& name, std::vector<double>& angles)
+{
+  const auto param = params.find(name);
+  if (param == params.end())
+    return;
+  if (param->second.size() != OusterOS1Decoder::BEAMS)
+    throw std::runtime_error("Parameter " + name + " has to have " + std::to_string(OusterOS1Decoder::BEAMS) +
+      " values, but it has " + std::to_string(param->second.size()));
+
+  for (size_t i = 0; i < OusterOS1Decoder::BEAMS; ++i)
+    angles[i] = param->second[i] * M_PI / 180.0;
+}
+
+}
+
+OusterOS1Decoder::OusterOS1Decoder() : beamAltitudeAngles(BEAMS), beamAzimuthAngles(BEAMS)
+{
+  for (size_t i = 0; i < BEAMS; ++i)
+  {
+    const auto altitude = NOMINAL_VERTICAL_FOV / 2 - NOMINAL_VERTICAL_FOV * i / (BEAMS - 1);
+    this->beamAltitudeAngles[i] = altitude * M_PI / 180.0;
+    this->beamAzimuthAngles[i] = NOMINAL_BEAM_AZIMUTHS[i % 4] * M_PI / 180.0;
+  }
+}
+
+void OusterOS1Decoder::Configure(const DecoderParameters& params)
+{
+  getAnglesParameter(params, "beam_altitude_angles", this->beamAltitudeAngles);
+  getAnglesParameter(params, "beam_azimuth_angles", this->beamAzimuthAngles);
+  this->rangeMin = static_cast<float>(getParameter(params, "range_min", this->rangeMin));
+  this->rangeMax = static_cast<float>(getParameter(params, "range_max", this->rangeMax));
+}
+
+size_t OusterOS1Decoder::GetSubscanLength() const
+{
+  return BEAMS;
+}
+
+void OusterOS1Decoder::FillScanTemplate(MultiLayerLaserScan& msg) const
+{
+  msg.range_min = this->rangeMin;
+  msg.range_max = this->rangeMax;
+
+  msg.subscan_layout.angular_offsets.regular = false;
+  msg.subscan_layout.angular_offsets.offsets = this->beamAltitudeAngles;
+
+  // all beams of a column are fired at once
+  msg.subscan_layout.time_offsets.regular = true;
+  msg.subscan_layout.time_offsets.base_offset = ros::Duration(0);
+  msg.subscan_layout.time_offsets.increment = ros::Duration(0);
+
+  // beam azimuth is added to the encoder angle, which decreases the scan angle
+  msg.scan_offsets_during_subscan.regular = false;
+  msg.scan_offsets_during_subscan.offsets.resize(BEAMS);
+  for (size_t i = 0; i < BEAMS; ++i)
+    msg.scan_offsets_during_subscan.offsets[i] = -this->beamAzimuthAngles[i];
+
+  msg.custom_data.fields.resize(1);
+  msg.custom_data.fields[0].name = "reflectivity";
+  msg.custom_data.fields[0].offset = 0;
+  msg.custom_data.fields[0].datatype = PointField::UINT16;
+  msg.custom_data.fields[0].count = 1;
+  msg.custom_data.point_step = sizeof(uint16_t);
+  msg.custom_data.is_bigendian = impl::isHostBigEndian();
+}
+
+void OusterOS1Decoder::Decode(const uint8_t* data, const size_t size, const ros::Time& stamp,
+    ScanAssembler& assembler) const
+{
+  if (size < PACKET_SIZE)
+    throw std::runtime_error("OS1-64 packet has " + std::to_string(size) + " bytes, expected " +
+      std::to_string(PACKET_SIZE));
+
+  // column timestamps are in sensor time, so only their differences are used
+  const auto packetTimestamp = readUInt64(data);
+
+  for (size_t c = 0; c < COLUMNS_PER_PACKET; ++c)
+  {
+    const auto* const column = data + c * COLUMN_SIZE;
+    if (readUInt32(column + COLUMN_SIZE - 4) != VALID_COLUMN_STATUS)
+      continue;
+
+    const auto timestamp = static_cast<int64_t>(readUInt64(column) - packetTimestamp);
+    ros::Duration timeOffset;
+    timeOffset.fromNSec(timestamp);
+
+    const auto encoderAngle = 2 * M_PI * readUInt32(column + 12) / ENCODER_TICKS_PER_REV;
+    auto scanAngle = M_PI - encoderAngle;
+    if (scanAngle < -M_PI)
+      scanAngle += 2 * M_PI;
+
+    const auto subscan = assembler.AppendSubscan(scanAngle, stamp + timeOffset);
+
+    const auto* pixel = column + COLUMN_HEADER_SIZE;
+    for (size_t i = 0; i < BEAMS; ++i, pixel += PIXEL_SIZE)
+    {
+      subscan.ranges[i] = static_cast<float>((readUInt32(pixel) & 0x000FFFFF) * 0.001);
+      subscan.intensities[i] = readUInt16(pixel + 6);
+      const auto reflectivity = readUInt16(pixel + 4);
+      std::memcpy(subscan.customData + i * sizeof(uint16_t), &reflectivity, sizeof(uint16_t));
+    }
+  }
+}
+
+}
+
+PLUGINLIB_EXPORT_CLASS(sensor_msgs::OusterOS1Decoder, sensor_msgs::ScanPacketDecoder)
@@ -0,0 +1,117 @@
+#include <multilayer_laser_scan/decoders/VelodyneHDL32EDecoder.h>
+#include <multilayer_laser_scan/ScanAssembler.h>
+
+#include <pluginlib/class_list_macros.hpp>
+
+#include <cmath>
+
+namespace sensor_msgs
+{
+
+constexpr size_t VelodyneHDL32EDecoder::PACKET_SIZE;
+constexpr size_t VelodyneHDL32EDecoder::BLOCKS_PER_PACKET;
+constexpr size_t VelodyneHDL32EDecoder::BLOCK_SIZE;
+constexpr size_t VelodyneHDL32EDecoder::LASERS;
+constexpr uint16_t VelodyneHDL32EDecoder::BLOCK_FLAG;
+constexpr double VelodyneHDL32EDecoder::DISTANCE_RESOLUTION;
+constexpr double VelodyneHDL32EDecoder::LASER_FIRING_PERIOD;
+constexpr double VelodyneHDL32EDecoder::BLOCK_FIRING_PERIOD;
+
+namespace
+{
+
+// vertical angles of the lasers in the order they are fired [deg]
+const double VERTICAL_ANGLES[VelodyneHDL32EDecoder::LASERS] = {
+  -30.67, -9.33, -29.33, -8.00, -28.00, -6.67, -26.67, -5.33,
+  -25.33, -4.00, -24.00, -2.67, -22.67, -1.33, -21.33, 0.00,
+  -20.00, 1.33, -18.67, 2.67, -17.33, 4.00, -16.00, 5.33,
+  -14.67, 6.67, -13.33, 8.00, -12.00, 9.33, -10.67, 10.67,
+};
+
+inline uint16_t readUInt16(const uint8_t* data)
+{
+  return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+double getParameter(const DecoderParameters& params, const std::string& name, const double defaultValue)
+{
+  const auto param = params.find(name);
+  if (param == params.end())
+    return defaultValue;
+  if (param->second.size() != 1)
+    throw std::runtime_error("Parameter " + name + " has to have exactly one value");
+  return param->second[0];
+}
+
+}
+
+void VelodyneHDL32EDecoder::Configure(const DecoderParameters& params)
+{
+  this->rangeMin = static_cast<float>(getParameter(params, "range_min", this->rangeMin));
+  this->rangeMax = static_cast<float>(getParameter(params, "range_max", this->rangeMax));
+  this->rpm = getParameter(params, "rpm", this->rpm);
+}
+
+size_t VelodyneHDL32EDecoder::GetSubscanLength() const
+{
+  return LASERS;
+}
+
+void VelodyneHDL32EDecoder::FillScanTemplate(MultiLayerLaserScan& msg) const
+{
+  msg.range_min = this->rangeMin;
+  msg.range_max = this->rangeMax;
+
+  msg.subscan_layout.angular_offsets.regular = false;
+  msg.subscan_layout.angular_offsets.offsets.resize(LASERS);
+  for (size_t i = 0; i < LASERS; ++i)
+    msg.subscan_layout.angular_offsets.offsets[i] = VERTICAL_ANGLES[i] * M_PI / 180.0;
+
+  msg.subscan_layout.time_offsets.regular = true;
+  msg.subscan_layout.time_offsets.base_offset = ros::Duration(0);
+  msg.subscan_layout.time_offsets.increment = ros::Duration(LASER_FIRING_PERIOD);
+
+  // the head rotates clockwise, so the scan angle decreases while the lasers are fired
+  const auto angularVelocity = -this->rpm / 60.0 * 2 * M_PI;
+  msg.scan_offsets_during_subscan.regular = false;
+  msg.scan_offsets_during_subscan.offsets.resize(LASERS);
+  for (size_t i = 0; i < LASERS; ++i)
+    msg.scan_offsets_during_subscan.offsets[i] = angularVelocity * LASER_FIRING_PERIOD * i;
+
+  msg.custom_data.fields.clear();
+  msg.custom_data.point_step = 0;
+}
+
+void VelodyneHDL32EDecoder::Decode(const uint8_t* data, const size_t size, const ros::Time& stamp,
+    ScanAssembler& assembler) const
+{
+  if (size < PACKET_SIZE)
+    throw std::runtime_error("HDL-32E packet has " + std::to_string(size) + " bytes, expected " +
+      std::to_string(PACKET_SIZE));
+
+  for (size_t b = 0; b < BLOCKS_PER_PACKET; ++b)
+  {
+    const auto* const block = data + b * BLOCK_SIZE;
+    if (readUInt16(block) != BLOCK_FLAG)
+      throw std::runtime_error("Firing block " + std::to_string(b) + " of HDL-32E packet has invalid flag");
+
+    // azimuth is in hundredths of degree clockwise from the front of the sensor
+    const auto azimuth = readUInt16(block + 2) * M_PI / 18000.0;
+    auto scanAngle = -azimuth;
+    if (scanAngle < -M_PI)
+      scanAngle += 2 * M_PI;
+
+    const auto subscan = assembler.AppendSubscan(scanAngle, stamp + ros::Duration(b * BLOCK_FIRING_PERIOD));
+
+    const auto* laser = block + 4;
+    for (size_t i = 0; i < LASERS; ++i, laser += 3)
+    {
+      subscan.ranges[i] = static_cast<float>(readUInt16(laser) * DISTANCE_RESOLUTION);
+      subscan.intensities[i] = laser[2];
+    }
+  }
+}
+
+}
+
+PLUGINLIB_EXPORT_CLASS(sensor_msgs::VelodyneHDL32EDecoder, sensor_msgs::ScanPacketDecoder)
@@ -0,0 +1,138 @@
+/**
+ * Publishes synthetic MultiLayerLaserScans of a room (see SyntheticScene::Room())
+ * for load testing without recorded data.
+ *
+ * Private parameters:
+ * - presets (string, default "ouster_os1_64"): Comma-separated scanner presets
+ *   (see SyntheticScanGenerator::ParsePreset()), one per simulated sensor. The
+ *   same preset may be given more times.
+ * - rate (double, default 10): Scan rate of all sensors [Hz].
+ * - dual_return (bool, default false): Add "strongest" and "latest" custom fields.
+ * - range_noise (double, default 0.01): Standard deviation of range noise [m].
+ * - dropout_probability (double, default 0): Probability of rays without return.
+ * - sensor_height (double, default 1.5): Height of the sensors above the floor [m].
+ * - room_size (double, default 20): Side of the room [m].
+ * - max_scans (int, default 0): Stop after publishing this many scans of each
+ *   sensor (0 = run until shutdown).
+ * - instrumentation_file (string, default ""): If the library is compiled with
+ *   MULTILAYER_LASER_SCAN_INSTRUMENTATION, write its statistics to this file on
+ *   exit (see instrumentation::WriteToFile()). The statistics are also published
+ *   on /diagnostics once per second in that case.
+ *
+ * Sensor i publishes on topic scan_i in frame sensor_i (topic scan and frame
+ * sensor if there is only one sensor).
+ */
+
+#include <diagnostic_msgs/DiagnosticArray.h>
+#include <multilayer_laser_scan/Instrumentation.h>
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+#include <multilayer_laser_scan/SyntheticScanGenerator.h>
+#include <ros/ros.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace sensor_msgs;
+
+int main(int argc, char** argv)
+{
+  ros::init(argc, argv, "synthetic_scan_generator");
+  ros::NodeHandle nh;
+  ros::NodeHandle pnh("~");
+
+  std::string presets, instrumentationFile;
+  double rate, rangeNoise, dropoutProbability, sensorHeight, roomSize;
+  bool dualReturn;
+  int maxScans;
+  pnh.param<std::string>("presets", presets, "ouster_os1_64");
+  pnh.param("rate", rate, 10.0);
+  pnh.param("dual_return", dualReturn, false);
+  pnh.param("range_noise", rangeNoise, 0.01);
+  pnh.param("dropout_probability", dropoutProbability, 0.0);
+  pnh.param("sensor_height", sensorHeight, 1.5);
+  pnh.param("room_size", roomSize, 20.0);
+  pnh.param("max_scans", maxScans, 0);
+  pnh.param<std::string>("instrumentation_file", instrumentationFile, "");
+
+  if (!(rate > 0))
+  {
+    ROS_ERROR_STREAM("Parameter rate has to be positive, got " << rate);
+    return 1;
+  }
+
+  auto scene = SyntheticScene::Room(sensorHeight, roomSize);
+  scene.rangeNoise = rangeNoise;
+  scene.dropoutProbability = dropoutProbability;
+
+  std::vector<std::string> names;
+  std::stringstream presetStream(presets);
+  std::string name;
+  while (std::getline(presetStream, name, ','))
+    if (!name.empty())
+      names.push_back(name);
+
+  std::vector<std::unique_ptr<SyntheticScanGenerator>> generators;
+  std::vector<ros::Publisher> publishers;
+  std::vector<MultiLayerLaserScan> scans(names.size());
+  try
+  {
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+      const auto suffix = names.size() == 1 ? std::string() : "_" + std::to_string(i);
+      auto layoutScan = SyntheticScanGenerator::CreatePresetScan(SyntheticScanGenerator::ParsePreset(names[i]), rate);
+      layoutScan.header.frame_id = "sensor" + suffix;
+      generators.emplace_back(new SyntheticScanGenerator(layoutScan, scene, dualReturn, static_cast<uint32_t>(i)));
+      publishers.push_back(nh.advertise<MultiLayerLaserScan>("scan" + suffix, 10));
+      ROS_INFO_STREAM("Sensor " << i << " is " << names[i] << " with " << generators.back()->GetLayout().Length()
+                      << " points, publishing on scan" << suffix);
+    }
+  }
+  catch (const std::runtime_error& e)
+  {
+    ROS_ERROR_STREAM(e.what());
+    return 1;
+  }
+
+  ros::Publisher diagnosticsPublisher;
+  diagnostic_msgs::DiagnosticArray diagnostics;
+  ros::Time lastDiagnostics;
+  if (instrumentation::IsEnabled())
+    diagnosticsPublisher = nh.advertise<diagnostic_msgs::DiagnosticArray>("/diagnostics", 1);
+
+  ros::Rate loopRate(rate);
+  for (int n = 0; ros::ok() && (maxScans <= 0 || n < maxScans); ++n)
+  {
+    const auto stamp = ros::Time::now();
+    for (size_t i = 0; i < generators.size(); ++i)
+    {
+      generators[i]->Generate(stamp, scans[i]);
+      publishers[i].publish(scans[i]);
+    }
+    if (instrumentation::IsEnabled() && stamp - lastDiagnostics >= ros::Duration(1.0))
+    {
+      instrumentation::FillDiagnostics(instrumentation::Collect(), ros::this_node::getName(), diagnostics);
+      diagnosticsPublisher.publish(diagnostics);
+      lastDiagnostics = stamp;
+    }
+    ros::spinOnce();
+    if (!loopRate.sleep())
+      ROS_WARN_STREAM("Generating the scans took longer than 1/rate");
+  }
+
+  if (instrumentation::IsEnabled() && !instrumentationFile.empty())
+  {
+    try
+    {
+      instrumentation::WriteToFile(instrumentationFile, instrumentation::Collect());
+    }
+    catch (const std::runtime_error& e)
+    {
+      ROS_ERROR_STREAM(e.what());
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -1,4 +1,10 @@
 #include <multilayer_laser_scan/scan_iterator.h>
+#include <multilayer_laser_scan/Instrumentation.h>
+#include <multilayer_laser_scan/PointFieldUtils.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
 
 namespace sensor_msgs
 {
@@ -12,10 +18,21 @@ MultiLayerLaserScanBaseFields<C, R, I>::MultiLayerLaserScanBaseFields(
 {
 }
 
+template<typename C, typename R, typename I>
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::MultiLayerLaserScanBaseFieldsIteratorBase() = default;
+
 template<typename C, typename R, typename I>
 MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::MultiLayerLaserScanBaseFieldsIteratorBase(
-    C &scan, std::shared_ptr<MultiLayerLaserScanLayout> layout)
+    C &scan, std::shared_ptr<const MultiLayerLaserScanLayout> layout)
     : scan(&scan), layout(std::move(layout))
+{
+  MLS_INSTRUMENT_COUNT(ITERATOR_CREATE, (scan.ranges.size() + scan.intensities.size()) * sizeof(float));
+}
+
+template<typename C, typename R, typename I>
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::MultiLayerLaserScanBaseFieldsIteratorBase(
+    C &scan, std::shared_ptr<const MultiLayerLaserScanLayout> layout, const size_t i)
+    : scan(&scan), layout(std::move(layout)), i(i)
 {
 }
 
@@ -51,6 +68,13 @@ MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator*() const
       timestamp);
 }
 
+template<typename C, typename R, typename I>
+MultiLayerLaserScanBaseFields<C, R, I>
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator[](const difference_type n) const
+{
+  return *(*this + n);
+}
+
 template<typename C, typename R, typename I>
 MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>&
 MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator++()
@@ -59,6 +83,74 @@ MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator++()
   return *this;
 }
 
+template<typename C, typename R, typename I>
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator++(int)
+{
+  auto result = *this;
+  ++this->i;
+  return result;
+}
+
+template<typename C, typename R, typename I>
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>&
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator--()
+{
+  --this->i;
+  return *this;
+}
+
+template<typename C, typename R, typename I>
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator--(int)
+{
+  auto result = *this;
+  --this->i;
+  return result;
+}
+
+template<typename C, typename R, typename I>
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>&
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator+=(const difference_type n)
+{
+  this->i += n;
+  return *this;
+}
+
+template<typename C, typename R, typename I>
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>&
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator-=(const difference_type n)
+{
+  this->i -= n;
+  return *this;
+}
+
+template<typename C, typename R, typename I>
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator+(const difference_type n) const
+{
+  auto result = *this;
+  result.i += n;
+  return result;
+}
+
+template<typename C, typename R, typename I>
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator-(const difference_type n) const
+{
+  auto result = *this;
+  result.i -= n;
+  return result;
+}
+
+template<typename C, typename R, typename I>
+typename MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::difference_type
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator-(
+    const MultiLayerLaserScanBaseFieldsIteratorBase& iter) const
+{
+  return static_cast<difference_type>(this->i) - static_cast<difference_type>(iter.i);
+}
+
 template<typename C, typename R, typename I>
 bool MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator!=(
     const MultiLayerLaserScanBaseFieldsIteratorBase& iter) const
@@ -66,13 +158,54 @@ bool MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator!=(
   return this->i != iter.i;
 }
 
+template<typename C, typename R, typename I>
+bool MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator==(
+    const MultiLayerLaserScanBaseFieldsIteratorBase& iter) const
+{
+  return this->i == iter.i;
+}
+
+template<typename C, typename R, typename I>
+bool MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator<(
+    const MultiLayerLaserScanBaseFieldsIteratorBase& iter) const
+{
+  return this->i < iter.i;
+}
+
+template<typename C, typename R, typename I>
+bool MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator>(
+    const MultiLayerLaserScanBaseFieldsIteratorBase& iter) const
+{
+  return this->i > iter.i;
+}
+
+template<typename C, typename R, typename I>
+bool MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator<=(
+    const MultiLayerLaserScanBaseFieldsIteratorBase& iter) const
+{
+  return this->i <= iter.i;
+}
+
+template<typename C, typename R, typename I>
+bool MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::operator>=(
+    const MultiLayerLaserScanBaseFieldsIteratorBase& iter) const
+{
+  return this->i >= iter.i;
+}
+
+template<typename C, typename R, typename I>
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>
+MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::begin() const
+{
+  return MultiLayerLaserScanBaseFieldsIteratorBase(*this->scan, this->layout, 0);
+}
+
 template<typename C, typename R, typename I>
 MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>
 MultiLayerLaserScanBaseFieldsIteratorBase<C, R, I>::end() const
 {
-  MultiLayerLaserScanBaseFieldsIteratorBase result(*this->scan, this->layout);
-  result.i = this->layout->Length();
-  return result;
+  // the index constructor, so that comparing with end() in every step of a loop is not counted as a new iterator
+  return MultiLayerLaserScanBaseFieldsIteratorBase(*this->scan, this->layout, this->layout->Length());
 }
 
 template<typename C, typename R, typename I>
@@ -95,6 +228,7 @@ void PointDataModifier::reserve(size_t size)
 
 void PointDataModifier::resize(size_t size)
 {
+  MLS_INSTRUMENT_SCOPE(POINT_DATA_MODIFY, size * pointDataMsg.point_step);
   pointDataMsg.data.resize(size * pointDataMsg.point_step);
 }
 
@@ -103,28 +237,6 @@ void PointDataModifier::clear()
   pointDataMsg.data.clear();
 }
 
-/** Return the size of a datatype (which is an enum of sensor_msgs::PointField::) in bytes
- * @param datatype one of the enums of sensor_msgs::PointField::
- */
-inline size_t sizeOfPointField(PointField::_datatype_type datatype)
-{
-  if ((datatype == PointField::INT8) || (datatype == PointField::UINT8))
-    return 1;
-  else if ((datatype == PointField::INT16) || (datatype == PointField::UINT16))
-    return 2;
-  else if ((datatype == PointField::INT32) || (datatype == PointField::UINT32) ||
-      (datatype == PointField::FLOAT32))
-    return 4;
-  else if (datatype == PointField::FLOAT64)
-    return 8;
-  else
-  {
-    std::stringstream err;
-    err << "PointField of type " << datatype << " does not exist";
-    throw std::runtime_error(err.str());
-  }
-}
-
 /** Private function that adds a PointField to the "fields" member of a PointCloud2
  * @param pointDataMsg the PointCloud2 to add a field to
  * @param name the name of the field
@@ -145,7 +257,7 @@ inline size_t addPointField(sensor_msgs::PointData &pointDataMsg,
   pointDataMsg.fields.push_back(point_field);
 
   // Update the offset
-  return offset + point_field.count * sizeOfPointField(datatype);
+  return offset + point_field.count * impl::sizeOfPointField(datatype);
 }
 
 void PointDataModifier::setFields(size_t n_fields, ...)
@@ -201,6 +313,75 @@ void PointDataModifier::setFieldsByString(size_t n_fields, ...)
   this->resize(numPoints);
 }
 
+void PointDataModifier::appendFieldsByString(size_t n_fields, ...)
+{
+  std::vector<std::string> fieldNames;
+  fieldNames.reserve(n_fields);
+  va_list vl;
+  va_start(vl, n_fields);
+  for (size_t i = 0; i < n_fields; ++i)
+    fieldNames.emplace_back(va_arg(vl, char*));
+  va_end(vl);
+
+  for (const auto& fieldName : fieldNames)
+  {
+    for (const auto& field : pointDataMsg.fields)
+      if (field.name == fieldName)
+        throw std::runtime_error("Field " + fieldName + " already exists");
+  }
+
+  const size_t oldStep = pointDataMsg.point_step;
+  size_t numPoints = 0;
+  if (oldStep > 0)
+    numPoints = pointDataMsg.data.size() / oldStep;
+
+  const auto oldFields = pointDataMsg.fields;
+  size_t offset = oldStep;
+  for (const auto& fieldName : fieldNames)
+  {
+    if (!this->addPointFieldByString(fieldName, offset))
+    {
+      pointDataMsg.fields = oldFields;
+      throw std::runtime_error("Field " + fieldName + " does not exist");
+    }
+  }
+
+  // Move the points to the new layout
+  MLS_INSTRUMENT_SCOPE(POINT_DATA_MODIFY, numPoints * (oldStep + offset));
+  std::vector<uint8_t> data(numPoints * offset, 0);
+  for (size_t i = 0; i < numPoints; ++i)
+    std::memcpy(&data[i * offset], &pointDataMsg.data[i * oldStep], oldStep);
+  pointDataMsg.data.swap(data);
+  pointDataMsg.point_step = offset;
+}
+
+const PointField& PointDataModifier::findOrAppendFieldByString(const std::string& fieldName, const size_t size)
+{
+  // checked before anything is appended, so that a failure leaves the data as they were
+  if (!pointDataMsg.data.empty() && pointDataMsg.data.size() != size * pointDataMsg.point_step)
+    throw std::runtime_error("Custom data have " + std::to_string(pointDataMsg.data.size()) +
+        " bytes, but " + std::to_string(size * pointDataMsg.point_step) + " are required");
+
+  for (const auto& field : pointDataMsg.fields)
+    if (field.name == fieldName)
+      return field;
+
+  if (pointDataMsg.fields.empty())
+  {
+    this->setFieldsByString(1, fieldName.c_str());
+    pointDataMsg.is_bigendian = impl::isHostBigEndian();
+  }
+  else
+  {
+    this->appendFieldsByString(1, fieldName.c_str());
+  }
+
+  if (pointDataMsg.data.empty())
+    this->resize(size);
+
+  return pointDataMsg.fields.back();
+}
+
 bool PointDataModifier::addPointFieldByString(const std::string &fieldName, size_t& offset)
 {
   if (fieldName == "rgb" || fieldName == "rgba" || fieldName == "strongest" ||
@@ -219,6 +400,11 @@ bool PointDataModifier::addPointFieldByString(const std::string &fieldName, size
     offset = addPointField(pointDataMsg, fieldName, 3, sensor_msgs::PointField::FLOAT32, offset);
     return true;
   }
+  else if (fieldName == "label")
+  {
+    offset = addPointField(pointDataMsg, fieldName, 1, sensor_msgs::PointField::UINT8, offset);
+    return true;
+  }
   return false;
 }
 
@@ -0,0 +1,155 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/CartesianProjection.h>
+
+#include <random>
+
+using namespace sensor_msgs;
+
+MultiLayerLaserScan createOusterScan()
+{
+  MultiLayerLaserScan msg;
+
+  msg.header.stamp = ros::Time(10.0);
+
+  msg.subscan_layout.time_offsets.regular = true;
+  msg.subscan_layout.time_offsets.increment = ros::Duration(1e-6);
+  msg.subscan_layout.angular_offsets.regular = true;
+  msg.subscan_layout.angular_offsets.min = -16.611 * 2 * M_PI / 360;
+  msg.subscan_layout.angular_offsets.max =  16.611 * 2 * M_PI / 360;
+  msg.subscan_layout.angular_offsets.samples = -64;
+
+  msg.scan_layout.time_offsets.regular = true;
+  msg.scan_layout.time_offsets.increment = ros::Duration(0.1 / 512);
+  msg.scan_layout.angular_offsets.regular = true;
+  msg.scan_layout.angular_offsets.min = 0;
+  msg.scan_layout.angular_offsets.max = 2 * M_PI;
+  msg.scan_layout.angular_offsets.exclude_last = true;
+  msg.scan_layout.angular_offsets.samples = 512;
+
+  msg.scan_offsets_during_subscan.regular = false;
+  for (size_t i = 0; i < 16; ++i)
+  {
+    for (const auto offset : {3.164, 1.055, -1.055, -3.164})
+      msg.scan_offsets_during_subscan.offsets.push_back(offset * 2 * M_PI / 360);
+  }
+
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<float> distribution(0.3, 100.0);
+  msg.ranges.resize(512 * 64);
+  for (auto& range : msg.ranges)
+    range = distribution(generator);
+
+  return msg;
+}
+
+void expectProjection(const MultiLayerLaserScan& msg, const MultiLayerLaserScanLayout& layout,
+    const std::vector<float>& x, const std::vector<float>& y, const std::vector<float>& z,
+    const std::vector<float>& t, const size_t first, const size_t last)
+{
+  for (size_t i = first; i < last; ++i)
+  {
+    double scanAngle, subscanAngle;
+    ros::Duration time;
+    layout.GetAll(i, scanAngle, subscanAngle, time);
+
+    const auto r = msg.ranges[i];
+    const auto tolerance = 1e-5 * r;
+    EXPECT_NEAR(r * std::cos(subscanAngle) * std::cos(scanAngle), x[i], tolerance);
+    EXPECT_NEAR(r * std::cos(subscanAngle) * std::sin(scanAngle), y[i], tolerance);
+    EXPECT_NEAR(r * std::sin(subscanAngle), z[i], tolerance);
+    if (!t.empty())
+    {
+      EXPECT_NEAR(time.toSec(), t[i], 1e-7);
+    }
+  }
+}
+
+TEST(CartesianProjection, Ouster)
+{
+  const auto msg = createOusterScan();
+  const MultiLayerLaserScanLayout layout(msg);
+  const CartesianProjection projection(layout);
+
+  ASSERT_EQ(msg.ranges.size(), projection.Length());
+  EXPECT_EQ(512, projection.GetScanLength());
+  EXPECT_EQ(64, projection.GetSubscanLength());
+
+  std::vector<float> x(projection.Length()), y(projection.Length()), z(projection.Length());
+  std::vector<float> t(projection.Length());
+
+  projection.Project(msg, x.data(), y.data(), z.data(), t.data());
+  expectProjection(msg, layout, x, y, z, t, 0, msg.ranges.size());
+
+  // without time
+  std::vector<float> x2(projection.Length()), y2(projection.Length()), z2(projection.Length());
+  ProjectToCartesian(msg, layout, x2.data(), y2.data(), z2.data());
+  EXPECT_EQ(x, x2);
+  EXPECT_EQ(y, y2);
+  EXPECT_EQ(z, z2);
+}
+
+TEST(CartesianProjection, Simple)
+{
+  MultiLayerLaserScan msg;
+
+  msg.subscan_layout.time_offsets.regular = false;
+  msg.subscan_layout.time_offsets.offsets = {ros::Duration(0.0), ros::Duration(0.1), ros::Duration(0.2)};
+  msg.subscan_layout.angular_offsets.regular = false;
+  msg.subscan_layout.angular_offsets.offsets = {0.0, M_PI_2, -M_PI_4};
+
+  msg.scan_layout.time_offsets.regular = false;
+  msg.scan_layout.time_offsets.offsets = {ros::Duration(0.0), ros::Duration(1.0)};
+  msg.scan_layout.angular_offsets.regular = false;
+  msg.scan_layout.angular_offsets.offsets = {0.0, M_PI_2};
+
+  msg.scan_offsets_during_subscan.regular = false;
+  msg.scan_offsets_during_subscan.offsets = { 0.0, 0.0, M_PI_2 };
+
+  msg.ranges = {1, 2, 3, 4, 5, 6};
+
+  const MultiLayerLaserScanLayout layout(msg);
+  std::vector<float> x(6), y(6), z(6), t(6);
+  ProjectToCartesian(msg, layout, x.data(), y.data(), z.data(), t.data());
+
+  EXPECT_NEAR(1, x[0], 1e-6); EXPECT_NEAR(0, y[0], 1e-6); EXPECT_NEAR(0, z[0], 1e-6);
+  EXPECT_NEAR(0, x[1], 1e-6); EXPECT_NEAR(0, y[1], 1e-6); EXPECT_NEAR(2, z[1], 1e-6);
+  EXPECT_NEAR(0, x[2], 1e-6); EXPECT_NEAR(3 * M_SQRT1_2, y[2], 1e-6); EXPECT_NEAR(-3 * M_SQRT1_2, z[2], 1e-6);
+  EXPECT_NEAR(0, x[3], 1e-6); EXPECT_NEAR(4, y[3], 1e-6); EXPECT_NEAR(0, z[3], 1e-6);
+  EXPECT_NEAR(0, x[4], 1e-6); EXPECT_NEAR(0, y[4], 1e-6); EXPECT_NEAR(5, z[4], 1e-6);
+  EXPECT_NEAR(-6 * M_SQRT1_2, x[5], 1e-6); EXPECT_NEAR(0, y[5], 1e-6); EXPECT_NEAR(-6 * M_SQRT1_2, z[5], 1e-6);
+
+  EXPECT_FLOAT_EQ(0.0, t[0]);
+  EXPECT_FLOAT_EQ(0.1, t[1]);
+  EXPECT_FLOAT_EQ(0.2, t[2]);
+  EXPECT_FLOAT_EQ(1.0, t[3]);
+  EXPECT_FLOAT_EQ(1.1, t[4]);
+  EXPECT_FLOAT_EQ(1.2, t[5]);
+}
+
+TEST(CartesianProjection, ScanRange)
+{
+  const auto msg = createOusterScan();
+  const MultiLayerLaserScanLayout layout(msg);
+  const CartesianProjection projection(layout);
+
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<float> x(projection.Length(), nan), y(projection.Length(), nan);
+  std::vector<float> z(projection.Length(), nan);
+
+  projection.ProjectScans(msg, 10, 20, x.data(), y.data(), z.data());
+  expectProjection(msg, layout, x, y, z, {}, 10 * 64, 20 * 64);
+  EXPECT_TRUE(std::isnan(x[10 * 64 - 1]));
+  EXPECT_TRUE(std::isnan(x[20 * 64]));
+
+  EXPECT_THROW(projection.ProjectScans(msg, 10, 513, x.data(), y.data(), z.data()), std::out_of_range);
+
+  auto wrongMsg = msg;
+  wrongMsg.ranges.resize(10);
+  EXPECT_THROW(projection.Project(wrongMsg, x.data(), y.data(), z.data()), std::runtime_error);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,168 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/Deskew.h>
+
+#include <cmath>
+
+#include "test_scans.h"
+
+using namespace sensor_msgs;
+
+MultiLayerLaserScan createScan()
+{
+  auto msg = CreateRegularLayoutScan(360, 8, -M_PI, M_PI, -0.3, 0.3, ros::Duration(0.1 / 360));
+
+  msg.ranges.resize(360 * 8);
+  for (size_t i = 0; i < msg.ranges.size(); ++i)
+    msg.ranges[i] = 5.0f + 0.001f * i;
+
+  return msg;
+}
+
+class Deskew : public ::testing::Test
+{
+  protected: void SetUp() override
+  {
+    this->scan = createScan();
+    this->layout.reset(new MultiLayerLaserScanLayout(this->scan));
+    const auto n = this->layout->Length();
+    this->x.resize(n); this->y.resize(n); this->z.resize(n);
+    this->dx.resize(n); this->dy.resize(n); this->dz.resize(n);
+    CartesianProjection(*this->layout).Project(this->scan, this->x.data(), this->y.data(), this->z.data());
+  }
+
+  protected: ros::Time PointTime(const size_t i) const
+  {
+    return this->scan.header.stamp + this->layout->GetTime(i);
+  }
+
+  protected: MultiLayerLaserScan scan;
+  protected: std::unique_ptr<MultiLayerLaserScanLayout> layout;
+  protected: std::vector<float> x, y, z, dx, dy, dz;
+};
+
+TEST_F(Deskew, NoMotion)
+{
+  const ConstantTwistPoseSource poses(Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero());
+  Deskewer(*this->layout).Deskew(this->scan, poses, this->dx.data(), this->dy.data(), this->dz.data());
+
+  for (size_t i = 0; i < this->layout->Length(); ++i)
+  {
+    EXPECT_FLOAT_EQ(this->x[i], this->dx[i]);
+    EXPECT_FLOAT_EQ(this->y[i], this->dy[i]);
+    EXPECT_FLOAT_EQ(this->z[i], this->dz[i]);
+  }
+}
+
+TEST_F(Deskew, ConstantTranslation)
+{
+  const Eigen::Vector3d velocity(2.0, -1.0, 0.5);
+  const ConstantTwistPoseSource poses(velocity, Eigen::Vector3d::Zero(), ros::Time(50.0));
+
+  // express the points at the end of the scan
+  const auto referenceTime = this->scan.header.stamp + ros::Duration(0.1);
+  Deskewer(*this->layout).Deskew(this->scan, poses, referenceTime,
+    this->dx.data(), this->dy.data(), this->dz.data());
+
+  for (size_t i = 0; i < this->layout->Length(); ++i)
+  {
+    const auto dt = (this->PointTime(i) - referenceTime).toSec();
+    EXPECT_NEAR(this->x[i] + velocity.x() * dt, this->dx[i], 1e-4);
+    EXPECT_NEAR(this->y[i] + velocity.y() * dt, this->dy[i], 1e-4);
+    EXPECT_NEAR(this->z[i] + velocity.z() * dt, this->dz[i], 1e-4);
+  }
+}
+
+TEST_F(Deskew, ConstantRotation)
+{
+  const double yawRate = 1.0;
+  const ConstantTwistPoseSource poses(Eigen::Vector3d::Zero(), Eigen::Vector3d(0, 0, yawRate));
+  Deskewer(*this->layout).Deskew(this->scan, poses, this->dx.data(), this->dy.data(), this->dz.data());
+
+  for (size_t i = 0; i < this->layout->Length(); ++i)
+  {
+    const auto angle = yawRate * (this->PointTime(i) - this->scan.header.stamp).toSec();
+    EXPECT_NEAR(std::cos(angle) * this->x[i] - std::sin(angle) * this->y[i], this->dx[i], 1e-4);
+    EXPECT_NEAR(std::sin(angle) * this->x[i] + std::cos(angle) * this->y[i], this->dy[i], 1e-4);
+    EXPECT_NEAR(this->z[i], this->dz[i], 1e-4);
+  }
+}
+
+TEST_F(Deskew, BufferedPosesMatchTwist)
+{
+  const ConstantTwistPoseSource twist(Eigen::Vector3d(1.0, 0.5, 0.0), Eigen::Vector3d(0.0, 0.0, 0.8),
+    ros::Time(99.0));
+
+  // poses at 100 Hz covering the scan
+  BufferedPoseSource buffer;
+  for (int i = -2; i < 14; ++i)
+  {
+    const auto stamp = this->scan.header.stamp + ros::Duration(0.01 * i);
+    buffer.AddPose(stamp, twist.GetPose(stamp));
+  }
+  EXPECT_EQ(16, buffer.Size());
+
+  std::vector<float> tx(this->layout->Length()), ty(this->layout->Length()), tz(this->layout->Length());
+  const Deskewer deskewer(*this->layout);
+  deskewer.Deskew(this->scan, twist, tx.data(), ty.data(), tz.data());
+  deskewer.Deskew(this->scan, buffer, this->dx.data(), this->dy.data(), this->dz.data());
+
+  for (size_t i = 0; i < this->layout->Length(); ++i)
+  {
+    EXPECT_NEAR(tx[i], this->dx[i], 1e-3);
+    EXPECT_NEAR(ty[i], this->dy[i], 1e-3);
+    EXPECT_NEAR(tz[i], this->dz[i], 1e-3);
+  }
+}
+
+TEST(BufferedPoseSource, Interpolation)
+{
+  BufferedPoseSource buffer(ros::Duration(1.0));
+  EXPECT_THROW(buffer.GetPose(ros::Time(1.0)), std::out_of_range);
+
+  Eigen::Isometry3d pose1 = Eigen::Isometry3d::Identity();
+  Eigen::Isometry3d pose2 = Eigen::Isometry3d::Identity();
+  pose2.translation() = Eigen::Vector3d(1, 2, 3);
+  pose2.linear() = Eigen::AngleAxisd(1.0, Eigen::Vector3d::UnitZ()).toRotationMatrix();
+
+  // out of order
+  buffer.AddPose(ros::Time(2.0), pose2);
+  buffer.AddPose(ros::Time(1.0), pose1);
+
+  const auto middle = buffer.GetPose(ros::Time(1.25));
+  EXPECT_TRUE(middle.translation().isApprox(Eigen::Vector3d(0.25, 0.5, 0.75)));
+  EXPECT_NEAR(0.25, Eigen::AngleAxisd(middle.rotation()).angle(), 1e-9);
+  EXPECT_TRUE(buffer.GetPose(ros::Time(2.0)).isApprox(pose2));
+  EXPECT_TRUE(buffer.GetPose(ros::Time(1.0)).isApprox(pose1));
+
+  EXPECT_THROW(buffer.GetPose(ros::Time(0.9)), std::out_of_range);
+  EXPECT_THROW(buffer.GetPose(ros::Time(2.1)), std::out_of_range);
+
+  // the first pose is too old
+  buffer.AddPose(ros::Time(2.5), pose2);
+  EXPECT_EQ(2, buffer.Size());
+  EXPECT_THROW(buffer.GetPose(ros::Time(1.5)), std::out_of_range);
+
+  buffer.Clear();
+  EXPECT_EQ(0, buffer.Size());
+}
+
+TEST(ConstantTwistPoseSource, Composition)
+{
+  const ConstantTwistPoseSource twist(Eigen::Vector3d(1.0, -2.0, 0.3), Eigen::Vector3d(0.2, -0.1, 1.5),
+    ros::Time(10.0));
+
+  EXPECT_TRUE(twist.GetPose(ros::Time(10.0)).isApprox(Eigen::Isometry3d::Identity()));
+
+  // constant twist: pose(a + b) = pose(a) * pose(b)
+  const auto a = twist.GetPose(ros::Time(10.3));
+  const auto b = twist.GetPose(ros::Time(10.5));
+  const auto ab = twist.GetPose(ros::Time(10.8));
+  EXPECT_TRUE((a * b).isApprox(ab, 1e-9));
+  EXPECT_TRUE(twist.GetPose(ros::Time(9.7)).isApprox(a.inverse(), 1e-9));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
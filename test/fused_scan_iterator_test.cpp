@@ -0,0 +1,156 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/FusedScanIterator.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+
+#include <algorithm>
+
+using namespace sensor_msgs;
+
+namespace
+{
+
+MultiLayerLaserScan createScan()
+{
+  MultiLayerLaserScan msg;
+  msg.header.stamp = ros::Time(10.0);
+
+  msg.subscan_layout.time_offsets.regular = false;
+  msg.subscan_layout.time_offsets.offsets = {ros::Duration(0.0), ros::Duration(0.1)};
+  msg.subscan_layout.angular_offsets.regular = false;
+  msg.subscan_layout.angular_offsets.offsets = {0.0, 0.1};
+
+  msg.scan_layout.time_offsets.regular = false;
+  msg.scan_layout.time_offsets.offsets = {ros::Duration(0.0), ros::Duration(1.0), ros::Duration(2.0)};
+  msg.scan_layout.angular_offsets.regular = false;
+  msg.scan_layout.angular_offsets.offsets = {0.0, 1.0, 2.0};
+
+  msg.scan_offsets_during_subscan.regular = false;
+  msg.scan_offsets_during_subscan.offsets = {0.0, 0.0};
+
+  msg.ranges = {1, 2, 3, 4, 5, 6};
+  msg.intensities = {7, 8, 9, 10, 11, 12};
+
+  PointDataModifier mod(msg.custom_data);
+  mod.setFieldsByString(3, "reflectivity", "ring", "normal");
+  mod.resize(6);
+
+  PointDataIterator<float> fit(msg.custom_data, "reflectivity");
+  PointDataIterator<uint16_t> rit(msg.custom_data, "ring");
+  PointDataIterator<float> nit(msg.custom_data, "normal");
+  for (size_t i = 0; i < 6; ++i, ++fit, ++rit, ++nit)
+  {
+    *fit = i * 10.0f;
+    *rit = i % 2;
+    nit[0] = i;
+    nit[1] = 2.0f * i;
+    nit[2] = 3.0f * i;
+  }
+
+  return msg;
+}
+
+}
+
+TEST(FusedScanIterator, SameAsLockstepIterators)  // NOLINT
+{
+  const auto msg = createScan();
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+
+  MultiLayerLaserScanFusedConstIterator<float, uint16_t, float> it(msg, layout, {"reflectivity", "ring", "normal"});
+  MultiLayerLaserScanBaseFieldsConstIterator bit(msg, layout);
+  PointDataConstIterator<float> fit(msg.custom_data, "reflectivity");
+  PointDataConstIterator<uint16_t> rit(msg.custom_data, "ring");
+  PointDataConstIterator<float> nit(msg.custom_data, "normal");
+
+  size_t n = 0;
+  for (; it != it.end(); ++it, ++bit, ++fit, ++rit, ++nit, ++n)
+  {
+    const auto point = *it;
+    const auto base = *bit;
+    EXPECT_EQ(base.scanAngle, point.scanAngle);
+    EXPECT_EQ(base.subscanAngle, point.subscanAngle);
+    EXPECT_EQ(base.timestamp, point.timestamp);
+    EXPECT_EQ(base.range, point.range);
+    EXPECT_EQ(base.intensity, point.intensity);
+    EXPECT_EQ(*fit, point.Get<0>());
+    EXPECT_EQ(*rit, point.Get<1>());
+    EXPECT_EQ(nit[0], (&point.Get<2>())[0]);
+    EXPECT_EQ(nit[2], (&point.Get<2>())[2]);
+    EXPECT_EQ(&point.Get<1>(), it.GetCustom<1>());
+  }
+  EXPECT_EQ(6, n);
+}
+
+TEST(FusedScanIterator, Modify)  // NOLINT
+{
+  auto msg = createScan();
+  msg.intensities.clear();
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+
+  MultiLayerLaserScanFusedIterator<uint16_t> it(msg, layout, {"ring"});
+  for (; it != it.end(); ++it)
+  {
+    const auto point = *it;
+    EXPECT_EQ(nullptr, point.intensity);
+    *point.range *= 2;
+    point.Get<0>() += 100;
+  }
+
+  PointDataConstIterator<uint16_t> rit(msg.custom_data, "ring");
+  for (size_t i = 0; i < 6; ++i, ++rit)
+  {
+    EXPECT_EQ(2.0f * (i + 1), msg.ranges[i]);
+    EXPECT_EQ(100 + i % 2, *rit);
+  }
+}
+
+TEST(FusedScanIterator, RandomAccess)  // NOLINT
+{
+  const auto msg = createScan();
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+
+  MultiLayerLaserScanFusedConstIterator<float> it(msg, layout, {"reflectivity"});
+  EXPECT_EQ(6, std::distance(it.begin(), it.end()));
+  EXPECT_EQ(6, it.end() - it.begin());
+  EXPECT_EQ(30.0f, it[3].Get<0>());
+  EXPECT_EQ(50.0f, (2 + it + 3)[0].Get<0>());
+
+  auto last = it.end();
+  --last;
+  EXPECT_EQ(5, last.Index());
+  EXPECT_EQ(2.0, (*last).scanAngle);
+  EXPECT_TRUE(it < last);
+
+  const auto found = std::find_if(it.begin(), it.end(),
+      [](const MultiLayerLaserScanFusedFields<const float, const float>& point) {
+        return point.Get<0>() > 25.0f; });
+  EXPECT_EQ(3, found.Index());
+
+  // only base fields
+  MultiLayerLaserScanFusedConstIterator<> base(msg, layout, {});
+  EXPECT_EQ(4.0f, *base[3].range);
+}
+
+TEST(FusedScanIterator, InvalidFields)  // NOLINT
+{
+  auto msg = createScan();
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+
+  EXPECT_THROW((MultiLayerLaserScanFusedIterator<float>(msg, layout, {"nonexistent"})), std::runtime_error);
+  EXPECT_THROW((MultiLayerLaserScanFusedIterator<double>(msg, layout, {"reflectivity"})), std::runtime_error);
+  EXPECT_THROW((MultiLayerLaserScanFusedIterator<float>(msg, layout, {"ring"})), std::runtime_error);
+  // the same size, but a different type
+  EXPECT_THROW((MultiLayerLaserScanFusedIterator<uint32_t>(msg, layout, {"reflectivity"})), std::runtime_error);
+  EXPECT_THROW((MultiLayerLaserScanFusedIterator<int32_t>(msg, layout, {"reflectivity"})), std::runtime_error);
+  EXPECT_THROW((MultiLayerLaserScanFusedConstIterator<int16_t>(msg, layout, {"ring"})), std::runtime_error);
+  EXPECT_NO_THROW((MultiLayerLaserScanFusedConstIterator<uint16_t, float>(msg, layout, {"ring", "reflectivity"})));
+
+  msg.custom_data.data.resize(msg.custom_data.data.size() - 1);
+  EXPECT_THROW((MultiLayerLaserScanFusedIterator<float>(msg, layout, {"reflectivity"})), std::runtime_error);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
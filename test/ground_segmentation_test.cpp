@@ -0,0 +1,184 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/GroundSegmentation.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "test_scans.h"
+
+using namespace sensor_msgs;
+
+namespace
+{
+
+MultiLayerLaserScan createScan(const size_t numScans, const std::vector<double>& elevations)
+{
+  const auto subscanLength = elevations.size();
+  auto msg = CreateRegularLayoutScan(numScans, subscanLength, 0, 2 * M_PI, 0, 0, ros::Duration(0.001));
+  msg.subscan_layout.angular_offsets.regular = false;
+  msg.subscan_layout.angular_offsets.offsets = elevations;
+
+  msg.range_min = 0.5f;
+  msg.range_max = 100.0f;
+  msg.ranges.resize(numScans * subscanLength, std::numeric_limits<float>::infinity());
+  return msg;
+}
+
+/**
+ * @brief Rays of column scanIndex hit a floor 1.5 m below the sensor, and a
+ *        1 m high wall at distance wallDistance if it is positive.
+ */
+void setColumn(MultiLayerLaserScan& msg, const std::vector<double>& elevations, const size_t scanIndex,
+    const float wallDistance)
+{
+  for (size_t ring = 0; ring < elevations.size(); ++ring)
+  {
+    const auto e = elevations[ring];
+    auto& range = msg.ranges[scanIndex * elevations.size() + ring];
+    range = std::numeric_limits<float>::infinity();
+    if (e < 0)
+      range = static_cast<float>(-1.5 / std::sin(e));
+    if (wallDistance > 0 && range * std::cos(e) > wallDistance)
+    {
+      const auto wallRange = wallDistance / std::cos(e);
+      if (wallRange * std::sin(e) < -0.5)
+        range = static_cast<float>(wallRange);
+    }
+  }
+}
+
+}
+
+TEST(GroundSegmentation, FloorAndWall)  // NOLINT
+{
+  // rays are not sorted by elevation
+  const std::vector<double> elevations = {-0.3, 0.1, -0.25, -0.2, -0.15, -0.1, -0.05, 0.0, -0.35, -0.4};
+  auto msg = createScan(8, elevations);
+  for (size_t s = 0; s < 8; ++s)
+    setColumn(msg, elevations, s, s < 4 ? 0.0f : 6.0f);
+  msg.ranges[9] = 0.1f;  // too close
+  msg.ranges[10 + 2] = std::numeric_limits<float>::quiet_NaN();
+
+  const MultiLayerLaserScanLayout layout(msg);
+  const GroundSegmentation segmentation(layout, 1.5f);
+  std::vector<uint8_t> labels(layout.Length());
+  segmentation.Segment(msg, labels.data());
+
+  for (size_t s = 0; s < 8; ++s)
+  {
+    for (size_t ring = 0; ring < elevations.size(); ++ring)
+    {
+      const auto i = s * elevations.size() + ring;
+      const auto range = msg.ranges[i];
+      const auto e = elevations[ring];
+      uint8_t expected;
+      if (!(range >= msg.range_min && range <= msg.range_max))
+        expected = GroundSegmentation::INVALID;
+      else if (std::abs(range * std::sin(e) + 1.5) < 1e-3)
+        expected = GroundSegmentation::GROUND;
+      else
+        expected = GroundSegmentation::NON_GROUND;
+      EXPECT_EQ(expected, labels[i]) << "column " << s << ", ring " << ring;
+    }
+  }
+
+  // the columns with the wall have some wall points
+  size_t numWall = 0;
+  for (size_t i = 4 * elevations.size(); i < layout.Length(); ++i)
+    numWall += labels[i] == GroundSegmentation::NON_GROUND;
+  EXPECT_GT(numWall, 4u);
+}
+
+TEST(GroundSegmentation, Slope)  // NOLINT
+{
+  const std::vector<double> elevations = {-0.4, -0.35, -0.3, -0.25, -0.2, -0.15, -0.1};
+  auto msg = createScan(4, elevations);
+
+  // ground rising with slope 0.1 rad starting 3 m from the sensor
+  for (size_t ring = 0; ring < elevations.size(); ++ring)
+  {
+    const auto e = elevations[ring];
+    double range = -1.5 / std::sin(e);
+    if (range * std::cos(e) > 3)
+    {
+      const auto k = std::tan(0.1);
+      const auto d = (1.5 + 3 * k) / (k - std::tan(e));
+      range = d / std::cos(e);
+    }
+    for (size_t s = 0; s < 4; ++s)
+      msg.ranges[s * elevations.size() + ring] = static_cast<float>(range);
+  }
+
+  const MultiLayerLaserScanLayout layout(msg);
+  std::vector<uint8_t> labels(layout.Length());
+
+  GroundSegmentation(layout, 1.5f, 0.15f).Segment(msg, labels.data());
+  for (const auto label : labels)
+    EXPECT_EQ(GroundSegmentation::GROUND, label);
+
+  GroundSegmentation(layout, 1.5f, 0.02f, 0.01f).Segment(msg, labels.data());
+  EXPECT_EQ(GroundSegmentation::GROUND, labels[0]);
+  EXPECT_EQ(GroundSegmentation::NON_GROUND, labels[elevations.size() - 1]);
+
+  EXPECT_THROW(GroundSegmentation(layout, 1.5f, 2.0f), std::runtime_error);
+  EXPECT_THROW(GroundSegmentation(layout, 1.5f).SegmentScans(msg, 2, 5, labels.data()), std::out_of_range);
+  msg.ranges.pop_back();
+  EXPECT_THROW(GroundSegmentation(layout, 1.5f).Segment(msg, labels.data()), std::runtime_error);
+}
+
+TEST(GroundSegmentation, CustomField)  // NOLINT
+{
+  const std::vector<double> elevations = {-0.4, -0.3, -0.2, -0.1, 0.0, 0.1};
+  auto msg = createScan(16, elevations);
+  for (size_t s = 0; s < 16; ++s)
+    setColumn(msg, elevations, s, s % 2 == 0 ? 5.0f : 0.0f);
+
+  const MultiLayerLaserScanLayout layout(msg);
+  const GroundSegmentation segmentation(layout, 1.5f);
+  std::vector<uint8_t> labels(layout.Length());
+  segmentation.Segment(msg, labels.data());
+
+  // a scan without custom data gets them
+  auto copy = msg;
+  segmentation.Segment(copy);
+  ASSERT_EQ(1, copy.custom_data.fields.size());
+  EXPECT_EQ(1, copy.custom_data.point_step);
+  EXPECT_EQ(labels, copy.custom_data.data);
+
+  // the field is appended after existing fields
+  PointDataModifier modifier(msg.custom_data);
+  modifier.setFieldsByString(1, "ring");
+  modifier.resize(layout.Length());
+  for (size_t i = 0; i < layout.Length(); ++i)
+  {
+    const auto ring = static_cast<uint16_t>(i % elevations.size());
+    std::memcpy(&msg.custom_data.data[i * msg.custom_data.point_step], &ring, sizeof(ring));
+  }
+
+  segmentation.Segment(msg);
+  segmentation.Segment(msg);
+  ASSERT_EQ(2, msg.custom_data.fields.size());
+  EXPECT_EQ("label", msg.custom_data.fields[1].name);
+  EXPECT_EQ(PointField::UINT8, msg.custom_data.fields[1].datatype);
+  ASSERT_EQ(3, msg.custom_data.point_step);
+
+  PointDataConstIterator<uint16_t> ring(msg.custom_data, "ring");
+  PointDataConstIterator<uint8_t> label(msg.custom_data, "label");
+  for (size_t i = 0; i < layout.Length(); ++i, ++ring, ++label)
+  {
+    EXPECT_EQ(i % elevations.size(), *ring);
+    EXPECT_EQ(labels[i], *label);
+  }
+
+  msg.custom_data.fields[1].datatype = PointField::UINT16;
+  EXPECT_THROW(segmentation.Segment(msg), std::runtime_error);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,189 @@
+// use the macros in this test even if the library was compiled without them
+#ifndef MULTILAYER_LASER_SCAN_INSTRUMENTATION
+#define MULTILAYER_LASER_SCAN_INSTRUMENTATION
+#endif
+
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/Instrumentation.h>
+#include <multilayer_laser_scan/MultiLayerLaserScanToPointCloud2.h>
+#include <multilayer_laser_scan/SyntheticScanGenerator.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace sensor_msgs;
+using namespace sensor_msgs::instrumentation;
+
+TEST(Instrumentation, LatencyBuckets)  // NOLINT
+{
+  EXPECT_EQ(0u, GetLatencyBucket(0));
+  EXPECT_EQ(0u, GetLatencyBucket(1));
+  EXPECT_EQ(1u, GetLatencyBucket(2));
+  EXPECT_EQ(1u, GetLatencyBucket(3));
+  EXPECT_EQ(10u, GetLatencyBucket(1024));
+  EXPECT_EQ(10u, GetLatencyBucket(2047));
+  EXPECT_EQ(NUM_LATENCY_BUCKETS - 1, GetLatencyBucket(uint64_t(1) << 40));
+}
+
+TEST(Instrumentation, RecordAndReset)  // NOLINT
+{
+  Reset();
+  Record(CARTESIAN_PROJECTION, 100, 1000);
+  Record(CARTESIAN_PROJECTION, 100, 3000);
+  Record(CARTESIAN_PROJECTION, 50);
+
+  auto statistics = Collect();
+  ASSERT_EQ(NUM_STAGES, statistics.size());
+  const auto& stage = statistics[CARTESIAN_PROJECTION];
+  EXPECT_EQ(CARTESIAN_PROJECTION, stage.stage);
+  EXPECT_EQ(3u, stage.calls);
+  EXPECT_EQ(2u, stage.timedCalls);
+  EXPECT_EQ(250u, stage.bytes);
+  EXPECT_EQ(4000u, stage.totalNSec);
+  EXPECT_DOUBLE_EQ(2000.0, stage.MeanNSec());
+  EXPECT_EQ(1u, stage.latencyHistogram[9]);
+  EXPECT_EQ(1u, stage.latencyHistogram[11]);
+  EXPECT_EQ(1024u, stage.PercentileNSec(50));
+  EXPECT_EQ(4096u, stage.PercentileNSec(99));
+  EXPECT_EQ(0u, statistics[LAYOUT_PARSE].calls);
+
+  Reset();
+  statistics = Collect();
+  EXPECT_EQ(0u, statistics[CARTESIAN_PROJECTION].calls);
+  EXPECT_EQ(0u, statistics[CARTESIAN_PROJECTION].bytes);
+  EXPECT_EQ(0u, statistics[CARTESIAN_PROJECTION].PercentileNSec(50));
+  EXPECT_DOUBLE_EQ(0.0, statistics[CARTESIAN_PROJECTION].MeanNSec());
+
+  Record(CARTESIAN_PROJECTION, 10, 10);
+  EXPECT_EQ(1u, Collect()[CARTESIAN_PROJECTION].calls);
+}
+
+TEST(Instrumentation, AggregatesThreads)  // NOLINT
+{
+  Reset();
+
+  // some threads are still running while collecting, some already finished
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < 4; ++t)
+    threads.emplace_back([]()
+    {
+      for (size_t i = 0; i < 1000; ++i)
+        Record(SCAN_TO_POINT_CLOUD2, 2, 100);
+    });
+  Record(SCAN_TO_POINT_CLOUD2, 2, 100);
+  for (auto& thread : threads)
+    thread.join();
+
+  const auto stage = Collect()[SCAN_TO_POINT_CLOUD2];
+  EXPECT_EQ(4001u, stage.calls);
+  EXPECT_EQ(4001u, stage.timedCalls);
+  EXPECT_EQ(8002u, stage.bytes);
+  EXPECT_EQ(4001u, stage.latencyHistogram[GetLatencyBucket(100)]);
+}
+
+TEST(Instrumentation, Macros)  // NOLINT
+{
+  Reset();
+  {
+    MLS_INSTRUMENT_SCOPE(LAYOUT_MATERIALIZE, 10);
+    MLS_INSTRUMENT_ADD_BYTES(5);
+    EXPECT_EQ(0u, Collect()[LAYOUT_MATERIALIZE].calls);
+  }
+  MLS_INSTRUMENT_COUNT(ITERATOR_CREATE, 7);
+
+  const auto statistics = Collect();
+  EXPECT_EQ(1u, statistics[LAYOUT_MATERIALIZE].calls);
+  EXPECT_EQ(1u, statistics[LAYOUT_MATERIALIZE].timedCalls);
+  EXPECT_EQ(15u, statistics[LAYOUT_MATERIALIZE].bytes);
+  EXPECT_EQ(1u, statistics[ITERATOR_CREATE].calls);
+  EXPECT_EQ(0u, statistics[ITERATOR_CREATE].timedCalls);
+  EXPECT_EQ(7u, statistics[ITERATOR_CREATE].bytes);
+}
+
+TEST(Instrumentation, LibraryStages)  // NOLINT
+{
+  auto msg = SyntheticScanGenerator::CreatePresetScan(SyntheticScanGenerator::SICK_LMS151);
+
+  Reset();
+  auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+  layout->Materialize();
+  MultiLayerLaserScanBaseFieldsConstIterator it(msg, layout);
+  PointDataModifier(msg.custom_data).setFieldsByString(1, "ring");
+  PointCloud2 cloud;
+  MultiLayerLaserScanToPointCloud2().Convert(msg, layout, cloud);
+
+  const auto statistics = Collect();
+  if (IsEnabled())
+  {
+    EXPECT_EQ(2u, statistics[LAYOUT_PARSE].calls);
+    EXPECT_EQ(1u, statistics[LAYOUT_MATERIALIZE].calls);
+    EXPECT_EQ(541u * (2 * sizeof(double) + sizeof(ros::Duration)), statistics[LAYOUT_MATERIALIZE].bytes);
+    EXPECT_LE(1u, statistics[ITERATOR_CREATE].calls);
+    EXPECT_LE(1u, statistics[POINT_DATA_MODIFY].calls);
+    EXPECT_EQ(1u, statistics[SCAN_TO_POINT_CLOUD2].calls);
+    EXPECT_EQ(1u, statistics[SCAN_TO_POINT_CLOUD2].timedCalls);
+  }
+  else
+  {
+    for (const auto& stage : statistics)
+      EXPECT_EQ(0u, stage.calls) << GetStageName(stage.stage);
+  }
+}
+
+TEST(Instrumentation, IteratorLoopCountsOnce)  // NOLINT
+{
+  auto msg = SyntheticScanGenerator::CreatePresetScan(SyntheticScanGenerator::SICK_LMS151);
+  auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+
+  Reset();
+  size_t numPoints = 0;
+  for (MultiLayerLaserScanBaseFieldsConstIterator it(msg, layout); it != it.end(); ++it)
+    ++numPoints;
+  EXPECT_EQ(layout->Length(), numPoints);
+
+  // comparing with end() in every step does not count as creating an iterator
+  EXPECT_EQ(IsEnabled() ? 1u : 0u, Collect()[ITERATOR_CREATE].calls);
+}
+
+TEST(Instrumentation, Export)  // NOLINT
+{
+  Reset();
+  Record(LAYOUT_PARSE, 16, 1500);
+  Record(POINT_CLOUD2_TO_SCAN, 1000, 2000000);
+  const auto statistics = Collect();
+
+  std::stringstream json;
+  WriteJson(json, statistics);
+  EXPECT_NE(std::string::npos, json.str().find("\"layout_parse\": {\"calls\": 1, \"timed_calls\": 1, \"bytes\": 16"));
+  EXPECT_NE(std::string::npos, json.str().find("\"point_cloud2_to_scan\": {\"calls\": 1"));
+  EXPECT_NE(std::string::npos, json.str().find("\"iterator_create\": {\"calls\": 0"));
+
+  std::stringstream text;
+  WriteText(text, statistics);
+  EXPECT_NE(std::string::npos, text.str().find("point_cloud2_to_scan"));
+  EXPECT_NE(std::string::npos, text.str().find("2000.0"));  // mean in us
+
+  diagnostic_msgs::DiagnosticArray diagnostics;
+  FillDiagnostics(statistics, "test", diagnostics);
+  ASSERT_EQ(2u, diagnostics.status.size());
+  EXPECT_EQ("multilayer_laser_scan: layout_parse", diagnostics.status[0].name);
+  EXPECT_EQ("multilayer_laser_scan: point_cloud2_to_scan", diagnostics.status[1].name);
+  EXPECT_EQ("test", diagnostics.status[1].hardware_id);
+  EXPECT_EQ(diagnostic_msgs::DiagnosticStatus::OK, diagnostics.status[1].level);
+  ASSERT_LE(2u, diagnostics.status[1].values.size());
+  EXPECT_EQ("calls", diagnostics.status[1].values[0].key);
+  EXPECT_EQ("1", diagnostics.status[1].values[0].value);
+  EXPECT_EQ("bytes", diagnostics.status[1].values[1].key);
+  EXPECT_EQ("1000", diagnostics.status[1].values[1].value);
+
+  EXPECT_THROW(WriteToFile("/nonexistent/directory/stats.json", statistics), std::runtime_error);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,209 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/LayoutCache.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+
+#include <thread>
+
+using namespace sensor_msgs;
+
+MultiLayerLaserScan createScan()
+{
+  MultiLayerLaserScan msg;
+
+  msg.header.stamp = ros::Time(10.0);
+
+  msg.subscan_layout.time_offsets.regular = false;
+  msg.subscan_layout.time_offsets.offsets = {ros::Duration(0.0), ros::Duration(0.1)};
+  msg.subscan_layout.angular_offsets.regular = false;
+  msg.subscan_layout.angular_offsets.offsets = {0.0, 0.1};
+
+  msg.scan_layout.time_offsets.regular = true;
+  msg.scan_layout.time_offsets.increment = ros::Duration(1.0);
+  msg.scan_layout.angular_offsets.regular = true;
+  msg.scan_layout.angular_offsets.min = -M_PI;
+  msg.scan_layout.angular_offsets.max = M_PI;
+  msg.scan_layout.angular_offsets.samples = 4;
+  msg.scan_layout.angular_offsets.exclude_last = true;
+
+  msg.scan_offsets_during_subscan.regular = false;
+  msg.scan_offsets_during_subscan.offsets = { 0.0, 0.0 };
+
+  msg.ranges = {1, 2, 3, 4, 5, 6, 7, 8};
+
+  return msg;
+}
+
+TEST(LayoutCache, HitsAndMisses)
+{
+  LayoutCache cache;
+
+  auto msg = createScan();
+
+  const auto layout1 = cache.Get(msg);
+  EXPECT_EQ(0, cache.Hits());
+  EXPECT_EQ(1, cache.Misses());
+  EXPECT_EQ(1, cache.Size());
+  ASSERT_EQ(8, layout1->Length());
+
+  // different data, header and intensities do not matter
+  msg.header.stamp = ros::Time(11.0);
+  msg.ranges = {8, 7, 6, 5, 4, 3, 2, 1};
+  msg.intensities = {1, 1, 1, 1, 1, 1, 1, 1};
+
+  const auto layout2 = cache.Get(msg);
+  EXPECT_EQ(layout1, layout2);
+  EXPECT_EQ(1, cache.Hits());
+  EXPECT_EQ(1, cache.Misses());
+  EXPECT_EQ(1, cache.Size());
+
+  // the layout is usable with iterators
+  MultiLayerLaserScanBaseFieldsConstIterator it(msg, layout2);
+  EXPECT_DOUBLE_EQ(-M_PI, (*it).scanAngle);
+  EXPECT_DOUBLE_EQ(8, *(*it).range);
+
+  // different layout
+  msg.subscan_layout.angular_offsets.offsets = {0.0, 0.2};
+  const auto layout3 = cache.Get(msg);
+  EXPECT_NE(layout1, layout3);
+  EXPECT_DOUBLE_EQ(0.2, layout3->GetSubscanAngle(1));
+  EXPECT_EQ(1, cache.Hits());
+  EXPECT_EQ(2, cache.Misses());
+  EXPECT_EQ(2, cache.Size());
+
+  // switching back to the first layout is a hit
+  msg.subscan_layout.angular_offsets.offsets = {0.0, 0.1};
+  EXPECT_EQ(layout1, cache.Get(msg));
+  EXPECT_EQ(2, cache.Hits());
+  EXPECT_EQ(2, cache.Misses());
+
+  cache.Clear();
+  EXPECT_EQ(0, cache.Hits());
+  EXPECT_EQ(0, cache.Misses());
+  EXPECT_EQ(0, cache.Size());
+}
+
+TEST(LayoutCache, LayoutsEqualByOperatorButParsedDifferently)
+{
+  LayoutCache cache;
+
+  auto msg = createScan();
+  const auto layout1 = cache.Get(msg);
+
+  // operator== ignores exclude_last, but it changes the increment
+  msg.scan_layout.angular_offsets.exclude_last = false;
+  const auto layout2 = cache.Get(msg);
+  EXPECT_NE(layout1, layout2);
+  EXPECT_DOUBLE_EQ(-M_PI + M_PI_2, layout1->GetScanAngle(2));
+  EXPECT_DOUBLE_EQ(-M_PI + 2 * M_PI / 3, layout2->GetScanAngle(2));
+
+  // operator== treats min and min + 2 pi as equal, but the angles differ
+  msg.scan_layout.angular_offsets.exclude_last = true;
+  msg.scan_layout.angular_offsets.min = M_PI;
+  msg.scan_layout.angular_offsets.max = 3 * M_PI;
+  const auto layout3 = cache.Get(msg);
+  EXPECT_NE(layout1, layout3);
+  EXPECT_DOUBLE_EQ(M_PI, layout3->GetScanAngle(0));
+
+  EXPECT_EQ(0, cache.Hits());
+  EXPECT_EQ(3, cache.Misses());
+}
+
+TEST(LayoutCache, DifferentNumberOfPoints)
+{
+  LayoutCache cache;
+
+  auto msg = createScan();
+  cache.Get(msg);
+
+  msg.ranges.resize(10);
+  EXPECT_THROW(cache.Get(msg), std::runtime_error);
+  EXPECT_EQ(0, cache.Hits());
+  EXPECT_EQ(2, cache.Misses());
+  EXPECT_EQ(1, cache.Size());
+}
+
+TEST(LayoutCache, Eviction)
+{
+  LayoutCache cache(2);
+  EXPECT_EQ(2, cache.Capacity());
+
+  auto msg1 = createScan();
+  auto msg2 = createScan();
+  msg2.subscan_layout.angular_offsets.offsets = {0.0, 0.2};
+  auto msg3 = createScan();
+  msg3.subscan_layout.angular_offsets.offsets = {0.0, 0.3};
+
+  const auto layout1 = cache.Get(msg1);
+  cache.Get(msg2);
+  cache.Get(msg1);  // msg1 is now the most recently used one
+  cache.Get(msg3);  // evicts msg2
+  EXPECT_EQ(2, cache.Size());
+
+  EXPECT_EQ(layout1, cache.Get(msg1));
+  EXPECT_EQ(2, cache.Hits());
+  cache.Get(msg2);
+  EXPECT_EQ(2, cache.Hits());
+  EXPECT_EQ(4, cache.Misses());
+
+  EXPECT_THROW(LayoutCache(0), std::runtime_error);
+}
+
+TEST(LayoutCache, Materialize)
+{
+  LayoutCache cache(16, true);
+  const auto msg = createScan();
+  EXPECT_TRUE(cache.Get(msg)->IsMaterialized());
+
+  LayoutCache cache2;
+  EXPECT_FALSE(cache2.Get(msg)->IsMaterialized());
+}
+
+TEST(LayoutCache, Instance)
+{
+  auto& cache = LayoutCache::Instance();
+  EXPECT_EQ(&cache, &LayoutCache::Instance());
+
+  cache.Clear();
+  const auto msg = createScan();
+  EXPECT_EQ(cache.Get(msg), LayoutCache::Instance().Get(msg));
+  EXPECT_EQ(1, cache.Hits());
+  cache.Clear();
+}
+
+TEST(LayoutCache, MultipleThreads)
+{
+  LayoutCache cache(4);
+
+  std::vector<MultiLayerLaserScan> msgs;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    msgs.push_back(createScan());
+    msgs.back().subscan_layout.angular_offsets.offsets = {0.0, 0.1 * i};
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < 8; ++t)
+  {
+    threads.emplace_back([&cache, &msgs, t]()
+    {
+      for (size_t i = 0; i < 1000; ++i)
+      {
+        const auto& msg = msgs[(i + t) % msgs.size()];
+        const auto layout = cache.Get(msg);
+        EXPECT_DOUBLE_EQ(msg.subscan_layout.angular_offsets.offsets[1], layout->GetSubscanAngle(1));
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  EXPECT_EQ(8000, cache.Hits() + cache.Misses());
+  EXPECT_GE(cache.Misses(), 4);
+  EXPECT_EQ(4, cache.Size());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
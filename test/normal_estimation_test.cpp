@@ -0,0 +1,206 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/NormalEstimation.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+#include <multilayer_laser_scan/PointFieldUtils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "test_scans.h"
+
+using namespace sensor_msgs;
+
+namespace
+{
+
+MultiLayerLaserScan createScan(const size_t numScans, const size_t subscanLength)
+{
+  auto msg = CreateRegularLayoutScan(numScans, subscanLength, 0, 2 * M_PI, -0.4, 0.4, ros::Duration(0.001));
+  msg.range_min = 0.5f;
+  msg.range_max = 100.0f;
+  msg.ranges.resize(numScans * subscanLength, 10.0f);
+  return msg;
+}
+
+/**
+ * @brief Set ranges of the scan so that the points lie on the plane z = -1.
+ *        Rays that don't hit it get infinite ranges.
+ */
+void makeFloor(MultiLayerLaserScan& msg, const MultiLayerLaserScanLayout& layout)
+{
+  std::vector<float> x(layout.Length()), y(layout.Length()), z(layout.Length());
+  std::fill(msg.ranges.begin(), msg.ranges.end(), 1.0f);
+  CartesianProjection(layout).Project(msg, x.data(), y.data(), z.data());
+  for (size_t i = 0; i < layout.Length(); ++i)
+    msg.ranges[i] = z[i] < -0.05f ? -1.0f / z[i] : std::numeric_limits<float>::infinity();
+}
+
+}
+
+TEST(NormalEstimation, Sphere)  // NOLINT
+{
+  const auto msg = createScan(64, 16);
+  const MultiLayerLaserScanLayout layout(msg);
+  const auto n = layout.Length();
+
+  std::vector<float> x(n), y(n), z(n);
+  CartesianProjection(layout).Project(msg, x.data(), y.data(), z.data());
+
+  for (const auto method : {NormalEstimation::CROSS_PRODUCT, NormalEstimation::PCA})
+  {
+    NormalEstimation estimation(layout, method);
+    EXPECT_EQ(method, estimation.GetMethod());
+    std::vector<float> nx(n), ny(n), nz(n);
+    estimation.Compute(msg, nx.data(), ny.data(), nz.data());
+
+    // normals of a sphere around the sensor point towards the sensor
+    for (size_t i = 0; i < n; ++i)
+    {
+      const auto dot = -(nx[i] * x[i] + ny[i] * y[i] + nz[i] * z[i]) / 10.0f;
+      EXPECT_NEAR(1.0f, std::hypot(std::hypot(nx[i], ny[i]), nz[i]), 1e-4f) << i;
+      EXPECT_GT(dot, 0.98f) << "method " << method << ", point " << i;
+    }
+  }
+}
+
+TEST(NormalEstimation, Floor)  // NOLINT
+{
+  auto msg = createScan(64, 16);
+  const MultiLayerLaserScanLayout layout(msg);
+  makeFloor(msg, layout);
+  const auto n = layout.Length();
+
+  for (const auto method : {NormalEstimation::CROSS_PRODUCT, NormalEstimation::PCA})
+  {
+    NormalEstimation estimation(layout, method, 2);
+    std::vector<float> nx(n), ny(n), nz(n);
+    estimation.Compute(msg, nx.data(), ny.data(), nz.data());
+
+    size_t numValid = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (!std::isfinite(msg.ranges[i]) || msg.ranges[i] > msg.range_max)
+      {
+        EXPECT_TRUE(std::isnan(nx[i]) && std::isnan(ny[i]) && std::isnan(nz[i])) << i;
+        continue;
+      }
+      if (std::isnan(nz[i]))  // the last ring above the floor has no neighbors across rings
+        continue;
+      ++numValid;
+      EXPECT_NEAR(0.0f, nx[i], 1e-3f) << i;
+      EXPECT_NEAR(0.0f, ny[i], 1e-3f) << i;
+      EXPECT_NEAR(1.0f, nz[i], 1e-3f) << i;
+    }
+    EXPECT_GT(numValid, n / 4);
+  }
+}
+
+TEST(NormalEstimation, InvalidPoints)  // NOLINT
+{
+  auto msg = createScan(8, 4);
+  const MultiLayerLaserScanLayout layout(msg);
+  const auto n = layout.Length();
+
+  // a point surrounded by invalid or out-of-range points has no normal
+  for (size_t i = 0; i < n; ++i)
+    msg.ranges[i] = i % 3 == 0 ? 0.1f : std::numeric_limits<float>::quiet_NaN();
+  msg.ranges[9] = 10.0f;
+  msg.ranges[12] = 200.0f;
+
+  std::vector<float> nx(n), ny(n), nz(n);
+  NormalEstimation(layout).Compute(msg, nx.data(), ny.data(), nz.data());
+  for (size_t i = 0; i < n; ++i)
+    EXPECT_TRUE(std::isnan(nx[i])) << i;
+
+  // neighbors across a depth discontinuity are not used
+  msg = createScan(8, 4);
+  msg.ranges[9] = 50.0f;
+  NormalEstimation(layout, NormalEstimation::CROSS_PRODUCT, 1, 1.0f).Compute(msg, nx.data(), ny.data(), nz.data());
+  EXPECT_TRUE(std::isnan(nx[9]));
+  EXPECT_FALSE(std::isnan(nx[10]));
+
+  msg.ranges.resize(n - 1);
+  EXPECT_THROW(NormalEstimation(layout).Compute(msg, nx.data(), ny.data(), nz.data()), std::runtime_error);
+}
+
+TEST(NormalEstimation, CustomField)  // NOLINT
+{
+  auto msg = createScan(32, 8);
+  const MultiLayerLaserScanLayout layout(msg);
+  makeFloor(msg, layout);
+  const auto n = layout.Length();
+
+  PointDataModifier modifier(msg.custom_data);
+  modifier.setFieldsByString(1, "ring");
+  modifier.resize(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    const auto ring = static_cast<uint16_t>(i % 8);
+    std::memcpy(&msg.custom_data.data[i * msg.custom_data.point_step], &ring, sizeof(ring));
+  }
+
+  NormalEstimation estimation(layout, NormalEstimation::PCA);
+  estimation.Compute(msg);
+
+  ASSERT_EQ(2, msg.custom_data.fields.size());
+  EXPECT_EQ("normal", msg.custom_data.fields[1].name);
+  ASSERT_EQ(n * msg.custom_data.point_step, msg.custom_data.data.size());
+
+  std::vector<float> nx(n), ny(n), nz(n);
+  estimation.Compute(msg, nx.data(), ny.data(), nz.data());
+
+  const auto offset = msg.custom_data.fields[1].offset;
+  for (size_t i = 0; i < n; ++i)
+  {
+    const auto point = &msg.custom_data.data[i * msg.custom_data.point_step];
+    uint16_t ring;
+    std::memcpy(&ring, point, sizeof(ring));
+    EXPECT_EQ(i % 8, ring);
+
+    float normal[3];
+    std::memcpy(normal, point + offset, sizeof(normal));
+    if (std::isnan(nx[i]))
+    {
+      EXPECT_TRUE(std::isnan(normal[0]));
+      continue;
+    }
+    EXPECT_FLOAT_EQ(nx[i], normal[0]);
+    EXPECT_FLOAT_EQ(ny[i], normal[1]);
+    EXPECT_FLOAT_EQ(nz[i], normal[2]);
+  }
+
+  // the existing field is reused
+  estimation.Compute(msg);
+  EXPECT_EQ(2, msg.custom_data.fields.size());
+
+  // a scan without custom data gets them
+  auto empty = createScan(32, 8);
+  estimation.Compute(empty);
+  ASSERT_EQ(1, empty.custom_data.fields.size());
+  EXPECT_EQ(12, empty.custom_data.point_step);
+  EXPECT_EQ(12 * n, empty.custom_data.data.size());
+
+  msg.custom_data.fields[1].datatype = PointField::FLOAT64;
+  EXPECT_THROW(estimation.Compute(msg), std::runtime_error);
+
+  // custom data that can't take the normals are left as they were
+  auto other = createScan(32, 8);
+  PointDataModifier(other.custom_data).setFieldsByString(1, "ring");
+  other.custom_data.is_bigendian = !impl::isHostBigEndian();
+  PointDataModifier(other.custom_data).resize(n);
+  EXPECT_THROW(estimation.Compute(other), std::runtime_error);
+  other.custom_data.is_bigendian = impl::isHostBigEndian();
+  PointDataModifier(other.custom_data).resize(n - 1);
+  EXPECT_THROW(estimation.Compute(other), std::runtime_error);
+  EXPECT_EQ(1, other.custom_data.fields.size());
+  EXPECT_EQ(2, other.custom_data.point_step);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
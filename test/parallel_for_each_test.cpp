@@ -0,0 +1,172 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/ParallelForEachPoint.h>
+#include <multilayer_laser_scan/StaticScanLayout.h>
+
+#include <atomic>
+#include <cmath>
+#include <mutex>
+
+#include "test_scans.h"
+
+using namespace sensor_msgs;
+
+MultiLayerLaserScan createScan(const size_t scanLength, const size_t subscanLength)
+{
+  auto msg = CreateRegularLayoutScan(scanLength, subscanLength, 0, 2 * M_PI, -0.5, 0.5, ros::Duration(0.01));
+  msg.header.stamp = ros::Time(10.0);
+  msg.subscan_layout.time_offsets.increment = ros::Duration(0.001);
+
+  msg.ranges.resize(scanLength * subscanLength);
+  msg.intensities.resize(scanLength * subscanLength);
+  for (size_t i = 0; i < msg.ranges.size(); ++i)
+  {
+    msg.ranges[i] = static_cast<float>(i);
+    msg.intensities[i] = static_cast<float>(2 * i);
+  }
+
+  return msg;
+}
+
+TEST(ThreadPool, RunsAllTasks)
+{
+  for (const size_t numThreads : {1, 2, 4, 7})
+  {
+    SCOPED_TRACE(numThreads);
+    ThreadPool pool(numThreads);
+    EXPECT_EQ(numThreads, pool.NumThreads());
+
+    for (const size_t numTasks : {0, 1, 3, 100})
+    {
+      std::vector<std::atomic<int>> calls(numTasks);
+      for (auto& c : calls)
+        c = 0;
+      pool.Run(numTasks, [&calls](const size_t i) { ++calls[i]; });
+      for (size_t i = 0; i < numTasks; ++i)
+        EXPECT_EQ(1, calls[i]);
+    }
+  }
+}
+
+TEST(ThreadPool, Exceptions)
+{
+  ThreadPool pool(4);
+  EXPECT_THROW(pool.Run(100, [](const size_t i)
+  {
+    if (i == 42)
+      throw std::out_of_range("42");
+  }), std::out_of_range);
+
+  // the pool is still usable
+  std::atomic<size_t> sum {0};
+  pool.Run(10, [&sum](const size_t i) { sum += i; });
+  EXPECT_EQ(45, sum);
+}
+
+TEST(ThreadPool, Nested)
+{
+  ThreadPool pool(4);
+  std::atomic<size_t> sum {0};
+  pool.Run(8, [&](const size_t i)
+  {
+    pool.Run(8, [&](const size_t j) { sum += i * 8 + j; });
+  });
+  EXPECT_EQ(63 * 64 / 2, sum);
+}
+
+TEST(ParallelForEachPoint, Mutable)
+{
+  auto scan = createScan(100, 16);
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(scan);
+  ThreadPool pool(4);
+
+  for (const size_t grain : {0, 1, 7, 100, 1000})
+  {
+    SCOPED_TRACE(grain);
+    std::mutex mutex;
+    std::vector<size_t> rangeSizes;
+
+    ParallelForEachPoint(scan, layout,
+      [&](MultiLayerLaserScanBaseFieldsIterator it, const MultiLayerLaserScanBaseFieldsIterator& end)
+      {
+        size_t n = 0;
+        for (; it != end; ++it, ++n)
+          *(*it).range += 1.0f;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        rangeSizes.push_back(n);
+      }, grain, pool);
+
+    size_t numPoints = 0;
+    for (const auto n : rangeSizes)
+    {
+      EXPECT_EQ(0, n % 16);  // whole columns
+      numPoints += n;
+    }
+    EXPECT_EQ(scan.ranges.size(), numPoints);
+  }
+
+  for (size_t i = 0; i < scan.ranges.size(); ++i)
+    EXPECT_EQ(i + 5, scan.ranges[i]);
+}
+
+TEST(ParallelForEachPoint, Const)
+{
+  const auto scan = createScan(100, 16);
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(scan);
+  ThreadPool pool(3);
+
+  std::vector<double> scanAngles(scan.ranges.size()), subscanAngles(scan.ranges.size());
+  std::vector<ros::Time> times(scan.ranges.size());
+  ParallelForEachPoint(scan, layout,
+    [&](MultiLayerLaserScanBaseFieldsConstIterator it, const MultiLayerLaserScanBaseFieldsConstIterator& end)
+    {
+      for (; it != end; ++it)
+      {
+        const auto point = *it;
+        const auto i = static_cast<size_t>(*point.range);
+        EXPECT_EQ(2 * i, *point.intensity);
+        scanAngles[i] = point.scanAngle;
+        subscanAngles[i] = point.subscanAngle;
+        times[i] = point.timestamp;
+      }
+    }, 0, pool);
+
+  MultiLayerLaserScanBaseFieldsConstIterator it(scan, layout);
+  for (size_t i = 0; it != it.end(); ++it, ++i)
+  {
+    EXPECT_EQ((*it).scanAngle, scanAngles[i]);
+    EXPECT_EQ((*it).subscanAngle, subscanAngles[i]);
+    EXPECT_EQ((*it).timestamp, times[i]);
+  }
+
+  auto wrongScan = scan;
+  wrongScan.ranges.pop_back();
+  EXPECT_THROW(ParallelForEachPoint(wrongScan, layout,
+    [](MultiLayerLaserScanBaseFieldsConstIterator, const MultiLayerLaserScanBaseFieldsConstIterator&) {}),
+    std::runtime_error);
+}
+
+TEST(ParallelForEachPoint, ParallelForScans)
+{
+  const auto scan = createScan(100, 16);
+  const MultiLayerLaserScanLayout layout(scan);
+  ThreadPool pool(4);
+
+  std::vector<int> visited(scan.ranges.size(), 0);
+  ParallelForScans(layout, [&](const size_t firstScan, const size_t endScan)
+  {
+    ForEachPointInScans(layout, firstScan, endScan, [&](size_t i, double, double, int64_t)
+    {
+      ++visited[i];
+    });
+  }, 3, pool);
+
+  for (size_t i = 0; i < visited.size(); ++i)
+    EXPECT_EQ(1, visited[i]);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
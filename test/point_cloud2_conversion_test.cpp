@@ -0,0 +1,192 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/MultiLayerLaserScanToPointCloud2.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+
+#include <cstring>
+
+using namespace sensor_msgs;
+
+MultiLayerLaserScan createScan()
+{
+  MultiLayerLaserScan msg;
+
+  msg.header.stamp = ros::Time(10.0);
+  msg.header.frame_id = "laser";
+  msg.range_min = 0.5;
+  msg.range_max = 10.0;
+
+  // rays are ordered top to bottom
+  msg.subscan_layout.time_offsets.regular = false;
+  msg.subscan_layout.time_offsets.offsets = {ros::Duration(0.0), ros::Duration(0.1), ros::Duration(0.2)};
+  msg.subscan_layout.angular_offsets.regular = false;
+  msg.subscan_layout.angular_offsets.offsets = {M_PI_4, 0.0, -M_PI_4};
+
+  msg.scan_layout.time_offsets.regular = false;
+  msg.scan_layout.time_offsets.offsets = {ros::Duration(0.0), ros::Duration(1.0)};
+  msg.scan_layout.angular_offsets.regular = false;
+  msg.scan_layout.angular_offsets.offsets = {0.0, M_PI_2};
+
+  msg.scan_offsets_during_subscan.regular = false;
+  msg.scan_offsets_during_subscan.offsets = { 0.0, 0.0, 0.0 };
+
+  msg.ranges = {1, 2, 20, 4, 0.1, 6};
+  msg.intensities = {10, 20, 30, 40, 50, 60};
+
+  PointDataModifier modifier(msg.custom_data);
+  modifier.setFieldsByString(1, "reflectivity");
+  modifier.resize(6);
+  PointDataIterator<float> it(msg.custom_data, "reflectivity");
+  for (size_t i = 0; it != it.end(); ++it, ++i)
+    *it = 100.0f + i;
+
+  return msg;
+}
+
+template<typename T>
+T readValue(const PointCloud2& cloud, const size_t index, const std::string& field)
+{
+  for (const auto& f : cloud.fields)
+  {
+    if (f.name == field)
+    {
+      T value;
+      std::memcpy(&value, &cloud.data[index * cloud.point_step + f.offset], sizeof(T));
+      return value;
+    }
+  }
+  throw std::runtime_error("Field " + field + " not found");
+}
+
+TEST(MultiLayerLaserScanToPointCloud2, Unorganized)
+{
+  const auto msg = createScan();
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+
+  MultiLayerLaserScanToPointCloud2 converter;
+  PointCloud2 cloud;
+  converter.Convert(msg, layout, cloud);
+
+  EXPECT_EQ("laser", cloud.header.frame_id);
+  EXPECT_EQ(msg.header.stamp, cloud.header.stamp);
+  ASSERT_EQ(1, cloud.height);
+  ASSERT_EQ(4, cloud.width);  // 2 points are out of range
+  EXPECT_TRUE(cloud.is_dense);
+  ASSERT_EQ(7, cloud.fields.size());
+  EXPECT_EQ(28, cloud.point_step);  // 3*4 + 4 + 4 + 2, padding to 24, 4
+  EXPECT_EQ(cloud.width * cloud.point_step, cloud.row_step);
+  EXPECT_EQ(cloud.row_step, cloud.data.size());
+
+  const std::vector<size_t> indices = {0, 1, 3, 5};
+  const std::vector<uint16_t> rings = {2, 1, 0};
+  for (size_t j = 0; j < indices.size(); ++j)
+  {
+    const auto i = indices[j];
+    const auto scanAngle = layout->GetScanAngle(i);
+    const auto subscanAngle = layout->GetSubscanAngle(i);
+    const auto r = msg.ranges[i];
+
+    EXPECT_NEAR(r * std::cos(subscanAngle) * std::cos(scanAngle), readValue<float>(cloud, j, "x"), 1e-6);
+    EXPECT_NEAR(r * std::cos(subscanAngle) * std::sin(scanAngle), readValue<float>(cloud, j, "y"), 1e-6);
+    EXPECT_NEAR(r * std::sin(subscanAngle), readValue<float>(cloud, j, "z"), 1e-6);
+    EXPECT_FLOAT_EQ(msg.intensities[i], readValue<float>(cloud, j, "intensity"));
+    EXPECT_FLOAT_EQ(layout->GetTime(i).toSec(), readValue<float>(cloud, j, "time"));
+    EXPECT_EQ(rings[i % 3], readValue<uint16_t>(cloud, j, "ring"));
+    EXPECT_FLOAT_EQ(100.0f + i, readValue<float>(cloud, j, "reflectivity"));
+  }
+}
+
+TEST(MultiLayerLaserScanToPointCloud2, Organized)
+{
+  const auto msg = createScan();
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+
+  MultiLayerLaserScanToPointCloud2 converter(MultiLayerLaserScanToPointCloud2::RING, true);
+  PointCloud2 cloud;
+  cloud.data.assign(6 * 16, 0xff);  // stale contents of a reused buffer
+  converter.Convert(msg, layout, cloud);
+
+  ASSERT_EQ(3, cloud.height);
+  ASSERT_EQ(2, cloud.width);
+  EXPECT_FALSE(cloud.is_dense);
+  ASSERT_EQ(4, cloud.fields.size());
+  EXPECT_EQ(16, cloud.point_step);
+  EXPECT_EQ(cloud.height * cloud.width * cloud.point_step, cloud.data.size());
+
+  // rows are sorted by ring, i.e. bottom to top
+  const std::vector<size_t> rows = {2, 1, 0};
+  for (size_t i = 0; i < msg.ranges.size(); ++i)
+  {
+    const auto index = rows[i % 3] * cloud.width + i / 3;
+    EXPECT_EQ(rows[i % 3], readValue<uint16_t>(cloud, index, "ring"));
+    // the padding after the ring
+    EXPECT_EQ(0, cloud.data[index * cloud.point_step + 14]);
+    EXPECT_EQ(0, cloud.data[index * cloud.point_step + 15]);
+    const auto x = readValue<float>(cloud, index, "x");
+    if (i == 2 || i == 4)
+    {
+      EXPECT_TRUE(std::isnan(x));
+    }
+    else
+    {
+      EXPECT_NEAR(msg.ranges[i], std::hypot(std::hypot(x, readValue<float>(cloud, index, "y")),
+                                            readValue<float>(cloud, index, "z")), 1e-6);
+    }
+  }
+}
+
+TEST(MultiLayerLaserScanToPointCloud2, ReuseBuffer)
+{
+  auto msg = createScan();
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+
+  MultiLayerLaserScanToPointCloud2 converter;
+  PointCloud2 cloud;
+  converter.Convert(msg, layout, cloud);
+  const auto* data = cloud.data.data();
+  const auto* fields = cloud.fields.data();
+
+  msg.ranges = {1, 2, 3, 4, 5, 6};
+  converter.Convert(msg, layout, cloud);
+  EXPECT_EQ(6, cloud.width);
+  EXPECT_EQ(data, cloud.data.data());
+  EXPECT_EQ(fields, cloud.fields.data());
+
+  // without custom data, the fields change
+  msg.custom_data = PointData();
+  converter.Convert(msg, layout, cloud);
+  EXPECT_EQ(6, cloud.fields.size());
+  EXPECT_EQ(24, cloud.point_step);
+  EXPECT_EQ(data, cloud.data.data());
+}
+
+TEST(MultiLayerLaserScanToPointCloud2, Errors)
+{
+  auto msg = createScan();
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+
+  MultiLayerLaserScanToPointCloud2 converter;
+  PointCloud2 cloud;
+
+  auto wrongIntensities = msg;
+  wrongIntensities.intensities.resize(3);
+  EXPECT_THROW(converter.Convert(wrongIntensities, layout, cloud), std::runtime_error);
+
+  auto wrongRanges = msg;
+  wrongRanges.ranges.resize(3);
+  EXPECT_THROW(converter.Convert(wrongRanges, layout, cloud), std::runtime_error);
+
+  auto wrongEndian = msg;
+  wrongEndian.custom_data.is_bigendian = !wrongEndian.custom_data.is_bigendian;
+  EXPECT_THROW(converter.Convert(wrongEndian, layout, cloud), std::runtime_error);
+
+  // without custom data, endianness doesn't matter
+  MultiLayerLaserScanToPointCloud2 converterNoCustom(MultiLayerLaserScanToPointCloud2::INTENSITY);
+  EXPECT_NO_THROW(converterNoCustom.Convert(wrongEndian, layout, cloud));
+  EXPECT_EQ(4, cloud.fields.size());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
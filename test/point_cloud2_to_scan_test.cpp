@@ -0,0 +1,263 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/MultiLayerLaserScanToPointCloud2.h>
+#include <multilayer_laser_scan/PointCloud2ToMultiLayerLaserScan.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+using namespace sensor_msgs;
+
+MultiLayerLaserScan createScan(const bool regular)
+{
+  MultiLayerLaserScan msg;
+
+  msg.header.stamp = ros::Time(10.0);
+  msg.header.frame_id = "laser";
+  msg.range_min = 0.5;
+  msg.range_max = 100.0;
+
+  // rays are not ordered by elevation
+  msg.subscan_layout.time_offsets.regular = true;
+  msg.subscan_layout.time_offsets.base_offset = ros::Duration(0.0);
+  msg.subscan_layout.time_offsets.increment = ros::Duration(0.001);
+  msg.subscan_layout.angular_offsets.regular = false;
+  msg.subscan_layout.angular_offsets.offsets = {0.1, -0.1, 0.3, -0.3};
+
+  msg.scan_layout.time_offsets.regular = true;
+  msg.scan_layout.time_offsets.base_offset = ros::Duration(0.0);
+  msg.scan_layout.time_offsets.increment = ros::Duration(0.01);
+  if (regular)
+  {
+    msg.scan_layout.angular_offsets.regular = true;
+    msg.scan_layout.angular_offsets.min = -M_PI;
+    msg.scan_layout.angular_offsets.max = M_PI;
+    msg.scan_layout.angular_offsets.exclude_last = true;
+    msg.scan_layout.angular_offsets.samples = 16;
+  }
+  else
+  {
+    msg.scan_layout.angular_offsets.regular = false;
+    for (size_t i = 0; i < 16; ++i)
+      msg.scan_layout.angular_offsets.offsets.push_back(3.0 - 0.4 * i);
+  }
+
+  msg.scan_offsets_during_subscan.regular = false;
+  msg.scan_offsets_during_subscan.offsets = {0.0, 0.01, 0.02, 0.03};
+
+  msg.ranges.resize(64);
+  msg.intensities.resize(64);
+  for (size_t i = 0; i < 64; ++i)
+  {
+    msg.ranges[i] = 1.0f + 0.25f * i;
+    msg.intensities[i] = 2.0f * i;
+  }
+  msg.ranges[5] = std::numeric_limits<float>::quiet_NaN();
+  msg.ranges[17] = 1000.0f;  // out of range
+
+  PointDataModifier modifier(msg.custom_data);
+  modifier.setFieldsByString(1, "reflectivity");
+  modifier.resize(64);
+  PointDataIterator<float> it(msg.custom_data, "reflectivity");
+  for (size_t i = 0; it != it.end(); ++it, ++i)
+    *it = 100.0f + i;
+
+  return msg;
+}
+
+void expectRoundTrip(const MultiLayerLaserScan& orig, const MultiLayerLaserScan& scan)
+{
+  ASSERT_EQ(orig.ranges.size(), scan.ranges.size());
+  ASSERT_EQ(orig.intensities.size(), scan.intensities.size());
+  ASSERT_EQ(1, scan.custom_data.fields.size());
+  EXPECT_EQ("reflectivity", scan.custom_data.fields[0].name);
+  EXPECT_EQ(4, scan.custom_data.point_step);
+  EXPECT_EQ(orig.header.stamp, scan.header.stamp);
+
+  const float* reflectivity = reinterpret_cast<const float*>(scan.custom_data.data.data());
+  for (size_t i = 0; i < orig.ranges.size(); ++i)
+  {
+    SCOPED_TRACE(i);
+    if (i == 5 || i == 17)
+    {
+      EXPECT_TRUE(std::isnan(scan.ranges[i]));
+      continue;
+    }
+    EXPECT_NEAR(orig.ranges[i], scan.ranges[i], 1e-4);
+    EXPECT_EQ(orig.intensities[i], scan.intensities[i]);
+    EXPECT_EQ(100.0f + i, reflectivity[i]);
+  }
+}
+
+TEST(PointCloud2ToMultiLayerLaserScan, OrganizedRoundTrip)
+{
+  const auto orig = createScan(true);
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(orig);
+
+  PointCloud2 cloud;
+  MultiLayerLaserScanToPointCloud2(MultiLayerLaserScanToPointCloud2::ALL, true).Convert(orig, layout, cloud);
+  ASSERT_EQ(4, cloud.height);
+  ASSERT_EQ(16, cloud.width);
+
+  PointCloud2ToMultiLayerLaserScan converter(orig, {"reflectivity"});
+  MultiLayerLaserScan scan;
+  const auto stats = converter.Convert(cloud, scan);
+
+  EXPECT_EQ(62, stats.numPoints);
+  EXPECT_EQ(2, stats.numDroppedPoints);
+  EXPECT_GT(stats.BytesSaved(), 0);
+  expectRoundTrip(orig, scan);
+}
+
+TEST(PointCloud2ToMultiLayerLaserScan, UnorganizedRoundTrip)
+{
+  for (const auto regular : {true, false})
+  {
+    SCOPED_TRACE(regular);
+    const auto orig = createScan(regular);
+    const auto layout = std::make_shared<MultiLayerLaserScanLayout>(orig);
+
+    PointCloud2 cloud;
+    MultiLayerLaserScanToPointCloud2().Convert(orig, layout, cloud);
+    ASSERT_EQ(1, cloud.height);
+    ASSERT_EQ(62, cloud.width);
+
+    PointCloud2ToMultiLayerLaserScan converter(orig, {"reflectivity"});
+    MultiLayerLaserScan scan;
+    const auto stats = converter.Convert(cloud, scan);
+
+    EXPECT_EQ(62, stats.numPoints);
+    EXPECT_EQ(0, stats.numDroppedPoints);
+    expectRoundTrip(orig, scan);
+
+    // the output buffers are reused
+    const auto* rangesData = scan.ranges.data();
+    converter.Convert(cloud, scan);
+    EXPECT_EQ(rangesData, scan.ranges.data());
+    expectRoundTrip(orig, scan);
+  }
+}
+
+TEST(PointCloud2ToMultiLayerLaserScan, NoRingField)
+{
+  const auto orig = createScan(true);
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(orig);
+
+  PointCloud2 cloud;
+  MultiLayerLaserScanToPointCloud2(MultiLayerLaserScanToPointCloud2::XYZ |
+    MultiLayerLaserScanToPointCloud2::INTENSITY).Convert(orig, layout, cloud);
+
+  PointCloud2ToMultiLayerLaserScan converter(orig, {}, "intensity", "");
+  MultiLayerLaserScan scan;
+  const auto stats = converter.Convert(cloud, scan);
+
+  EXPECT_EQ(62, stats.numPoints);
+  EXPECT_TRUE(scan.custom_data.data.empty());
+  for (size_t i = 0; i < orig.ranges.size(); ++i)
+  {
+    SCOPED_TRACE(i);
+    if (i == 5 || i == 17)
+      EXPECT_TRUE(std::isnan(scan.ranges[i]));
+    else
+      EXPECT_NEAR(orig.ranges[i], scan.ranges[i], 1e-4);
+  }
+}
+
+TEST(PointCloud2ToMultiLayerLaserScan, RingIsSubscanIndex)
+{
+  const auto orig = createScan(true);
+
+  PointCloud2 cloud;
+  cloud.height = 1;
+  cloud.width = 1;
+  cloud.fields.resize(4);
+  const std::vector<std::string> names = {"x", "y", "z", "ring"};
+  for (size_t f = 0; f < 4; ++f)
+  {
+    cloud.fields[f].name = names[f];
+    cloud.fields[f].offset = f * 4;
+    cloud.fields[f].datatype = f < 3 ? PointField::FLOAT32 : PointField::UINT16;
+    cloud.fields[f].count = 1;
+  }
+  cloud.point_step = 16;
+  cloud.row_step = 16;
+  cloud.data.resize(16);
+  const float xyz[3] = {2.0f, 0.0f, 0.0f};
+  const uint16_t ring = 2;
+  std::memcpy(&cloud.data[0], xyz, sizeof(xyz));
+  std::memcpy(&cloud.data[12], &ring, sizeof(ring));
+
+  MultiLayerLaserScan scan;
+  PointCloud2ToMultiLayerLaserScan(orig, {}, "intensity", "ring",
+    PointCloud2ToMultiLayerLaserScan::RING_IS_SUBSCAN_INDEX).Convert(cloud, scan);
+
+  // azimuth 0 is the 8th column, ring 2 is the third ray of the subscan
+  EXPECT_FLOAT_EQ(2.0f, scan.ranges[8 * 4 + 2]);
+  EXPECT_TRUE(scan.intensities.empty());
+
+  // by elevation, ring 2 is the second highest ray
+  PointCloud2ToMultiLayerLaserScan(orig).Convert(cloud, scan);
+  EXPECT_FLOAT_EQ(2.0f, scan.ranges[8 * 4 + 0]);
+}
+
+TEST(PointCloud2ToMultiLayerLaserScan, InvalidRingsAndSameCell)
+{
+  const auto orig = createScan(true);
+
+  // rings stored as floats: 2, 2 again, -1 and NaN
+  PointCloud2 cloud;
+  cloud.height = 1;
+  cloud.width = 4;
+  cloud.fields.resize(4);
+  const std::vector<std::string> names = {"x", "y", "z", "ring"};
+  for (size_t f = 0; f < 4; ++f)
+  {
+    cloud.fields[f].name = names[f];
+    cloud.fields[f].offset = f * 4;
+    cloud.fields[f].datatype = PointField::FLOAT32;
+    cloud.fields[f].count = 1;
+  }
+  cloud.point_step = 16;
+  cloud.row_step = 64;
+  const float points[4][4] = {
+    {2.0f, 0.0f, 0.0f, 2.0f},
+    {3.0f, 0.0f, 0.0f, 2.0f},
+    {4.0f, 0.0f, 0.0f, -1.0f},
+    {5.0f, 0.0f, 0.0f, std::numeric_limits<float>::quiet_NaN()},
+  };
+  cloud.data.resize(sizeof(points));
+  std::memcpy(cloud.data.data(), points, sizeof(points));
+
+  MultiLayerLaserScan scan;
+  const auto stats = PointCloud2ToMultiLayerLaserScan(orig, {}, "intensity", "ring",
+    PointCloud2ToMultiLayerLaserScan::RING_IS_SUBSCAN_INDEX).Convert(cloud, scan);
+
+  // the second point overwrites the first one
+  EXPECT_EQ(1, stats.numPoints);
+  EXPECT_EQ(2, stats.numDroppedPoints);
+  EXPECT_FLOAT_EQ(3.0f, scan.ranges[8 * 4 + 2]);
+}
+
+TEST(PointCloud2ToMultiLayerLaserScan, Errors)
+{
+  const auto orig = createScan(true);
+  PointCloud2ToMultiLayerLaserScan converter(orig, {"reflectivity"});
+  MultiLayerLaserScan scan;
+
+  PointCloud2 cloud;
+  EXPECT_THROW(converter.Convert(cloud, scan), std::runtime_error);
+
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(orig);
+  MultiLayerLaserScanToPointCloud2(MultiLayerLaserScanToPointCloud2::XYZ).Convert(orig, layout, cloud);
+  EXPECT_THROW(converter.Convert(cloud, scan), std::runtime_error);  // no reflectivity
+
+  cloud.is_bigendian = !cloud.is_bigendian;
+  EXPECT_THROW(PointCloud2ToMultiLayerLaserScan(orig).Convert(cloud, scan), std::runtime_error);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,195 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/PointDataSchema.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+
+using namespace sensor_msgs;
+
+#pragma pack(push, 1)
+struct OusterPoint
+{
+  float strongest;
+  uint16_t ring;
+  float reflectivity;
+};
+
+struct NormalPoint
+{
+  uint16_t ring;
+  float normal[3];
+};
+#pragma pack(pop)
+
+struct AlignedPoint
+{
+  double strongest;
+  uint16_t ring;
+};
+
+namespace sensor_msgs
+{
+
+template<> struct PointDataSchemaTraits<OusterPoint>
+{
+  static std::vector<PointField> Fields()
+  {
+    return {
+      MULTILAYER_LASER_SCAN_SCHEMA_FIELD(OusterPoint, strongest),
+      MULTILAYER_LASER_SCAN_SCHEMA_FIELD(OusterPoint, ring),
+      MULTILAYER_LASER_SCAN_SCHEMA_FIELD(OusterPoint, reflectivity),
+    };
+  }
+};
+
+template<> struct PointDataSchemaTraits<NormalPoint>
+{
+  static std::vector<PointField> Fields()
+  {
+    return {
+      MULTILAYER_LASER_SCAN_SCHEMA_FIELD(NormalPoint, ring),
+      MULTILAYER_LASER_SCAN_SCHEMA_FIELD(NormalPoint, normal),
+    };
+  }
+};
+
+template<> struct PointDataSchemaTraits<AlignedPoint>
+{
+  static std::vector<PointField> Fields()
+  {
+    return {
+      MULTILAYER_LASER_SCAN_SCHEMA_FIELD(AlignedPoint, strongest),
+      MULTILAYER_LASER_SCAN_SCHEMA_FIELD(AlignedPoint, ring),
+    };
+  }
+};
+
+}
+
+TEST(PointDataSchema, Fields)  // NOLINT
+{
+  PointDataSchema<NormalPoint> schema;
+  ASSERT_EQ(2, schema.GetFields().size());
+  EXPECT_EQ("ring", schema.GetFields()[0].name);
+  EXPECT_EQ(0, schema.GetFields()[0].offset);
+  EXPECT_EQ(PointField::UINT16, schema.GetFields()[0].datatype);
+  EXPECT_EQ(1, schema.GetFields()[0].count);
+  EXPECT_EQ("normal", schema.GetFields()[1].name);
+  EXPECT_EQ(2, schema.GetFields()[1].offset);
+  EXPECT_EQ(PointField::FLOAT32, schema.GetFields()[1].datatype);
+  EXPECT_EQ(3, schema.GetFields()[1].count);
+
+  // the same layout as created by PointDataModifier
+  PointData msg;
+  PointDataModifier mod(msg);
+  mod.setFieldsByString(2, "ring", "normal");
+  mod.resize(3);
+  EXPECT_TRUE(schema.Matches(msg));
+  EXPECT_NO_THROW(schema.Validate(msg));
+}
+
+TEST(PointDataSchema, View)  // NOLINT
+{
+  PointData msg;
+  PointDataModifier mod(msg);
+  mod.setFieldsByString(3, "strongest", "ring", "reflectivity");
+  mod.resize(4);
+
+  PointDataIterator<float> sit(msg, "strongest");
+  PointDataIterator<uint16_t> rit(msg, "ring");
+  PointDataIterator<float> fit(msg, "reflectivity");
+  for (size_t i = 0; i < 4; ++i, ++sit, ++rit, ++fit)
+  {
+    *sit = i * 1.5f;
+    *rit = i;
+    *fit = i * 2.5f;
+  }
+
+  PointDataSchema<OusterPoint> schema;
+  ASSERT_TRUE(schema.CanView(msg));
+
+  const auto& constMsg = msg;
+  const auto constView = schema.View(constMsg);
+  ASSERT_EQ(4, constView.size());
+  for (size_t i = 0; i < constView.size(); ++i)
+  {
+    EXPECT_EQ(i * 1.5f, constView[i].strongest);
+    EXPECT_EQ(i, constView[i].ring);
+    EXPECT_EQ(i * 2.5f, constView[i].reflectivity);
+  }
+
+  auto view = schema.View(msg);
+  for (auto& point : view)
+    point.ring += 10;
+
+  PointDataConstIterator<uint16_t> it(msg, "ring");
+  for (size_t i = 0; i < 4; ++i, ++it)
+    EXPECT_EQ(i + 10, *it);
+}
+
+TEST(PointDataSchema, Mismatch)  // NOLINT
+{
+  PointDataSchema<OusterPoint> schema;
+
+  PointData msg;
+  PointDataModifier mod(msg);
+
+  // missing field
+  mod.setFieldsByString(2, "strongest", "ring");
+  EXPECT_FALSE(schema.Matches(msg));
+  EXPECT_THROW(schema.Validate(msg), std::runtime_error);
+
+  // different order
+  mod.setFieldsByString(3, "ring", "strongest", "reflectivity");
+  EXPECT_FALSE(schema.Matches(msg));
+
+  // different datatype
+  mod.setFields(3, "strongest", 1, PointField::FLOAT32, "ring", 1, PointField::INT16,
+                "reflectivity", 1, PointField::FLOAT32);
+  EXPECT_FALSE(schema.Matches(msg));
+
+  // additional field
+  mod.setFieldsByString(4, "strongest", "ring", "reflectivity", "noise");
+  EXPECT_FALSE(schema.Matches(msg));
+  EXPECT_THROW(schema.View(msg), std::runtime_error);
+
+  mod.setFieldsByString(3, "strongest", "ring", "reflectivity");
+  mod.resize(2);
+  EXPECT_TRUE(schema.Matches(msg));
+
+  msg.is_bigendian = !msg.is_bigendian;
+  EXPECT_FALSE(schema.Matches(msg));
+}
+
+TEST(PointDataSchema, CopyAndAssign)  // NOLINT
+{
+  PointDataSchema<AlignedPoint> schema;
+  std::vector<AlignedPoint> points = {{1.0, 1}, {2.0, 2}, {3.0, 3}};
+
+  PointData msg;
+  schema.Assign(msg, points.data(), points.size());
+  EXPECT_EQ(sizeof(AlignedPoint), msg.point_step);
+  EXPECT_EQ(3 * sizeof(AlignedPoint), msg.data.size());
+  ASSERT_TRUE(schema.Matches(msg));
+
+  PointDataConstIterator<double> it(msg, "strongest");
+  EXPECT_EQ(1.0, it[0]);
+  EXPECT_EQ(2.0, (it + 1)[0]);
+
+  std::vector<AlignedPoint> copy;
+  schema.CopyTo(msg, copy);
+  ASSERT_EQ(3, copy.size());
+  for (size_t i = 0; i < copy.size(); ++i)
+  {
+    EXPECT_EQ(points[i].strongest, copy[i].strongest);
+    EXPECT_EQ(points[i].ring, copy[i].ring);
+  }
+
+  schema.Resize(msg, 5);
+  EXPECT_EQ(5, schema.View(msg).size());
+  EXPECT_EQ(0, schema.View(msg)[4].ring);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,203 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/PointDataSoA.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+
+#include <random>
+
+using namespace sensor_msgs;
+
+namespace
+{
+
+PointData createPointData(const size_t numPoints)
+{
+  PointData msg;
+  PointDataModifier mod(msg);
+  mod.setFields(4, "reflectivity", 1, PointField::FLOAT32, "ring", 1, PointField::UINT16,
+                "time", 1, PointField::FLOAT64, "normal", 3, PointField::FLOAT32);
+  mod.resize(numPoints);
+
+  PointDataIterator<float> fit(msg, "reflectivity");
+  PointDataIterator<uint16_t> rit(msg, "ring");
+  PointDataIterator<double> tit(msg, "time");
+  PointDataIterator<float> nit(msg, "normal");
+  for (size_t i = 0; i < numPoints; ++i, ++fit, ++rit, ++tit, ++nit)
+  {
+    *fit = i * 0.5f;
+    *rit = i % 128;
+    *tit = i * 1e-6;
+    nit[0] = i;
+    nit[1] = -static_cast<float>(i);
+    nit[2] = 1.0f;
+  }
+  return msg;
+}
+
+}
+
+TEST(PointDataSoA, Kernels)  // NOLINT
+{
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<int> byte(0, 255);
+
+  for (const size_t fieldSize : {1, 2, 3, 4, 8, 12})
+  {
+    for (const size_t stride : {fieldSize, fieldSize + 1, size_t(22), size_t(48)})
+    {
+      for (const size_t numPoints : {0, 1, 7, 8, 9, 33})
+      {
+        std::vector<uint8_t> aos(numPoints * stride);
+        for (auto& value : aos)
+          value = byte(generator);
+
+        std::vector<uint8_t> soa(numPoints * fieldSize);
+        GatherField(aos.data(), stride, fieldSize, numPoints, soa.data());
+        for (size_t i = 0; i < numPoints; ++i)
+          for (size_t b = 0; b < fieldSize; ++b)
+            ASSERT_EQ(aos[i * stride + b], soa[i * fieldSize + b]) << fieldSize << " " << stride << " " << i;
+
+        for (auto& value : soa)
+          value = byte(generator);
+        auto scattered = aos;
+        ScatterField(soa.data(), fieldSize, numPoints, stride, scattered.data());
+        for (size_t i = 0; i < numPoints; ++i)
+          for (size_t b = 0; b < stride; ++b)
+            ASSERT_EQ(b < fieldSize ? soa[i * fieldSize + b] : aos[i * stride + b], scattered[i * stride + b]);
+      }
+    }
+  }
+
+  std::vector<uint8_t> data(8 * 19);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<uint8_t>(i);
+  for (const size_t elementSize : {1, 2, 4, 8})
+  {
+    auto swapped = data;
+    SwapBytes(swapped.data(), elementSize, data.size() / elementSize);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+      const auto element = i / elementSize;
+      ASSERT_EQ(data[element * elementSize + elementSize - 1 - i % elementSize], swapped[i]);
+    }
+  }
+  EXPECT_THROW(SwapBytes(data.data(), 3, 1), std::runtime_error);
+}
+
+TEST(PointDataSoA, Extract)  // NOLINT
+{
+  const auto msg = createPointData(100);
+
+  PointDataSoAView soa(msg, {"ring", "normal", "reflectivity"});
+  ASSERT_EQ(100, soa.NumPoints());
+  ASSERT_EQ(3, soa.GetFields().size());
+  EXPECT_EQ("ring", soa.GetFields()[0].name);
+  EXPECT_TRUE(soa.HasField("normal"));
+  EXPECT_FALSE(soa.HasField("time"));
+
+  const auto reflectivity = soa.Get<float>("reflectivity");
+  const auto ring = soa.Get<uint16_t>("ring");
+  const auto normal = soa.Get<float>("normal");
+  for (size_t i = 0; i < soa.NumPoints(); ++i)
+  {
+    EXPECT_EQ(i * 0.5f, reflectivity[i]);
+    EXPECT_EQ(i % 128, ring[i]);
+    EXPECT_EQ(i, normal[3 * i]);
+    EXPECT_EQ(-static_cast<float>(i), normal[3 * i + 1]);
+    EXPECT_EQ(1.0f, normal[3 * i + 2]);
+  }
+
+  EXPECT_THROW(soa.Get<double>("reflectivity"), std::runtime_error);
+  EXPECT_THROW(soa.Get<float>("time"), std::runtime_error);
+  EXPECT_THROW(soa.Extract(msg, {"nonexistent"}), std::runtime_error);
+  EXPECT_EQ(3, soa.GetFields().size());
+
+  soa.Extract(msg, {});
+  EXPECT_EQ(4, soa.GetFields().size());
+  EXPECT_EQ(99e-6, soa.Get<double>("time")[99]);
+
+  // extracting the same fields of another scan reuses the buffers
+  const auto* fields = soa.GetFields().data();
+  const auto* time = soa.Get<double>("time");
+  soa.Extract(createPointData(100), {});
+  EXPECT_EQ(fields, soa.GetFields().data());
+  EXPECT_EQ(time, soa.Get<double>("time"));
+  EXPECT_EQ(99e-6, soa.Get<double>("time")[99]);
+}
+
+TEST(PointDataSoA, Endianness)  // NOLINT
+{
+  auto msg = createPointData(20);
+  const PointDataSoAView host(msg, {});
+
+  // convert the data to the other endianness
+  PointDataSoAView converted(msg, {});
+  msg.is_bigendian = !msg.is_bigendian;
+  converted.Scatter(msg);
+  EXPECT_NE(msg.data, createPointData(20).data);
+
+  const PointDataSoAView soa(msg, {"time", "ring"});
+  for (size_t i = 0; i < 20; ++i)
+  {
+    EXPECT_EQ(host.Get<double>("time")[i], soa.Get<double>("time")[i]);
+    EXPECT_EQ(host.Get<uint16_t>("ring")[i], soa.Get<uint16_t>("ring")[i]);
+  }
+
+  PointData packed;
+  soa.Pack(packed);
+  EXPECT_NE(static_cast<bool>(msg.is_bigendian), static_cast<bool>(packed.is_bigendian));
+  PointDataConstIterator<uint16_t> it(packed, "ring");
+  EXPECT_EQ(5, (it + 5)[0]);
+}
+
+TEST(PointDataSoA, ScatterAndPack)  // NOLINT
+{
+  auto msg = createPointData(50);
+  const auto original = msg;
+
+  PointDataSoAView soa(msg, {"reflectivity"});
+  for (size_t i = 0; i < soa.NumPoints(); ++i)
+    soa.Get<float>("reflectivity")[i] *= 2;
+  soa.Scatter(msg);
+
+  PointDataConstIterator<float> fit(msg, "reflectivity");
+  PointDataConstIterator<uint16_t> rit(msg, "ring");
+  for (size_t i = 0; i < 50; ++i, ++fit, ++rit)
+  {
+    EXPECT_EQ(i * 1.0f, *fit);
+    EXPECT_EQ(i % 128, *rit);
+  }
+
+  soa.AddField("label", PointField::UINT8);
+  EXPECT_THROW(soa.AddField("label", PointField::UINT8), std::runtime_error);
+  soa.Get<uint8_t>("label")[3] = 7;
+
+  // the original data don't have the new field
+  EXPECT_THROW(soa.Scatter(msg), std::runtime_error);
+
+  PointData packed;
+  soa.Pack(packed);
+  ASSERT_EQ(2, packed.fields.size());
+  EXPECT_EQ(0, packed.fields[0].offset);
+  EXPECT_EQ(4, packed.fields[1].offset);
+  EXPECT_EQ(5, packed.point_step);
+  EXPECT_EQ(50 * 5, packed.data.size());
+  PointDataConstIterator<uint8_t> lit(packed, "label");
+  EXPECT_EQ(7, (lit + 3)[0]);
+  EXPECT_EQ(0, (lit + 4)[0]);
+
+  // scattering into PointData with a different number of points fails
+  soa.Resize(10);
+  EXPECT_THROW(soa.Scatter(msg), std::runtime_error);
+
+  // full round trip
+  PointDataSoAView all(original, {});
+  PointData repacked;
+  all.Pack(repacked);
+  EXPECT_EQ(original, repacked);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
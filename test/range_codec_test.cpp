@@ -0,0 +1,185 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/RangeCodec.h>
+#include <multilayer_laser_scan/RangeEncoding.h>
+
+#include <cmath>
+#include <random>
+
+#include "test_scans.h"
+
+using namespace sensor_msgs;
+
+MultiLayerLaserScan createScan(const size_t numScans, const size_t subscanLength)
+{
+  auto msg = CreateRegularLayoutScan(numScans, subscanLength, -M_PI, M_PI, -0.3, 0.3, ros::Duration(0.1 / numScans));
+  msg.range_max = 100.0f;
+
+  // each ring sees a smooth surface with a few jumps and invalid points
+  std::mt19937 generator(1);
+  std::normal_distribution<float> noise(0.0f, 0.003f);
+  msg.ranges.resize(numScans * subscanLength);
+  for (size_t scan = 0; scan < numScans; ++scan)
+  {
+    for (size_t ring = 0; ring < subscanLength; ++ring)
+    {
+      auto range = 5.0f + 2.0f * std::sin(scan * 0.02f) + 0.1f * ring + noise(generator);
+      if (scan % 97 == 50)
+        range = 40.0f;
+      if ((scan * subscanLength + ring) % 211 == 0)
+        range = std::numeric_limits<float>::quiet_NaN();
+      msg.ranges[scan * subscanLength + ring] = range;
+    }
+  }
+
+  return msg;
+}
+
+TEST(RangeCodec, RoundTrip)  // NOLINT
+{
+  std::mt19937 generator(2);
+  std::uniform_int_distribution<uint16_t> distribution;
+  for (const auto predictor : {RangeCodec::PREDICT_PREVIOUS, RangeCodec::PREDICT_LINEAR})
+  {
+    RangeCodec codec(predictor);
+    EXPECT_EQ(predictor, codec.GetPredictor());
+
+    // sizes not divisible by the block size, and empty scans
+    for (const auto& size : {std::make_pair(0, 0), std::make_pair(1, 1), std::make_pair(7, 3),
+                            std::make_pair(100, 13), std::make_pair(1024, 64)})
+    {
+      std::vector<uint16_t> raw(size.first * size.second);
+      // random data including the extremes which test the modular residuals
+      for (auto& value : raw)
+        value = distribution(generator);
+      if (!raw.empty())
+      {
+        raw[0] = 65535;
+        raw[raw.size() / 2] = 0;
+      }
+
+      std::vector<uint8_t> encoded;
+      const auto stats = codec.Encode(raw.data(), size.first, size.second, encoded);
+      EXPECT_EQ(raw.size() * 2, stats.rawBytes);
+      EXPECT_EQ(encoded.size(), stats.encodedBytes);
+
+      std::vector<uint16_t> decoded;
+      size_t numScans;
+      size_t subscanLength;
+      codec.Decode(encoded.data(), encoded.size(), decoded, &numScans, &subscanLength);
+      EXPECT_EQ(raw, decoded);
+      EXPECT_EQ(size.first, numScans);
+      EXPECT_EQ(size.second, subscanLength);
+
+      // the predictor is read from the stream
+      RangeCodec otherCodec(predictor == RangeCodec::PREDICT_LINEAR ?
+        RangeCodec::PREDICT_PREVIOUS : RangeCodec::PREDICT_LINEAR);
+      otherCodec.Decode(encoded.data(), encoded.size(), decoded);
+      EXPECT_EQ(raw, decoded);
+    }
+  }
+}
+
+TEST(RangeCodec, CompressionRatio)  // NOLINT
+{
+  const auto msg = createScan(1024, 64);
+  CompressedMultiLayerLaserScan compressed;
+  CompressScan(msg, compressed, ChannelEncoding::Scaled(0.001f));
+
+  for (const auto predictor : {RangeCodec::PREDICT_PREVIOUS, RangeCodec::PREDICT_LINEAR})
+  {
+    RangeCodec codec(predictor);
+    std::vector<uint8_t> encoded;
+    const auto stats = codec.Encode(compressed.ranges.data(), 1024, 64, encoded);
+    // 3 mm noise at 1 mm resolution needs about 5 bits per point instead of 16
+    EXPECT_GT(stats.CompressionRatio(), 2.0) << predictor;
+
+    std::vector<uint16_t> decoded;
+    codec.Decode(encoded.data(), encoded.size(), decoded);
+    EXPECT_EQ(compressed.ranges, decoded);
+  }
+}
+
+TEST(RangeCodec, CorruptedData)  // NOLINT
+{
+  const auto msg = createScan(100, 16);
+  CompressedMultiLayerLaserScan compressed;
+  CompressScan(msg, compressed, ChannelEncoding::Scaled(0.001f));
+
+  RangeCodec codec;
+  std::vector<uint8_t> encoded;
+  codec.Encode(compressed.ranges.data(), 100, 16, encoded);
+  std::vector<uint16_t> decoded;
+
+  EXPECT_THROW(codec.Decode(encoded.data(), 10, decoded), std::runtime_error);
+  EXPECT_THROW(codec.Decode(encoded.data(), encoded.size() - 1, decoded), std::runtime_error);
+  EXPECT_THROW(codec.Decode(encoded.data(), encoded.size() / 2, decoded), std::runtime_error);
+
+  auto extra = encoded;
+  extra.push_back(0);
+  EXPECT_THROW(codec.Decode(extra.data(), extra.size(), decoded), std::runtime_error);
+
+  auto badMagic = encoded;
+  badMagic[0] = 'X';
+  EXPECT_THROW(codec.Decode(badMagic.data(), badMagic.size(), decoded), std::runtime_error);
+
+  auto badWidth = encoded;
+  badWidth[16] = 17;
+  EXPECT_THROW(codec.Decode(badWidth.data(), badWidth.size(), decoded), std::runtime_error);
+
+  auto hugeSize = encoded;
+  hugeSize[11] = 0xFF;
+  EXPECT_THROW(codec.Decode(hugeSize.data(), hugeSize.size(), decoded), std::runtime_error);
+
+  EXPECT_NO_THROW(codec.Decode(encoded.data(), encoded.size(), decoded));
+}
+
+TEST(RangeCodec, PackRanges)  // NOLINT
+{
+  const auto msg = createScan(360, 16);
+  CompressedMultiLayerLaserScan compressed;
+  CompressScan(msg, compressed, ChannelEncoding::Scaled(0.001f));
+  const auto ranges = compressed.ranges;
+
+  auto packed = compressed;
+  const auto stats = PackRanges(packed, RangeCodec::PREDICT_LINEAR);
+  EXPECT_TRUE(packed.ranges.empty());
+  EXPECT_EQ(packed.packed_ranges.size(), stats.encodedBytes);
+  EXPECT_LT(packed.packed_ranges.size(), ranges.size());
+
+  // decompression unpacks the ranges transparently
+  MultiLayerLaserScan decompressed;
+  MultiLayerLaserScan expected;
+  DecompressScan(packed, decompressed);
+  DecompressScan(compressed, expected);
+  ASSERT_EQ(expected.ranges.size(), decompressed.ranges.size());
+  for (size_t i = 0; i < expected.ranges.size(); ++i)
+  {
+    if (std::isnan(expected.ranges[i]))
+      EXPECT_TRUE(std::isnan(decompressed.ranges[i]));
+    else
+      EXPECT_EQ(expected.ranges[i], decompressed.ranges[i]);
+  }
+
+  UnpackRanges(packed);
+  EXPECT_TRUE(packed.packed_ranges.empty());
+  EXPECT_EQ(ranges, packed.ranges);
+
+  // unpacking a scan without packed ranges does nothing
+  UnpackRanges(packed);
+  EXPECT_EQ(ranges, packed.ranges);
+
+  // layout mismatch
+  PackRanges(packed);
+  packed.scan_layout.angular_offsets.samples = 100;
+  EXPECT_THROW(UnpackRanges(packed), std::runtime_error);
+  EXPECT_FALSE(packed.packed_ranges.empty());
+
+  compressed.ranges.pop_back();
+  EXPECT_THROW(PackRanges(compressed), std::runtime_error);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,226 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/CompressedScanIterator.h>
+#include <multilayer_laser_scan/RangeEncoding.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+
+#include <cmath>
+#include <limits>
+
+#include "test_scans.h"
+
+using namespace sensor_msgs;
+
+MultiLayerLaserScan createScan()
+{
+  auto msg = CreateRegularLayoutScan(100, 13, -M_PI, M_PI, -0.3, 0.3, ros::Duration(0.1 / 100));
+  msg.range_min = 0.5f;
+  msg.range_max = 120.0f;
+
+  msg.ranges.resize(100 * 13);
+  msg.intensities.resize(100 * 13);
+  for (size_t i = 0; i < msg.ranges.size(); ++i)
+  {
+    msg.ranges[i] = 0.5f + 0.0917f * i;
+    msg.intensities[i] = 0.37f * i;
+  }
+  // a few invalid measurements
+  msg.ranges[3] = std::numeric_limits<float>::quiet_NaN();
+  msg.ranges[17] = std::numeric_limits<float>::infinity();
+  msg.ranges[18] = -1.0f;
+
+  return msg;
+}
+
+TEST(RangeEncoding, HalfConversion)  // NOLINT
+{
+  // exhaustively check that all finite halves survive the round-trip
+  for (uint32_t h = 0; h < 0x10000u; ++h)
+  {
+    const auto f = HalfToFloat(static_cast<uint16_t>(h));
+    if (std::isnan(f))
+      EXPECT_TRUE(std::isnan(HalfToFloat(FloatToHalf(f)))) << h;
+    else
+      EXPECT_EQ(h, FloatToHalf(f)) << h;
+  }
+
+  EXPECT_EQ(0x3C00u, FloatToHalf(1.0f));
+  EXPECT_EQ(0xC000u, FloatToHalf(-2.0f));
+  EXPECT_EQ(0x7BFFu, FloatToHalf(65504.0f));
+  EXPECT_EQ(0x7C00u, FloatToHalf(65520.0f));
+  EXPECT_EQ(0x0001u, FloatToHalf(5.9604644775390625e-8f));
+  EXPECT_EQ(0x0000u, FloatToHalf(2.98023223876953125e-8f));  // ties to even
+  EXPECT_EQ(0x3C00u, FloatToHalf(1.0f + 1.0f / 2048));  // ties to even
+  EXPECT_EQ(0x3C02u, FloatToHalf(1.0f + 3.0f / 2048));  // ties to even
+  EXPECT_EQ(0x3C01u, FloatToHalf(1.0f + 1.1f / 2048));
+}
+
+TEST(RangeEncoding, HalfArrays)  // NOLINT
+{
+  // the arrays are long enough to exercise both the vectorized and scalar parts
+  std::vector<float> values;
+  for (int i = -1000; i < 1003; ++i)
+    values.push_back(0.0371f * static_cast<float>(i * i) * (i < 0 ? -1.0f : 1.0f));
+  values.push_back(std::numeric_limits<float>::quiet_NaN());
+  values.push_back(1e6f);
+
+  std::vector<uint16_t> raw(values.size());
+  EncodeHalf(values.data(), values.size(), raw.data());
+  std::vector<float> decoded(values.size());
+  DecodeHalf(raw.data(), raw.size(), decoded.data());
+
+  for (size_t i = 0; i + 2 < values.size(); ++i)
+  {
+    EXPECT_EQ(FloatToHalf(values[i]), raw[i]) << i;
+    EXPECT_NEAR(values[i], decoded[i], std::abs(values[i]) / 2048 + 3e-8) << i;
+  }
+  EXPECT_TRUE(std::isnan(decoded[values.size() - 2]));
+  EXPECT_TRUE(std::isinf(decoded[values.size() - 1]));
+}
+
+TEST(RangeEncoding, ScaledArrays)  // NOLINT
+{
+  const auto encoding = ChannelEncoding::Scaled(0.002f, 0.1f);
+  EXPECT_FLOAT_EQ(0.001f, encoding.Precision());
+
+  std::vector<float> values;
+  for (size_t i = 0; i < 1003; ++i)
+    values.push_back(0.1f + 0.1307f * i);
+  values[5] = std::numeric_limits<float>::quiet_NaN();
+  values[6] = 0.0f;  // below offset
+  values[7] = 0.1f + 0.002f * 65534;  // the largest valid value
+  values[8] = 0.1f + 0.002f * 65535;  // too large
+  values[9] = std::numeric_limits<float>::infinity();
+  values[1002] = -std::numeric_limits<float>::infinity();  // in the scalar part
+
+  std::vector<uint16_t> raw(values.size());
+  Encode(values.data(), values.size(), encoding, raw.data());
+  std::vector<float> decoded(values.size());
+  Decode(raw.data(), raw.size(), encoding, decoded.data());
+
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    if (i == 5 || i == 6 || i == 8 || i == 9 || i == 1002)
+    {
+      EXPECT_EQ(SCALED_INVALID, raw[i]) << i;
+      EXPECT_TRUE(std::isnan(decoded[i])) << i;
+    }
+    else
+    {
+      EXPECT_NEAR(values[i], decoded[i], encoding.Precision() + 1e-4) << i;
+      EXPECT_FLOAT_EQ(DecodeValue(raw[i], encoding), decoded[i]) << i;
+    }
+  }
+  EXPECT_EQ(65534, raw[7]);
+
+  // decoding and encoding again is lossless
+  std::vector<uint16_t> raw2(values.size());
+  Encode(decoded.data(), decoded.size(), encoding, raw2.data());
+  EXPECT_EQ(raw, raw2);
+}
+
+TEST(RangeEncoding, ScaledRange)  // NOLINT
+{
+  const auto encoding = ChannelEncoding::ScaledRange(0.0f, 120.0f);
+  EXPECT_NEAR(120.0 / 131068, encoding.Precision(), 1e-8);
+
+  const float values[] = {0.0f, 60.0f, 120.0f};
+  uint16_t raw[3];
+  Encode(values, 3, encoding, raw);
+  EXPECT_EQ(0, raw[0]);
+  EXPECT_NE(SCALED_INVALID, raw[2]);
+  for (size_t i = 0; i < 3; ++i)
+    EXPECT_NEAR(values[i], DecodeValue(raw[i], encoding), encoding.Precision() + 1e-4);
+
+  EXPECT_THROW(ChannelEncoding::ScaledRange(1.0f, 1.0f), std::runtime_error);
+  EXPECT_THROW(ChannelEncoding::Scaled(0.0f), std::runtime_error);
+}
+
+TEST(RangeEncoding, CompressScan)  // NOLINT
+{
+  const auto msg = createScan();
+
+  CompressedMultiLayerLaserScan compressed;
+  CompressScan(msg, compressed);
+  EXPECT_EQ(CompressedMultiLayerLaserScan::ENCODING_UINT16_SCALED, compressed.range_encoding);
+  EXPECT_EQ(CompressedMultiLayerLaserScan::ENCODING_FLOAT16, compressed.intensity_encoding);
+  EXPECT_EQ(msg.ranges.size(), compressed.ranges.size());
+  EXPECT_EQ(msg.intensities.size(), compressed.intensities.size());
+  EXPECT_EQ(msg.header.stamp, compressed.header.stamp);
+  EXPECT_EQ(msg.scan_layout, compressed.scan_layout);
+
+  MultiLayerLaserScan decompressed;
+  DecompressScan(compressed, decompressed);
+  const auto rangePrecision = GetRangeEncoding(compressed).Precision() + 1e-4;
+  for (size_t i = 0; i < msg.ranges.size(); ++i)
+  {
+    if (i == 3 || i == 17 || i == 18)
+      EXPECT_TRUE(std::isnan(decompressed.ranges[i])) << i;
+    else
+      EXPECT_NEAR(msg.ranges[i], decompressed.ranges[i], rangePrecision) << i;
+    EXPECT_NEAR(msg.intensities[i], decompressed.intensities[i],
+      msg.intensities[i] / 2048 + 1e-7) << i;
+  }
+
+  // recompressing the decompressed scan gives the same message
+  CompressedMultiLayerLaserScan recompressed;
+  CompressScan(decompressed, recompressed, GetRangeEncoding(compressed), GetIntensityEncoding(compressed));
+  EXPECT_EQ(compressed.ranges, recompressed.ranges);
+  EXPECT_EQ(compressed.intensities, recompressed.intensities);
+
+  // no intensities
+  auto noIntensities = msg;
+  noIntensities.intensities.clear();
+  CompressScan(noIntensities, compressed, ChannelEncoding::Half());
+  EXPECT_TRUE(compressed.intensities.empty());
+  DecompressScan(compressed, decompressed);
+  EXPECT_TRUE(decompressed.intensities.empty());
+}
+
+TEST(RangeEncoding, Iterator)  // NOLINT
+{
+  const auto msg = createScan();
+  CompressedMultiLayerLaserScan compressed;
+  CompressScan(msg, compressed, ChannelEncoding::Scaled(0.001f));
+  MultiLayerLaserScan decompressed;
+  DecompressScan(compressed, decompressed);
+
+  std::shared_ptr<const MultiLayerLaserScanLayout> layout(new MultiLayerLaserScanLayout(compressed));
+  ASSERT_EQ(msg.ranges.size(), layout->Length());
+
+  CompressedMultiLayerLaserScanBaseFieldsConstIterator it(compressed, layout);
+  MultiLayerLaserScanBaseFieldsConstIterator expectedIt(decompressed, layout);
+  size_t n = 0;
+  for (; it != it.end(); ++it, ++expectedIt, ++n)
+  {
+    const auto fields = *it;
+    const auto expected = *expectedIt;
+    EXPECT_EQ(expected.scanAngle, fields.scanAngle);
+    EXPECT_EQ(expected.subscanAngle, fields.subscanAngle);
+    EXPECT_EQ(expected.timestamp, fields.timestamp);
+    if (std::isnan(*expected.range))
+      EXPECT_TRUE(std::isnan(fields.range));
+    else
+      EXPECT_FLOAT_EQ(*expected.range, fields.range);
+    EXPECT_FLOAT_EQ(*expected.intensity, fields.intensity);
+  }
+  EXPECT_EQ(msg.ranges.size(), n);
+
+  const auto begin = it.begin();
+  EXPECT_EQ(static_cast<std::ptrdiff_t>(n), it - begin);
+  EXPECT_FLOAT_EQ(decompressed.ranges[100], begin[100].range);
+  EXPECT_FLOAT_EQ(decompressed.ranges[100], (*(50 + begin + 50)).range);
+  EXPECT_TRUE(begin < it);
+  EXPECT_TRUE(std::isnan(begin[3].range));
+
+  compressed.intensities.clear();
+  EXPECT_TRUE(std::isnan((*CompressedMultiLayerLaserScanBaseFieldsConstIterator(compressed, layout)).intensity));
+
+  compressed.range_encoding = 42;
+  EXPECT_THROW(CompressedMultiLayerLaserScanBaseFieldsConstIterator(compressed, layout), std::runtime_error);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
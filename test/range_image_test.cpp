@@ -0,0 +1,153 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/RangeImage.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "test_scans.h"
+
+using namespace sensor_msgs;
+
+namespace
+{
+
+// 4 subscans with 3 rings each
+MultiLayerLaserScan createScan()
+{
+  auto msg = CreateRegularLayoutScan(4, 3, 0, 2 * M_PI, -0.1, 0.1, ros::Duration(0.025));
+  msg.header.frame_id = "laser";
+
+  for (size_t i = 0; i < 12; ++i)
+  {
+    msg.ranges.push_back(i);
+    msg.intensities.push_back(100 + i);
+  }
+
+  PointDataModifier mod(msg.custom_data);
+  mod.setFieldsByString(2, "reflectivity", "ring");
+  mod.resize(12);
+  PointDataIterator<uint16_t> rit(msg.custom_data, "ring");
+  for (size_t i = 0; i < 12; ++i, ++rit)
+    *rit = 1000 + i;
+
+  return msg;
+}
+
+}
+
+TEST(RangeImage, Views)  // NOLINT
+{
+  auto msg = createScan();
+  const MultiLayerLaserScanLayout layout(msg);
+
+  const auto ranges = GetRangeImage(msg, layout);
+  ASSERT_EQ(3, ranges.Rows());
+  ASSERT_EQ(4, ranges.Cols());
+  EXPECT_FALSE(ranges.HasContiguousRows());
+  EXPECT_TRUE(ranges.Transposed().HasContiguousRows());
+
+  const auto intensities = GetIntensityImage(static_cast<const MultiLayerLaserScan&>(msg), layout);
+  const auto rings = GetCustomFieldImage<uint16_t>(msg, layout, "ring");
+  for (size_t ring = 0; ring < 3; ++ring)
+  {
+    for (size_t col = 0; col < 4; ++col)
+    {
+      EXPECT_EQ(col * 3 + ring, ranges(ring, col));
+      EXPECT_EQ(ranges(ring, col), ranges.Transposed()(col, ring));
+      EXPECT_EQ(100 + col * 3 + ring, intensities(ring, col));
+      EXPECT_EQ(1000 + col * 3 + ring, rings(ring, col));
+    }
+  }
+
+  // the views point into the scan
+  ranges(2, 1) = -1.0f;
+  EXPECT_EQ(-1.0f, msg.ranges[5]);
+  rings(1, 3) = 7;
+  PointDataConstIterator<uint16_t> rit(msg.custom_data, "ring");
+  EXPECT_EQ(7, (rit + 10)[0]);
+}
+
+TEST(RangeImage, RingsByElevation)  // NOLINT
+{
+  auto msg = createScan();
+  EXPECT_EQ(std::vector<size_t>({2, 1, 0}), GetRingsByElevation(MultiLayerLaserScanLayout(msg)));
+
+  // interleaved rings as in Velodyne scanners
+  msg.subscan_layout.angular_offsets.regular = false;
+  msg.subscan_layout.angular_offsets.offsets = {-0.2, 0.1, -0.1};
+  EXPECT_EQ(std::vector<size_t>({1, 2, 0}), GetRingsByElevation(MultiLayerLaserScanLayout(msg)));
+}
+
+TEST(RangeImage, Errors)  // NOLINT
+{
+  auto msg = createScan();
+  const MultiLayerLaserScanLayout layout(msg);
+
+  EXPECT_THROW(GetCustomFieldImage<uint16_t>(msg, layout, "nonexistent"), std::runtime_error);
+  EXPECT_THROW(GetCustomFieldImage<float>(msg, layout, "ring"), std::runtime_error);
+
+  msg.custom_data.data.resize(msg.custom_data.data.size() - 1);
+  EXPECT_THROW(GetCustomFieldImage<uint16_t>(msg, layout, "ring"), std::runtime_error);
+
+  msg.intensities.clear();
+  EXPECT_THROW(GetIntensityImage(msg, layout), std::runtime_error);
+  Image image;
+  EXPECT_THROW(IntensitiesToImage(msg, layout, image), std::runtime_error);
+}
+
+TEST(RangeImage, ToImage)  // NOLINT
+{
+  const auto msg = createScan();
+  const MultiLayerLaserScanLayout layout(msg);
+
+  Image image;
+  RangesToImage(msg, layout, image);
+  EXPECT_EQ("laser", image.header.frame_id);
+  EXPECT_EQ(msg.header.stamp, image.header.stamp);
+  EXPECT_EQ(3, image.height);
+  EXPECT_EQ(4, image.width);
+  EXPECT_EQ("32FC1", image.encoding);
+  EXPECT_EQ(16, image.step);
+  ASSERT_EQ(48, image.data.size());
+  for (size_t row = 0; row < 3; ++row)
+  {
+    for (size_t col = 0; col < 4; ++col)
+    {
+      float value;
+      std::memcpy(&value, &image.data[row * image.step + col * 4], 4);
+      EXPECT_EQ(col * 3 + row, value);
+    }
+  }
+
+  RangesToImage(msg, layout, image, true);
+  EXPECT_EQ(4, image.height);
+  EXPECT_EQ(3, image.width);
+  EXPECT_EQ(12, image.step);
+  ASSERT_EQ(48, image.data.size());
+  EXPECT_EQ(0, std::memcmp(msg.ranges.data(), image.data.data(), 48));
+
+  IntensitiesToImage(msg, layout, image);
+  float value;
+  std::memcpy(&value, &image.data[2 * image.step + 3 * 4], 4);
+  EXPECT_EQ(111.0f, value);
+
+  ToImage(GetCustomFieldImage<uint16_t>(msg, layout, "ring"), image);
+  EXPECT_EQ("16UC1", image.encoding);
+  EXPECT_EQ(3, image.height);
+  EXPECT_EQ(8, image.step);
+  uint16_t ring;
+  std::memcpy(&ring, &image.data[1 * image.step + 2 * 2], 2);
+  EXPECT_EQ(1007, ring);
+
+  ToImage(GetCustomFieldImage<uint16_t>(msg, layout, "ring").Transposed(), image);
+  std::memcpy(&ring, &image.data[2 * image.step + 1 * 2], 2);
+  EXPECT_EQ(1007, ring);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,189 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/ScanAssembler.h>
+#include <multilayer_laser_scan/decoders/OusterOS1Decoder.h>
+#include <multilayer_laser_scan/decoders/VelodyneHDL32EDecoder.h>
+
+#include <cmath>
+#include <cstring>
+
+using namespace sensor_msgs;
+
+void writeUInt(uint8_t* data, uint64_t value, const size_t bytes)
+{
+  for (size_t i = 0; i < bytes; ++i, value >>= 8)
+    data[i] = static_cast<uint8_t>(value & 0xFF);
+}
+
+std::vector<uint8_t> createVelodynePacket(const uint16_t firstAzimuth, const uint16_t azimuthIncrement)
+{
+  std::vector<uint8_t> packet(VelodyneHDL32EDecoder::PACKET_SIZE);
+  for (size_t b = 0; b < VelodyneHDL32EDecoder::BLOCKS_PER_PACKET; ++b)
+  {
+    auto* block = &packet[b * VelodyneHDL32EDecoder::BLOCK_SIZE];
+    writeUInt(block, VelodyneHDL32EDecoder::BLOCK_FLAG, 2);
+    writeUInt(block + 2, (firstAzimuth + b * azimuthIncrement) % 36000, 2);
+    for (size_t i = 0; i < VelodyneHDL32EDecoder::LASERS; ++i)
+    {
+      writeUInt(block + 4 + 3 * i, 1000 + 10 * b + i, 2);
+      block[4 + 3 * i + 2] = static_cast<uint8_t>(i);
+    }
+  }
+  return packet;
+}
+
+std::vector<uint8_t> createOusterPacket(const double firstEncoderAngle, const uint64_t firstTimestamp)
+{
+  std::vector<uint8_t> packet(OusterOS1Decoder::PACKET_SIZE);
+  for (size_t c = 0; c < OusterOS1Decoder::COLUMNS_PER_PACKET; ++c)
+  {
+    auto* column = &packet[c * OusterOS1Decoder::COLUMN_SIZE];
+    writeUInt(column, firstTimestamp + c * 100000, 8);
+    // one column per degree
+    const auto encoder = std::lround((firstEncoderAngle + c) / 360 * OusterOS1Decoder::ENCODER_TICKS_PER_REV);
+    writeUInt(column + 12, encoder % OusterOS1Decoder::ENCODER_TICKS_PER_REV, 4);
+    for (size_t i = 0; i < OusterOS1Decoder::BEAMS; ++i)
+    {
+      auto* pixel = column + OusterOS1Decoder::COLUMN_HEADER_SIZE + i * OusterOS1Decoder::PIXEL_SIZE;
+      writeUInt(pixel, 0xFFF00000 | (2000 + 10 * c + i), 4);  // the upper bits are not range
+      writeUInt(pixel + 4, 500 + i, 2);
+      writeUInt(pixel + 6, 1000 + c, 2);
+    }
+    // the last column is invalid
+    if (c + 1 < OusterOS1Decoder::COLUMNS_PER_PACKET)
+      writeUInt(column + OusterOS1Decoder::COLUMN_SIZE - 4, OusterOS1Decoder::VALID_COLUMN_STATUS, 4);
+  }
+  return packet;
+}
+
+TEST(ScanAssembler, VelodyneHDL32E)
+{
+  std::vector<MultiLayerLaserScan> scans;
+  ScanAssembler assembler(std::make_shared<VelodyneHDL32EDecoder>(), "velodyne", 0.0,
+    [&scans](const MultiLayerLaserScan& scan) { scans.push_back(scan); });
+
+  const ros::Time stamp(10.0);
+  const auto packetDuration = ros::Duration(12 * VelodyneHDL32EDecoder::BLOCK_FIRING_PERIOD);
+  // azimuth 358 deg to 5 deg, crossing the cut angle at azimuth 0
+  for (size_t p = 0; p < 3; ++p)
+  {
+    const auto packet = createVelodynePacket(35800 + p * 240, 20);
+    assembler.AddPacket(packet.data(), packet.size(), stamp + ros::Duration(p * packetDuration.toSec()));
+  }
+
+  ASSERT_EQ(1, scans.size());
+  EXPECT_EQ(26, assembler.GetNumSubscans());
+  assembler.Flush();
+  ASSERT_EQ(2, scans.size());
+  EXPECT_EQ(0, assembler.GetNumSubscans());
+  assembler.Flush();
+  EXPECT_EQ(2, scans.size());
+
+  const auto& scan = scans[0];
+  EXPECT_EQ("velodyne", scan.header.frame_id);
+  EXPECT_EQ(stamp, scan.header.stamp);
+  ASSERT_EQ(10 * 32, scan.ranges.size());
+  ASSERT_EQ(10 * 32, scan.intensities.size());
+  EXPECT_TRUE(scan.custom_data.data.empty());
+
+  MultiLayerLaserScanLayout layout(scan);
+  ASSERT_EQ(10 * 32, layout.Length());
+  for (size_t b = 0; b < 10; ++b)
+  {
+    SCOPED_TRACE(b);
+    EXPECT_NEAR((2.0 - 0.2 * b) * M_PI / 180, layout.GetScanLayout().GetAngle(b), 1e-9);
+    EXPECT_NEAR(b * VelodyneHDL32EDecoder::BLOCK_FIRING_PERIOD, layout.GetScanLayout().GetTime(b).toSec(), 1e-8);
+    for (size_t i = 0; i < 32; ++i)
+    {
+      EXPECT_FLOAT_EQ((1000 + 10 * b + i) * 0.002f, scan.ranges[b * 32 + i]);
+      EXPECT_EQ(i, scan.intensities[b * 32 + i]);
+    }
+  }
+  EXPECT_NEAR(-30.67 * M_PI / 180, layout.GetSubscanAngle(0), 1e-9);
+  EXPECT_NEAR(10.67 * M_PI / 180, layout.GetSubscanAngle(31), 1e-9);
+  EXPECT_NEAR(31 * VelodyneHDL32EDecoder::LASER_FIRING_PERIOD, layout.GetTime(31).toSec(), 1e-8);
+  EXPECT_LT(layout.GetScanAngle(31), layout.GetScanAngle(0));
+
+  const auto& scan2 = scans[1];
+  EXPECT_EQ(26 * 32, scan2.ranges.size());
+  EXPECT_NEAR(stamp.toSec() + 10 * VelodyneHDL32EDecoder::BLOCK_FIRING_PERIOD, scan2.header.stamp.toSec(), 1e-8);
+  EXPECT_NEAR(0.0, scan2.scan_layout.angular_offsets.offsets[0], 1e-9);
+  EXPECT_FLOAT_EQ((1000 + 10 * 10) * 0.002f, scan2.ranges[0]);
+}
+
+TEST(ScanAssembler, VelodyneHDL32EErrors)
+{
+  ScanAssembler assembler(std::make_shared<VelodyneHDL32EDecoder>(), "velodyne", 0.0,
+    [](const MultiLayerLaserScan&) {});
+
+  auto packet = createVelodynePacket(0, 20);
+  EXPECT_THROW(assembler.AddPacket(packet.data(), packet.size() - 1, ros::Time(1)), std::runtime_error);
+
+  packet[VelodyneHDL32EDecoder::BLOCK_SIZE] = 0;
+  EXPECT_THROW(assembler.AddPacket(packet.data(), packet.size(), ros::Time(1)), std::runtime_error);
+
+  VelodyneHDL32EDecoder decoder;
+  EXPECT_THROW(decoder.Configure({{"range_min", {1.0, 2.0}}}), std::runtime_error);
+}
+
+TEST(ScanAssembler, OusterOS1)
+{
+  auto decoder = std::make_shared<OusterOS1Decoder>();
+  std::vector<double> altitudes(64), azimuths(64, 0.0);
+  for (size_t i = 0; i < 64; ++i)
+    altitudes[i] = 16.0 - 0.5 * i;
+  decoder->Configure({{"beam_altitude_angles", altitudes}, {"beam_azimuth_angles", azimuths}});
+  EXPECT_THROW(decoder->Configure({{"beam_altitude_angles", {1.0}}}), std::runtime_error);
+
+  std::vector<MultiLayerLaserScan> scans;
+  ScanAssembler assembler(decoder, "os1", M_PI_2,
+    [&scans](const MultiLayerLaserScan& scan) { scans.push_back(scan); });
+
+  // encoder angle 80 deg to 111 deg, the cut angle is crossed at encoder angle 90 deg
+  const ros::Time stamp(20.0);
+  for (size_t p = 0; p < 2; ++p)
+  {
+    const auto packet = createOusterPacket(80 + 16 * p, 1000000000ull + p * 1600000);
+    assembler.AddPacket(packet.data(), packet.size(), stamp + ros::Duration(p * 0.0016));
+  }
+  assembler.Flush();
+
+  ASSERT_EQ(2, scans.size());
+  const auto& scan = scans[0];
+  ASSERT_EQ(10 * 64, scan.ranges.size());  // columns 80 - 89 deg
+  ASSERT_EQ(10 * 64, scan.intensities.size());
+  ASSERT_EQ(1, scan.custom_data.fields.size());
+  EXPECT_EQ("reflectivity", scan.custom_data.fields[0].name);
+  EXPECT_EQ(PointField::UINT16, scan.custom_data.fields[0].datatype);
+  ASSERT_EQ(10 * 64 * 2, scan.custom_data.data.size());
+
+  MultiLayerLaserScanLayout layout(scan);
+  for (size_t c = 0; c < 10; ++c)
+  {
+    SCOPED_TRACE(c);
+    EXPECT_NEAR(M_PI - (80.0 + c) * M_PI / 180, layout.GetScanLayout().GetAngle(c), 1e-4);
+    EXPECT_NEAR(c * 1e-4, layout.GetScanLayout().GetTime(c).toSec(), 1e-9);
+    for (size_t i = 0; i < 64; ++i)
+    {
+      EXPECT_FLOAT_EQ((2000 + 10 * c + i) * 0.001f, scan.ranges[c * 64 + i]);
+      EXPECT_EQ(1000 + c, scan.intensities[c * 64 + i]);
+      uint16_t reflectivity;
+      std::memcpy(&reflectivity, &scan.custom_data.data[(c * 64 + i) * 2], 2);
+      EXPECT_EQ(500 + i, reflectivity);
+    }
+  }
+  EXPECT_NEAR(16.0 * M_PI / 180, layout.GetSubscanAngle(0), 1e-9);
+  EXPECT_NEAR(-15.5 * M_PI / 180, layout.GetSubscanAngle(63), 1e-9);
+
+  // columns 90 - 94 deg and 96 - 110 deg, the last column of each packet is invalid
+  const auto& scan2 = scans[1];
+  EXPECT_EQ(20 * 64, scan2.ranges.size());
+  EXPECT_EQ(stamp + ros::Duration(10 * 1e-4), scan2.header.stamp);
+  EXPECT_NEAR(M_PI_2, scan2.scan_layout.angular_offsets.offsets[0], 1e-9);
+  EXPECT_NEAR(0.0016 + 1e-4 - 10 * 1e-4, scan2.scan_layout.time_offsets.offsets[6].toSec(), 1e-9);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
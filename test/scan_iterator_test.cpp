@@ -1,6 +1,11 @@
 #include "gtest/gtest.h"
 #include <multilayer_laser_scan/scan_iterator.h>
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
 using namespace sensor_msgs;
 
 TEST(ScanIterator, Simple)
@@ -386,6 +391,66 @@ TEST(ScanIterator, ConstructPointDataFromString)
   ASSERT_EQ(2, msg.fields.size());
 }
 
+TEST(ScanIterator, AppendPointDataFromString)
+{
+  PointData msg;
+  PointDataModifier mod(msg);
+
+  mod.setFieldsByString(1, "ring");
+  mod.resize(3);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    const auto ring = static_cast<uint16_t>(10 + i);
+    std::memcpy(&msg.data[i * msg.point_step], &ring, sizeof(ring));
+  }
+
+  mod.appendFieldsByString(2, "normal", "rgba");
+
+  ASSERT_EQ(3, msg.fields.size());
+  EXPECT_EQ("ring", msg.fields[0].name);
+  EXPECT_EQ(0, msg.fields[0].offset);
+  EXPECT_EQ("normal", msg.fields[1].name);
+  EXPECT_EQ(2, msg.fields[1].offset);
+  EXPECT_EQ("rgba", msg.fields[2].name);
+  EXPECT_EQ(14, msg.fields[2].offset);
+  EXPECT_EQ(18, msg.point_step);
+  ASSERT_EQ(54, msg.data.size());
+  EXPECT_EQ(3, mod.size());
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    uint16_t ring;
+    std::memcpy(&ring, &msg.data[i * msg.point_step], sizeof(ring));
+    EXPECT_EQ(10 + i, ring);
+    for (size_t j = 2; j < msg.point_step; ++j)
+      EXPECT_EQ(0, msg.data[i * msg.point_step + j]);
+  }
+
+  EXPECT_THROW(mod.appendFieldsByString(1, "normal"), std::runtime_error);
+  EXPECT_THROW(mod.appendFieldsByString(2, "intensity", "nonexistent"), std::runtime_error);
+  EXPECT_EQ(3, msg.fields.size());
+  EXPECT_EQ(18, msg.point_step);
+
+  // existing fields are found, missing ones are appended
+  EXPECT_EQ(2, mod.findOrAppendFieldByString("normal", 3).offset);
+  EXPECT_EQ(18, mod.findOrAppendFieldByString("label", 3).offset);
+  ASSERT_EQ(4, msg.fields.size());
+  EXPECT_EQ(19, msg.point_step);
+  EXPECT_EQ(3, mod.size());
+
+  // a different number of points is rejected before the field is added
+  EXPECT_THROW(mod.findOrAppendFieldByString("rgb", 4), std::runtime_error);
+  EXPECT_EQ(4, msg.fields.size());
+  EXPECT_EQ(19, msg.point_step);
+
+  // empty point data get the field and the requested number of points
+  PointData empty;
+  const auto& label = PointDataModifier(empty).findOrAppendFieldByString("label", 5);
+  EXPECT_EQ("label", label.name);
+  EXPECT_EQ(PointField::UINT8, label.datatype);
+  EXPECT_EQ(5, empty.data.size());
+}
+
 TEST(ScanIterator, FillDataByIterators)
 {
   MultiLayerLaserScan msg;
@@ -485,6 +550,96 @@ TEST(ScanIterator, FillDataByIterators)
   EXPECT_EQ(30, reinterpret_cast<uint8_t*>(&msg.custom_data.data[3 * step + 14])[2]);
 }
 
+TEST(ScanIterator, RandomAccess)
+{
+  MultiLayerLaserScan msg;
+
+  msg.subscan_layout.time_offsets.regular = false;
+  msg.subscan_layout.time_offsets.offsets = {ros::Duration(0.0), ros::Duration(0.1)};
+  msg.subscan_layout.angular_offsets.regular = false;
+  msg.subscan_layout.angular_offsets.offsets = {0.0, 0.1};
+
+  msg.scan_layout.time_offsets.regular = false;
+  msg.scan_layout.time_offsets.offsets = {ros::Duration(0.0), ros::Duration(1.0), ros::Duration(2.0)};
+  msg.scan_layout.angular_offsets.regular = false;
+  msg.scan_layout.angular_offsets.offsets = {0.0, 1.0, 2.0};
+
+  msg.scan_offsets_during_subscan.regular = false;
+  msg.scan_offsets_during_subscan.offsets = { 0.0, 0.0 };
+
+  msg.ranges = {1, 2, 3, 4, 5, 6};
+  msg.intensities = {7, 8, 9, 10, 11, 12};
+
+  msg.header.stamp = ros::Time(10.0);
+
+  auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+
+  typedef std::iterator_traits<MultiLayerLaserScanBaseFieldsIterator> Traits;
+  static_assert(std::is_same<Traits::iterator_category, std::random_access_iterator_tag>::value,
+                "The iterator should be random-access");
+  static_assert(std::is_same<Traits::difference_type, std::ptrdiff_t>::value,
+                "The iterator should have ptrdiff_t difference type");
+#if defined(__cpp_lib_ranges) && __cpp_lib_ranges >= 201911L
+  static_assert(std::random_access_iterator<MultiLayerLaserScanBaseFieldsIterator>,
+                "The iterator should model std::random_access_iterator");
+  static_assert(std::random_access_iterator<MultiLayerLaserScanBaseFieldsConstIterator>,
+                "The iterator should model std::random_access_iterator");
+#endif
+
+  MultiLayerLaserScanBaseFieldsIterator it(msg, layout);
+  const auto begin = it.begin();
+  const auto end = it.end();
+
+  EXPECT_EQ(6, end - begin);
+  EXPECT_EQ(-6, begin - end);
+  EXPECT_EQ(6, std::distance(begin, end));
+  EXPECT_TRUE(begin == it);
+  EXPECT_TRUE(begin < end);
+  EXPECT_TRUE(end > begin);
+  EXPECT_TRUE(begin <= it);
+  EXPECT_TRUE(begin >= it);
+  EXPECT_FALSE(begin >= end);
+
+  EXPECT_DOUBLE_EQ(4, *begin[3].range);
+  EXPECT_DOUBLE_EQ(10, *begin[3].intensity);
+  EXPECT_DOUBLE_EQ(1.0, begin[3].scanAngle);
+  EXPECT_DOUBLE_EQ(0.1, begin[3].subscanAngle);
+  EXPECT_DOUBLE_EQ(6, *(*(end - 1)).range);
+  EXPECT_DOUBLE_EQ(3, *(*(2 + begin)).range);
+
+  it += 4;
+  EXPECT_DOUBLE_EQ(5, *(*it).range);
+  it -= 3;
+  EXPECT_DOUBLE_EQ(2, *(*it).range);
+  EXPECT_DOUBLE_EQ(2, *(*it++).range);
+  EXPECT_DOUBLE_EQ(3, *(*it).range);
+  EXPECT_DOUBLE_EQ(3, *(*it--).range);
+  EXPECT_DOUBLE_EQ(1, *(*--it).range);
+  std::advance(it, 5);
+  EXPECT_DOUBLE_EQ(6, *(*it).range);
+
+  // iterate backwards
+  float expected = 6;
+  for (auto rit = end; rit != begin;)
+  {
+    --rit;
+    EXPECT_DOUBLE_EQ(expected--, *(*rit).range);
+  }
+
+  // binary search by time
+  const auto found = std::lower_bound(begin, end, ros::Time(12.05),
+    [](const MultiLayerLaserScanBaseFields<MultiLayerLaserScan, float, float>& point, const ros::Time& time)
+    {
+      return point.timestamp < time;
+    });
+  EXPECT_EQ(5, found - begin);
+  EXPECT_DOUBLE_EQ(ros::Duration(12.1).toSec(), (*found).timestamp.toSec());
+
+  MultiLayerLaserScanBaseFieldsIterator singular;
+  singular = begin;
+  EXPECT_TRUE(singular == begin);
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -830,6 +830,47 @@ TEST(ScanLayout, TestParsedScanLayout)
   EXPECT_THROW(parsed.GetAngle(3), std::out_of_range);
 }
 
+TEST(ScanLayout, TestParsedScanLayoutReset)
+{
+  ScanLayout msg;
+  msg.time_offsets.regular = true;
+  msg.time_offsets.increment = ros::Duration(1.0);
+  msg.angular_offsets.regular = true;
+  msg.angular_offsets.min = -M_PI;
+  msg.angular_offsets.max = M_PI;
+  msg.angular_offsets.samples = 5;
+
+  // regular offsets become explicit
+  ParsedScanLayout parsed(msg);
+  parsed.Reset(1.0, ros::Duration(2.0));
+  ASSERT_EQ(1, parsed.Length());
+  EXPECT_DOUBLE_EQ(1.0, parsed.GetAngle(0));
+  EXPECT_EQ(2000000000, parsed.GetTimeNSec(0));
+  ASSERT_NE(nullptr, dynamic_cast<const ExplicitAngularOffsets*>(&parsed.GetAngularOffsets()));
+  ASSERT_NE(nullptr, dynamic_cast<const ExplicitTimeOffsets*>(&parsed.GetTimeOffsets()));
+
+  for (size_t i = 1; i < 100; ++i)
+    parsed.AddOffset(1.0 + i, ros::Duration(2.0 + i));
+  const auto& angularOffsets = dynamic_cast<const ExplicitAngularOffsets&>(parsed.GetAngularOffsets());
+  const auto& timeOffsets = dynamic_cast<const ExplicitTimeOffsets&>(parsed.GetTimeOffsets());
+  const auto* angles = angularOffsets.GetOffsets().data();
+  const auto* times = timeOffsets.GetOffsets().data();
+  const auto* timesNSec = timeOffsets.GetOffsetsNSec().data();
+
+  // explicit offsets are reused and growing them again up to the previous length does not reallocate
+  parsed.Reset(-1.0, ros::Duration(0.5));
+  ASSERT_EQ(1, parsed.Length());
+  EXPECT_DOUBLE_EQ(-1.0, parsed.GetAngle(0));
+  EXPECT_EQ(500000000, parsed.GetTimeNSec(0));
+  for (size_t i = 1; i < 100; ++i)
+    parsed.AddOffset(-1.0 - i, ros::Duration(0.5 + i));
+  ASSERT_EQ(100, parsed.Length());
+  EXPECT_DOUBLE_EQ(-100.0, parsed.GetAngle(99));
+  EXPECT_EQ(angles, angularOffsets.GetOffsets().data());
+  EXPECT_EQ(times, timeOffsets.GetOffsets().data());
+  EXPECT_EQ(timesNSec, timeOffsets.GetOffsetsNSec().data());
+}
+
 TEST(ScanLayout, TestMultiLayerLaserScanLayout)
 {
   MultiLayerLaserScan msg;
@@ -900,6 +941,132 @@ TEST(ScanLayout, TestMultiLayerLaserScanLayout)
   }
 }
 
+TEST(ScanLayout, TestMultiLayerLaserScanLayoutMaterialized)
+{
+  MultiLayerLaserScan msg;
+
+  msg.scan_layout.time_offsets.regular = true;
+  msg.scan_layout.time_offsets.increment = ros::Duration(0.1);
+  msg.scan_layout.time_offsets.base_offset = ros::Duration(0.5);
+  msg.scan_layout.angular_offsets.regular = true;
+  msg.scan_layout.angular_offsets.min = -M_PI;
+  msg.scan_layout.angular_offsets.max = M_PI;
+  msg.scan_layout.angular_offsets.samples = 4;
+  msg.scan_layout.angular_offsets.exclude_last = true;
+
+  msg.subscan_layout.time_offsets.regular = false;
+  msg.subscan_layout.time_offsets.offsets = {ros::Duration(0.0), ros::Duration(0.01), ros::Duration(0.02) };
+  msg.subscan_layout.angular_offsets.regular = false;
+  msg.subscan_layout.angular_offsets.offsets = {-0.1 * M_PI, 0, 0.1 * M_PI };
+
+  msg.scan_offsets_during_subscan.regular = false;
+  msg.scan_offsets_during_subscan.offsets = { -0.1, 0, 0.1 };
+
+  msg.ranges.resize(12, 0.0);
+
+  MultiLayerLaserScanLayout parsed(msg);
+  MultiLayerLaserScanLayout materialized(msg);
+
+  EXPECT_FALSE(materialized.IsMaterialized());
+  materialized.Materialize();
+  EXPECT_TRUE(materialized.IsMaterialized());
+  // materializing twice is a no-op
+  materialized.Materialize();
+  EXPECT_TRUE(materialized.IsMaterialized());
+
+  ASSERT_EQ(parsed.Length(), materialized.Length());
+
+  for (size_t i = 0; i < parsed.Length(); ++i)
+  {
+    EXPECT_EQ(parsed.GetScanAngle(i), materialized.GetScanAngle(i));
+    EXPECT_EQ(parsed.GetSubscanAngle(i), materialized.GetSubscanAngle(i));
+    EXPECT_EQ(parsed.GetTime(i), materialized.GetTime(i));
+
+    double scanAngle, subscanAngle;
+    ros::Duration time;
+    materialized.GetAll(i, scanAngle, subscanAngle, time);
+    EXPECT_EQ(parsed.GetScanAngle(i), scanAngle);
+    EXPECT_EQ(parsed.GetSubscanAngle(i), subscanAngle);
+    EXPECT_EQ(parsed.GetTime(i), time);
+  }
+
+  EXPECT_THROW(materialized.GetTime(12), std::out_of_range);
+  EXPECT_THROW(materialized.GetScanAngle(12), std::out_of_range);
+  EXPECT_THROW(materialized.GetSubscanAngle(12), std::out_of_range);
+  double scanAngle, subscanAngle;
+  ros::Duration time;
+  EXPECT_THROW(materialized.GetAll(12, scanAngle, subscanAngle, time), std::out_of_range);
+
+  MultiLayerLaserScan filled, filledMaterialized;
+  parsed.FillMsg(filled);
+  materialized.FillMsg(filledMaterialized);
+  EXPECT_EQ(filled, filledMaterialized);
+}
+
+TEST(ScanLayout, TestMultiLayerLaserScanLayoutTimeNSec)
+{
+  MultiLayerLaserScan msg;
+
+  // negative base offset and a non-integer number of microseconds
+  msg.scan_layout.time_offsets.regular = true;
+  msg.scan_layout.time_offsets.increment = ros::Duration(0.000046080);
+  msg.scan_layout.time_offsets.base_offset = ros::Duration(-0.05);
+  msg.scan_layout.angular_offsets.regular = true;
+  msg.scan_layout.angular_offsets.min = -M_PI;
+  msg.scan_layout.angular_offsets.max = M_PI;
+  msg.scan_layout.angular_offsets.samples = 2000;
+  msg.scan_layout.angular_offsets.exclude_last = true;
+
+  msg.subscan_layout.time_offsets.regular = false;
+  msg.subscan_layout.time_offsets.offsets = {ros::Duration(0.0), ros::Duration(1.5), ros::Duration(-0.000000001) };
+  msg.subscan_layout.angular_offsets.regular = false;
+  msg.subscan_layout.angular_offsets.offsets = {-0.1 * M_PI, 0, 0.1 * M_PI };
+
+  msg.scan_offsets_during_subscan.regular = false;
+  msg.scan_offsets_during_subscan.offsets = { -0.1, 0, 0.1 };
+
+  msg.ranges.resize(6000, 0.0);
+
+  MultiLayerLaserScanLayout parsed(msg);
+  MultiLayerLaserScanLayout materialized(msg);
+  materialized.Materialize();
+
+  std::vector<int64_t> timesNSec, materializedTimesNSec;
+  std::vector<float> timesSec, materializedTimesSec;
+  parsed.GetTimesNSec(timesNSec);
+  parsed.GetTimesSec(timesSec);
+  materialized.GetTimesNSec(materializedTimesNSec);
+  materialized.GetTimesSec(materializedTimesSec);
+  ASSERT_EQ(parsed.Length(), timesNSec.size());
+  ASSERT_EQ(parsed.Length(), timesSec.size());
+
+  for (size_t i = 0; i < parsed.Length(); ++i)
+  {
+    const auto expected = parsed.GetTime(i).toNSec();
+    EXPECT_EQ(expected, parsed.GetTimeNSec(i));
+    EXPECT_EQ(expected, materialized.GetTimeNSec(i));
+    EXPECT_EQ(expected, timesNSec[i]);
+    EXPECT_EQ(expected, materializedTimesNSec[i]);
+    EXPECT_FLOAT_EQ(parsed.GetTime(i).toSec(), parsed.GetTimeSec(i));
+    EXPECT_EQ(parsed.GetTimeSec(i), timesSec[i]);
+    EXPECT_EQ(parsed.GetTimeSec(i), materializedTimesSec[i]);
+  }
+
+  EXPECT_THROW(parsed.GetTimeNSec(6000), std::out_of_range);
+  EXPECT_THROW(parsed.GetTimeSec(6000), std::out_of_range);
+  EXPECT_THROW(materialized.GetTimeNSec(6000), std::out_of_range);
+
+  // the integer offsets follow the offsets added to the layout
+  ParsedScanLayout layout(msg.subscan_layout);
+  layout.AddOffset(0.2 * M_PI, ros::Duration(2.25));
+  EXPECT_EQ(2250000000, layout.GetTimeNSec(3));
+
+  RegularTimeOffsets regular(msg.scan_layout.time_offsets);
+  regular.AddOffset(ros::Duration(-0.05) - ros::Duration(0.000046080));
+  EXPECT_EQ(regular.Get(0).toNSec(), regular.GetNSec(0));
+  EXPECT_EQ(regular.Get(10).toNSec(), regular.GetNSec(10));
+}
+
 TEST(RealScanners, SickLMS151AsScan)
 {
   // a single-layer lidar, but it should be possible to represent it
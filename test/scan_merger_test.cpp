@@ -0,0 +1,237 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/ScanMerger.h>
+#include <multilayer_laser_scan/SubScanView.h>
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "test_scans.h"
+
+using namespace sensor_msgs;
+
+namespace
+{
+
+// CreateRegularScan() with one uint16 custom field
+MultiLayerLaserScan createScan(const size_t numScans, const size_t subscanLength, const double minAngle,
+    const double maxAngle)
+{
+  auto msg = CreateRegularScan(numScans, subscanLength, minAngle, maxAngle);
+  msg.header.frame_id = "laser";
+
+  const auto length = msg.ranges.size();
+  PointField field;
+  field.name = "ring";
+  field.offset = 0;
+  field.datatype = PointField::UINT16;
+  field.count = 1;
+  msg.custom_data.fields.push_back(field);
+  msg.custom_data.point_step = 2;
+  msg.custom_data.data.resize(2 * length);
+  for (size_t i = 0; i < length; ++i)
+    msg.custom_data.data[2 * i] = static_cast<uint8_t>(i % subscanLength);
+
+  return msg;
+}
+
+void expectSameLayout(const ScanLayout& expected, const ScanLayout& actual)
+{
+  const ParsedScanLayout expectedLayout(expected);
+  const ParsedScanLayout actualLayout(actual);
+  ASSERT_EQ(expectedLayout.Length(), actualLayout.Length());
+  for (size_t i = 0; i < expectedLayout.Length(); ++i)
+  {
+    EXPECT_NEAR(expectedLayout.GetAngle(i), actualLayout.GetAngle(i), 1e-9) << i;
+    EXPECT_EQ(expectedLayout.GetTimeNSec(i), actualLayout.GetTimeNSec(i)) << i;
+  }
+}
+
+void expectSamePoints(const MultiLayerLaserScan& expected, const MultiLayerLaserScan& actual)
+{
+  EXPECT_EQ(expected.header.frame_id, actual.header.frame_id);
+  EXPECT_EQ(expected.header.stamp, actual.header.stamp);
+  EXPECT_EQ(expected.ranges, actual.ranges);
+  EXPECT_EQ(expected.intensities, actual.intensities);
+  EXPECT_EQ(expected.custom_data.data, actual.custom_data.data);
+  EXPECT_EQ(expected.custom_data.point_step, actual.custom_data.point_step);
+  EXPECT_EQ(expected.custom_data.fields.size(), actual.custom_data.fields.size());
+}
+
+// splits msg into views of the given numbers of subscans
+std::vector<MultiLayerLaserScan> split(const MultiLayerLaserScan& msg, const std::vector<size_t>& scanLengths)
+{
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+  std::vector<MultiLayerLaserScan> parts;
+  size_t firstScan = 0;
+  for (const auto scanLength : scanLengths)
+  {
+    parts.push_back(SubScanView(msg, layout, firstScan, firstScan + scanLength).ToScan());
+    firstScan += scanLength;
+  }
+  return parts;
+}
+
+std::vector<const MultiLayerLaserScan*> pointers(const std::vector<MultiLayerLaserScan>& parts)
+{
+  std::vector<const MultiLayerLaserScan*> result;
+  for (const auto& part : parts)
+    result.push_back(&part);
+  return result;
+}
+
+}
+
+TEST(ScanMerger, SplitAndMergeStaysRegular)  // NOLINT
+{
+  const auto msg = createScan(360, 4, -M_PI, M_PI);
+  const auto parts = split(msg, {100, 1, 150, 109});
+
+  MultiLayerLaserScan merged;
+  MergeScans(pointers(parts), merged);
+
+  EXPECT_TRUE(merged.scan_layout.angular_offsets.regular);
+  EXPECT_TRUE(merged.scan_layout.time_offsets.regular);
+  expectSameLayout(msg.scan_layout, merged.scan_layout);
+  expectSamePoints(msg, merged);
+  EXPECT_EQ(msg.subscan_layout, merged.subscan_layout);
+  EXPECT_EQ(msg.range_min, merged.range_min);
+  EXPECT_EQ(msg.range_max, merged.range_max);
+
+  // the merged scan can be used with the layout classes directly
+  MultiLayerLaserScanLayout layout(merged);
+  EXPECT_EQ(msg.ranges.size(), layout.Length());
+
+  // a single part is copied
+  MergeScans({&msg}, merged);
+  expectSamePoints(msg, merged);
+  expectSameLayout(msg.scan_layout, merged.scan_layout);
+}
+
+TEST(ScanMerger, PartsWithDifferentStamps)  // NOLINT
+{
+  const auto msg = createScan(90, 2, 0, M_PI / 2);
+  auto parts = split(msg, {30, 30, 30});
+
+  // each packet stamped by its first subscan, as drivers usually do
+  for (auto& part : parts)
+  {
+    const ParsedScanLayout scanLayout(part.scan_layout);
+    const auto firstTimeNSec = scanLayout.GetTimeNSec(0);
+    part.header.stamp.fromNSec(part.header.stamp.toNSec() + firstTimeNSec);
+    part.scan_layout.time_offsets.base_offset = ros::Duration(0);
+  }
+
+  MultiLayerLaserScan merged;
+  MergeScans(pointers(parts), merged);
+  EXPECT_EQ(parts[0].header.stamp, merged.header.stamp);
+  EXPECT_TRUE(merged.scan_layout.time_offsets.regular);
+
+  const ParsedScanLayout original(msg.scan_layout);
+  const ParsedScanLayout result(merged.scan_layout);
+  ASSERT_EQ(original.Length(), result.Length());
+  for (size_t i = 0; i < original.Length(); ++i)
+    EXPECT_EQ(msg.header.stamp.toNSec() + original.GetTimeNSec(i),
+              merged.header.stamp.toNSec() + result.GetTimeNSec(i)) << i;
+}
+
+TEST(ScanMerger, ExplicitWhenPartsDoNotContinue)  // NOLINT
+{
+  const auto msg = createScan(90, 2, 0, M_PI / 2);
+  auto parts = split(msg, {30, 30, 30});
+
+  // a missing packet: the angles and times jump
+  MultiLayerLaserScan merged;
+  MergeScans({&parts[0], &parts[2]}, merged);
+  EXPECT_FALSE(merged.scan_layout.angular_offsets.regular);
+  EXPECT_FALSE(merged.scan_layout.time_offsets.regular);
+
+  const ParsedScanLayout original(msg.scan_layout);
+  const ParsedScanLayout result(merged.scan_layout);
+  ASSERT_EQ(60u, result.Length());
+  for (size_t i = 0; i < 30; ++i)
+  {
+    EXPECT_NEAR(original.GetAngle(i), result.GetAngle(i), 1e-9);
+    EXPECT_NEAR(original.GetAngle(60 + i), result.GetAngle(30 + i), 1e-9);
+    EXPECT_EQ(original.GetTimeNSec(i), result.GetTimeNSec(i));
+    EXPECT_EQ(original.GetTimeNSec(60 + i), result.GetTimeNSec(30 + i));
+  }
+  EXPECT_EQ(120u, merged.ranges.size());
+  EXPECT_EQ(parts[2].ranges.back(), merged.ranges.back());
+
+  // explicit parts that continue each other stay explicit
+  const ParsedScanLayout first(parts[0].scan_layout);
+  parts[0].scan_layout.angular_offsets.regular = false;
+  for (size_t i = 0; i < first.Length(); ++i)
+    parts[0].scan_layout.angular_offsets.offsets.push_back(first.GetAngle(i));
+  MergeScans(pointers(parts), merged);
+  EXPECT_FALSE(merged.scan_layout.angular_offsets.regular);
+  EXPECT_TRUE(merged.scan_layout.time_offsets.regular);
+  expectSameLayout(msg.scan_layout, merged.scan_layout);
+  expectSamePoints(msg, merged);
+}
+
+TEST(ScanMerger, InPlaceAndMove)  // NOLINT
+{
+  const auto msg = createScan(360, 4, -M_PI, M_PI);
+  auto parts = split(msg, {120, 120, 120});
+
+  // appending to the first part
+  auto accumulated = parts[0];
+  MergeScans({&accumulated, &parts[1], &parts[2]}, accumulated);
+  expectSamePoints(msg, accumulated);
+  expectSameLayout(msg.scan_layout, accumulated.scan_layout);
+  EXPECT_TRUE(accumulated.scan_layout.angular_offsets.regular);
+
+  // the merged scan can only be the first part
+  auto copy = parts[0];
+  EXPECT_THROW(MergeScans({&parts[1], &copy}, copy), std::runtime_error);
+
+  const auto merged = MergeScans(std::move(parts));
+  expectSamePoints(msg, merged);
+  expectSameLayout(msg.scan_layout, merged.scan_layout);
+}
+
+TEST(ScanMerger, IncompatibleParts)  // NOLINT
+{
+  const auto msg = createScan(90, 2, 0, M_PI / 2);
+  const auto parts = split(msg, {45, 45});
+  MultiLayerLaserScan merged;
+
+  EXPECT_THROW(MergeScans({}, merged), std::runtime_error);
+
+  auto other = parts[1];
+  other.header.frame_id = "other";
+  EXPECT_THROW(MergeScans({&parts[0], &other}, merged), std::runtime_error);
+
+  other = parts[1];
+  other.range_max = 50.0f;
+  EXPECT_THROW(MergeScans({&parts[0], &other}, merged), std::runtime_error);
+
+  other = parts[1];
+  other.subscan_layout.angular_offsets.max = 0.2;
+  EXPECT_THROW(MergeScans({&parts[0], &other}, merged), std::runtime_error);
+
+  other = parts[1];
+  other.intensities.clear();
+  EXPECT_THROW(MergeScans({&parts[0], &other}, merged), std::runtime_error);
+
+  other = parts[1];
+  other.custom_data.fields[0].name = "other";
+  EXPECT_THROW(MergeScans({&parts[0], &other}, merged), std::runtime_error);
+
+  other = parts[1];
+  other.ranges.pop_back();
+  EXPECT_THROW(MergeScans({&parts[0], &other}, merged), std::runtime_error);
+
+  const ParsedScanLayout layout(parts[0].scan_layout);
+  EXPECT_THROW(MergeScanLayouts({}, {}, merged.scan_layout), std::runtime_error);
+  EXPECT_THROW(MergeScanLayouts({&layout}, {0, 0}, merged.scan_layout), std::runtime_error);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,134 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/ScanNeighborhood.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "test_scans.h"
+
+using namespace sensor_msgs;
+
+namespace
+{
+
+MultiLayerLaserScan createScan(const size_t numScans, const size_t subscanLength, const double fov,
+    const bool excludeLast)
+{
+  auto msg = CreateRegularLayoutScan(numScans, subscanLength, 0, fov, -0.1, 0.1, ros::Duration(0.001));
+  msg.scan_layout.angular_offsets.exclude_last = excludeLast;
+  msg.range_min = 0.5f;
+  msg.range_max = 100.0f;
+  msg.ranges.resize(numScans * subscanLength, 10.0f);
+  return msg;
+}
+
+}
+
+TEST(ScanNeighborhood, DetectWrapAround)  // NOLINT
+{
+  EXPECT_TRUE(ScanNeighborhood(MultiLayerLaserScanLayout(createScan(16, 4, 2 * M_PI, true))).WrapsAround());
+  EXPECT_FALSE(ScanNeighborhood(MultiLayerLaserScanLayout(createScan(16, 4, 2 * M_PI, false))).WrapsAround());
+  EXPECT_FALSE(ScanNeighborhood(MultiLayerLaserScanLayout(createScan(16, 4, M_PI, true))).WrapsAround());
+
+  auto msg = createScan(3, 4, 2 * M_PI, true);
+  msg.scan_layout.angular_offsets.regular = false;
+  msg.scan_layout.angular_offsets.offsets = {0.0, 2 * M_PI / 3, 4 * M_PI / 3};
+  msg.scan_layout.time_offsets.regular = false;
+  msg.scan_layout.time_offsets.offsets = {ros::Duration(0), ros::Duration(1), ros::Duration(2)};
+  const MultiLayerLaserScanLayout layout(msg);
+  const ScanNeighborhood neighborhood(layout);
+  EXPECT_FALSE(neighborhood.WrapsAround());
+  EXPECT_EQ(3, neighborhood.GetScanLength());
+  EXPECT_EQ(4, neighborhood.GetSubscanLength());
+}
+
+TEST(ScanNeighborhood, Window)  // NOLINT
+{
+  // 10 columns of 5 rings
+  const ScanNeighborhood neighborhood(10, 5, false);
+  std::vector<size_t> neighbors;
+
+  // column 3, ring 2
+  EXPECT_EQ(8, neighborhood.GetNeighbors(17, 1, 1, neighbors));
+  EXPECT_EQ((std::vector<size_t>{11, 12, 13, 16, 18, 21, 22, 23}), neighbors);
+
+  EXPECT_EQ(14, neighborhood.GetNeighbors(17, 1, 2, neighbors));
+  EXPECT_EQ(24, neighborhood.GetNeighbors(17, 2, 2, neighbors));
+
+  // column 0, ring 0
+  EXPECT_EQ(3, neighborhood.GetNeighbors(0, 1, 1, neighbors));
+  EXPECT_EQ((std::vector<size_t>{1, 5, 6}), neighbors);
+
+  // column 9, ring 4
+  EXPECT_EQ(3, neighborhood.GetNeighbors(49, 1, 1, neighbors));
+  EXPECT_EQ((std::vector<size_t>{43, 44, 48}), neighbors);
+
+  // the whole scan
+  EXPECT_EQ(49, neighborhood.GetNeighbors(49, 100, std::numeric_limits<size_t>::max(), neighbors));
+
+  EXPECT_EQ(0, neighborhood.GetNeighbors(17, 0, 0, neighbors));
+  EXPECT_THROW(neighborhood.GetNeighbors(50, 1, 1, neighbors), std::out_of_range);
+}
+
+TEST(ScanNeighborhood, WrapAround)  // NOLINT
+{
+  const ScanNeighborhood neighborhood(10, 5, true);
+  std::vector<size_t> neighbors;
+
+  // column 0, ring 0
+  EXPECT_EQ(5, neighborhood.GetNeighbors(0, 1, 1, neighbors));
+  EXPECT_EQ((std::vector<size_t>{45, 46, 1, 5, 6}), neighbors);
+
+  // column 9, ring 2
+  EXPECT_EQ(8, neighborhood.GetNeighbors(47, 1, 1, neighbors));
+  EXPECT_EQ((std::vector<size_t>{41, 42, 43, 46, 48, 1, 2, 3}), neighbors);
+
+  EXPECT_EQ(44, neighborhood.GetNeighbors(22, 4, 4, neighbors));
+
+  // a window wider than the scan contains each point once
+  for (const size_t radius : {5, 6, 100})
+  {
+    EXPECT_EQ(49, neighborhood.GetNeighbors(22, 4, radius, neighbors));
+    std::sort(neighbors.begin(), neighbors.end());
+    EXPECT_EQ(neighbors.end(), std::unique(neighbors.begin(), neighbors.end()));
+  }
+
+  const ScanNeighborhood oddNeighborhood(5, 1, true);
+  EXPECT_EQ(2, oddNeighborhood.GetNeighbors(0, 0, 1, neighbors));
+  EXPECT_EQ(4, oddNeighborhood.GetNeighbors(0, 0, 2, neighbors));
+  EXPECT_EQ((std::vector<size_t>{3, 4, 1, 2}), neighbors);
+}
+
+TEST(ScanNeighborhood, RangeGated)  // NOLINT
+{
+  auto msg = createScan(10, 5, 2 * M_PI, true);
+  const ScanNeighborhood neighborhood{MultiLayerLaserScanLayout(msg)};
+  ASSERT_TRUE(neighborhood.WrapsAround());
+  std::vector<size_t> neighbors;
+
+  // column 3, ring 2 and its neighbors 11, 12, 13, 16, 18, 21, 22, 23
+  msg.ranges[11] = 10.5f;
+  msg.ranges[12] = 12.0f;
+  msg.ranges[13] = std::numeric_limits<float>::quiet_NaN();
+  msg.ranges[16] = 0.1f;  // below range_min
+  EXPECT_EQ(5, neighborhood.GetNeighbors(msg.ranges.data(), 17, 1, 1, 1.0f, neighbors));
+  EXPECT_EQ((std::vector<size_t>{11, 18, 21, 22, 23}), neighbors);
+
+  EXPECT_EQ(5, neighborhood.GetNeighbors(msg, 17, 1, 1, 1.0f, neighbors));
+
+  // only the scan version knows range_min
+  EXPECT_EQ(7, neighborhood.GetNeighbors(msg.ranges.data(), 17, 1, 1, 10.0f, neighbors));
+  EXPECT_EQ(6, neighborhood.GetNeighbors(msg, 17, 1, 1, 10.0f, neighbors));
+  EXPECT_EQ((std::vector<size_t>{11, 12, 18, 21, 22, 23}), neighbors);
+  EXPECT_EQ(0, neighborhood.GetNeighbors(msg, 13, 1, 1, 10.0f, neighbors));
+  EXPECT_EQ(0, neighborhood.GetNeighbors(msg, 16, 1, 1, 10.0f, neighbors));
+
+  msg.ranges.pop_back();
+  EXPECT_THROW(neighborhood.GetNeighbors(msg, 17, 1, 1, 1.0f, neighbors), std::runtime_error);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,156 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/StaticScanLayout.h>
+
+using namespace sensor_msgs;
+
+MultiLayerLaserScan createScan(const bool regularAngles, const bool regularTimes)
+{
+  MultiLayerLaserScan msg;
+
+  msg.subscan_layout.time_offsets.regular = false;
+  msg.subscan_layout.time_offsets.offsets = {ros::Duration(0.0), ros::Duration(0.001), ros::Duration(0.002)};
+  msg.subscan_layout.angular_offsets.regular = true;
+  msg.subscan_layout.angular_offsets.min = -0.1;
+  msg.subscan_layout.angular_offsets.max = 0.1;
+  msg.subscan_layout.angular_offsets.samples = -3;
+
+  msg.scan_offsets_during_subscan.regular = false;
+  msg.scan_offsets_during_subscan.offsets = { 0.0, 0.01, 0.02 };
+
+  msg.scan_layout.angular_offsets.regular = regularAngles;
+  if (regularAngles)
+  {
+    msg.scan_layout.angular_offsets.min = 0;
+    msg.scan_layout.angular_offsets.max = 2 * M_PI;
+    msg.scan_layout.angular_offsets.samples = 100;
+    msg.scan_layout.angular_offsets.exclude_last = true;
+  }
+  else
+  {
+    for (size_t i = 0; i < 100; ++i)
+      msg.scan_layout.angular_offsets.offsets.push_back(i * 0.06 + 0.001 * (i % 3));
+  }
+
+  msg.scan_layout.time_offsets.regular = regularTimes;
+  if (regularTimes)
+  {
+    msg.scan_layout.time_offsets.base_offset = ros::Duration(0.5);
+    msg.scan_layout.time_offsets.increment = ros::Duration(0.005);
+  }
+  else
+  {
+    for (size_t i = 0; i < 100; ++i)
+      msg.scan_layout.time_offsets.offsets.push_back(ros::Duration(0, i * 1000003));
+  }
+
+  msg.ranges.resize(300, 1.0);
+
+  return msg;
+}
+
+void compareWithLayout(const MultiLayerLaserScanLayout& layout)
+{
+  size_t numCalls = 0;
+  ForEachPoint(layout, [&](size_t i, double scanAngle, double subscanAngle, int64_t timeOffset)
+  {
+    ASSERT_EQ(numCalls, i);
+    ++numCalls;
+
+    double expectedScanAngle, expectedSubscanAngle;
+    ros::Duration expectedTime;
+    layout.GetAll(i, expectedScanAngle, expectedSubscanAngle, expectedTime);
+
+    EXPECT_DOUBLE_EQ(expectedScanAngle, scanAngle);
+    EXPECT_DOUBLE_EQ(expectedSubscanAngle, subscanAngle);
+    // regular time offsets are computed in floating point by ParsedScanLayout
+    EXPECT_NEAR(expectedTime.toNSec(), timeOffset, 1);
+  });
+  EXPECT_EQ(layout.Length(), numCalls);
+}
+
+TEST(StaticScanLayout, RegularAnglesRegularTimes)
+{
+  compareWithLayout(MultiLayerLaserScanLayout(createScan(true, true)));
+}
+
+TEST(StaticScanLayout, RegularAnglesExplicitTimes)
+{
+  compareWithLayout(MultiLayerLaserScanLayout(createScan(true, false)));
+}
+
+TEST(StaticScanLayout, ExplicitAnglesRegularTimes)
+{
+  compareWithLayout(MultiLayerLaserScanLayout(createScan(false, true)));
+}
+
+TEST(StaticScanLayout, ExplicitAnglesExplicitTimes)
+{
+  compareWithLayout(MultiLayerLaserScanLayout(createScan(false, false)));
+}
+
+TEST(StaticScanLayout, StaticScanLayout)
+{
+  AngularOffsets angularMsg;
+  angularMsg.regular = true;
+  angularMsg.min = -1;
+  angularMsg.max = 1;
+  angularMsg.increment = -0.5;
+  const RegularAngularOffsets angles(angularMsg);
+
+  TimeOffsets timeMsg;
+  timeMsg.regular = false;
+  timeMsg.offsets = {ros::Duration(1, 0), ros::Duration(0, 5), ros::Duration(-1, 0),
+    ros::Duration(0, 0), ros::Duration(2, 1)};
+  const ExplicitTimeOffsets times(timeMsg);
+
+  const StaticScanLayout<RegularAngles, ExplicitTimes> layout(
+    RegularAngles(angles), ExplicitTimes(times), angles.Length());
+
+  ASSERT_EQ(5, layout.Length());
+  for (size_t i = 0; i < layout.Length(); ++i)
+  {
+    EXPECT_EQ(angles.Get(i), layout.GetAngle(i));
+    EXPECT_EQ(times.Get(i).toNSec(), layout.GetTimeNSec(i));
+  }
+  EXPECT_DOUBLE_EQ(1.0, layout.GetAngle(0));
+  EXPECT_DOUBLE_EQ(-1.0, layout.GetAngle(4));
+  EXPECT_EQ(5, layout.GetTimeNSec(1));
+  EXPECT_EQ(-1000000000, layout.GetTimeNSec(2));
+}
+
+TEST(StaticScanLayout, ScanRange)
+{
+  const MultiLayerLaserScanLayout layout(createScan(true, true));
+
+  std::vector<size_t> indices;
+  ForEachPointInScans(layout, 10, 12, [&](size_t i, double, double, int64_t)
+  {
+    indices.push_back(i);
+  });
+  EXPECT_EQ(std::vector<size_t>({30, 31, 32, 33, 34, 35}), indices);
+
+  indices.clear();
+  ForEachPointInScans(layout, 99, 100, [&](size_t i, double, double, int64_t)
+  {
+    indices.push_back(i);
+  });
+  EXPECT_EQ(std::vector<size_t>({297, 298, 299}), indices);
+
+  indices.clear();
+  ForEachPointInScans(layout, 5, 5, [&](size_t i, double, double, int64_t)
+  {
+    indices.push_back(i);
+  });
+  EXPECT_TRUE(indices.empty());
+
+  EXPECT_THROW(ForEachPointInScans(layout, 0, 101, [](size_t, double, double, int64_t) {}),
+               std::out_of_range);
+  EXPECT_THROW(ForEachPointInScans(layout, 2, 1, [](size_t, double, double, int64_t) {}),
+               std::out_of_range);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
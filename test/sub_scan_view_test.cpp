@@ -0,0 +1,269 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/SubScanView.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "test_scans.h"
+
+using namespace sensor_msgs;
+
+namespace
+{
+
+// the same layout with explicit offsets
+MultiLayerLaserScan makeExplicit(MultiLayerLaserScan msg)
+{
+  const ParsedScanLayout scanLayout(msg.scan_layout);
+  msg.scan_layout.angular_offsets.regular = false;
+  msg.scan_layout.time_offsets.regular = false;
+  for (size_t i = 0; i < scanLayout.Length(); ++i)
+  {
+    msg.scan_layout.angular_offsets.offsets.push_back(scanLayout.GetAngle(i));
+    msg.scan_layout.time_offsets.offsets.push_back(scanLayout.GetTime(i));
+  }
+  return msg;
+}
+
+// subscans with angles in <minAngle, maxAngle> (possibly shifted by 2 pi)
+// @return Whether they are contiguous.
+bool bruteForceSector(const ParsedScanLayout& scanLayout, const double minAngle, const double maxAngle,
+    size_t& firstScan, size_t& endScan)
+{
+  firstScan = endScan = 0;
+  for (size_t i = 0; i < scanLayout.Length(); ++i)
+  {
+    bool inside = false;
+    for (int k = -2; k <= 2; ++k)
+    {
+      const auto angle = scanLayout.GetAngle(i) + 2 * M_PI * k;
+      inside |= angle >= minAngle - 1e-9 && angle <= maxAngle + 1e-9;
+    }
+    if (!inside)
+      continue;
+    if (firstScan == endScan)
+      firstScan = i;
+    else if (endScan != i)
+      return false;
+    endScan = i + 1;
+  }
+  return true;
+}
+
+}
+
+TEST(SubScanView, ForwardSector)  // NOLINT
+{
+  // 1 degree per subscan from -pi
+  auto msg = CreateRegularScan(360, 4, -M_PI, M_PI);
+  auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+
+  const auto view = SubScanView::Sector(msg, layout, -M_PI / 3, M_PI / 3);
+  EXPECT_EQ(120u, view.GetFirstScan());
+  EXPECT_EQ(241u, view.GetEndScan());
+  EXPECT_EQ(121u, view.GetScanLength());
+  EXPECT_EQ(121u * 4, view.Length());
+  EXPECT_EQ(480u, view.GetFirstIndex());
+  EXPECT_FALSE(view.Empty());
+
+  size_t numPoints = 0;
+  for (auto it = view.begin(); it != view.end(); ++it, ++numPoints)
+  {
+    EXPECT_EQ(1.0f + view.GetFirstIndex() + numPoints, *(*it).range);
+    EXPECT_GE((*it).scanAngle, -M_PI / 3 - 1e-9);
+    EXPECT_LE((*it).scanAngle, M_PI / 3 + 0.001 + 1e-9);  // plus scan_offsets_during_subscan
+  }
+  EXPECT_EQ(view.Length(), numPoints);
+
+  // the same sector in a layout from 0 to 2 pi wraps around its start
+  msg = CreateRegularScan(360, 4, 0, 2 * M_PI);
+  layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+  EXPECT_THROW(SubScanView::Sector(msg, layout, -M_PI / 3, M_PI / 3), std::runtime_error);
+  EXPECT_THROW(SubScanView::Sector(msg, layout, 1.0, 0.5), std::runtime_error);
+  EXPECT_THROW(SubScanView::SplitSector(msg, layout, 1.0, 0.5), std::runtime_error);
+
+  // split into its part from -pi/3 and the part after the start of the scan
+  const auto parts = SubScanView::SplitSector(msg, layout, -M_PI / 3, M_PI / 3);
+  ASSERT_EQ(2u, parts.size());
+  EXPECT_EQ(300u, parts[0].GetFirstScan());
+  EXPECT_EQ(360u, parts[0].GetEndScan());
+  EXPECT_EQ(0u, parts[1].GetFirstScan());
+  EXPECT_EQ(61u, parts[1].GetEndScan());
+
+  // the rear sector does not
+  const auto rear = SubScanView::Sector(msg, layout, 2 * M_PI / 3, 4 * M_PI / 3);
+  EXPECT_EQ(120u, rear.GetFirstScan());
+  EXPECT_EQ(241u, rear.GetEndScan());
+  const auto rearParts = SubScanView::SplitSector(msg, layout, 2 * M_PI / 3, 4 * M_PI / 3);
+  ASSERT_EQ(1u, rearParts.size());
+  EXPECT_EQ(120u, rearParts[0].GetFirstScan());
+  EXPECT_EQ(241u, rearParts[0].GetEndScan());
+  const auto rearShifted = SubScanView::Sector(msg, layout, -4 * M_PI / 3, -2 * M_PI / 3);
+  EXPECT_EQ(120u, rearShifted.GetFirstScan());
+  EXPECT_EQ(241u, rearShifted.GetEndScan());
+
+  // whole circle
+  const auto all = SubScanView::Sector(msg, layout, -M_PI, 3 * M_PI);
+  EXPECT_EQ(0u, all.GetFirstScan());
+  EXPECT_EQ(360u, all.GetEndScan());
+
+  // nothing
+  const auto none = SubScanView::Sector(msg, layout, 0.0001, 0.0002);
+  EXPECT_TRUE(none.Empty());
+  EXPECT_EQ(0u, none.Length());
+  EXPECT_TRUE(none.begin() == none.end());
+  EXPECT_THROW(none.ToScan(), std::out_of_range);
+}
+
+TEST(SubScanView, SectorMatchesBruteForce)  // NOLINT
+{
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> angle(-4.0, 4.0);
+  std::uniform_real_distribution<double> width(0.0, 3.0);
+
+  // regular and explicit, ascending and descending, full circle and 3/4 of it
+  std::vector<MultiLayerLaserScan> scans = {CreateRegularScan(360, 2, -M_PI, M_PI),
+                                            CreateRegularScan(-360, 2, -M_PI, M_PI),
+                                            CreateRegularScan(271, 2, -3 * M_PI / 4, 3 * M_PI / 4)};
+  scans.push_back(makeExplicit(scans[0]));
+  scans.push_back(makeExplicit(scans[1]));
+  scans.push_back(makeExplicit(scans[2]));
+
+  for (const auto& msg : scans)
+  {
+    const ParsedScanLayout scanLayout(msg.scan_layout);
+    for (size_t n = 0; n < 1000; ++n)
+    {
+      const auto minAngle = angle(generator);
+      const auto maxAngle = minAngle + width(generator);
+      size_t expectedFirst, expectedEnd, first, end;
+      if (!bruteForceSector(scanLayout, minAngle, maxAngle, expectedFirst, expectedEnd))
+      {
+        EXPECT_THROW(SubScanView::FindSector(scanLayout, minAngle, maxAngle, first, end), std::runtime_error);
+        continue;
+      }
+
+      try
+      {
+        SubScanView::FindSector(scanLayout, minAngle, maxAngle, first, end);
+      }
+      catch (const std::runtime_error&)
+      {
+        ADD_FAILURE() << "Sector <" << minAngle << ", " << maxAngle << "> should be contiguous";
+        continue;
+      }
+      if (expectedFirst == expectedEnd)
+      {
+        EXPECT_EQ(first, end);
+      }
+      else
+      {
+        EXPECT_EQ(expectedFirst, first) << minAngle << " " << maxAngle;
+        EXPECT_EQ(expectedEnd, end) << minAngle << " " << maxAngle;
+      }
+    }
+  }
+}
+
+TEST(SubScanView, TimeWindow)  // NOLINT
+{
+  for (const auto& msg : {CreateRegularScan(100, 4, 0, M_PI), makeExplicit(CreateRegularScan(100, 4, 0, M_PI))})
+  {
+    const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+
+    // subscan i starts at 0.5 + i ms
+    auto view = SubScanView::TimeWindow(msg, layout, ros::Time(100.010), ros::Time(100.0205));
+    EXPECT_EQ(10u, view.GetFirstScan());
+    EXPECT_EQ(21u, view.GetEndScan());
+
+    // the last 20 ms of the sweep
+    const auto sweepEnd = msg.header.stamp + layout->GetTime(layout->Length() - 1);
+    view = SubScanView::TimeWindow(msg, layout, sweepEnd - ros::Duration(0.02), sweepEnd);
+    EXPECT_EQ(80u, view.GetFirstScan());
+    EXPECT_EQ(100u, view.GetEndScan());
+
+    view = SubScanView::TimeWindow(msg, layout, ros::Time(99), ros::Time(100.0005));
+    EXPECT_EQ(0u, view.GetFirstScan());
+    EXPECT_EQ(1u, view.GetEndScan());
+
+    view = SubScanView::TimeWindow(msg, layout, ros::Time(101), ros::Time(102));
+    EXPECT_TRUE(view.Empty());
+
+    EXPECT_THROW(SubScanView::TimeWindow(msg, layout, ros::Time(101), ros::Time(100)), std::runtime_error);
+  }
+}
+
+TEST(SubScanView, ToScan)  // NOLINT
+{
+  for (const auto& original : {CreateRegularScan(360, 4, -M_PI, M_PI),
+                               makeExplicit(CreateRegularScan(-360, 4, -M_PI, M_PI))})
+  {
+    auto msg = original;
+    msg.custom_data.point_step = 2;
+    msg.custom_data.data.resize(msg.ranges.size() * 2);
+    for (size_t i = 0; i < msg.custom_data.data.size(); ++i)
+      msg.custom_data.data[i] = static_cast<uint8_t>(i);
+
+    const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+    const SubScanView view(msg, layout, 100, 150);
+    const auto trimmed = view.ToScan();
+
+    EXPECT_EQ(msg.header.stamp, trimmed.header.stamp);
+    EXPECT_EQ(msg.scan_layout.angular_offsets.regular, trimmed.scan_layout.angular_offsets.regular);
+    EXPECT_EQ(msg.scan_layout.time_offsets.regular, trimmed.scan_layout.time_offsets.regular);
+    ASSERT_EQ(200u, trimmed.ranges.size());
+    ASSERT_EQ(200u, trimmed.intensities.size());
+    ASSERT_EQ(400u, trimmed.custom_data.data.size());
+    EXPECT_EQ(2u, trimmed.custom_data.point_step);
+
+    const MultiLayerLaserScanLayout trimmedLayout(trimmed);
+    const auto viewLayout = view.GetLayout();
+    ASSERT_EQ(200u, trimmedLayout.Length());
+    ASSERT_EQ(200u, viewLayout->Length());
+    EXPECT_EQ(50u, trimmedLayout.GetScanLength());
+
+    for (size_t i = 0; i < trimmed.ranges.size(); ++i)
+    {
+      const auto j = view.GetFirstIndex() + i;
+      EXPECT_EQ(msg.ranges[j], trimmed.ranges[i]);
+      EXPECT_EQ(msg.intensities[j], trimmed.intensities[i]);
+      EXPECT_EQ(msg.custom_data.data[2 * j + 1], trimmed.custom_data.data[2 * i + 1]);
+      EXPECT_NEAR(layout->GetScanAngle(j), trimmedLayout.GetScanAngle(i), 1e-9);
+      EXPECT_NEAR(layout->GetSubscanAngle(j), trimmedLayout.GetSubscanAngle(i), 1e-9);
+      EXPECT_EQ(layout->GetTimeNSec(j), trimmedLayout.GetTimeNSec(i));
+      EXPECT_NEAR(layout->GetScanAngle(j), viewLayout->GetScanAngle(i), 1e-9);
+      EXPECT_EQ(layout->GetTimeNSec(j), viewLayout->GetTimeNSec(i));
+    }
+
+    // reuses the output
+    MultiLayerLaserScan output = trimmed;
+    SubScanView(msg, layout, 359, 360).ToScan(output);
+    EXPECT_EQ(4u, output.ranges.size());
+    EXPECT_EQ(1u, MultiLayerLaserScanLayout(output).GetScanLength());
+    EXPECT_NEAR(layout->GetScanAngle(359 * 4), MultiLayerLaserScanLayout(output).GetScanAngle(0), 1e-9);
+  }
+}
+
+TEST(SubScanView, InvalidRanges)  // NOLINT
+{
+  auto msg = CreateRegularScan(10, 4, 0, M_PI);
+  const auto layout = std::make_shared<MultiLayerLaserScanLayout>(msg);
+  EXPECT_THROW(SubScanView(msg, layout, 5, 4), std::out_of_range);
+  EXPECT_THROW(SubScanView(msg, layout, 5, 11), std::out_of_range);
+  EXPECT_NO_THROW(SubScanView(msg, layout, 10, 10));
+
+  ScanLayout trimmed;
+  EXPECT_THROW(SubScanView::TrimScanLayout(layout->GetScanLayout(), 3, 3, trimmed), std::out_of_range);
+
+  msg.ranges.pop_back();
+  EXPECT_THROW(SubScanView(msg, layout, 0, 1), std::runtime_error);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
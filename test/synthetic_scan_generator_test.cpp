@@ -0,0 +1,183 @@
+#include "gtest/gtest.h"
+#include <multilayer_laser_scan/CartesianProjection.h>
+#include <multilayer_laser_scan/SyntheticScanGenerator.h>
+#include <multilayer_laser_scan/scan_iterator.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace sensor_msgs;
+
+namespace
+{
+
+SyntheticScene createFloorScene()
+{
+  SyntheticScene scene;
+  scene.planes.push_back({Eigen::Vector3d::UnitZ(), -1.5, 20.0f});
+  return scene;
+}
+
+}
+
+TEST(SyntheticScanGenerator, Presets)  // NOLINT
+{
+  typedef SyntheticScanGenerator G;
+  const std::vector<std::pair<G::Preset, size_t>> presets = {
+      {G::SICK_LMS151, 541}, {G::VELODYNE_HDL_32E, 69504}, {G::OUSTER_OS1_64, 131072}, {G::RSLIDAR_32, 48000}};
+
+  for (const auto& preset : presets)
+  {
+    const auto msg = G::CreatePresetScan(preset.first);
+    const MultiLayerLaserScanLayout layout(msg);
+    EXPECT_EQ(preset.second, layout.Length());
+    EXPECT_EQ(preset.second, msg.ranges.size());
+    EXPECT_EQ(preset.second, msg.intensities.size());
+    EXPECT_LT(msg.range_min, msg.range_max);
+
+    // time offsets follow the rate
+    const auto nominalRate = G::GetNominalRate(preset.first);
+    const auto fast = G::CreatePresetScan(preset.first, 2 * nominalRate);
+    const MultiLayerLaserScanLayout fastLayout(fast);
+    const auto last = layout.GetScanLength() - 1;
+    EXPECT_NEAR(layout.GetScanLayout().GetTime(last).toSec() / 2,
+                fastLayout.GetScanLayout().GetTime(last).toSec(), 1e-5);  // increments are rounded to ns
+  }
+
+  EXPECT_EQ(G::OUSTER_OS1_64, G::ParsePreset("ouster_os1_64"));
+  EXPECT_EQ(G::VELODYNE_HDL_32E, G::ParsePreset("Velodyne-HDL-32E"));
+  EXPECT_EQ(G::SICK_LMS151, G::ParsePreset("sick_lms151"));
+  EXPECT_EQ(G::RSLIDAR_32, G::ParsePreset("RSLIDAR_32"));
+  EXPECT_THROW(G::ParsePreset("hdl_64"), std::runtime_error);
+  EXPECT_THROW(G::CreatePresetScan(G::OUSTER_OS1_64, -1.0), std::runtime_error);
+}
+
+TEST(SyntheticScanGenerator, Floor)  // NOLINT
+{
+  const auto layoutScan = SyntheticScanGenerator::CreatePresetScan(SyntheticScanGenerator::VELODYNE_HDL_32E);
+  SyntheticScanGenerator generator(layoutScan, createFloorScene());
+
+  const auto msg = generator.Generate(ros::Time(10, 5));
+  EXPECT_EQ(ros::Time(10, 5), msg.header.stamp);
+  EXPECT_TRUE(msg.custom_data.fields.empty());
+
+  const auto& layout = generator.GetLayout();
+  std::vector<float> x(layout.Length()), y(layout.Length()), z(layout.Length());
+  CartesianProjection(layout).Project(msg, x.data(), y.data(), z.data());
+
+  size_t numHits = 0;
+  for (size_t i = 0; i < layout.Length(); ++i)
+  {
+    const auto elevation = layout.GetSubscanAngle(i);
+    if (elevation >= 0 || -1.5 / std::sin(elevation) > msg.range_max)
+    {
+      EXPECT_TRUE(std::isinf(msg.ranges[i])) << i;
+      continue;
+    }
+    ++numHits;
+    EXPECT_NEAR(-1.5f, z[i], 1e-3f) << i;
+    EXPECT_EQ(20.0f, msg.intensities[i]);
+  }
+  EXPECT_GT(numHits, layout.Length() / 2);
+}
+
+TEST(SyntheticScanGenerator, Box)  // NOLINT
+{
+  SyntheticScene scene;
+  scene.boxes.push_back({{3.0, -1.0, -1.0}, {4.0, 1.0, 1.0}, 100.0f});
+  const auto layoutScan = SyntheticScanGenerator::CreatePresetScan(SyntheticScanGenerator::OUSTER_OS1_64);
+  SyntheticScanGenerator generator(layoutScan, scene);
+
+  const auto msg = generator.Generate(ros::Time(10));
+  const auto& layout = generator.GetLayout();
+  std::vector<float> x(layout.Length()), y(layout.Length()), z(layout.Length());
+  CartesianProjection(layout).Project(msg, x.data(), y.data(), z.data());
+
+  size_t numHits = 0;
+  for (size_t i = 0; i < layout.Length(); ++i)
+  {
+    if (std::isinf(msg.ranges[i]))
+      continue;
+    ++numHits;
+    // the sensor sees the front and the side faces
+    const auto onFront = std::abs(x[i] - 3.0f) < 1e-3f && std::abs(y[i]) <= 1.001f && std::abs(z[i]) <= 1.001f;
+    const auto onSide = std::abs(std::abs(y[i]) - 1.0f) < 1e-3f && x[i] >= 2.999f && x[i] <= 4.001f;
+    EXPECT_TRUE(onFront || onSide) << x[i] << " " << y[i] << " " << z[i];
+  }
+  EXPECT_GT(numHits, 1000u);
+}
+
+TEST(SyntheticScanGenerator, DualReturnAndNoise)  // NOLINT
+{
+  auto scene = createFloorScene();
+  scene.boxes.push_back({{3.0, -1.0, -1.5}, {4.0, 1.0, 0.0}, 100.0f});
+  scene.rangeNoise = 0.02;
+  const auto layoutScan = SyntheticScanGenerator::CreatePresetScan(SyntheticScanGenerator::RSLIDAR_32, 20.0);
+  SyntheticScanGenerator generator(layoutScan, scene, true, 42);
+
+  MultiLayerLaserScan msg;
+  generator.Generate(ros::Time(10), msg);
+  generator.Generate(ros::Time(10.1), msg);  // the message is reused
+  const auto n = generator.GetLayout().Length();
+  ASSERT_EQ(2, msg.custom_data.fields.size());
+  ASSERT_EQ(n * msg.custom_data.point_step, msg.custom_data.data.size());
+
+  PointDataConstIterator<float> strongest(msg.custom_data, "strongest");
+  PointDataConstIterator<float> latest(msg.custom_data, "latest");
+  size_t numDual = 0;
+  for (size_t i = 0; i < n; ++i, ++strongest, ++latest)
+  {
+    if (std::isinf(msg.ranges[i]))
+    {
+      EXPECT_TRUE(std::isinf(*latest));
+      continue;
+    }
+    EXPECT_LE(msg.ranges[i], *strongest);
+    EXPECT_LE(*strongest, *latest);
+    // the box is brighter than the floor
+    if (msg.intensities[i] == 100.0f)
+    {
+      EXPECT_EQ(msg.ranges[i], *strongest);
+    }
+    if (*latest > msg.ranges[i])
+      ++numDual;
+  }
+  EXPECT_GT(numDual, 0u);
+
+  // the same seed gives the same scans
+  SyntheticScanGenerator generator2(layoutScan, scene, true, 42);
+  const auto msg2 = generator2.Generate(ros::Time(10));
+  const auto msg3 = generator.Generate(ros::Time(10));
+  SyntheticScanGenerator generator3(layoutScan, scene, true, 42);
+  EXPECT_EQ(generator3.Generate(ros::Time(10)).ranges, msg2.ranges);
+  EXPECT_NE(msg2.ranges, msg3.ranges);
+}
+
+TEST(SyntheticScanGenerator, Dropout)  // NOLINT
+{
+  auto scene = SyntheticScene::Room();
+  scene.dropoutProbability = 0.25;
+  const auto layoutScan = SyntheticScanGenerator::CreatePresetScan(SyntheticScanGenerator::OUSTER_OS1_64);
+  SyntheticScanGenerator generator(layoutScan, scene);
+  const auto msg = generator.Generate(ros::Time(10));
+
+  size_t numNaN = 0;
+  for (const auto range : msg.ranges)
+  {
+    if (std::isnan(range))
+      ++numNaN;
+    else
+      EXPECT_TRUE(std::isfinite(range));  // the room is closed
+  }
+  EXPECT_NEAR(0.25, numNaN / static_cast<double>(msg.ranges.size()), 0.01);
+
+  scene.rangeNoise = -1;
+  EXPECT_THROW(SyntheticScanGenerator(layoutScan, scene), std::runtime_error);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,81 @@
+#ifndef MULTILAYER_LASER_SCAN_TEST_SCANS_H
+#define MULTILAYER_LASER_SCAN_TEST_SCANS_H
+
+#include <multilayer_laser_scan/MultiLayerLaserScan.h>
+
+#include <cstddef>
+#include <cstdlib>
+
+namespace sensor_msgs
+{
+
+/**
+ * @brief Scan with regular layouts and no points, shared by the tests.
+ *
+ * The numScans subscans go from minAngle to maxAngle (exclusive) timeIncrement
+ * apart, starting at the header stamp; negative numScans go from maxAngle
+ * down. Each subscan has subscanLength rays from subscanMinAngle to
+ * subscanMaxAngle, all measured at the same time and scan angle.
+ */
+inline MultiLayerLaserScan CreateRegularLayoutScan(const int numScans, const size_t subscanLength,
+    const double minAngle, const double maxAngle, const double subscanMinAngle, const double subscanMaxAngle,
+    const ros::Duration& timeIncrement)
+{
+  MultiLayerLaserScan msg;
+  msg.header.stamp = ros::Time(100, 0);
+
+  msg.subscan_layout.time_offsets.regular = true;
+  msg.subscan_layout.time_offsets.increment = ros::Duration(0);
+  msg.subscan_layout.angular_offsets.regular = true;
+  msg.subscan_layout.angular_offsets.min = subscanMinAngle;
+  msg.subscan_layout.angular_offsets.max = subscanMaxAngle;
+  msg.subscan_layout.angular_offsets.samples = subscanLength;
+
+  msg.scan_layout.time_offsets.regular = true;
+  msg.scan_layout.time_offsets.increment = timeIncrement;
+  msg.scan_layout.angular_offsets.regular = true;
+  msg.scan_layout.angular_offsets.min = minAngle;
+  msg.scan_layout.angular_offsets.max = maxAngle;
+  msg.scan_layout.angular_offsets.exclude_last = true;
+  msg.scan_layout.angular_offsets.samples = numScans;
+
+  msg.scan_offsets_during_subscan.regular = true;
+  msg.scan_offsets_during_subscan.min = 0;
+  msg.scan_offsets_during_subscan.max = 0;
+  msg.scan_offsets_during_subscan.samples = subscanLength;
+
+  return msg;
+}
+
+/**
+ * @brief CreateRegularLayoutScan() of subscans 1 ms apart with rays in
+ *        <-0.1, 0.1> rad, and with points.
+ *
+ * The first subscan starts 0.5 ms after the header stamp, its rays are 10 us
+ * apart and the scan angle advances by 1 mrad during each subscan. Point i has
+ * range 1 + i and intensity 2 i.
+ */
+inline MultiLayerLaserScan CreateRegularScan(const int numScans, const size_t subscanLength, const double minAngle,
+    const double maxAngle)
+{
+  auto msg = CreateRegularLayoutScan(numScans, subscanLength, minAngle, maxAngle, -0.1, 0.1, ros::Duration(0.001));
+  msg.subscan_layout.time_offsets.increment = ros::Duration(0.00001);
+  msg.scan_layout.time_offsets.base_offset = ros::Duration(0.0005);
+  msg.scan_offsets_during_subscan.max = 0.001;
+
+  const auto length = std::abs(numScans) * subscanLength;
+  msg.range_min = 0.5f;
+  msg.range_max = 100.0f;
+  msg.ranges.resize(length);
+  msg.intensities.resize(length);
+  for (size_t i = 0; i < length; ++i)
+  {
+    msg.ranges[i] = 1.0f + i;
+    msg.intensities[i] = 2.0f * i;
+  }
+  return msg;
+}
+
+}
+
+#endif //MULTILAYER_LASER_SCAN_TEST_SCANS_H